@@ -14,6 +14,9 @@
 
 #include "serialbox-c/Archive.h"
 #include "serialbox-c/Utility.h"
+#include "serialbox/core/ArchiveCompactor.h"
+#include "serialbox/core/ArchiveConverter.h"
+#include "serialbox/core/ArchiveMerger.h"
 #include "serialbox/core/archive/ArchiveFactory.h"
 
 using namespace serialboxC;
@@ -44,3 +47,50 @@ char* serialboxArchiveGetArchiveFromExtension(const char* filename) {
   }
   return archive;
 }
+
+int serialboxArchiveCompact(const char* directory, const char* prefix, int numThreads) {
+  try {
+    serialbox::ArchiveCompactor compactor(directory, prefix);
+    compactor.setNumThreads(numThreads);
+    compactor.compact();
+    return (int)compactor.numRemovedRecords();
+  } catch(std::exception& e) {
+    serialboxFatalError(e.what());
+  }
+  return -1;
+}
+
+int serialboxArchiveConvert(const char* directory, const char* prefix, const char* archive,
+                            const char* targetDirectory, const char* targetPrefix,
+                            const char* targetArchive, int numThreads, double* throughput) {
+  try {
+    serialbox::ArchiveConverter converter(directory, prefix, archive, targetDirectory,
+                                          targetPrefix, targetArchive);
+    converter.setNumThreads(numThreads);
+    converter.convert();
+    if(throughput)
+      *throughput = converter.statistics().throughput();
+    return (int)converter.statistics().numRecords;
+  } catch(std::exception& e) {
+    serialboxFatalError(e.what());
+  }
+  return -1;
+}
+
+int serialboxArchiveMerge(const char* directory, const char* prefix, int numSegments,
+                          const char** directories, const char** prefixes, int conflictPolicy) {
+  try {
+    if(conflictPolicy < 0 || conflictPolicy > 2)
+      throw serialbox::Exception("invalid conflict policy: %i", conflictPolicy);
+
+    serialbox::ArchiveMerger merger(directory, prefix);
+    merger.setConflictPolicy(
+        static_cast<serialbox::ArchiveMerger::ConflictPolicyKind>(conflictPolicy));
+    for(int i = 0; i < numSegments; ++i)
+      merger.addSegment(directories[i], prefixes[i]);
+    return (int)merger.merge();
+  } catch(std::exception& e) {
+    serialboxFatalError(e.what());
+  }
+  return -1;
+}
@@ -53,6 +53,63 @@ SERIALBOX_API serialboxArrayOfString_t* serialboxArchiveGetRegisteredArchives(vo
  */
 SERIALBOX_API char* serialboxArchiveGetArchiveFromExtension(const char* filename);
 
+/**
+ * \brief Remove the records of a serializer using the Binary archive which are not referenced by
+ * any savepoint and merge records of equal checksum
+ *
+ * The data files are rewritten and the FieldIDs of the savepoints are remapped. The serializer
+ * must not be in use during the compaction.
+ *
+ * \param directory   Directory of the serializer
+ * \param prefix      Prefix of the serializer
+ * \param numThreads  Number of threads used to rewrite the data files (0 uses one per core)
+ * \return Number of removed records or -1 if an error occured
+ */
+SERIALBOX_API int serialboxArchiveCompact(const char* directory, const char* prefix,
+                                          int numThreads);
+
+/**
+ * \brief Copy a serializer to a new serializer using a different archive (e.g Binary to NetCDF)
+ *
+ * Each record is converted once, no matter how many savepoints refer to it. The meta-data of the
+ * serializer is preserved. The target serializer is opened in `Write` mode.
+ *
+ * \param directory        Directory of the source serializer
+ * \param prefix           Prefix of the source serializer
+ * \param archive          Archive of the source serializer
+ * \param targetDirectory  Directory of the target serializer
+ * \param targetPrefix     Prefix of the target serializer
+ * \param targetArchive    Archive of the target serializer
+ * \param numThreads       Number of threads used to read the records (0 uses one per core)
+ * \param throughput       If not NULL, set to the throughput of the conversion in MB/s
+ * \return Number of converted records or -1 if an error occured
+ */
+SERIALBOX_API int serialboxArchiveConvert(const char* directory, const char* prefix,
+                                          const char* archive, const char* targetDirectory,
+                                          const char* targetPrefix, const char* targetArchive,
+                                          int numThreads, double* throughput);
+
+/**
+ * \brief Merge several serializers using the Binary archive (e.g the segments of a restarted run)
+ * into a single serializer
+ *
+ * The savepoints are concatenated in the order of the segments. The data files are appended at
+ * block-aligned offsets using `copy_file_range` where available. If the target is the first
+ * segment, it is extended in place.
+ *
+ * \param directory       Directory of the merged serializer
+ * \param prefix          Prefix of the merged serializer
+ * \param numSegments     Number of segments
+ * \param directories     Array of the directories of the segments
+ * \param prefixes        Array of the prefixes of the segments
+ * \param conflictPolicy  Handling of savepoints present in more than one segment (0: error,
+ *                        1: keep the first occurrence, 2: keep the last occurrence)
+ * \return Number of savepoints of the merged serializer or -1 if an error occured
+ */
+SERIALBOX_API int serialboxArchiveMerge(const char* directory, const char* prefix, int numSegments,
+                                        const char** directories, const char** prefixes,
+                                        int conflictPolicy);
+
 /** @} @} */
 
 #ifdef __cplusplus
@@ -42,3 +42,5 @@ SERIALBOX_ARRAY_CREATE_DESTROY_IMPL(Int64);
 SERIALBOX_ARRAY_CREATE_DESTROY_IMPL(Float32);
 SERIALBOX_ARRAY_CREATE_DESTROY_IMPL(Float64);
 SERIALBOX_ARRAY_CREATE_DESTROY_IMPL(String);
+
+void serialboxStringTableDestroy(serialboxStringTable_t* table) { std::free(table); }
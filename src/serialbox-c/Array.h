@@ -82,6 +82,21 @@ SERIALBOX_API typedef struct {
   int len;
 } serialboxArrayOfString_t;
 
+/**
+ * \brief Array of strings allocated as a single block
+ *
+ * The header, the pointers to the strings, the offsets and the (null-terminated) strings are
+ * stored in one contiguous block of memory. The i-th string is `data[i]` which is equal to
+ * `table + offsets[i]`. The whole array is deallocated with a single call to
+ * \ref serialboxStringTableDestroy.
+ */
+SERIALBOX_API typedef struct {
+  serialboxString_t* data;
+  int* offsets;
+  char* table;
+  int len;
+} serialboxStringTable_t;
+
 /**
  * \brief Allocate array of type `T` of size `len`
  *
@@ -111,6 +126,13 @@ SERIALBOX_API void serialboxArrayOfFloat64Destroy(serialboxArrayOfFloat64_t* arr
 SERIALBOX_API void serialboxArrayOfStringDestroy(serialboxArrayOfString_t* array);
 /** @} */
 
+/**
+ * \brief Deallocate the string table (including the strings)
+ *
+ * \param table   String table to deallocate
+ */
+SERIALBOX_API void serialboxStringTableDestroy(serialboxStringTable_t* table);
+
 /** @} @} */
 
 #ifdef __cplusplus
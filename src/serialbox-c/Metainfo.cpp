@@ -110,39 +110,41 @@ char* serialboxMetainfoToString(const serialboxMetainfo_t* metaInfo) {
 serialboxMetainfoElementInfo_t*
 serialboxMetainfoCreateElementInfo(const serialboxMetainfo_t* metaInfo) {
   const MetainfoMap* map = toConstMetainfoMap(metaInfo);
-  serialboxMetainfoElementInfo_t* elements = allocate<serialboxMetainfoElementInfo_t>();
+  const auto keyVector = map->keys();
+  const auto typeVector = map->types();
+  const std::size_t len = keyVector.size();
+
+  std::size_t keysSize = 0;
+  for(const auto& key : keyVector)
+    keysSize += key.size() + 1;
+
+  // The element-info is followed by the pointers to the keys, the types and the keys
+  serialboxMetainfoElementInfo_t* elements = allocateBlock<serialboxMetainfoElementInfo_t>(
+      len * (sizeof(char*) + sizeof(int)) + keysSize);
+  char* block = reinterpret_cast<char*>(elements + 1);
+  elements->keys = reinterpret_cast<char**>(block);
+  elements->types = reinterpret_cast<int*>(block + len * sizeof(char*));
+  char* keyPtr = block + len * (sizeof(char*) + sizeof(int));
 
   // keys
-  const auto keyVector = map->keys();
-  elements->keys = (char**)std::malloc(keyVector.size() * sizeof(char*));
-  for(std::size_t i = 0; i < keyVector.size(); ++i)
-    elements->keys[i] = allocateAndCopyString(keyVector[i]);
+  for(std::size_t i = 0; i < len; ++i) {
+    std::memcpy(keyPtr, keyVector[i].c_str(), keyVector[i].size() + 1);
+    elements->keys[i] = keyPtr;
+    keyPtr += keyVector[i].size() + 1;
+  }
 
   // types
-  const auto typeVector = map->types();
-  elements->types = (int*)std::malloc(typeVector.size() * sizeof(int));
-  for(std::size_t i = 0; i < typeVector.size(); ++i)
+  for(std::size_t i = 0; i < len; ++i)
     elements->types[i] = (int)typeVector[i];
 
   // len
-  elements->len = (int)map->size();
+  elements->len = (int)len;
 
   return elements;
 }
 
 void serialboxMetainfoDestroyElementInfo(serialboxMetainfoElementInfo_t* elementInfo) {
-  if(elementInfo) {
-    // keys
-    for(int i = 0; i < elementInfo->len; ++i)
-      std::free(elementInfo->keys[i]);
-    std::free(elementInfo->keys);
-
-    // types
-    std::free(elementInfo->types);
-
-    // element-info
-    std::free(elementInfo);
-  }
+  std::free(elementInfo);
 }
 
 SERIALBOX_API int serialboxMetainfoDeleteKey(serialboxMetainfo_t* metaInfo, const char* key) {
@@ -271,4 +273,16 @@ serialboxArrayOfString_t* serialboxMetainfoGetArrayOfString(const serialboxMetai
   return array;
 }
 
+serialboxStringTable_t*
+serialboxMetainfoGetArrayOfStringTable(const serialboxMetainfo_t* metaInfo, const char* key) {
+  const MetainfoMap* map = toConstMetainfoMap(metaInfo);
+  serialboxStringTable_t* table = NULL;
+  try {
+    table = allocateStringTable(map->as<serialbox::Array<std::string>>(key));
+  } catch(std::exception& e) {
+    serialboxFatalError(e.what());
+  }
+  return table;
+}
+
 #undef SERIALBOX_METAINFO_GET_ARRAY_IMPL
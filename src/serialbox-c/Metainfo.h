@@ -142,7 +142,8 @@ SERIALBOX_API typedef struct {
 /**
  * \brief Allocate and intialize the element-info
  *
- * To free the data-structure use `serialboxMetainfoDestroyElementInfo`.
+ * The element-info (including the keys) is allocated as a single block. To free the data-structure
+ * use `serialboxMetainfoDestroyElementInfo`.
  *
  * \param metaInfo  Meta-information to use
  * \return allocated and initialized `serialboxMetainfoElementInfo_t`
@@ -293,6 +294,19 @@ SERIALBOX_API serialboxArrayOfString_t*
 serialboxMetainfoGetArrayOfString(const serialboxMetainfo_t* metaInfo, const char* key);
 /** @} */
 
+/**
+ * \brief Get the array of strings of the element with key `key` as a string table
+ *
+ * In contrast to \ref serialboxMetainfoGetArrayOfString, the strings are allocated in a single
+ * block which is deallocated with \ref serialboxStringTableDestroy.
+ *
+ * \param metaInfo  Meta-information to use
+ * \param key       Key of the element
+ * \return Newly allocated string table
+ */
+SERIALBOX_API serialboxStringTable_t*
+serialboxMetainfoGetArrayOfStringTable(const serialboxMetainfo_t* metaInfo, const char* key);
+
 /** @} @} */
 
 #ifdef __cplusplus
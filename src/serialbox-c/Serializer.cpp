@@ -24,6 +24,7 @@
 #include "serialbox/core/Slice.h"
 #include "serialbox/core/StorageView.h"
 #include "serialbox/core/Unreachable.h"
+#include "serialbox/core/Validator.h"
 #include "serialbox/core/archive/ArchiveFactory.h"
 
 using namespace serialboxC;
@@ -131,6 +132,54 @@ void serialboxEnableSerialization(void) { Serializer::enableSerialization(); }
 
 void serialboxDisableSerialization(void) { Serializer::disableSerialization(); }
 
+void serialboxSerializerEnableHaloStripping(serialboxSerializer_t* serializer) {
+  Serializer* ser = toSerializer(serializer);
+  ser->enableHaloStripping();
+}
+
+void serialboxSerializerDisableHaloStripping(serialboxSerializer_t* serializer) {
+  Serializer* ser = toSerializer(serializer);
+  ser->disableHaloStripping();
+}
+
+int serialboxSerializerIsHaloStrippingEnabled(const serialboxSerializer_t* serializer) {
+  const Serializer* ser = toConstSerializer(serializer);
+  return ser->isHaloStrippingEnabled();
+}
+
+void serialboxSerializerEnableValidation(serialboxSerializer_t* serializer, const char* directory,
+                                         const char* prefix, const char* archive) {
+  Serializer* ser = toSerializer(serializer);
+  try {
+    ser->enableValidation(directory, prefix, archive);
+  } catch(std::exception& e) {
+    serialboxFatalError(e.what());
+  }
+}
+
+void serialboxSerializerSetValidationTolerance(serialboxSerializer_t* serializer, const char* name,
+                                               double tolerance) {
+  Serializer* ser = toSerializer(serializer);
+  try {
+    if(!ser->isValidationEnabled())
+      throw serialbox::Exception("serializer is not in validation mode");
+
+    if(name)
+      ser->validator()->setTolerance(name, tolerance);
+    else
+      ser->validator()->setTolerance(tolerance);
+  } catch(std::exception& e) {
+    serialboxFatalError(e.what());
+  }
+}
+
+int serialboxSerializerValidationSuccess(const serialboxSerializer_t* serializer) {
+  const Serializer* ser = toConstSerializer(serializer);
+  if(!ser->isValidationEnabled())
+    return -1;
+  return ser->validator()->success();
+}
+
 char* serialboxSerializerToString(const serialboxSerializer_t* serializer) {
   const Serializer* ser = toConstSerializer(serializer);
   std::stringstream ss;
@@ -199,6 +248,28 @@ void serialboxSerializerDestroySavepointVector(serialboxSavepoint_t** savepointV
   std::free(savepointVector);
 }
 
+serialboxArrayOfSavepoint_t*
+serialboxSerializerGetSavepointArray(const serialboxSerializer_t* serializer) {
+  const Serializer* ser = toConstSerializer(serializer);
+  const auto& savepointVector = ser->savepointVector().savepoints();
+
+  // The header is followed by the savepoints
+  serialboxArrayOfSavepoint_t* array = allocateBlock<serialboxArrayOfSavepoint_t>(
+      savepointVector.size() * sizeof(serialboxSavepoint_t));
+  array->data = reinterpret_cast<serialboxSavepoint_t*>(array + 1);
+  array->len = (int)savepointVector.size();
+
+  for(std::size_t i = 0; i < savepointVector.size(); ++i) {
+    array->data[i].impl = savepointVector[i].get();
+    array->data[i].ownsData = 0;
+  }
+  return array;
+}
+
+void serialboxSerializerDestroySavepointArray(serialboxArrayOfSavepoint_t* savepointArray) {
+  std::free(savepointArray);
+}
+
 serialboxArrayOfString_t*
 serialboxSerializerGetFieldnamesAtSavepoint(const serialboxSerializer_t* serializer,
                                             const serialboxSavepoint_t* savepoint) {
@@ -220,6 +291,43 @@ serialboxSerializerGetFieldnamesAtSavepoint(const serialboxSerializer_t* seriali
   return array;
 }
 
+int serialboxSerializerFindFieldAtOrBefore(const serialboxSerializer_t* serializer,
+                                           const char* field,
+                                           const serialboxSavepoint_t* savepoint) {
+  const Savepoint* sp = toConstSavepoint(savepoint);
+  const Serializer* ser = toConstSerializer(serializer);
+  int idx = ser->savepointVector().find(*sp);
+  return idx == -1 ? -1 : ser->savepointVector().findFieldAtOrBefore(idx, field);
+}
+
+int serialboxSerializerFindFieldAfter(const serialboxSerializer_t* serializer, const char* field,
+                                      const serialboxSavepoint_t* savepoint) {
+  const Savepoint* sp = toConstSavepoint(savepoint);
+  const Serializer* ser = toConstSerializer(serializer);
+  int idx = ser->savepointVector().find(*sp);
+  return idx == -1 ? -1 : ser->savepointVector().findFieldAfter(idx, field);
+}
+
+serialboxStringTable_t*
+serialboxSerializerGetFieldnamesAtSavepointTable(const serialboxSerializer_t* serializer,
+                                                 const serialboxSavepoint_t* savepoint) {
+  const Savepoint* sp = toConstSavepoint(savepoint);
+  const Serializer* ser = toConstSerializer(serializer);
+  serialboxStringTable_t* table = NULL;
+
+  try {
+    const auto& fieldnameMap = ser->savepointVector().fieldsOf(*sp);
+    table = allocateStringTable(
+        fieldnameMap.begin(), fieldnameMap.end(),
+        [](const std::pair<const std::string, unsigned int>& field) -> const std::string& {
+          return field.first;
+        });
+  } catch(std::exception& e) {
+    serialboxFatalError(e.what());
+  }
+  return table;
+}
+
 /*===------------------------------------------------------------------------------------------===*\
  *     Register and Query Fields
 \*===------------------------------------------------------------------------------------------===*/
@@ -312,6 +420,19 @@ serialboxSerializerGetFieldnames(const serialboxSerializer_t* serializer) {
   return array;
 }
 
+serialboxStringTable_t*
+serialboxSerializerGetFieldnamesTable(const serialboxSerializer_t* serializer) {
+  const Serializer* ser = toConstSerializer(serializer);
+  serialboxStringTable_t* table = NULL;
+
+  try {
+    table = allocateStringTable(ser->fieldnames());
+  } catch(std::exception& e) {
+    serialboxFatalError(e.what());
+  }
+  return table;
+}
+
 serialboxFieldMetainfo_t*
 serialboxSerializerGetFieldMetainfo(const serialboxSerializer_t* serializer, const char* name) {
   const Serializer* ser = toConstSerializer(serializer);
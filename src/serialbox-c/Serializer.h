@@ -116,6 +116,64 @@ SERIALBOX_API void serialboxEnableSerialization(void);
  */
 SERIALBOX_API void serialboxDisableSerialization(void);
 
+/**
+ * \brief Only store the compute domain of fields registered with halo meta-information
+ *
+ * Fields registered with halos (e.g via `serialboxSerializerAddField2`) are written without their
+ * halos and reading such a field leaves the halos of the destination untouched.
+ *
+ * \param serializer  Serializer to use
+ */
+SERIALBOX_API void serialboxSerializerEnableHaloStripping(serialboxSerializer_t* serializer);
+
+/**
+ * \brief Store fields including their halos [default]
+ *
+ * \param serializer  Serializer to use
+ */
+SERIALBOX_API void serialboxSerializerDisableHaloStripping(serialboxSerializer_t* serializer);
+
+/**
+ * \brief Indicate whether halo stripping is enabled
+ *
+ * \param serializer  Serializer to use
+ * \return 1 if halo stripping is enabled, 0 otherwise
+ */
+SERIALBOX_API int
+serialboxSerializerIsHaloStrippingEnabled(const serialboxSerializer_t* serializer);
+
+/**
+ * \brief Compare all subsequent writes against a reference instead of writing them
+ *
+ * Only the mismatches and per-field statistics are recorded in `ValidationReport-prefix.json`.
+ *
+ * \param serializer  Serializer to use
+ * \param directory   Directory of the reference
+ * \param prefix      Prefix of the reference
+ * \param archive     Archive of the reference (e.g "Binary")
+ */
+SERIALBOX_API void serialboxSerializerEnableValidation(serialboxSerializer_t* serializer,
+                                                       const char* directory, const char* prefix,
+                                                       const char* archive);
+
+/**
+ * \brief Set the tolerance used to compare field `name` (or all fields if `name` is NULL)
+ *
+ * \param serializer  Serializer to use
+ * \param name        Name of the field or NULL
+ * \param tolerance   Tolerance
+ */
+SERIALBOX_API void serialboxSerializerSetValidationTolerance(serialboxSerializer_t* serializer,
+                                                             const char* name, double tolerance);
+
+/**
+ * \brief Check if all validated fields matched the reference
+ *
+ * \param serializer  Serializer to use
+ * \return 1 if all fields matched, 0 if there were mismatches and -1 if validation is disabled
+ */
+SERIALBOX_API int serialboxSerializerValidationSuccess(const serialboxSerializer_t* serializer);
+
 /**
  * \brief Convert serializer to string
  */
@@ -189,6 +247,37 @@ serialboxSerializerGetSavepointVector(const serialboxSerializer_t* serializer);
 SERIALBOX_API void serialboxSerializerDestroySavepointVector(serialboxSavepoint_t** savepointVector,
                                                              int len);
 
+/**
+ * \brief Array of \b references to the registered savepoints allocated as a single block
+ *
+ * \param data   Savepoints (the i-th savepoint is `&data[i]`)
+ * \param len    Number of savepoints
+ */
+SERIALBOX_API typedef struct {
+  serialboxSavepoint_t* data;
+  int len;
+} serialboxArrayOfSavepoint_t;
+
+/**
+ * \brief Get an array of \b references to the registered savepoints
+ *
+ * In contrast to \ref serialboxSerializerGetSavepointVector, the array is allocated as a single
+ * block which is deallocated with \ref serialboxSerializerDestroySavepointArray.
+ *
+ * \param serializer  Serializer to use
+ * \return Newly allocated array of all savepoints
+ */
+SERIALBOX_API serialboxArrayOfSavepoint_t*
+serialboxSerializerGetSavepointArray(const serialboxSerializer_t* serializer);
+
+/**
+ * \brief Deallocate a savepoint array retrieved via \ref serialboxSerializerGetSavepointArray
+ *
+ * \param savepointArray   Savepoint array to deallocate
+ */
+SERIALBOX_API void
+serialboxSerializerDestroySavepointArray(serialboxArrayOfSavepoint_t* savepointArray);
+
 /**
  * \brief Get an array of C-strings of the field names registered at `savepoint`
  *
@@ -200,6 +289,51 @@ SERIALBOX_API serialboxArrayOfString_t*
 serialboxSerializerGetFieldnamesAtSavepoint(const serialboxSerializer_t* serializer,
                                             const serialboxSavepoint_t* savepoint);
 
+/**
+ * \brief Get a string table of the field names registered at `savepoint`
+ *
+ * The table is allocated as a single block which is deallocated with
+ * \ref serialboxStringTableDestroy.
+ *
+ * \param serializer  Serializer to use
+ * \param savepoint   Savepoint of intrest
+ * \return String table of the names of all registered fields at `savepoint`
+ */
+SERIALBOX_API serialboxStringTable_t*
+serialboxSerializerGetFieldnamesAtSavepointTable(const serialboxSerializer_t* serializer,
+                                                 const serialboxSavepoint_t* savepoint);
+
+/**
+ * \brief Find the last savepoint at or before `savepoint` at which `field` exists
+ *
+ * The lookup is a binary search in the savepoints at which the field exists (see
+ * \ref serialboxSerializerRead for reading the field at the returned savepoint).
+ *
+ * \param serializer  Serializer to use
+ * \param field       Name of the field
+ * \param savepoint   Savepoint to start the search from
+ * \return Index of the savepoint in the savepoint vector (see
+ *         \ref serialboxSerializerGetSavepointVector) or -1 if there is no such savepoint or
+ *         `savepoint` does not exist
+ */
+SERIALBOX_API int serialboxSerializerFindFieldAtOrBefore(const serialboxSerializer_t* serializer,
+                                                         const char* field,
+                                                         const serialboxSavepoint_t* savepoint);
+
+/**
+ * \brief Find the first savepoint after `savepoint` at which `field` exists
+ *
+ * \param serializer  Serializer to use
+ * \param field       Name of the field
+ * \param savepoint   Savepoint to start the search from
+ * \return Index of the savepoint in the savepoint vector (see
+ *         \ref serialboxSerializerGetSavepointVector) or -1 if there is no such savepoint or
+ *         `savepoint` does not exist
+ */
+SERIALBOX_API int serialboxSerializerFindFieldAfter(const serialboxSerializer_t* serializer,
+                                                    const char* field,
+                                                    const serialboxSavepoint_t* savepoint);
+
 /*===------------------------------------------------------------------------------------------===*\
  *     Register and Query Fields
 \*===------------------------------------------------------------------------------------------===*/
@@ -262,6 +396,18 @@ SERIALBOX_API int serialboxSerializerAddField2(serialboxSerializer_t* serializer
 SERIALBOX_API serialboxArrayOfString_t*
 serialboxSerializerGetFieldnames(const serialboxSerializer_t* serializer);
 
+/**
+ * \brief Get a string table of all names of the registered fields
+ *
+ * The table is allocated as a single block which is deallocated with
+ * \ref serialboxStringTableDestroy.
+ *
+ * \param serializer  Serializer to use
+ * \return String table of the names of all registered fields
+ */
+SERIALBOX_API serialboxStringTable_t*
+serialboxSerializerGetFieldnamesTable(const serialboxSerializer_t* serializer);
+
 /**
  * \brief Get FieldMetainfoImpl of field with name `name`
  *
@@ -20,6 +20,7 @@
 
 #ifdef __cplusplus
 
+#include "serialbox-c/Array.h"
 #include "serialbox-c/ErrorHandling.h"
 #include "serialbox-c/Type.h"
 #include "serialbox/core/FieldMetainfoImpl.h"
@@ -28,6 +29,9 @@
 #include "serialbox/core/SerializerImpl.h"
 #include <cstdlib>
 #include <cstring>
+#include <iterator>
+#include <string>
+#include <vector>
 
 namespace serialboxC {
 
@@ -127,6 +131,52 @@ T* allocate(std::size_t n) noexcept {
   return data;
 }
 
+/// \brief Allocate a block of `size` bytes starting with a zero-initialized `Header`
+template <class Header>
+Header* allocateBlock(std::size_t size) noexcept {
+  char* block = (char*)std::malloc(sizeof(Header) + size);
+  if(!block)
+    serialboxFatalError("out of memory");
+  std::memset(block, 0, sizeof(Header));
+  return reinterpret_cast<Header*>(block);
+}
+
+/// \brief Copy the strings `toString(*it)` of the range [`first`, `last`) into a string table
+/// allocated as a single block
+template <class Iterator, class ToString>
+serialboxStringTable_t* allocateStringTable(Iterator first, Iterator last, ToString toString) {
+  const std::size_t len = std::distance(first, last);
+  std::size_t tableSize = 0;
+  for(Iterator it = first; it != last; ++it)
+    tableSize += toString(*it).size() + 1;
+
+  // The header is followed by the pointers, the offsets and the strings
+  serialboxStringTable_t* stringTable = allocateBlock<serialboxStringTable_t>(
+      len * (sizeof(serialboxString_t) + sizeof(int)) + tableSize);
+  char* block = reinterpret_cast<char*>(stringTable + 1);
+  stringTable->data = reinterpret_cast<serialboxString_t*>(block);
+  stringTable->offsets = reinterpret_cast<int*>(block + len * sizeof(serialboxString_t));
+  stringTable->table = block + len * (sizeof(serialboxString_t) + sizeof(int));
+  stringTable->len = (int)len;
+
+  std::size_t offset = 0;
+  int i = 0;
+  for(Iterator it = first; it != last; ++it, ++i) {
+    const std::string& str = toString(*it);
+    std::memcpy(stringTable->table + offset, str.c_str(), str.size() + 1);
+    stringTable->data[i] = stringTable->table + offset;
+    stringTable->offsets[i] = (int)offset;
+    offset += str.size() + 1;
+  }
+  return stringTable;
+}
+
+/// \brief Copy `strings` into a string table allocated as a single block
+inline serialboxStringTable_t* allocateStringTable(const std::vector<std::string>& strings) {
+  return allocateStringTable(strings.begin(), strings.end(),
+                             [](const std::string& str) -> const std::string& { return str; });
+}
+
 #ifdef SERIALBOX_COMPILER_MSVC
 
 /// \brief Convert wchar_t* to char*
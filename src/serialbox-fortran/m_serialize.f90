@@ -44,6 +44,7 @@ PUBLIC :: &
   fs_create_savepoint, fs_destroy_savepoint, fs_add_savepoint_metainfo, fs_get_savepoint_metainfo, &
   fs_field_exists, fs_register_field, fs_add_field_metainfo, fs_get_field_metainfo, fs_write_field, fs_read_field, &
   fs_enable_serialization, fs_disable_serialization, fs_print_debuginfo, &
+  fs_enable_halo_stripping, fs_disable_halo_stripping, &
   fs_get_size, fs_get_halos, fs_get_rank, fs_get_total_size, &
   fs_boolsize, fs_intsize, fs_longsize, fs_floatsize, fs_doublesize
   INTEGER, PARAMETER :: MODE_READ = 0
@@ -702,6 +703,48 @@ END SUBROUTINE fs_print_debuginfo
 !=============================================================================
 !=============================================================================
 
+!==============================================================================
+!+ Module procedure to store only the compute domain of fields with halos
+!------------------------------------------------------------------------------
+SUBROUTINE fs_enable_halo_stripping(serializer)
+  TYPE(t_serializer), INTENT(IN) :: serializer
+
+  ! External function
+  INTERFACE
+     SUBROUTINE serialboxSerializerEnableHaloStripping(serializer) &
+          BIND(c, name='serialboxSerializerEnableHaloStripping')
+       USE, INTRINSIC :: iso_c_binding
+       TYPE(C_PTR), INTENT(IN), VALUE       :: serializer
+     END SUBROUTINE serialboxSerializerEnableHaloStripping
+  END INTERFACE
+
+  CALL serialboxSerializerEnableHaloStripping(serializer%serializer_ptr)
+END SUBROUTINE fs_enable_halo_stripping
+
+!=============================================================================
+!=============================================================================
+
+!==============================================================================
+!+ Module procedure to store fields including their halos (default)
+!------------------------------------------------------------------------------
+SUBROUTINE fs_disable_halo_stripping(serializer)
+  TYPE(t_serializer), INTENT(IN) :: serializer
+
+  ! External function
+  INTERFACE
+     SUBROUTINE serialboxSerializerDisableHaloStripping(serializer) &
+          BIND(c, name='serialboxSerializerDisableHaloStripping')
+       USE, INTRINSIC :: iso_c_binding
+       TYPE(C_PTR), INTENT(IN), VALUE       :: serializer
+     END SUBROUTINE serialboxSerializerDisableHaloStripping
+  END INTERFACE
+
+  CALL serialboxSerializerDisableHaloStripping(serializer%serializer_ptr)
+END SUBROUTINE fs_disable_halo_stripping
+
+!=============================================================================
+!=============================================================================
+
 !==============================================================================
 !+ Module procedure to register a field
 !  If the field exists already in the serializer, the function does nothing
@@ -0,0 +1,81 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+##===-----------------------------------------------------------------------------*- Python -*-===##
+##
+##                                   S E R I A L B O X
+##
+## This file is distributed under terms of BSD license.
+## See LICENSE.txt for more information.
+##
+##===------------------------------------------------------------------------------------------===##
+##
+## Compacts a Serialbox archive. FILE is the MetaData-prefix.json of a serializer using the Binary
+## archive. Records which are not referenced by any savepoint are removed and records with equal
+## checksums are merged. The serializer must not be in use during the compaction.
+##
+##===------------------------------------------------------------------------------------------===##
+
+from __future__ import print_function
+
+from sys import exit, stderr, version_info
+
+# Check Python version
+if version_info < (3, 4):
+    from platform import python_version
+
+    print("compact: error: compact requires at least python 3.4 (detected %s)" % python_version(),
+          file=stderr)
+    exit(1)
+
+from argparse import ArgumentParser
+from os import path
+from sys import path as sys_path
+from time import time
+
+# Find the Serialbox python module
+sys_path.insert(1, path.join(path.dirname(path.realpath(__file__)), "../"))
+
+import serialbox as ser
+
+
+def fatal_error(msg):
+    print("compact: error: " + msg, file=stderr)
+    exit(1)
+
+
+def main():
+    parser = ArgumentParser(
+        description=
+        """
+        Compacts a Serialbox archive by removing the records which are not referenced by any
+        savepoint and merging records with equal checksums. FILE is the MetaData-prefix.json of a
+        serializer using the Binary archive.
+        """
+    )
+    parser.add_argument('FILE', help="Path to the MetaData-prefix.json of the serializer",
+                        nargs=1, type=str)
+    parser.add_argument("-j", "--threads", dest="threads", metavar="N", type=int, default=0,
+                        help="number of threads used to rewrite the data files (default: one "
+                             "per core)")
+    args = parser.parse_args()
+
+    file = args.FILE[0]
+    basename = path.basename(file)
+    if not basename.startswith("MetaData-") or not basename.endswith(".json"):
+        fatal_error("'%s': expected a MetaData-prefix.json file" % file)
+
+    directory = path.dirname(file) or "."
+    prefix = basename[len("MetaData-"):-len(".json")]
+
+    start = time()
+    try:
+        num_removed = ser.Archive.compact(directory, prefix, args.threads)
+    except ser.SerialboxError as e:
+        fatal_error(str(e))
+
+    print("removed %i records (%.2f s)" % (num_removed, time() - start))
+    return 0
+
+
+if __name__ == '__main__':
+    exit(main())
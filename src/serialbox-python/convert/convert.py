@@ -0,0 +1,102 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+##===-----------------------------------------------------------------------------*- Python -*-===##
+##
+##                                   S E R I A L B O X
+##
+## This file is distributed under terms of BSD license.
+## See LICENSE.txt for more information.
+##
+##===------------------------------------------------------------------------------------------===##
+##
+## Converts a Serialbox serializer to a different archive (e.g Binary to NetCDF). FILE is the
+## MetaData-prefix.json of the source serializer, the records are copied archive-to-archive by the
+## native library and each unique record is converted once.
+##
+##===------------------------------------------------------------------------------------------===##
+
+from __future__ import print_function
+
+from sys import exit, stderr, version_info
+
+# Check Python version
+if version_info < (3, 4):
+    from platform import python_version
+
+    print("convert: error: convert requires at least python 3.4 (detected %s)" % python_version(),
+          file=stderr)
+    exit(1)
+
+from argparse import ArgumentParser
+from json import load
+from os import path
+from sys import path as sys_path
+
+# Find the Serialbox python module
+sys_path.insert(1, path.join(path.dirname(path.realpath(__file__)), "../"))
+
+import serialbox as ser
+
+
+def fatal_error(msg):
+    print("convert: error: " + msg, file=stderr)
+    exit(1)
+
+
+def archive_of(directory, prefix):
+    """ Read the name of the archive from ArchiveMetaData-prefix.json """
+    filename = path.join(directory, "ArchiveMetaData-" + prefix + ".json")
+    try:
+        with open(filename, "r") as f:
+            return load(f)["archive_name"]
+    except (IOError, ValueError, KeyError) as e:
+        fatal_error("cannot determine the archive of '%s': %s" % (filename, e))
+
+
+def main():
+    parser = ArgumentParser(
+        description=
+        """
+        Converts a Serialbox serializer to a different archive. FILE is the MetaData-prefix.json
+        of the source serializer.
+        """
+    )
+    parser.add_argument('FILE', help="Path to the MetaData-prefix.json of the source serializer",
+                        nargs=1, type=str)
+    parser.add_argument('DIRECTORY', help="Directory of the converted serializer", nargs=1,
+                        type=str)
+    parser.add_argument("-a", "--archive", dest="archive", metavar="ARCHIVE", default="NetCDF",
+                        help="archive of the converted serializer (default: NetCDF)")
+    parser.add_argument("-p", "--prefix", dest="prefix", metavar="PREFIX", default=None,
+                        help="prefix of the converted serializer (default: prefix of FILE)")
+    parser.add_argument("-j", "--threads", dest="threads", metavar="N", type=int, default=0,
+                        help="number of threads used to read the records (default: one per core)")
+    args = parser.parse_args()
+
+    file = args.FILE[0]
+    basename = path.basename(file)
+    if not basename.startswith("MetaData-") or not basename.endswith(".json"):
+        fatal_error("'%s': expected a MetaData-prefix.json file" % file)
+
+    directory = path.dirname(file) or "."
+    prefix = basename[len("MetaData-"):-len(".json")]
+    archive = archive_of(directory, prefix)
+
+    if args.archive not in ser.Archive.registered_archives():
+        fatal_error("archive '%s' is not available (registered archives: %s)" % (
+            args.archive, ", ".join(ser.Archive.registered_archives())))
+
+    try:
+        num_records, throughput = ser.Archive.convert(directory, prefix, archive,
+                                                      args.DIRECTORY[0], args.prefix or prefix,
+                                                      args.archive, args.threads)
+    except ser.SerialboxError as e:
+        fatal_error(str(e))
+
+    print("converted %i records from %s to %s (%.2f MB/s)" % (num_records, archive, args.archive,
+                                                               throughput))
+    return 0
+
+
+if __name__ == '__main__':
+    exit(main())
@@ -0,0 +1,190 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+##===-----------------------------------------------------------------------------*- Python -*-===##
+##
+##                                   S E R I A L B O X
+##
+## This file is distributed under terms of BSD license. 
+## See LICENSE.txt for more information.
+##
+##===------------------------------------------------------------------------------------------===##
+##
+## Compares the checksums of two Serialbox runs and reports the first savepoint and field which
+## are not bit-identical. FILE_1 and FILE_2 are MetaData-prefix.json files of serializers using the
+## Fingerprint or the Binary archive (both need to use the same hash algorithm). Only the JSON
+## meta-data is parsed, no data is read.
+##
+##===------------------------------------------------------------------------------------------===##
+
+from __future__ import print_function
+
+from sys import exit, stderr, version_info
+
+# Check Python version
+if version_info < (3, 4):
+    from platform import python_version
+
+    print("fingerprint_diff: error: fingerprint_diff requires at least python 3.4 (detected %s)"
+          % python_version(), file=stderr)
+    exit(1)
+
+from argparse import ArgumentParser
+from json import load
+from os import path
+from time import time
+
+# Index of the checksum in the `fields_table` entries of the archive meta-data
+CHECKSUM_INDEX = {"Binary": 1, "Fingerprint": 0}
+
+
+def fatal_error(msg):
+    print("fingerprint_diff: error: " + msg, file=stderr)
+    exit(1)
+
+
+def load_json(filename):
+    try:
+        with open(filename, "r") as f:
+            return load(f)
+    except (IOError, ValueError) as e:
+        fatal_error("cannot load '%s': %s" % (filename, e))
+
+
+class Run(object):
+    """ Savepoints and checksums of a serialized run """
+
+    def __init__(self, file):
+        if not file.endswith(".json") or not path.basename(file).startswith("MetaData-"):
+            fatal_error("'%s': expected a MetaData-prefix.json file" % file)
+
+        self.file = file
+        self.prefix = path.basename(file)[len("MetaData-"):-len(".json")]
+
+        meta_data = load_json(file)
+        archive_meta_data = load_json(
+            path.join(path.dirname(file), "ArchiveMetaData-%s.json" % self.prefix))
+
+        self.archive = archive_meta_data.get("archive_name", "Binary")
+        if self.archive not in CHECKSUM_INDEX:
+            fatal_error("'%s': archive '%s' is not supported" % (file, self.archive))
+
+        self.hash_algorithm = archive_meta_data.get("hash_algorithm", "")
+
+        # List of (savepoint, {field: id}), the savepoints may be split into shards
+        savepoint_vectors = [meta_data.get("savepoint_vector") or {}]
+        if meta_data.get("savepoint_shards"):
+            savepoint_vectors = [load_json(path.join(path.dirname(file), shard)) or {}
+                                 for shard in meta_data["savepoint_shards"].get("shards", [])]
+
+        self.savepoints = []
+        for savepoint_vector in savepoint_vectors:
+            for savepoint, fields in zip(savepoint_vector.get("savepoints") or [],
+                                         savepoint_vector.get("fields_per_savepoint") or []):
+                self.savepoints += [(savepoint, fields.get(savepoint["name"]) or {})]
+
+        # Dictionary {field: [entry]}
+        self.fields_table = archive_meta_data.get("fields_table", {})
+
+    def record(self, field, id):
+        """ Get the entry of the record `id` of `field` in the archive """
+        return self.fields_table[field][id]
+
+    def checksum(self, field, id):
+        return self.record(field, id)[CHECKSUM_INDEX[self.archive]]
+
+    def statistics(self, field, id):
+        """ Get (min, max, mean) of the record (only available for the Fingerprint archive) """
+        if self.archive != "Fingerprint":
+            return None
+        return tuple(float("nan") if v is None else v for v in self.record(field, id)[1:4])
+
+
+def savepoint_to_string(savepoint):
+    meta_info = savepoint.get("meta_info") or {}
+    values = ", ".join("%s: %s" % (k, meta_info[k]["value"]) for k in sorted(meta_info))
+    return "%s {%s}" % (savepoint["name"], values) if values else savepoint["name"]
+
+
+def statistics_to_string(statistics):
+    return "min = %s, max = %s, mean = %s" % statistics if statistics else "n/a"
+
+
+def same_savepoint(sp_1, sp_2):
+    return sp_1["name"] == sp_2["name"] and \
+           (sp_1.get("meta_info") or {}) == (sp_2.get("meta_info") or {})
+
+
+def diff(run_1, run_2, check_all):
+    """ Compare the runs savepoint by savepoint, return the number of divergent records """
+    num_divergent = 0
+
+    for idx, ((sp_1, fields_1), (sp_2, fields_2)) in enumerate(zip(run_1.savepoints,
+                                                                   run_2.savepoints)):
+        if not same_savepoint(sp_1, sp_2):
+            print("savepoint %i differs: '%s' vs. '%s'" % (idx, savepoint_to_string(sp_1),
+                                                           savepoint_to_string(sp_2)))
+            return num_divergent + 1
+
+        for field in sorted(set(fields_1) | set(fields_2)):
+            if field not in fields_1 or field not in fields_2:
+                print("%s: field '%s' is only present in %s" % (
+                    savepoint_to_string(sp_1), field,
+                    run_1.file if field in fields_1 else run_2.file))
+                num_divergent += 1
+            elif run_1.checksum(field, fields_1[field]) != run_2.checksum(field, fields_2[field]):
+                print("%s: field '%s' diverges" % (savepoint_to_string(sp_1), field))
+                print("  %s: %s" % (run_1.file,
+                                    statistics_to_string(run_1.statistics(field, fields_1[field]))))
+                print("  %s: %s" % (run_2.file,
+                                    statistics_to_string(run_2.statistics(field, fields_2[field]))))
+                num_divergent += 1
+            else:
+                continue
+
+            if not check_all:
+                return num_divergent
+
+    if len(run_1.savepoints) != len(run_2.savepoints):
+        print("number of savepoints differs: %i vs. %i" % (len(run_1.savepoints),
+                                                           len(run_2.savepoints)))
+        num_divergent += 1
+
+    return num_divergent
+
+
+def main():
+    parser = ArgumentParser(
+        description=
+        """
+        Compares the checksums of two Serialbox runs and reports the first savepoint and field
+        which are not bit-identical. FILE_1 and FILE_2 are MetaData-prefix.json files of
+        serializers using the Fingerprint or the Binary archive.
+        """
+    )
+    parser.add_argument('FILE_1', help="Path to the MetaData-prefix.json of the first run",
+                        nargs=1, type=str)
+    parser.add_argument('FILE_2', help="Path to the MetaData-prefix.json of the second run",
+                        nargs=1, type=str)
+    parser.add_argument("-a", "--all", dest="all", action="store_true",
+                        help="report all divergent records instead of only the first one")
+    args = parser.parse_args()
+
+    start = time()
+
+    run_1 = Run(args.FILE_1[0])
+    run_2 = Run(args.FILE_2[0])
+
+    if run_1.hash_algorithm != run_2.hash_algorithm:
+        fatal_error("hash algorithms differ: '%s' vs. '%s'" % (run_1.hash_algorithm,
+                                                               run_2.hash_algorithm))
+
+    num_divergent = diff(run_1, run_2, args.all)
+
+    if num_divergent == 0:
+        print("runs are bit-identical (%i savepoints, %.2f s)" % (len(run_1.savepoints),
+                                                                  time() - start))
+    return 1 if num_divergent else 0
+
+
+if __name__ == '__main__':
+    exit(main())
@@ -0,0 +1,98 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+##===-----------------------------------------------------------------------------*- Python -*-===##
+##
+##                                   S E R I A L B O X
+##
+## This file is distributed under terms of BSD license.
+## See LICENSE.txt for more information.
+##
+##===------------------------------------------------------------------------------------------===##
+##
+## Merges several Serialbox serializers using the Binary archive (e.g the segments of a restarted
+## run) into a single serializer. Each FILE is the MetaData-prefix.json of a segment, the data
+## files are appended at block-aligned offsets (shared instead of copied on filesystems with
+## reflink support).
+##
+##===------------------------------------------------------------------------------------------===##
+
+from __future__ import print_function
+
+from sys import exit, stderr, version_info
+
+# Check Python version
+if version_info < (3, 4):
+    from platform import python_version
+
+    print("merge: error: merge requires at least python 3.4 (detected %s)" % python_version(),
+          file=stderr)
+    exit(1)
+
+from argparse import ArgumentParser
+from os import path
+from sys import path as sys_path
+
+# Find the Serialbox python module
+sys_path.insert(1, path.join(path.dirname(path.realpath(__file__)), "../"))
+
+import serialbox as ser
+
+
+def fatal_error(msg):
+    print("merge: error: " + msg, file=stderr)
+    exit(1)
+
+
+def split_metadata_file(file):
+    """ Split the path to a MetaData-prefix.json into directory and prefix """
+    basename = path.basename(file)
+    if not basename.startswith("MetaData-") or not basename.endswith(".json"):
+        fatal_error("'%s': expected a MetaData-prefix.json file" % file)
+    return path.dirname(file) or ".", basename[len("MetaData-"):-len(".json")]
+
+
+def main():
+    parser = ArgumentParser(
+        description=
+        """
+        Merges several Serialbox serializers using the Binary archive into a single serializer.
+        Each FILE is the MetaData-prefix.json of a segment, the savepoints are concatenated in the
+        order of the segments. If the merged serializer is the first segment, it is extended in
+        place.
+        """
+    )
+    parser.add_argument('FILE', help="Path to the MetaData-prefix.json of a segment", nargs='+',
+                        type=str)
+    parser.add_argument("-o", "--output", dest="output", metavar="DIRECTORY", required=True,
+                        help="directory of the merged serializer")
+    parser.add_argument("-p", "--prefix", dest="prefix", metavar="PREFIX", default=None,
+                        help="prefix of the merged serializer (default: prefix of the first FILE)")
+    parser.add_argument("--keep-first", dest="keep_first", action="store_true",
+                        help="keep the first occurrence of savepoints present in several segments")
+    parser.add_argument("--keep-last", dest="keep_last", action="store_true",
+                        help="keep the last occurrence of savepoints present in several segments")
+    args = parser.parse_args()
+
+    if args.keep_first and args.keep_last:
+        fatal_error("--keep-first and --keep-last are mutually exclusive")
+
+    policy = ser.Archive.ConflictError
+    if args.keep_first:
+        policy = ser.Archive.ConflictKeepFirst
+    elif args.keep_last:
+        policy = ser.Archive.ConflictKeepLast
+
+    segments = [split_metadata_file(file) for file in args.FILE]
+    prefix = args.prefix or segments[0][1]
+
+    try:
+        num_savepoints = ser.Archive.merge(args.output, prefix, segments, policy)
+    except ser.SerialboxError as e:
+        fatal_error(str(e))
+
+    print("merged %i segments into '%s' (%i savepoints)" % (len(segments), prefix, num_savepoints))
+    return 0
+
+
+if __name__ == '__main__':
+    exit(main())
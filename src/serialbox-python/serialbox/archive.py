@@ -13,7 +13,7 @@
 ##
 ##===------------------------------------------------------------------------------------------===##
 
-from ctypes import POINTER, c_char_p
+from ctypes import POINTER, byref, c_char_p, c_double, c_int
 
 from .common import get_library, to_c_string
 from .error import invoke
@@ -29,6 +29,17 @@ def register_library(library):
     library.serialboxArchiveGetArchiveFromExtension.argtypes = [c_char_p]
     library.serialboxArchiveGetArchiveFromExtension.restype = c_char_p
 
+    library.serialboxArchiveCompact.argtypes = [c_char_p, c_char_p, c_int]
+    library.serialboxArchiveCompact.restype = c_int
+
+    library.serialboxArchiveConvert.argtypes = [c_char_p, c_char_p, c_char_p, c_char_p, c_char_p,
+                                                c_char_p, c_int, POINTER(c_double)]
+    library.serialboxArchiveConvert.restype = c_int
+
+    library.serialboxArchiveMerge.argtypes = [c_char_p, c_char_p, c_int, POINTER(c_char_p),
+                                              POINTER(c_char_p), c_int]
+    library.serialboxArchiveMerge.restype = c_int
+
 class Archive(object):
     """Provide information about the registered archives
     """
@@ -71,4 +82,96 @@ class Archive(object):
         filestr = to_c_string(filename)[0]
         return invoke(lib.serialboxArchiveGetArchiveFromExtension, filestr).decode()
 
+    @staticmethod
+    def compact(directory, prefix, num_threads=0):
+        """ Remove the records of a serializer using the Binary archive which are not referenced by
+        any savepoint and merge records of equal checksum.
+
+        The data files are rewritten and the FieldIDs of the savepoints are remapped. The serializer
+        must not be in use during the compaction.
+
+        :param directory: Directory of the serializer
+        :type directory: str
+        :param prefix: Prefix of the serializer
+        :type prefix: str
+        :param num_threads: Number of threads used to rewrite the data files (0 uses one per core)
+        :type num_threads: int
+        :return: Number of removed records
+        :rtype: int
+        :raises serialbox.SerialboxError: if the serializer cannot be opened or compacted
+        """
+        dirstr = to_c_string(directory)[0]
+        prefixstr = to_c_string(prefix)[0]
+        return invoke(lib.serialboxArchiveCompact, dirstr, prefixstr, num_threads)
+
+    @staticmethod
+    def convert(directory, prefix, archive, target_directory, target_prefix, target_archive,
+                num_threads=0):
+        """ Copy a serializer to a new serializer using a different archive (e.g Binary to NetCDF).
+
+        Each record is converted once, no matter how many savepoints refer to it. The meta-data of
+        the serializer is preserved. The target serializer is opened in `Write` mode.
+
+        :param directory: Directory of the source serializer
+        :type directory: str
+        :param prefix: Prefix of the source serializer
+        :type prefix: str
+        :param archive: Archive of the source serializer
+        :type archive: str
+        :param target_directory: Directory of the target serializer
+        :type target_directory: str
+        :param target_prefix: Prefix of the target serializer
+        :type target_prefix: str
+        :param target_archive: Archive of the target serializer
+        :type target_archive: str
+        :param num_threads: Number of threads used to read the records (0 uses one per core)
+        :type num_threads: int
+        :return: Number of converted records and the throughput in MB/s
+        :rtype: :class:`tuple` (:class:`int`, :class:`float`)
+        :raises serialbox.SerialboxError: if the serializers cannot be opened or converted
+        """
+        throughput = c_double(0.0)
+        num_records = invoke(lib.serialboxArchiveConvert, to_c_string(directory)[0],
+                             to_c_string(prefix)[0], to_c_string(archive)[0],
+                             to_c_string(target_directory)[0], to_c_string(target_prefix)[0],
+                             to_c_string(target_archive)[0], num_threads, byref(throughput))
+        return num_records, throughput.value
+
+    #: Raise an error if a savepoint is present in more than one segment
+    ConflictError = 0
+
+    #: Keep the savepoint of the first segment containing it
+    ConflictKeepFirst = 1
+
+    #: Keep the savepoint of the last segment containing it (e.g the restarted run)
+    ConflictKeepLast = 2
+
+    @staticmethod
+    def merge(directory, prefix, segments, conflict_policy=0):
+        """ Merge several serializers using the Binary archive (e.g the segments of a restarted run)
+        into a single serializer.
+
+        The savepoints are concatenated in the order of the segments. The data files are appended
+        at block-aligned offsets using `copy_file_range` where available. If the target is the first
+        segment, it is extended in place.
+
+        :param directory: Directory of the merged serializer
+        :type directory: str
+        :param prefix: Prefix of the merged serializer
+        :type prefix: str
+        :param segments: Directory and prefix of each segment
+        :type segments: :class:`list` [:class:`tuple` (:class:`str`, :class:`str`)]
+        :param conflict_policy: Handling of savepoints present in more than one segment (one of
+                                `Archive.ConflictError`, `Archive.ConflictKeepFirst` or
+                                `Archive.ConflictKeepLast`)
+        :type conflict_policy: int
+        :return: Number of savepoints of the merged serializer
+        :rtype: int
+        :raises serialbox.SerialboxError: if the segments cannot be opened or are inconsistent
+        """
+        directories = (c_char_p * len(segments))(*[to_c_string(d)[0] for d, _ in segments])
+        prefixes = (c_char_p * len(segments))(*[to_c_string(p)[0] for _, p in segments])
+        return invoke(lib.serialboxArchiveMerge, to_c_string(directory)[0], to_c_string(prefix)[0],
+                      len(segments), directories, prefixes, conflict_policy)
+
 register_library(lib)
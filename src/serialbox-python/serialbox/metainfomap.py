@@ -65,6 +65,22 @@ class ArrayOfStringImpl(Structure):
     _fields_ = [("data", POINTER(c_char_p)), ("len", c_int)]
 
 
+class StringTableImpl(Structure):
+    """ Mapping of serialboxStringTable_t """
+    _fields_ = [("data", POINTER(c_char_p)),
+                ("offsets", POINTER(c_int)),
+                ("table", c_void_p),
+                ("len", c_int)]
+
+
+def string_table_to_list(table):
+    """Convert the string table `table` to a list of str and deallocate the table
+    """
+    list_table = [table.contents.data[i].decode() for i in range(table.contents.len)]
+    invoke(lib.serialboxStringTableDestroy, table)
+    return list_table
+
+
 def register_library(library):
     #
     # Construction & Destruction
@@ -150,6 +166,9 @@ def register_library(library):
     library.serialboxArrayOfStringDestroy.argtypes = [POINTER(ArrayOfStringImpl)]
     library.serialboxArrayOfStringDestroy.restype = None
 
+    library.serialboxStringTableDestroy.argtypes = [POINTER(StringTableImpl)]
+    library.serialboxStringTableDestroy.restype = None
+
     #
     # Add meta-information
     #
@@ -234,6 +253,9 @@ def register_library(library):
     library.serialboxMetainfoGetArrayOfString.argtypes = [POINTER(MetainfoImpl), c_char_p]
     library.serialboxMetainfoGetArrayOfString.restype = POINTER(ArrayOfStringImpl)
 
+    library.serialboxMetainfoGetArrayOfStringTable.argtypes = [POINTER(MetainfoImpl), c_char_p]
+    library.serialboxMetainfoGetArrayOfStringTable.restype = POINTER(StringTableImpl)
+
 
 class MetainfoMapIterator(object):
     """Iterator of the MetainfoMap
@@ -623,12 +645,8 @@ class MetainfoMap(object):
             return list_array
 
         elif typeid is TypeID.ArrayOfString.value:
-            array = invoke(lib.serialboxMetainfoGetArrayOfString, self.__metainfomap, keystr)
-            list_array = []
-            for i in range(array.contents.len):
-                list_array += [array.contents.data[i].decode()]
-            invoke(lib.serialboxArrayOfStringDestroy, array)
-            return list_array
+            return string_table_to_list(
+                invoke(lib.serialboxMetainfoGetArrayOfStringTable, self.__metainfomap, keystr))
 
         else:
             raise SerialboxError('internal error: unreachable (typeid = %i)' % typeid)
@@ -21,7 +21,8 @@ from .archive import Archive
 from .common import get_library, to_c_string
 from .error import invoke, SerialboxError
 from .fieldmetainfo import FieldMetainfo, FieldMetainfoImpl
-from .metainfomap import MetainfoMap, MetainfoImpl, ArrayOfStringImpl
+from .metainfomap import (MetainfoMap, MetainfoImpl, ArrayOfStringImpl, StringTableImpl,
+                          string_table_to_list)
 from .savepoint import Savepoint, SavepointImpl, SavepointTopCollection, SavepointCollection
 from .type import *
 
@@ -33,6 +34,11 @@ class SerializerImpl(Structure):
     _fields_ = [("impl", c_void_p), ("ownsData", c_int)]
 
 
+class ArrayOfSavepointImpl(Structure):
+    """ Mapping of serialboxArrayOfSavepoint_t """
+    _fields_ = [("data", POINTER(SavepointImpl)), ("len", c_int)]
+
+
 def register_library(library):
     #
     # Construction & Destruction
@@ -101,6 +107,24 @@ def register_library(library):
                                                                     POINTER(SavepointImpl)]
     library.serialboxSerializerGetFieldnamesAtSavepoint.restype = POINTER(ArrayOfStringImpl)
 
+    library.serialboxSerializerGetFieldnamesAtSavepointTable.argtypes = [POINTER(SerializerImpl),
+                                                                         POINTER(SavepointImpl)]
+    library.serialboxSerializerGetFieldnamesAtSavepointTable.restype = POINTER(StringTableImpl)
+
+    library.serialboxSerializerGetSavepointArray.argtypes = [POINTER(SerializerImpl)]
+    library.serialboxSerializerGetSavepointArray.restype = POINTER(ArrayOfSavepointImpl)
+
+    library.serialboxSerializerDestroySavepointArray.argtypes = [POINTER(ArrayOfSavepointImpl)]
+    library.serialboxSerializerDestroySavepointArray.restype = None
+
+    library.serialboxSerializerFindFieldAtOrBefore.argtypes = [POINTER(SerializerImpl), c_char_p,
+                                                               POINTER(SavepointImpl)]
+    library.serialboxSerializerFindFieldAtOrBefore.restype = c_int
+
+    library.serialboxSerializerFindFieldAfter.argtypes = [POINTER(SerializerImpl), c_char_p,
+                                                          POINTER(SavepointImpl)]
+    library.serialboxSerializerFindFieldAfter.restype = c_int
+
     library.serialboxSavepointCreateFromSavepoint.argtypes = [POINTER(SavepointImpl)]
     library.serialboxSavepointCreateFromSavepoint.restype = POINTER(SavepointImpl)
 
@@ -120,6 +144,9 @@ def register_library(library):
     library.serialboxSerializerGetFieldnames.argtypes = [POINTER(SerializerImpl)]
     library.serialboxSerializerGetFieldnames.restype = POINTER(ArrayOfStringImpl)
 
+    library.serialboxSerializerGetFieldnamesTable.argtypes = [POINTER(SerializerImpl)]
+    library.serialboxSerializerGetFieldnamesTable.restype = POINTER(StringTableImpl)
+
     #
     # Writing & Reading
     #
@@ -439,13 +466,45 @@ class Serializer(object):
         :raises serialbox.SerialboxError: if `savepoint` does not exists
         """
         savepoint_ = self.__extract_savepoint(savepoint)
-        array = invoke(lib.serialboxSerializerGetFieldnamesAtSavepoint, self.__serializer,
-                       savepoint_.impl())
-        list_array = []
-        for i in range(array.contents.len):
-            list_array += [array.contents.data[i].decode()]
-        invoke(lib.serialboxArrayOfStringDestroy, array)
-        return list_array
+        return string_table_to_list(
+            invoke(lib.serialboxSerializerGetFieldnamesAtSavepointTable, self.__serializer,
+                   savepoint_.impl()))
+
+    def find_field_at_or_before(self, field, savepoint):
+        """Get the last Savepoint at or before `savepoint` at which `field` exists.
+
+        This is useful for fields which are only written at some savepoints (e.g at
+        initialization). The lookup is a binary search in the savepoints at which the field exists.
+
+            >>> ser.find_field_at_or_before("u", ser.savepoint["step"].t[10])
+            <Savepoint step {"t": 0}>
+
+        :param field: Name of the field
+        :type field: str
+        :param savepoint: Savepoint to start the search from
+        :type savepoint: Savepoint
+        :return: Savepoint or `None` if there is no such savepoint
+        :rtype: :class:`Savepoint <serialbox.Savepoint>`
+        """
+        savepoint_ = self.__extract_savepoint(savepoint)
+        idx = invoke(lib.serialboxSerializerFindFieldAtOrBefore, self.__serializer,
+                     to_c_string(field)[0], savepoint_.impl())
+        return None if idx == -1 else self.savepoint_list()[idx]
+
+    def find_field_after(self, field, savepoint):
+        """Get the first Savepoint after `savepoint` at which `field` exists.
+
+        :param field: Name of the field
+        :type field: str
+        :param savepoint: Savepoint to start the search from
+        :type savepoint: Savepoint
+        :return: Savepoint or `None` if there is no such savepoint
+        :rtype: :class:`Savepoint <serialbox.Savepoint>`
+        """
+        savepoint_ = self.__extract_savepoint(savepoint)
+        idx = invoke(lib.serialboxSerializerFindFieldAfter, self.__serializer,
+                     to_c_string(field)[0], savepoint_.impl())
+        return None if idx == -1 else self.savepoint_list()[idx]
 
     def savepoint_list(self):
         """Get a list of registered savepoints within the Serializer.
@@ -462,22 +521,21 @@ class Serializer(object):
             #
             # Query the savepoint vector
             #
-            vec_savepoint = lib.serialboxSerializerGetSavepointVector(self.__serializer)
-            num_savepoints = lib.serialboxSerializerGetNumSavepoints(self.__serializer)
+            array = invoke(lib.serialboxSerializerGetSavepointArray, self.__serializer)
 
             #
             # Copy the savepoint vector
             #
             list_of_savepoints = []
-            for i in range(num_savepoints):
+            for i in range(array.contents.len):
                 list_of_savepoints += [Savepoint('',
                                                  impl=invoke(
                                                      lib.serialboxSavepointCreateFromSavepoint,
-                                                     vec_savepoint[i].contents))]
+                                                     array.contents.data[i]))]
             #
             # Destroy the savepoint vector
             #
-            invoke(lib.serialboxSerializerDestroySavepointVector, vec_savepoint, num_savepoints)
+            invoke(lib.serialboxSerializerDestroySavepointArray, array)
 
             #
             # If we are in Read mode, we can safely cache the savepoint list
@@ -604,12 +662,8 @@ class Serializer(object):
         :return: list of fieldnames
         :rtype: :class:`list` [:class:`str`]
         """
-        array = invoke(lib.serialboxSerializerGetFieldnames, self.__serializer)
-        list_array = []
-        for i in range(array.contents.len):
-            list_array += [array.contents.data[i].decode()]
-        invoke(lib.serialboxArrayOfStringDestroy, array)
-        return list_array
+        return string_table_to_list(
+            invoke(lib.serialboxSerializerGetFieldnamesTable, self.__serializer))
 
     # ===----------------------------------------------------------------------------------------===
     #    Writing & Reading
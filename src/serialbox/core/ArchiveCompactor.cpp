@@ -0,0 +1,413 @@
+//===-- serialbox/core/ArchiveCompactor.cpp -----------------------------------------*- C++ -*-===//
+//
+//                                    S E R I A L B O X
+//
+// This file is distributed under terms of BSD license.
+// See LICENSE.txt for more information
+//
+//===------------------------------------------------------------------------------------------===//
+//
+/// \file
+/// This file implements the ArchiveCompactor which removes unreferenced and duplicate records from
+/// a binary archive.
+///
+//===------------------------------------------------------------------------------------------===//
+
+#include "serialbox/core/ArchiveCompactor.h"
+#include "serialbox/core/FileRangeCopier.h"
+#include "serialbox/core/Logging.h"
+#include "serialbox/core/STLExtras.h"
+#include "serialbox/core/archive/BinaryArchive.h"
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <fstream>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace serialbox {
+
+namespace {
+
+/// \brief Rewrite plan of the data file of a field
+struct FieldPlan {
+  std::string name;
+  filesystem::path file;
+  filesystem::path compactFile;
+  const BinaryArchive::FieldOffsetTable* offsetTable;
+
+  std::vector<int> newIds;        ///< New id of each old id (-1 if the record is dropped)
+  std::vector<unsigned int> kept; ///< Old ids of the records which are kept (in order)
+
+  std::size_t numElements; ///< Number of elements of a record (0 if unknown)
+  int bytesPerElement;
+
+  BinaryArchive::FieldOffsetTable newOffsetTable;
+  std::uintmax_t bytesBefore;
+  std::uintmax_t bytesAfter;
+};
+
+inline std::uint64_t byteSwap64(std::uint64_t v) noexcept {
+  v = ((v & 0x00000000FFFFFFFFull) << 32) | ((v & 0xFFFFFFFF00000000ull) >> 32);
+  v = ((v & 0x0000FFFF0000FFFFull) << 16) | ((v & 0xFFFF0000FFFF0000ull) >> 16);
+  return ((v & 0x00FF00FF00FF00FFull) << 8) | ((v & 0xFF00FF00FF00FF00ull) >> 8);
+}
+
+/// \brief Size of the record `id` on disk
+///
+/// The size is computed from the dimensions of the field (and the number of non-zeros of sparse
+/// records). If the dimensions are unknown, the record extends to the beginning of the next record
+/// or the end of the file (`extent`).
+std::uintmax_t recordSize(const FieldPlan& plan, unsigned int id, std::uintmax_t extent, bool swap,
+                          FileRangeCopier& copier) {
+  const auto& record = (*plan.offsetTable)[id];
+  if(plan.numElements == 0)
+    return extent;
+
+  std::uintmax_t size = std::uintmax_t(plan.numElements) * plan.bytesPerElement;
+
+  if(record.encoding == BinaryArchive::EncodingKind::Sparse) {
+    std::uint64_t numNonZeros = 0;
+    if(extent < sizeof(numNonZeros))
+      throw Exception("corrupted sparse record %i of field '%s'", id, plan.name);
+    copier.read(reinterpret_cast<char*>(&numNonZeros), sizeof(numNonZeros), record.offset);
+    if(swap)
+      numNonZeros = byteSwap64(numNonZeros);
+    if(numNonZeros > plan.numElements)
+      throw Exception("corrupted sparse record %i of field '%s'", id, plan.name);
+    size = sizeof(numNonZeros) + (plan.numElements + 7) / 8 + numNonZeros * plan.bytesPerElement;
+  }
+
+  if(size > extent)
+    throw Exception("record %i of field '%s' is truncated (%i of %i bytes)", id, plan.name, extent,
+                    size);
+  return size;
+}
+
+/// \brief Write the records which are kept to the compacted data file
+void rewriteField(FieldPlan& plan, bool swap) {
+  const auto& offsetTable = *plan.offsetTable;
+  plan.bytesBefore = filesystem::exists(plan.file) ? filesystem::file_size(plan.file) : 0;
+  plan.bytesAfter = 0;
+
+  if(plan.kept.empty())
+    return;
+
+  // A record extends at most to the beginning of the next record (or the end of the file)
+  std::vector<std::uintmax_t> offsets;
+  for(const auto& record : offsetTable)
+    offsets.push_back(record.offset);
+  std::sort(offsets.begin(), offsets.end());
+  offsets.erase(std::unique(offsets.begin(), offsets.end()), offsets.end());
+
+  auto extentOf = [&](std::uintmax_t offset) -> std::uintmax_t {
+    if(offset > plan.bytesBefore)
+      throw Exception("record at offset %i exceeds the data file of field '%s'", offset,
+                      plan.name);
+    auto next = std::upper_bound(offsets.begin(), offsets.end(), offset);
+    return (next == offsets.end() ? plan.bytesBefore : *next) - offset;
+  };
+
+  FileRangeCopier copier(plan.file, plan.compactFile, false);
+
+  for(unsigned int id : plan.kept) {
+    const auto& record = offsetTable[id];
+    std::uintmax_t size = recordSize(plan, id, extentOf(record.offset), swap, copier);
+    copier.copy(record.offset, size);
+
+    plan.newOffsetTable.push_back(
+        BinaryArchive::FileOffsetType{std::streamoff(plan.bytesAfter), record.checksum,
+                                      record.encoding});
+    plan.bytesAfter += size;
+  }
+}
+
+filesystem::path backupFile(const filesystem::path& file) { return file.string() + ".orig"; }
+
+/// \brief Back up `file` before it is replaced
+///
+/// Data files are replaced by a rename, hence a hard link preserves their content. The meta-data
+/// is rewritten in place and has to be copied.
+void backup(const filesystem::path& file, bool link) {
+  filesystem::path backup(backupFile(file));
+  if(filesystem::exists(backup))
+    filesystem::remove(backup);
+
+  if(link) {
+    try {
+      filesystem::create_hard_link(file, backup);
+      return;
+    } catch(filesystem::filesystem_error&) {
+      // Filesystem does not support hard links, fall back to copying
+    }
+  }
+
+  FileRangeCopier copier(file, backup, false);
+  copier.copy(0, copier.sourceSize());
+}
+
+/// \brief Restore the files listed in the journal of an interrupted compaction
+void rollback(const filesystem::path& journal) {
+  LOG(warning) << "ArchiveCompactor: rolling back interrupted compaction (" << journal << ")";
+
+  std::ifstream ifs(journal.string());
+  if(!ifs.is_open())
+    throw Exception("cannot open file: %s", journal.string());
+
+  std::string filename;
+  while(std::getline(ifs, filename)) {
+    if(filename.empty())
+      continue;
+    filesystem::path file(journal.parent_path() / filename);
+    if(filesystem::exists(backupFile(file)))
+      filesystem::rename(backupFile(file), file);
+    if(filesystem::exists(file.string() + ".compact"))
+      filesystem::remove(file.string() + ".compact");
+  }
+  ifs.close();
+  filesystem::remove(journal);
+}
+
+} // anonymous namespace
+
+filesystem::path ArchiveCompactor::journalFile(const std::string& directory,
+                                               const std::string& prefix) {
+  return filesystem::path(directory) / ("Compaction-" + prefix + ".journal");
+}
+
+ArchiveCompactor::ArchiveCompactor(const std::string& directory, const std::string& prefix)
+    : numThreads_(0) {
+  // Opening in `Append` mode would silently create an empty serializer
+  filesystem::path metaDataFile(filesystem::path(directory) / ("MetaData-" + prefix + ".json"));
+  if(!filesystem::exists(metaDataFile))
+    throw Exception("cannot compact serializer: meta-data file '%s' does not exist",
+                    metaDataFile.string());
+
+  // An interrupted compaction left the meta-data and data files in an unknown state
+  filesystem::path journal(journalFile(directory, prefix));
+  try {
+    if(filesystem::exists(journal))
+      rollback(journal);
+  } catch(filesystem::filesystem_error& e) {
+    throw Exception("cannot roll back interrupted compaction: %s", e.what());
+  }
+
+  serializer_ = std::make_unique<SerializerImpl>(OpenModeKind::Append, directory, prefix,
+                                                 BinaryArchive::Name);
+}
+
+std::size_t ArchiveCompactor::numRemovedRecords() const noexcept {
+  std::size_t numRemoved = 0;
+  for(const auto& stats : statistics_)
+    numRemoved += stats.second.numRecords - stats.second.numKeptRecords;
+  return numRemoved;
+}
+
+void ArchiveCompactor::compact() {
+  BinaryArchive& archive = static_cast<BinaryArchive&>(serializer_->archive());
+  SavepointVector& savepointVector = serializer_->savepointVector();
+  BinaryArchive::FieldTable& fieldTable = archive.fieldTable();
+  const bool swap = (archive.byteOrder() != BinaryArchive::nativeByteOrder());
+
+  LOG(info) << "Compacting archive of serializer \"" << serializer_->prefix() << "\" in "
+            << serializer_->directory();
+
+  //
+  // 1) Collect the records referenced by the savepoints
+  //
+  std::unordered_map<std::string, std::vector<bool>> isReferenced;
+  for(const auto& field : fieldTable)
+    isReferenced[field.first].resize(field.second.size(), false);
+
+  for(std::size_t i = 0; i < savepointVector.size(); ++i)
+    for(const auto& field : savepointVector.fieldsOf(i)) {
+      auto it = isReferenced.find(field.first);
+      if(it == isReferenced.end() || field.second >= it->second.size())
+        throw Exception("savepoint '%s' refers to non-existing record %i of field '%s'",
+                        savepointVector[i].toString(), field.second, field.first);
+      it->second[field.second] = true;
+    }
+
+  //
+  // 2) Plan the new layout: drop unreferenced records and merge records of equal checksum
+  //
+  std::vector<FieldPlan> plans;
+  for(const auto& field : fieldTable) {
+    FieldPlan plan;
+    plan.name = field.first;
+    plan.file = archive.directory();
+    plan.file /= serializer_->prefix() + "_" + field.first + ".dat";
+    plan.compactFile = plan.file.string() + ".compact";
+    plan.offsetTable = &field.second;
+    plan.newIds.assign(field.second.size(), -1);
+    plan.numElements = 0;
+    plan.bytesPerElement = 0;
+
+    std::unordered_map<std::string, int> idOfChecksum;
+    const auto& referenced = isReferenced[field.first];
+    for(unsigned int id = 0; id < field.second.size(); ++id) {
+      if(!referenced[id])
+        continue;
+      auto insertion = idOfChecksum.emplace(field.second[id].checksum, int(plan.kept.size()));
+      if(insertion.second)
+        plan.kept.push_back(id);
+      plan.newIds[id] = insertion.first->second;
+    }
+
+    if(serializer_->hasField(field.first)) {
+      const FieldMetainfoImpl& info = serializer_->getFieldMetainfoImplOf(field.first);
+      std::vector<int> dims(info.dims());
+
+      // Fields with stripped halos only store the compute domain
+      auto haloIt = serializer_->strippedHalos().find(field.first);
+      if(haloIt != serializer_->strippedHalos().end())
+        for(std::size_t i = 0; i < dims.size() && i < haloIt->second.size(); ++i)
+          dims[i] -= haloIt->second[i].first + haloIt->second[i].second;
+
+      plan.numElements = 1;
+      for(int dim : dims)
+        plan.numElements *= (dim == 0 ? 1 : std::max(dim, 0));
+      plan.bytesPerElement = TypeUtil::sizeOf(info.type());
+    }
+
+    plans.push_back(std::move(plan));
+  }
+
+  //
+  // 3) Write the compacted data files (in parallel)
+  //
+  int numThreads = numThreads_ > 0 ? numThreads_ : int(std::thread::hardware_concurrency());
+  numThreads = std::max(1, std::min(numThreads, int(plans.size())));
+
+  std::atomic<std::size_t> nextPlan(0);
+  std::vector<std::exception_ptr> errors(numThreads);
+
+  auto worker = [&](int threadIdx) {
+    try {
+      for(std::size_t i = nextPlan++; i < plans.size(); i = nextPlan++)
+        rewriteField(plans[i], swap);
+    } catch(...) {
+      errors[threadIdx] = std::current_exception();
+      nextPlan = plans.size();
+    }
+  };
+
+  std::vector<std::thread> threads;
+  for(int i = 1; i < numThreads; ++i)
+    threads.emplace_back(worker, i);
+  worker(0);
+  for(auto& thread : threads)
+    thread.join();
+
+  for(const auto& error : errors)
+    if(error) {
+      for(const auto& plan : plans)
+        filesystem::remove(plan.compactFile);
+      std::rethrow_exception(error);
+    }
+
+  //
+  // 4) Back up all files which are modified and record them in the journal. Until the journal is
+  //    removed, the compaction is rolled back if it is interrupted (see ArchiveCompactor()).
+  //
+  std::vector<std::pair<filesystem::path, bool>> modifiedFiles;
+  modifiedFiles.emplace_back(serializer_->metaDataFile(), false);
+  modifiedFiles.emplace_back(archive.metaDataFile(), false);
+  for(std::size_t shard = 0; filesystem::exists(serializer_->metaDataShardFile(shard)); ++shard)
+    modifiedFiles.emplace_back(serializer_->metaDataShardFile(shard), false);
+  for(const auto& plan : plans)
+    if(filesystem::exists(plan.file))
+      modifiedFiles.emplace_back(plan.file, true);
+
+  filesystem::path journal(journalFile(serializer_->directory().string(), serializer_->prefix()));
+  try {
+    filesystem::path tmpJournal(journal.string() + ".tmp");
+    std::ofstream ofs(tmpJournal.string(), std::ios::out | std::ios::trunc);
+    if(!ofs.is_open())
+      throw Exception("cannot open file: %s", tmpJournal.string());
+
+    for(const auto& file : modifiedFiles) {
+      if(filesystem::exists(file.first)) {
+        backup(file.first, file.second);
+        ofs << file.first.filename().string() << "\n";
+      }
+    }
+
+    ofs.close();
+    if(!ofs)
+      throw Exception("cannot write file: %s", tmpJournal.string());
+    filesystem::rename(tmpJournal, journal);
+  } catch(filesystem::filesystem_error& e) {
+    for(const auto& plan : plans)
+      filesystem::remove(plan.compactFile);
+    throw Exception("cannot back up the files of the serializer: %s", e.what());
+  }
+
+  //
+  // 5) Remap the FieldIDs of the savepoints and update the meta-data, then replace the data files
+  //
+  std::unordered_map<std::string, const std::vector<int>*> newIdsOfField;
+  std::vector<filesystem::path> removedFiles;
+  statistics_.clear();
+
+  for(auto& plan : plans) {
+    statistics_[plan.name] =
+        FieldStatistics{plan.offsetTable->size(), plan.kept.size(), plan.bytesBefore,
+                        plan.bytesAfter};
+    newIdsOfField[plan.name] = &plan.newIds;
+  }
+
+  for(std::size_t i = 0; i < savepointVector.size(); ++i) {
+    bool modified = false;
+    for(auto& field : savepointVector.fieldsOf(i)) {
+      unsigned int newId = (*newIdsOfField[field.first])[field.second];
+      modified |= (newId != field.second);
+      field.second = newId;
+    }
+    if(modified)
+      serializer_->markSavepointModified(i);
+  }
+
+  // The plans refer to the offset tables of the field table, they are replaced last
+  for(auto& plan : plans) {
+    if(plan.kept.empty()) {
+      removedFiles.push_back(plan.file);
+      fieldTable.erase(plan.name);
+    } else
+      fieldTable[plan.name].swap(plan.newOffsetTable);
+  }
+
+  try {
+    serializer_->updateMetaData();
+
+    for(const auto& plan : plans)
+      if(!plan.kept.empty())
+        filesystem::rename(plan.compactFile, plan.file);
+  } catch(std::exception& e) {
+    LOG(warning) << "ArchiveCompactor: failed to replace the files of the serializer: " << e.what();
+    try {
+      rollback(journal);
+    } catch(filesystem::filesystem_error& rollbackError) {
+      LOG(warning) << "ArchiveCompactor: failed to roll back: " << rollbackError.what();
+    }
+    throw Exception("cannot compact serializer: %s", e.what());
+  }
+
+  // Data files of fields without referenced records are removed after the meta-data is consistent
+  for(const auto& file : removedFiles)
+    if(filesystem::exists(file) && !filesystem::remove(file))
+      LOG(warning) << "ArchiveCompactor: cannot remove file " << file;
+
+  //
+  // 6) Commit the compaction by removing the journal and drop the backups
+  //
+  filesystem::remove(journal);
+  for(const auto& file : modifiedFiles)
+    if(filesystem::exists(backupFile(file.first)) && !filesystem::remove(backupFile(file.first)))
+      LOG(warning) << "ArchiveCompactor: cannot remove file " << backupFile(file.first);
+
+  LOG(info) << "Successfully compacted archive (removed " << numRemovedRecords() << " records)";
+}
+
+} // namespace serialbox
@@ -0,0 +1,107 @@
+//===-- serialbox/core/ArchiveCompactor.h -------------------------------------------*- C++ -*-===//
+//
+//                                    S E R I A L B O X
+//
+// This file is distributed under terms of BSD license.
+// See LICENSE.txt for more information
+//
+//===------------------------------------------------------------------------------------------===//
+//
+/// \file
+/// This file contains the ArchiveCompactor which removes unreferenced and duplicate records from
+/// a binary archive.
+///
+//===------------------------------------------------------------------------------------------===//
+
+#ifndef SERIALBOX_CORE_ARCHIVECOMPACTOR_H
+#define SERIALBOX_CORE_ARCHIVECOMPACTOR_H
+
+#include "serialbox/core/SerializerImpl.h"
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <string>
+
+namespace serialbox {
+
+/// \addtogroup core
+/// @{
+
+/// \brief Rewrite the data files of a serializer using the BinaryArchive keeping only the records
+/// which are referenced by a savepoint
+///
+/// Records which are not referenced by any savepoint (e.g left behind by field rewrites or aborted
+/// writes) are dropped and records with the same checksum (e.g written by different runs in
+/// `Append` mode) are merged. The FieldIDs of the savepoints are remapped accordingly, the records
+/// of each field keep their relative order.
+///
+/// The data files of the fields are rewritten in parallel. On Linux the records are copied within
+/// the kernel using `copy_file_range`. The compacted data files are only swapped in after the
+/// meta-data is updated. Before any file is modified, the meta-data and data files are backed up
+/// and listed in a journal (see ArchiveCompactor::journalFile). A compaction which is interrupted
+/// before the journal is removed is rolled back when the serializer is opened for compaction again.
+/// The serializer must not be in use during the compaction.
+class ArchiveCompactor {
+public:
+  /// \brief Statistics of a field
+  struct FieldStatistics {
+    std::size_t numRecords;     ///< Number of records before the compaction
+    std::size_t numKeptRecords; ///< Number of records after the compaction
+    std::uintmax_t bytesBefore; ///< Size of the data file before the compaction
+    std::uintmax_t bytesAfter;  ///< Size of the data file after the compaction
+  };
+
+  /// \brief Open the serializer in `Append` mode
+  ///
+  /// An interrupted compaction of the serializer is rolled back first.
+  ///
+  /// \param directory    Directory of the serializer
+  /// \param prefix       Prefix of the serializer
+  ///
+  /// \throw Exception  Serializer cannot be opened or does not use the BinaryArchive
+  ArchiveCompactor(const std::string& directory, const std::string& prefix);
+
+  /// \brief Get the journal of a compaction of the serializer `prefix` in `directory`
+  ///
+  /// The journal lists the files of the serializer which have been backed up (with the suffix
+  /// `.orig`) and exists only while the files are replaced.
+  static filesystem::path journalFile(const std::string& directory, const std::string& prefix);
+
+  /// \brief Copy constructor [deleted]
+  ArchiveCompactor(const ArchiveCompactor&) = delete;
+
+  /// \brief Copy assignment [deleted]
+  ArchiveCompactor& operator=(const ArchiveCompactor&) = delete;
+
+  /// \brief Set the number of threads used to rewrite the data files (0 uses one thread per core)
+  void setNumThreads(int numThreads) noexcept { numThreads_ = numThreads; }
+
+  /// \brief Rewrite the data files and update the meta-data
+  ///
+  /// If the files cannot be replaced, they are restored and the compactor must not be used anymore.
+  ///
+  /// \throw Exception  Data files cannot be read or written
+  void compact();
+
+  /// \brief Get the statistics of all fields (available after the compaction)
+  const std::map<std::string, FieldStatistics>& statistics() const noexcept {
+    return statistics_;
+  }
+
+  /// \brief Number of records which have been removed
+  std::size_t numRemovedRecords() const noexcept;
+
+  /// \brief Get the serializer
+  const SerializerImpl& serializer() const noexcept { return *serializer_; }
+
+private:
+  std::unique_ptr<SerializerImpl> serializer_;
+  int numThreads_;
+  std::map<std::string, FieldStatistics> statistics_;
+};
+
+/// @}
+
+} // namespace serialbox
+
+#endif
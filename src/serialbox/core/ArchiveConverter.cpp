@@ -0,0 +1,228 @@
+//===-- serialbox/core/ArchiveConverter.cpp -----------------------------------------*- C++ -*-===//
+//
+//                                    S E R I A L B O X
+//
+// This file is distributed under terms of BSD license.
+// See LICENSE.txt for more information
+//
+//===------------------------------------------------------------------------------------------===//
+//
+/// \file
+/// This file implements the ArchiveConverter which copies a serializer to a different archive.
+///
+//===------------------------------------------------------------------------------------------===//
+
+#include "serialbox/core/ArchiveConverter.h"
+#include "serialbox/core/Logging.h"
+#include "serialbox/core/STLExtras.h"
+#include "serialbox/core/Timer.h"
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace serialbox {
+
+namespace {
+
+/// \brief Maximum number of records in flight per reading thread
+const std::size_t RecordsInFlightPerThread = 4;
+
+/// \brief Record of the source archive
+struct Record {
+  FieldID fieldID;             ///< FieldID in the source archive
+  std::vector<int> dims;       ///< Dimensions of the stored record
+  std::vector<int> savepoints; ///< Savepoints referring to the record
+  std::vector<Byte> data;      ///< Contiguous (col-major) copy of the record
+  bool isRead = false;
+};
+
+/// \brief Size of a contiguous record of dimensions `dims`
+std::size_t sizeInBytes(const std::vector<int>& dims, TypeID type) {
+  std::size_t size = TypeUtil::sizeOf(type);
+  for(int dim : dims)
+    size *= std::max(dim, 1);
+  return size;
+}
+
+/// \brief Create a col-major StorageView of the `data` of `record`
+StorageView storageViewOf(Record& record, TypeID type) {
+  std::vector<int> strides(record.dims.size());
+  int stride = 1;
+  for(std::size_t i = 0; i < record.dims.size(); ++i) {
+    strides[i] = stride;
+    stride *= std::max(record.dims[i], 1);
+  }
+  return StorageView(record.data.data(), type, record.dims, strides);
+}
+
+} // anonymous namespace
+
+ArchiveConverter::ArchiveConverter(const std::string& directory, const std::string& prefix,
+                                   const std::string& archive, const std::string& targetDirectory,
+                                   const std::string& targetPrefix,
+                                   const std::string& targetArchive)
+    : numThreads_(0), statistics_{0, 0, 0, 0.0} {
+  // Opening the target in `Write` mode would erase the source
+  if(prefix == targetPrefix && filesystem::exists(targetDirectory) &&
+     filesystem::equivalent(directory, targetDirectory))
+    throw Exception("cannot convert serializer '%s' in '%s' onto itself", prefix, directory);
+
+  source_ = std::make_unique<SerializerImpl>(OpenModeKind::Read, directory, prefix, archive);
+  target_ = std::make_unique<SerializerImpl>(OpenModeKind::Write, targetDirectory, targetPrefix,
+                                             targetArchive);
+}
+
+void ArchiveConverter::convert() {
+  Timer timer;
+  const SavepointVector& savepointVector = source_->savepointVector();
+
+  LOG(info) << "Converting serializer \"" << source_->prefix() << "\" (" << source_->archiveName()
+            << ") to \"" << target_->prefix() << "\" (" << target_->archiveName() << ")";
+
+  //
+  // 1) Copy the meta-data
+  //
+  target_->fieldMap().fromJSON(source_->fieldMap().toJSON());
+  target_->globalMetainfo() = source_->globalMetainfo();
+  target_->strippedHalos() = source_->strippedHalos();
+  if(source_->isMetaDataShardingEnabled())
+    target_->enableMetaDataSharding(source_->metaDataShardSize());
+
+  for(std::size_t i = 0; i < savepointVector.size(); ++i)
+    target_->savepointVector().insert(savepointVector[i]);
+
+  //
+  // 2) Collect the unique records (ordered by field and id to read the files sequentially)
+  //
+  std::map<std::pair<std::string, unsigned int>, std::vector<int>> savepointsOfRecord;
+  statistics_ = Statistics{0, 0, 0, 0.0};
+
+  for(std::size_t i = 0; i < savepointVector.size(); ++i)
+    for(const auto& field : savepointVector.fieldsOf(i)) {
+      savepointsOfRecord[field].push_back(int(i));
+      statistics_.numFields++;
+    }
+
+  std::vector<Record> records;
+  records.reserve(savepointsOfRecord.size());
+  for(auto& recordSavepoints : savepointsOfRecord) {
+    const std::string& name = recordSavepoints.first.first;
+    if(!source_->hasField(name))
+      throw Exception("field '%s' is referenced by a savepoint but not registered", name);
+
+    Record record;
+    record.fieldID = FieldID{name, recordSavepoints.first.second};
+    record.dims = source_->getFieldMetainfoImplOf(name).dims();
+    record.savepoints = std::move(recordSavepoints.second);
+
+    // Fields with stripped halos only store the compute domain
+    auto haloIt = source_->strippedHalos().find(name);
+    if(haloIt != source_->strippedHalos().end())
+      for(std::size_t i = 0; i < record.dims.size() && i < haloIt->second.size(); ++i)
+        record.dims[i] -= haloIt->second[i].first + haloIt->second[i].second;
+
+    records.push_back(std::move(record));
+  }
+
+  //
+  // 3) Read the records in parallel and write them in order
+  //
+  int numThreads = numThreads_ > 0 ? numThreads_ : int(std::thread::hardware_concurrency());
+  if(!source_->archive().isReadingThreadSafe())
+    numThreads = 1;
+  numThreads = std::max(1, std::min(numThreads, int(records.size())));
+  const std::size_t maxRecordsInFlight = RecordsInFlightPerThread * numThreads;
+
+  std::mutex mutex;
+  std::condition_variable cv;
+  std::atomic<std::size_t> nextRecord(0);
+  std::size_t numWritten = 0;
+  bool aborted = false;
+  std::exception_ptr error;
+
+  auto reader = [&]() {
+    try {
+      for(std::size_t i = nextRecord++; i < records.size(); i = nextRecord++) {
+        {
+          std::unique_lock<std::mutex> lock(mutex);
+          cv.wait(lock, [&]() { return aborted || i < numWritten + maxRecordsInFlight; });
+          if(aborted)
+            return;
+        }
+
+        Record& record = records[i];
+        const auto& info = source_->fieldMap().getFieldMetainfoImplPtrOf(record.fieldID.name);
+        record.data.resize(sizeInBytes(record.dims, info->type()));
+        StorageView storageView = storageViewOf(record, info->type());
+        source_->archive().read(storageView, record.fieldID, info);
+
+        std::lock_guard<std::mutex> lock(mutex);
+        record.isRead = true;
+        cv.notify_all();
+      }
+    } catch(...) {
+      std::lock_guard<std::mutex> lock(mutex);
+      if(!error)
+        error = std::current_exception();
+      aborted = true;
+      cv.notify_all();
+    }
+  };
+
+  std::vector<std::thread> threads;
+  for(int i = 0; i < numThreads && !records.empty(); ++i)
+    threads.emplace_back(reader);
+
+  try {
+    for(std::size_t i = 0; i < records.size(); ++i) {
+      Record& record = records[i];
+      {
+        std::unique_lock<std::mutex> lock(mutex);
+        cv.wait(lock, [&]() { return aborted || record.isRead; });
+        if(aborted)
+          break;
+      }
+
+      const std::string& name = record.fieldID.name;
+      const auto& info = target_->fieldMap().getFieldMetainfoImplPtrOf(name);
+      StorageView storageView = storageViewOf(record, info->type());
+      FieldID fieldID = target_->archive().write(storageView, name, info);
+
+      for(int savepointIdx : record.savepoints)
+        target_->savepointVector().addField(savepointIdx, fieldID);
+
+      statistics_.numRecords++;
+      statistics_.numBytes += record.data.size();
+      std::vector<Byte>().swap(record.data);
+
+      std::lock_guard<std::mutex> lock(mutex);
+      ++numWritten;
+      cv.notify_all();
+    }
+  } catch(...) {
+    std::lock_guard<std::mutex> lock(mutex);
+    if(!error)
+      error = std::current_exception();
+    aborted = true;
+    cv.notify_all();
+  }
+
+  for(auto& thread : threads)
+    thread.join();
+
+  if(error)
+    std::rethrow_exception(error);
+
+  target_->updateMetaData();
+  statistics_.seconds = timer.stop() / 1000.0;
+
+  LOG(info) << "Successfully converted " << statistics_.numRecords << " records ("
+            << statistics_.throughput() << " MB/s)";
+}
+
+} // namespace serialbox
@@ -0,0 +1,100 @@
+//===-- serialbox/core/ArchiveConverter.h -------------------------------------------*- C++ -*-===//
+//
+//                                    S E R I A L B O X
+//
+// This file is distributed under terms of BSD license.
+// See LICENSE.txt for more information
+//
+//===------------------------------------------------------------------------------------------===//
+//
+/// \file
+/// This file contains the ArchiveConverter which copies a serializer to a different archive.
+///
+//===------------------------------------------------------------------------------------------===//
+
+#ifndef SERIALBOX_CORE_ARCHIVECONVERTER_H
+#define SERIALBOX_CORE_ARCHIVECONVERTER_H
+
+#include "serialbox/core/SerializerImpl.h"
+#include <cstdint>
+#include <memory>
+#include <string>
+
+namespace serialbox {
+
+/// \addtogroup core
+/// @{
+
+/// \brief Copy a serializer to a new serializer using a different archive (e.g Binary to NetCDF)
+///
+/// The records are copied directly from archive to archive: each record is read and written
+/// exactly once, no matter how many savepoints refer to it. The field map, the global
+/// meta-information, the savepoints (including their order), the stripped halos and the sharding
+/// of the meta-data are preserved.
+///
+/// The records are read in parallel (if the source archive supports concurrent reads) while they
+/// are written in order by the calling thread. The number of records in flight is bounded.
+class ArchiveConverter {
+public:
+  /// \brief Statistics of the conversion
+  struct Statistics {
+    std::size_t numRecords;  ///< Number of converted records
+    std::size_t numFields;   ///< Number of fields at savepoints referring to the records
+    std::uintmax_t numBytes; ///< Number of bytes of the converted records (in memory)
+    double seconds;          ///< Wall time of the conversion
+
+    /// \brief Throughput in MB/s
+    double throughput() const noexcept {
+      return seconds > 0 ? (numBytes / (1024.0 * 1024.0)) / seconds : 0.0;
+    }
+  };
+
+  /// \brief Open the source serializer in `Read` and the target serializer in `Write` mode
+  ///
+  /// \param directory        Directory of the source serializer
+  /// \param prefix           Prefix of the source serializer
+  /// \param archive          Archive of the source serializer
+  /// \param targetDirectory  Directory of the target serializer
+  /// \param targetPrefix     Prefix of the target serializer
+  /// \param targetArchive    Archive of the target serializer
+  ///
+  /// \throw Exception  Serializers cannot be opened or source and target are the same
+  ArchiveConverter(const std::string& directory, const std::string& prefix,
+                   const std::string& archive, const std::string& targetDirectory,
+                   const std::string& targetPrefix, const std::string& targetArchive);
+
+  /// \brief Copy constructor [deleted]
+  ArchiveConverter(const ArchiveConverter&) = delete;
+
+  /// \brief Copy assignment [deleted]
+  ArchiveConverter& operator=(const ArchiveConverter&) = delete;
+
+  /// \brief Set the number of threads used to read the records (0 uses one thread per core)
+  void setNumThreads(int numThreads) noexcept { numThreads_ = numThreads; }
+
+  /// \brief Copy the records and the meta-data to the target serializer
+  ///
+  /// \throw Exception  Records cannot be read or written
+  void convert();
+
+  /// \brief Get the statistics (available after the conversion)
+  const Statistics& statistics() const noexcept { return statistics_; }
+
+  /// \brief Get the source serializer
+  const SerializerImpl& source() const noexcept { return *source_; }
+
+  /// \brief Get the target serializer
+  const SerializerImpl& target() const noexcept { return *target_; }
+
+private:
+  std::unique_ptr<SerializerImpl> source_;
+  std::unique_ptr<SerializerImpl> target_;
+  int numThreads_;
+  Statistics statistics_;
+};
+
+/// @}
+
+} // namespace serialbox
+
+#endif
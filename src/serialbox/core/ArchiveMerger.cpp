@@ -0,0 +1,254 @@
+//===-- serialbox/core/ArchiveMerger.cpp --------------------------------------------*- C++ -*-===//
+//
+//                                    S E R I A L B O X
+//
+// This file is distributed under terms of BSD license.
+// See LICENSE.txt for more information
+//
+//===------------------------------------------------------------------------------------------===//
+//
+/// \file
+/// This file implements the ArchiveMerger which combines several serializers into one.
+///
+//===------------------------------------------------------------------------------------------===//
+
+#include "serialbox/core/ArchiveMerger.h"
+#include "serialbox/core/FileRangeCopier.h"
+#include "serialbox/core/Logging.h"
+#include "serialbox/core/STLExtras.h"
+#include "serialbox/core/archive/BinaryArchive.h"
+#include "serialbox/core/hash/HashFactory.h"
+#include <map>
+#include <memory>
+#include <set>
+#include <unordered_map>
+
+namespace serialbox {
+
+const std::size_t ArchiveMerger::Alignment = 4096;
+
+namespace {
+
+/// \brief Check if the serializers `prefix1` in `directory1` and `prefix2` in `directory2` are the
+/// same
+bool isSameSerializer(const std::string& directory1, const std::string& prefix1,
+                      const std::string& directory2, const std::string& prefix2) {
+  return prefix1 == prefix2 && filesystem::exists(directory1) && filesystem::exists(directory2) &&
+         filesystem::equivalent(directory1, directory2);
+}
+
+/// \brief Check if opening the serializer `prefix1` in `directory1` in Write mode removes the data
+/// files of the serializer `prefix2` in `directory2` (i.e `prefix2` starts with `prefix1_`)
+bool isClearedBy(const std::string& directory1, const std::string& prefix1,
+                 const std::string& directory2, const std::string& prefix2) {
+  const std::string filePrefix = prefix1 + "_";
+  return prefix2.compare(0, filePrefix.size(), filePrefix) == 0 && filesystem::exists(directory1) &&
+         filesystem::exists(directory2) && filesystem::equivalent(directory1, directory2);
+}
+
+} // anonymous namespace
+
+ArchiveMerger::ArchiveMerger(const std::string& directory, const std::string& prefix)
+    : directory_(directory), prefix_(prefix), policy_(ConflictPolicyKind::Error),
+      numConflicts_(0) {}
+
+void ArchiveMerger::addSegment(const std::string& directory, const std::string& prefix) {
+  segments_.emplace_back(directory, prefix);
+}
+
+std::size_t ArchiveMerger::merge() {
+  if(segments_.empty())
+    throw Exception("no segments to merge");
+
+  numConflicts_ = 0;
+
+  //
+  // 1) Open the segments and the target (the first segment is extended in place if it is the
+  //    target)
+  //
+  const bool inPlace =
+      isSameSerializer(directory_, prefix_, segments_[0].first, segments_[0].second);
+
+  for(std::size_t s = 1; s < segments_.size(); ++s)
+    if(isSameSerializer(directory_, prefix_, segments_[s].first, segments_[s].second))
+      throw Exception("the target of the merge can only be the first segment (segment %i is '%s' "
+                      "in '%s')",
+                      s, prefix_, directory_);
+
+  // A new target is opened in Write mode which removes all files starting with `prefix_`
+  if(!inPlace)
+    for(std::size_t s = 0; s < segments_.size(); ++s)
+      if(isClearedBy(directory_, prefix_, segments_[s].first, segments_[s].second))
+        throw Exception("cannot merge into '%s' in '%s': creating it would remove the data of "
+                        "segment %i ('%s')",
+                        prefix_, directory_, s, segments_[s].second);
+
+  std::vector<std::unique_ptr<SerializerImpl>> sources(segments_.size());
+  for(std::size_t s = (inPlace ? 1 : 0); s < segments_.size(); ++s)
+    sources[s] = std::make_unique<SerializerImpl>(OpenModeKind::Read, segments_[s].first,
+                                                  segments_[s].second, BinaryArchive::Name);
+
+  if(inPlace &&
+     !filesystem::exists(filesystem::path(directory_) / ("MetaData-" + prefix_ + ".json")))
+    throw Exception("cannot merge: serializer '%s' in '%s' does not exist", prefix_, directory_);
+
+  SerializerImpl target(inPlace ? OpenModeKind::Append : OpenModeKind::Write, directory_, prefix_,
+                        BinaryArchive::Name);
+  BinaryArchive& targetArchive = static_cast<BinaryArchive&>(target.archive());
+
+  auto segment = [&](std::size_t s) -> SerializerImpl& {
+    return sources[s] ? *sources[s] : target;
+  };
+  auto archiveOf = [&](std::size_t s) -> BinaryArchive& {
+    return static_cast<BinaryArchive&>(segment(s).archive());
+  };
+
+  if(!inPlace) {
+    targetArchive.setHash(HashFactory::create(archiveOf(0).hash()->name()));
+    if(segment(0).isMetaDataShardingEnabled())
+      target.enableMetaDataSharding(segment(0).metaDataShardSize());
+  }
+
+  //
+  // 2) Check the consistency of the segments and combine the field maps, the global
+  //    meta-information and the stripped halos
+  //
+  std::map<std::string, std::pair<std::size_t, const SerializerImpl::HaloWidths*>> halosOfField;
+
+  for(std::size_t s = 0; s < segments_.size(); ++s) {
+    SerializerImpl& serializer = segment(s);
+    BinaryArchive& archive = archiveOf(s);
+
+    if(archive.byteOrder() != targetArchive.byteOrder())
+      throw Exception("byte order of segment %i (%s) differs from the target (%s)", s,
+                      BinaryArchive::byteOrderToString(archive.byteOrder()),
+                      BinaryArchive::byteOrderToString(targetArchive.byteOrder()));
+
+    if(std::string(archive.hash()->name()) != targetArchive.hash()->name())
+      throw Exception("hash algorithm of segment %i (%s) differs from the target (%s)", s,
+                      archive.hash()->name(), targetArchive.hash()->name());
+
+    for(const auto& field : serializer.fieldMap()) {
+      const FieldMetainfoImpl& info = *field.second;
+      auto it = target.fieldMap().findField(field.first);
+      if(it == target.fieldMap().end())
+        target.fieldMap().insert(field.first, info);
+      else if(it->second->type() != info.type() || it->second->dims() != info.dims())
+        throw Exception("field '%s' of segment %i is inconsistent with the previous segments",
+                        field.first, s);
+    }
+
+    for(const auto& metainfo : serializer.globalMetainfo())
+      target.globalMetainfo().insert(metainfo.first, metainfo.second);
+
+    // Fields need to be stored with the same halos in all segments containing records
+    for(const auto& field : archive.fieldTable()) {
+      if(field.second.empty())
+        continue;
+      auto haloIt = serializer.strippedHalos().find(field.first);
+      const SerializerImpl::HaloWidths* halos =
+          (haloIt == serializer.strippedHalos().end() ? nullptr : &haloIt->second);
+
+      auto it = halosOfField.find(field.first);
+      if(it == halosOfField.end())
+        halosOfField.emplace(field.first, std::make_pair(s, halos));
+      else if((it->second.second == nullptr) != (halos == nullptr) ||
+              (halos && *halos != *it->second.second))
+        throw Exception("field '%s' is stored with different halos in segment %i and %i",
+                        field.first, it->second.first, s);
+    }
+  }
+
+  for(const auto& fieldHalos : halosOfField)
+    if(fieldHalos.second.second)
+      target.strippedHalos()[fieldHalos.first] = *fieldHalos.second.second;
+
+  //
+  // 3) Select the savepoints, a savepoint keeps the position of its first occurrence
+  //
+  std::vector<std::pair<std::size_t, int>> selected; // (segment, savepoint index)
+  SavepointVector savepointIndex;
+
+  for(std::size_t s = 0; s < segments_.size(); ++s) {
+    const SavepointVector& savepointVector = segment(s).savepointVector();
+    for(std::size_t i = 0; i < savepointVector.size(); ++i) {
+      int idx = savepointIndex.find(savepointVector[i]);
+      if(idx == -1) {
+        savepointIndex.insert(savepointVector[i]);
+        selected.emplace_back(s, int(i));
+        continue;
+      }
+
+      if(policy_ == ConflictPolicyKind::Error)
+        throw Exception("savepoint '%s' is present in segment %i and %i",
+                        savepointVector[i].toString(), selected[idx].first, s);
+
+      ++numConflicts_;
+      if(policy_ == ConflictPolicyKind::KeepLast)
+        selected[idx] = std::make_pair(s, int(i));
+    }
+  }
+
+  //
+  // 4) Append the data files of the segments which are referenced by the selected savepoints
+  //
+  std::set<std::pair<std::size_t, std::string>> isReferenced;
+  for(const auto& entry : selected)
+    for(const auto& field : segment(entry.first).savepointVector().fieldsOf(entry.second))
+      isReferenced.emplace(entry.first, field.first);
+
+  // Offset of the ids of each field of each segment
+  std::vector<std::unordered_map<std::string, unsigned int>> idOffsets(segments_.size());
+
+  for(std::size_t s = (inPlace ? 1 : 0); s < segments_.size(); ++s) {
+    for(const auto& field : archiveOf(s).fieldTable()) {
+      if(!isReferenced.count(std::make_pair(s, field.first)))
+        continue;
+
+      auto& targetTable = targetArchive.fieldTable()[field.first];
+      filesystem::path source(filesystem::path(segments_[s].first) /
+                              (segments_[s].second + "_" + field.first + ".dat"));
+      filesystem::path file(filesystem::path(directory_) / (prefix_ + "_" + field.first + ".dat"));
+
+      FileRangeCopier copier(source, file, !targetTable.empty());
+      copier.align(Alignment);
+      const std::uintmax_t base = copier.targetSize();
+      copier.copy(0, copier.sourceSize());
+
+      LOG(info) << "Appended " << source << " to " << file << " at offset " << base;
+
+      idOffsets[s][field.first] = targetTable.size();
+      for(const auto& record : field.second)
+        targetTable.push_back(BinaryArchive::FileOffsetType{
+            std::streamoff(base + record.offset), record.checksum, record.encoding});
+    }
+  }
+
+  //
+  // 5) Build the merged savepoint vector and write the meta-data
+  //
+  SavepointVector merged;
+  for(const auto& entry : selected) {
+    const SavepointVector& savepointVector = segment(entry.first).savepointVector();
+    int idx = merged.insert(savepointVector[entry.second]);
+    for(const auto& field : savepointVector.fieldsOf(entry.second)) {
+      auto offsetIt = idOffsets[entry.first].find(field.first);
+      unsigned int offset = (offsetIt == idOffsets[entry.first].end() ? 0 : offsetIt->second);
+      merged.addField(idx, FieldID{field.first, field.second + offset});
+    }
+  }
+
+  target.savepointVector().swap(merged);
+  for(std::size_t i = 0; i < target.savepointVector().size(); ++i)
+    target.markSavepointModified(i);
+
+  target.updateMetaData();
+
+  LOG(info) << "Successfully merged " << segments_.size() << " segments into serializer \""
+            << prefix_ << "\" (" << target.savepointVector().size() << " savepoints, "
+            << numConflicts_ << " conflicts)";
+
+  return target.savepointVector().size();
+}
+
+} // namespace serialbox
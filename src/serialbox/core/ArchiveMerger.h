@@ -0,0 +1,102 @@
+//===-- serialbox/core/ArchiveMerger.h ----------------------------------------------*- C++ -*-===//
+//
+//                                    S E R I A L B O X
+//
+// This file is distributed under terms of BSD license.
+// See LICENSE.txt for more information
+//
+//===------------------------------------------------------------------------------------------===//
+//
+/// \file
+/// This file contains the ArchiveMerger which combines several serializers into one.
+///
+//===------------------------------------------------------------------------------------------===//
+
+#ifndef SERIALBOX_CORE_ARCHIVEMERGER_H
+#define SERIALBOX_CORE_ARCHIVEMERGER_H
+
+#include "serialbox/core/SerializerImpl.h"
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace serialbox {
+
+/// \addtogroup core
+/// @{
+
+/// \brief Combine several serializers using the BinaryArchive (e.g the segments of a restarted
+/// run) into a single serializer
+///
+/// The savepoints of the segments are concatenated in the order the segments are added and the
+/// field tables are combined. The data files of a segment are appended to the data files of the
+/// target as a whole, with block-aligned offsets, using `copy_file_range` where available. On
+/// filesystems with reflink support (e.g XFS or Btrfs) the blocks are shared instead of copied.
+///
+/// If the target is the first segment, the first segment is extended in place and its data is not
+/// touched at all.
+///
+/// Savepoints which are present in more than one segment are conflicts which are handled according
+/// to the ArchiveMerger::ConflictPolicyKind. Fields need to have the same type, dimensions and
+/// stripped halos in all segments and all segments need to share the byte order and the hash
+/// algorithm.
+class ArchiveMerger {
+public:
+  /// \brief Handling of savepoints which are present in more than one segment
+  enum class ConflictPolicyKind : int {
+    Error = 0, ///< Throw an Exception (default)
+    KeepFirst, ///< Keep the savepoint of the first segment containing it
+    KeepLast   ///< Keep the savepoint of the last segment containing it (e.g the restarted run)
+  };
+
+  /// \brief Set the target serializer
+  ///
+  /// \param directory  Directory of the merged serializer
+  /// \param prefix     Prefix of the merged serializer
+  ArchiveMerger(const std::string& directory, const std::string& prefix);
+
+  /// \brief Copy constructor [deleted]
+  ArchiveMerger(const ArchiveMerger&) = delete;
+
+  /// \brief Copy assignment [deleted]
+  ArchiveMerger& operator=(const ArchiveMerger&) = delete;
+
+  /// \brief Add the serializer `prefix` in `directory` as the next segment
+  void addSegment(const std::string& directory, const std::string& prefix);
+
+  /// \brief Set the handling of savepoints which are present in more than one segment
+  void setConflictPolicy(ConflictPolicyKind policy) noexcept { policy_ = policy; }
+
+  /// \brief Get the handling of savepoints which are present in more than one segment
+  ConflictPolicyKind conflictPolicy() const noexcept { return policy_; }
+
+  /// \brief Merge the segments
+  ///
+  /// The data files of the segments are appended before the meta-data of the target is written.
+  ///
+  /// \return Number of savepoints of the merged serializer
+  ///
+  /// \throw Exception  Segments cannot be opened or are inconsistent, conflicting savepoints with
+  ///                   ConflictPolicyKind::Error or creating the target would remove the data of a
+  ///                   segment (i.e a segment next to the target has the prefix `prefix_*`)
+  std::size_t merge();
+
+  /// \brief Get the number of savepoints which have been dropped due to conflicts
+  std::size_t numConflicts() const noexcept { return numConflicts_; }
+
+  /// \brief Alignment of the data appended to the data files of the target
+  static const std::size_t Alignment;
+
+private:
+  std::string directory_;
+  std::string prefix_;
+  std::vector<std::pair<std::string, std::string>> segments_;
+  ConflictPolicyKind policy_;
+  std::size_t numConflicts_;
+};
+
+/// @}
+
+} // namespace serialbox
+
+#endif
@@ -43,6 +43,9 @@
 /* Define if NetCDF is available */
 #cmakedefine SERIALBOX_HAS_NETCDF ${SERIALBOX_HAS_NETCDF}
 
+/* Define if copy_file_range is available */
+#cmakedefine SERIALBOX_HAS_COPY_FILE_RANGE ${SERIALBOX_HAS_COPY_FILE_RANGE}
+
 /* SERIALBOX was compiled with logging support */
 #cmakedefine SERIALBOX_HAS_LOGGING ${SERIALBOX_HAS_LOGGING}
 
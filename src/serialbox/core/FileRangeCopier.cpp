@@ -0,0 +1,183 @@
+//===-- serialbox/core/FileRangeCopier.cpp ------------------------------------------*- C++ -*-===//
+//
+//                                    S E R I A L B O X
+//
+// This file is distributed under terms of BSD license.
+// See LICENSE.txt for more information
+//
+//===------------------------------------------------------------------------------------------===//
+//
+/// \file
+/// This file implements the FileRangeCopier which appends byte ranges of a file to another file.
+///
+//===------------------------------------------------------------------------------------------===//
+
+#include "serialbox/core/FileRangeCopier.h"
+#include "serialbox/core/Exception.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <vector>
+
+#ifdef SERIALBOX_ON_UNIX
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#else
+#include <fstream>
+#endif
+
+namespace serialbox {
+
+namespace {
+
+/// \brief Size of the buffer used to copy through user space
+const std::size_t BufferSize = 1 << 20;
+
+} // anonymous namespace
+
+#ifdef SERIALBOX_ON_UNIX
+
+struct FileRangeCopier::Files {
+  int source = -1;
+  int target = -1;
+
+  ~Files() {
+    if(source >= 0)
+      ::close(source);
+    if(target >= 0)
+      ::close(target);
+  }
+};
+
+FileRangeCopier::FileRangeCopier(const filesystem::path& source, const filesystem::path& target,
+                                 bool append)
+    : files_(new Files), sourceSize_(0), targetSize_(0) {
+  files_->source = ::open(source.c_str(), O_RDONLY);
+  if(files_->source < 0)
+    throw Exception("cannot open file: '%s': %s", source.string(), std::strerror(errno));
+
+  // The target is not opened with O_APPEND which copy_file_range does not support
+  files_->target = ::open(target.c_str(), O_WRONLY | O_CREAT | (append ? 0 : O_TRUNC), 0644);
+  if(files_->target < 0)
+    throw Exception("cannot open file: '%s': %s", target.string(), std::strerror(errno));
+
+  struct stat st;
+  if(::fstat(files_->source, &st) == 0)
+    sourceSize_ = st.st_size;
+
+  off_t end = ::lseek(files_->target, 0, SEEK_END);
+  if(end < 0)
+    throw Exception("cannot seek in file: '%s': %s", target.string(), std::strerror(errno));
+  targetSize_ = end;
+}
+
+void FileRangeCopier::read(char* data, std::size_t size, std::uintmax_t offset) {
+  while(size > 0) {
+    ssize_t n = ::pread(files_->source, data, size, offset);
+    if(n <= 0)
+      throw Exception("cannot read file: %s",
+                      n == 0 ? "unexpected end of file" : std::strerror(errno));
+    data += n;
+    size -= n;
+    offset += n;
+  }
+}
+
+void FileRangeCopier::copy(std::uintmax_t offset, std::uintmax_t size) {
+#ifdef SERIALBOX_HAS_COPY_FILE_RANGE
+  loff_t sourceOffset = offset;
+  while(size > 0) {
+    ssize_t n = ::copy_file_range(files_->source, &sourceOffset, files_->target, nullptr, size, 0);
+    if(n < 0 && (errno == EXDEV || errno == ENOSYS || errno == EINVAL || errno == EOPNOTSUPP))
+      break; // Fall back to copying through user space
+    if(n <= 0)
+      throw Exception("cannot copy file: %s",
+                      n == 0 ? "unexpected end of file" : std::strerror(errno));
+    size -= n;
+    targetSize_ += n;
+  }
+  offset = sourceOffset;
+#endif
+
+  std::vector<char> buffer(std::min<std::uintmax_t>(size, BufferSize));
+  while(size > 0) {
+    std::size_t chunk = std::min<std::uintmax_t>(size, buffer.size());
+    read(buffer.data(), chunk, offset);
+    for(std::size_t written = 0; written < chunk;) {
+      ssize_t n = ::write(files_->target, buffer.data() + written, chunk - written);
+      if(n < 0)
+        throw Exception("cannot write file: %s", std::strerror(errno));
+      written += n;
+    }
+    offset += chunk;
+    size -= chunk;
+    targetSize_ += chunk;
+  }
+}
+
+void FileRangeCopier::align(std::uintmax_t alignment) {
+  std::uintmax_t aligned = (targetSize_ + alignment - 1) / alignment * alignment;
+  if(aligned == targetSize_)
+    return;
+  if(::ftruncate(files_->target, aligned) != 0 || ::lseek(files_->target, 0, SEEK_END) < 0)
+    throw Exception("cannot extend file: %s", std::strerror(errno));
+  targetSize_ = aligned;
+}
+
+#else
+
+struct FileRangeCopier::Files {
+  std::ifstream source;
+  std::ofstream target;
+};
+
+FileRangeCopier::FileRangeCopier(const filesystem::path& source, const filesystem::path& target,
+                                 bool append)
+    : files_(new Files), sourceSize_(0), targetSize_(0) {
+  files_->source.open(source.string(), std::ios::binary);
+  if(!files_->source.is_open())
+    throw Exception("cannot open file: '%s'", source.string());
+
+  files_->target.open(target.string(),
+                      std::ios::binary | (append ? std::ios::app : std::ios::trunc));
+  if(!files_->target.is_open())
+    throw Exception("cannot open file: '%s'", target.string());
+
+  sourceSize_ = filesystem::file_size(source);
+  targetSize_ = filesystem::file_size(target);
+}
+
+void FileRangeCopier::read(char* data, std::size_t size, std::uintmax_t offset) {
+  files_->source.seekg(offset);
+  files_->source.read(data, size);
+  if(!files_->source)
+    throw Exception("cannot read file: unexpected end of file");
+}
+
+void FileRangeCopier::copy(std::uintmax_t offset, std::uintmax_t size) {
+  std::vector<char> buffer(std::min<std::uintmax_t>(size, BufferSize));
+  while(size > 0) {
+    std::size_t chunk = std::min<std::uintmax_t>(size, buffer.size());
+    read(buffer.data(), chunk, offset);
+    files_->target.write(buffer.data(), chunk);
+    if(!files_->target)
+      throw Exception("cannot write file");
+    offset += chunk;
+    size -= chunk;
+    targetSize_ += chunk;
+  }
+}
+
+void FileRangeCopier::align(std::uintmax_t alignment) {
+  std::uintmax_t aligned = (targetSize_ + alignment - 1) / alignment * alignment;
+  std::vector<char> zeros(aligned - targetSize_, 0);
+  files_->target.write(zeros.data(), zeros.size());
+  targetSize_ = aligned;
+}
+
+#endif
+
+FileRangeCopier::~FileRangeCopier() {}
+
+} // namespace serialbox
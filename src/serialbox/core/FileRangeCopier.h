@@ -0,0 +1,84 @@
+//===-- serialbox/core/FileRangeCopier.h --------------------------------------------*- C++ -*-===//
+//
+//                                    S E R I A L B O X
+//
+// This file is distributed under terms of BSD license.
+// See LICENSE.txt for more information
+//
+//===------------------------------------------------------------------------------------------===//
+//
+/// \file
+/// This file contains the FileRangeCopier which appends byte ranges of a file to another file.
+///
+//===------------------------------------------------------------------------------------------===//
+
+#ifndef SERIALBOX_CORE_FILERANGECOPIER_H
+#define SERIALBOX_CORE_FILERANGECOPIER_H
+
+#include "serialbox/core/Filesystem.h"
+#include <cstdint>
+#include <memory>
+
+namespace serialbox {
+
+/// \addtogroup core
+/// @{
+
+/// \brief Append byte ranges of a source file to a target file
+///
+/// If `copy_file_range` is available, the data is copied within the kernel. Filesystems with
+/// reflink support (e.g XFS or Btrfs) share the blocks of block-aligned ranges instead of copying
+/// them, see FileRangeCopier::align.
+class FileRangeCopier {
+public:
+  /// \brief Open the files
+  ///
+  /// \param source  File to copy from
+  /// \param target  File to copy to
+  /// \param append  Append to `target` (otherwise `target` is truncated)
+  ///
+  /// \throw Exception  Files cannot be opened
+  FileRangeCopier(const filesystem::path& source, const filesystem::path& target, bool append);
+
+  /// \brief Copy constructor [deleted]
+  FileRangeCopier(const FileRangeCopier&) = delete;
+
+  /// \brief Copy assignment [deleted]
+  FileRangeCopier& operator=(const FileRangeCopier&) = delete;
+
+  /// \brief Close the files
+  ~FileRangeCopier();
+
+  /// \brief Read `size` bytes at `offset` of the source into `data`
+  ///
+  /// \throw Exception  Source is too short or cannot be read
+  void read(char* data, std::size_t size, std::uintmax_t offset);
+
+  /// \brief Append `size` bytes at `offset` of the source to the target
+  ///
+  /// \throw Exception  Source is too short or target cannot be written
+  void copy(std::uintmax_t offset, std::uintmax_t size);
+
+  /// \brief Pad the target with zeros up to the next multiple of `alignment` bytes
+  ///
+  /// The padding is a hole in the file on filesystems supporting sparse files.
+  void align(std::uintmax_t alignment);
+
+  /// \brief Get the size of the source
+  std::uintmax_t sourceSize() const noexcept { return sourceSize_; }
+
+  /// \brief Get the current size of the target
+  std::uintmax_t targetSize() const noexcept { return targetSize_; }
+
+private:
+  struct Files;
+  std::unique_ptr<Files> files_;
+  std::uintmax_t sourceSize_;
+  std::uintmax_t targetSize_;
+};
+
+/// @}
+
+} // namespace serialbox
+
+#endif
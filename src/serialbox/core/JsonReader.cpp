@@ -0,0 +1,356 @@
+//===-- serialbox/core/JsonReader.cpp -----------------------------------------------*- C++ -*-===//
+//
+//                                    S E R I A L B O X
+//
+// This file is distributed under terms of BSD license.
+// See LICENSE.txt for more information
+//
+//===------------------------------------------------------------------------------------------===//
+//
+/// \file
+/// This file implements the JsonReader, a streaming pull-parser for JSON documents.
+///
+//===------------------------------------------------------------------------------------------===//
+
+#include "serialbox/core/JsonReader.h"
+#include "serialbox/core/Exception.h"
+#include <cmath>
+#include <cstdlib>
+#include <istream>
+
+namespace serialbox {
+
+namespace {
+
+inline bool isWhitespace(int c) { return c == ' ' || c == '\n' || c == '\r' || c == '\t'; }
+
+inline bool isNumberCharacter(int c) {
+  return (c >= '0' && c <= '9') || c == '-' || c == '+' || c == '.' || c == 'e' || c == 'E';
+}
+
+inline std::string toPrintable(int c) {
+  return c == std::char_traits<char>::eof() ? std::string("end of file")
+                                            : std::string("'") + char(c) + "'";
+}
+
+void appendUTF8(std::string& str, unsigned long codepoint) {
+  if(codepoint < 0x80) {
+    str += char(codepoint);
+  } else if(codepoint < 0x800) {
+    str += char(0xC0 | (codepoint >> 6));
+    str += char(0x80 | (codepoint & 0x3F));
+  } else if(codepoint < 0x10000) {
+    str += char(0xE0 | (codepoint >> 12));
+    str += char(0x80 | ((codepoint >> 6) & 0x3F));
+    str += char(0x80 | (codepoint & 0x3F));
+  } else {
+    str += char(0xF0 | (codepoint >> 18));
+    str += char(0x80 | ((codepoint >> 12) & 0x3F));
+    str += char(0x80 | ((codepoint >> 6) & 0x3F));
+    str += char(0x80 | (codepoint & 0x3F));
+  }
+}
+
+} // anonymous namespace
+
+JsonReader::JsonReader(std::istream& stream) : buf_(stream.rdbuf()), offset_(0) {
+  if(!buf_)
+    throw Exception("JSON parser error: invalid stream");
+}
+
+int JsonReader::get() {
+  int c = buf_->sbumpc();
+  if(c != std::char_traits<char>::eof())
+    ++offset_;
+  return c;
+}
+
+int JsonReader::skipWhitespace() {
+  int c = buf_->sgetc();
+  while(isWhitespace(c)) {
+    get();
+    c = buf_->sgetc();
+  }
+  return c;
+}
+
+void JsonReader::expect(char expected) {
+  skipWhitespace();
+  int c = get();
+  if(c != expected)
+    error(std::string("expected '") + expected + "' but got " + toPrintable(c));
+}
+
+void JsonReader::expectLiteral(const char* literal) {
+  skipWhitespace();
+  for(const char* l = literal; *l != '\0'; ++l)
+    if(get() != *l)
+      error(std::string("invalid literal, expected '") + literal + "'");
+}
+
+void JsonReader::error(const std::string& msg) const {
+  throw Exception("JSON parser error at offset %i: %s", offset_, msg);
+}
+
+JsonReader::ValueKind JsonReader::peek() {
+  int c = skipWhitespace();
+  switch(c) {
+  case '{':
+    return ValueKind::Object;
+  case '[':
+    return ValueKind::Array;
+  case '"':
+    return ValueKind::String;
+  case 't':
+  case 'f':
+    return ValueKind::Boolean;
+  case 'n':
+    return ValueKind::Null;
+  default:
+    if(c == '-' || (c >= '0' && c <= '9'))
+      return ValueKind::Number;
+    error("unexpected " + toPrintable(c));
+  }
+}
+
+void JsonReader::beginObject() {
+  expect('{');
+  first_.push_back(true);
+}
+
+bool JsonReader::nextMember(std::string& key) {
+  if(skipWhitespace() == '}') {
+    get();
+    first_.pop_back();
+    return false;
+  }
+
+  if(!first_.back())
+    expect(',');
+  first_.back() = false;
+
+  readString(key);
+  expect(':');
+  return true;
+}
+
+void JsonReader::beginArray() {
+  expect('[');
+  first_.push_back(true);
+}
+
+bool JsonReader::nextElement() {
+  if(skipWhitespace() == ']') {
+    get();
+    first_.pop_back();
+    return false;
+  }
+
+  if(!first_.back())
+    expect(',');
+  first_.back() = false;
+  return true;
+}
+
+std::string JsonReader::readString() {
+  std::string str;
+  readString(str);
+  return str;
+}
+
+void JsonReader::readString(std::string& str) {
+  str.clear();
+  expect('"');
+
+  while(true) {
+    int c = get();
+    switch(c) {
+    case '"':
+      return;
+    case '\\': {
+      c = get();
+      switch(c) {
+      case '"':
+      case '\\':
+      case '/':
+        str += char(c);
+        break;
+      case 'b':
+        str += '\b';
+        break;
+      case 'f':
+        str += '\f';
+        break;
+      case 'n':
+        str += '\n';
+        break;
+      case 'r':
+        str += '\r';
+        break;
+      case 't':
+        str += '\t';
+        break;
+      case 'u': {
+        auto readHex = [this]() {
+          unsigned long value = 0;
+          for(int i = 0; i < 4; ++i) {
+            int h = get();
+            value <<= 4;
+            if(h >= '0' && h <= '9')
+              value |= (h - '0');
+            else if(h >= 'a' && h <= 'f')
+              value |= (h - 'a' + 10);
+            else if(h >= 'A' && h <= 'F')
+              value |= (h - 'A' + 10);
+            else
+              error("invalid unicode escape sequence");
+          }
+          return value;
+        };
+
+        unsigned long codepoint = readHex();
+
+        // Surrogate pair
+        if(codepoint >= 0xD800 && codepoint <= 0xDBFF) {
+          if(get() != '\\' || get() != 'u')
+            error("invalid unicode surrogate pair");
+          unsigned long low = readHex();
+          if(low < 0xDC00 || low > 0xDFFF)
+            error("invalid unicode surrogate pair");
+          codepoint = 0x10000 + ((codepoint - 0xD800) << 10) + (low - 0xDC00);
+        }
+        appendUTF8(str, codepoint);
+        break;
+      }
+      default:
+        error("invalid escape sequence");
+      }
+      break;
+    }
+    default:
+      if(c == std::char_traits<char>::eof())
+        error("unterminated string");
+      str += char(c);
+    }
+  }
+}
+
+std::string JsonReader::readNumberToken() {
+  skipWhitespace();
+  std::string token;
+  while(isNumberCharacter(buf_->sgetc()))
+    token += char(get());
+  if(token.empty())
+    error("expected a number but got " + toPrintable(buf_->sgetc()));
+  return token;
+}
+
+double JsonReader::readDouble() {
+  std::string token = readNumberToken();
+  char* end;
+  double value = std::strtod(token.c_str(), &end);
+  if(*end != '\0')
+    error("invalid number '" + token + "'");
+  return value;
+}
+
+std::int64_t JsonReader::readInteger() {
+  std::string token = readNumberToken();
+  char* end;
+  std::int64_t value = std::strtoll(token.c_str(), &end, 10);
+  if(*end == '\0')
+    return value;
+
+  // Integral numbers written in floating point notation (e.g 1.0 or 1e3)
+  double valueAsDouble = std::strtod(token.c_str(), &end);
+  if(*end != '\0' || std::trunc(valueAsDouble) != valueAsDouble)
+    error("expected an integer but got '" + token + "'");
+  return static_cast<std::int64_t>(valueAsDouble);
+}
+
+bool JsonReader::readBoolean() {
+  if(skipWhitespace() == 't') {
+    expectLiteral("true");
+    return true;
+  }
+  expectLiteral("false");
+  return false;
+}
+
+void JsonReader::readNull() { expectLiteral("null"); }
+
+void JsonReader::copyValue(std::string* raw) {
+  int c = skipWhitespace();
+
+  auto consume = [&]() {
+    int ch = get();
+    if(ch == std::char_traits<char>::eof())
+      error("unexpected end of file");
+    if(raw)
+      *raw += char(ch);
+    return ch;
+  };
+
+  auto copyString = [&]() {
+    consume(); // Opening quote
+    while(true) {
+      int ch = consume();
+      if(ch == '\\')
+        consume();
+      else if(ch == '"')
+        return;
+    }
+  };
+
+  // Scalar
+  if(c != '{' && c != '[') {
+    if(c == '"')
+      copyString();
+    else {
+      peek(); // Validate the beginning of the value
+      while(true) {
+        c = buf_->sgetc();
+        if(c == std::char_traits<char>::eof() || c == ',' || c == '}' || c == ']' ||
+           isWhitespace(c))
+          break;
+        consume();
+      }
+    }
+    return;
+  }
+
+  // Object or array
+  int depth = 0;
+  do {
+    c = buf_->sgetc();
+    if(c == '"') {
+      copyString();
+      continue;
+    }
+    c = consume();
+    if(c == '{' || c == '[')
+      ++depth;
+    else if(c == '}' || c == ']')
+      --depth;
+  } while(depth > 0);
+}
+
+json::json JsonReader::readValue() {
+  std::string raw;
+  copyValue(&raw);
+  try {
+    return json::json::parse(raw);
+  } catch(std::exception& e) {
+    error(e.what());
+  }
+}
+
+void JsonReader::skipValue() { copyValue(nullptr); }
+
+void JsonReader::end() {
+  int c = skipWhitespace();
+  if(c != std::char_traits<char>::eof())
+    error("unexpected " + toPrintable(c) + " after the end of the document");
+}
+
+} // namespace serialbox
@@ -0,0 +1,130 @@
+//===-- serialbox/core/JsonReader.h -------------------------------------------------*- C++ -*-===//
+//
+//                                    S E R I A L B O X
+//
+// This file is distributed under terms of BSD license.
+// See LICENSE.txt for more information
+//
+//===------------------------------------------------------------------------------------------===//
+//
+/// \file
+/// This file contains the JsonReader, a streaming pull-parser for JSON documents.
+///
+//===------------------------------------------------------------------------------------------===//
+
+#ifndef SERIALBOX_CORE_JSONREADER_H
+#define SERIALBOX_CORE_JSONREADER_H
+
+#include "serialbox/core/Compiler.h"
+#include "serialbox/core/Json.h"
+#include <cstdint>
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+namespace serialbox {
+
+/// \addtogroup core
+/// @{
+
+/// \brief Streaming pull-parser for JSON documents
+///
+/// The document is consumed token by token from the stream without building a DOM, allowing to
+/// construct the Serialbox data structures directly while parsing. Small sub-trees can still be
+/// extracted as a DOM via `readValue`.
+///
+/// \code
+///   JsonReader reader(stream);
+///   std::string key;
+///   reader.beginObject();
+///   while(reader.nextMember(key)) {
+///     if(key == "name")
+///       name = reader.readString();
+///     else
+///       reader.skipValue();
+///   }
+/// \endcode
+///
+/// All functions throw an Exception if the document does not match the expected structure.
+class JsonReader {
+public:
+  /// \brief Kind of the next value
+  enum class ValueKind { Object, Array, String, Number, Boolean, Null };
+
+  /// \brief Initialize the reader with the stream `stream`
+  explicit JsonReader(std::istream& stream);
+
+  /// \brief Copy constructor [deleted]
+  JsonReader(const JsonReader&) = delete;
+
+  /// \brief Copy assignment [deleted]
+  JsonReader& operator=(const JsonReader&) = delete;
+
+  /// \brief Kind of the next value
+  ValueKind peek();
+
+  /// \brief Check if the next value is `null`
+  bool isNull() { return peek() == ValueKind::Null; }
+
+  /// \brief Consume the beginning of an object
+  void beginObject();
+
+  /// \brief Advance to the next member of the current object and read its key
+  ///
+  /// \return False if the end of the object has been reached (the object is consumed)
+  bool nextMember(std::string& key);
+
+  /// \brief Consume the beginning of an array
+  void beginArray();
+
+  /// \brief Advance to the next element of the current array
+  ///
+  /// \return False if the end of the array has been reached (the array is consumed)
+  bool nextElement();
+
+  /// \brief Read a string
+  std::string readString();
+
+  /// \brief Read a number
+  double readDouble();
+
+  /// \brief Read an integral number
+  std::int64_t readInteger();
+
+  /// \brief Read a boolean
+  bool readBoolean();
+
+  /// \brief Read `null`
+  void readNull();
+
+  /// \brief Read the next value (including all sub-values) into a DOM
+  json::json readValue();
+
+  /// \brief Skip the next value (including all sub-values)
+  void skipValue();
+
+  /// \brief Check that the document has been fully consumed
+  void end();
+
+private:
+  int get();
+  int skipWhitespace();
+  void expect(char c);
+  void expectLiteral(const char* literal);
+  std::string readNumberToken();
+  void readString(std::string& str);
+  void copyValue(std::string* raw);
+
+  SERIALBOX_ATTRIBUTE_NORETURN void error(const std::string& msg) const;
+
+private:
+  std::streambuf* buf_;
+  std::size_t offset_;
+  std::vector<bool> first_; ///< Is the next member/element the first of the current scope
+};
+
+/// @}
+
+} // namespace serialbox
+
+#endif
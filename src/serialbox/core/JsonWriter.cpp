@@ -0,0 +1,219 @@
+//===-- serialbox/core/JsonWriter.cpp -----------------------------------------------*- C++ -*-===//
+//
+//                                    S E R I A L B O X
+//
+// This file is distributed under terms of BSD license.
+// See LICENSE.txt for more information
+//
+//===------------------------------------------------------------------------------------------===//
+//
+/// \file
+/// This file implements the JsonWriter, a streaming writer for JSON documents.
+///
+//===------------------------------------------------------------------------------------------===//
+
+#include "serialbox/core/JsonWriter.h"
+#include <cinttypes>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <ostream>
+
+namespace serialbox {
+
+namespace {
+
+/// Size of the buffer before it is flushed to the stream
+const std::size_t BufferSize = 1 << 16;
+
+} // anonymous namespace
+
+JsonWriter::JsonWriter(std::ostream& stream, int indent)
+    : stream_(stream), indent_(indent), afterKey_(false) {
+  buffer_.reserve(BufferSize + 1024);
+}
+
+JsonWriter::~JsonWriter() {
+  try {
+    flush();
+  } catch(...) {
+  }
+}
+
+void JsonWriter::flush() {
+  stream_.write(buffer_.data(), buffer_.size());
+  buffer_.clear();
+}
+
+void JsonWriter::writeRaw(const char* str, std::size_t size) {
+  buffer_.append(str, size);
+  if(buffer_.size() >= BufferSize)
+    flush();
+}
+
+void JsonWriter::newline() {
+  if(indent_ < 0)
+    return;
+  buffer_ += '\n';
+  buffer_.append(first_.size() * indent_, ' ');
+}
+
+void JsonWriter::beginValue() {
+  if(afterKey_) {
+    afterKey_ = false;
+    return;
+  }
+
+  // Element of an array
+  if(!first_.empty()) {
+    if(!first_.back())
+      buffer_ += ',';
+    first_.back() = false;
+    newline();
+  }
+}
+
+void JsonWriter::beginObject() {
+  beginValue();
+  buffer_ += '{';
+  first_.push_back(true);
+}
+
+void JsonWriter::endObject() { end('}'); }
+
+void JsonWriter::beginArray() {
+  beginValue();
+  buffer_ += '[';
+  first_.push_back(true);
+}
+
+void JsonWriter::endArray() { end(']'); }
+
+void JsonWriter::end(char c) {
+  bool empty = first_.back();
+  first_.pop_back();
+  if(!empty)
+    newline();
+  buffer_ += c;
+  if(first_.empty())
+    flush();
+}
+
+void JsonWriter::key(const std::string& key) {
+  if(!first_.back())
+    buffer_ += ',';
+  first_.back() = false;
+  newline();
+  writeString(key);
+  buffer_ += (indent_ < 0 ? ":" : ": ");
+  afterKey_ = true;
+}
+
+void JsonWriter::writeString(const std::string& str) {
+  buffer_ += '"';
+  for(char c : str) {
+    switch(c) {
+    case '"':
+      buffer_ += "\\\"";
+      break;
+    case '\\':
+      buffer_ += "\\\\";
+      break;
+    case '\b':
+      buffer_ += "\\b";
+      break;
+    case '\f':
+      buffer_ += "\\f";
+      break;
+    case '\n':
+      buffer_ += "\\n";
+      break;
+    case '\r':
+      buffer_ += "\\r";
+      break;
+    case '\t':
+      buffer_ += "\\t";
+      break;
+    default:
+      if(static_cast<unsigned char>(c) < 0x20) {
+        char escaped[8];
+        std::snprintf(escaped, sizeof(escaped), "\\u%04x", static_cast<int>(c));
+        buffer_ += escaped;
+      } else
+        buffer_ += c;
+    }
+  }
+  buffer_ += '"';
+  if(buffer_.size() >= BufferSize)
+    flush();
+}
+
+void JsonWriter::value(const std::string& value) {
+  beginValue();
+  writeString(value);
+}
+
+void JsonWriter::value(const char* value) { this->value(std::string(value)); }
+
+void JsonWriter::value(bool value) {
+  beginValue();
+  if(value)
+    writeRaw("true", 4);
+  else
+    writeRaw("false", 5);
+}
+
+void JsonWriter::value(int value) { this->value(static_cast<std::int64_t>(value)); }
+
+void JsonWriter::value(unsigned int value) { this->value(static_cast<std::uint64_t>(value)); }
+
+void JsonWriter::value(std::int64_t value) {
+  beginValue();
+  char str[32];
+  int size = std::snprintf(str, sizeof(str), "%" PRId64, value);
+  writeRaw(str, size);
+}
+
+void JsonWriter::value(std::uint64_t value) {
+  beginValue();
+  char str[32];
+  int size = std::snprintf(str, sizeof(str), "%" PRIu64, value);
+  writeRaw(str, size);
+}
+
+void JsonWriter::value(double value) {
+  // JSON has no representation of NaN or infinity
+  if(!std::isfinite(value)) {
+    null();
+    return;
+  }
+
+  beginValue();
+  char str[32];
+  int size = std::snprintf(str, sizeof(str), "%.17g", value);
+
+  // Keep the floating point notation and ignore the decimal separator of the locale
+  bool isIntegral = true;
+  for(int i = 0; i < size; ++i) {
+    if(str[i] == ',')
+      str[i] = '.';
+    if(str[i] == '.' || str[i] == 'e')
+      isIntegral = false;
+  }
+  writeRaw(str, size);
+  if(isIntegral)
+    writeRaw(".0", 2);
+}
+
+void JsonWriter::value(const json::json& value) {
+  beginValue();
+  std::string str = value.dump();
+  writeRaw(str.data(), str.size());
+}
+
+void JsonWriter::null() {
+  beginValue();
+  writeRaw("null", 4);
+}
+
+} // namespace serialbox
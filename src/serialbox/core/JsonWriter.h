@@ -0,0 +1,113 @@
+//===-- serialbox/core/JsonWriter.h -------------------------------------------------*- C++ -*-===//
+//
+//                                    S E R I A L B O X
+//
+// This file is distributed under terms of BSD license.
+// See LICENSE.txt for more information
+//
+//===------------------------------------------------------------------------------------------===//
+//
+/// \file
+/// This file contains the JsonWriter, a streaming writer for JSON documents.
+///
+//===------------------------------------------------------------------------------------------===//
+
+#ifndef SERIALBOX_CORE_JSONWRITER_H
+#define SERIALBOX_CORE_JSONWRITER_H
+
+#include "serialbox/core/Json.h"
+#include <cstdint>
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+namespace serialbox {
+
+/// \addtogroup core
+/// @{
+
+/// \brief Streaming writer for JSON documents
+///
+/// The document is emitted directly from the caller's data structures into an internal buffer
+/// which is flushed to the stream in large chunks, no DOM is built. Small sub-trees which are
+/// available as a DOM can be embedded via `value(const json::json&)`.
+///
+/// \code
+///   JsonWriter writer(stream, 1);
+///   writer.beginObject();
+///   writer.key("name");
+///   writer.value("savepoint");
+///   writer.endObject();
+/// \endcode
+///
+/// The writer does not validate the structure of the document (e.g a value without a preceding
+/// key inside an object).
+class JsonWriter {
+public:
+  /// \brief Initialize the writer
+  ///
+  /// \param stream  Output stream
+  /// \param indent  Indentation of each level (-1 produces a compact document)
+  explicit JsonWriter(std::ostream& stream, int indent = -1);
+
+  /// \brief Copy constructor [deleted]
+  JsonWriter(const JsonWriter&) = delete;
+
+  /// \brief Copy assignment [deleted]
+  JsonWriter& operator=(const JsonWriter&) = delete;
+
+  /// \brief Flush the remaining buffer
+  ~JsonWriter();
+
+  /// \brief Begin a new object
+  void beginObject();
+
+  /// \brief End the current object
+  void endObject();
+
+  /// \brief Begin a new array
+  void beginArray();
+
+  /// \brief End the current array
+  void endArray();
+
+  /// \brief Write the key of the next member of the current object
+  void key(const std::string& key);
+
+  /// \name Write a value
+  /// @{
+  void value(const std::string& value);
+  void value(const char* value);
+  void value(bool value);
+  void value(int value);
+  void value(unsigned int value);
+  void value(std::int64_t value);
+  void value(std::uint64_t value);
+  void value(double value);
+  void value(const json::json& value);
+  void null();
+  /// @}
+
+  /// \brief Flush the buffer to the stream
+  void flush();
+
+private:
+  void beginValue();
+  void newline();
+  void writeString(const std::string& str);
+  void writeRaw(const char* str, std::size_t size);
+  void end(char c);
+
+private:
+  std::ostream& stream_;
+  int indent_;
+  std::string buffer_;
+  std::vector<bool> first_; ///< Is the next member/element the first of the current scope
+  bool afterKey_;           ///< Was the last token a key
+};
+
+/// @}
+
+} // namespace serialbox
+
+#endif
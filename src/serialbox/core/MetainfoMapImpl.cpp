@@ -47,6 +47,63 @@ struct InsertHelper {
   }
 };
 
+template <class T>
+T readAs(JsonReader& reader);
+
+template <>
+bool readAs<bool>(JsonReader& reader) {
+  return reader.readBoolean();
+}
+
+template <>
+int readAs<int>(JsonReader& reader) {
+  return static_cast<int>(reader.readInteger());
+}
+
+template <>
+std::int64_t readAs<std::int64_t>(JsonReader& reader) {
+  return reader.readInteger();
+}
+
+template <>
+float readAs<float>(JsonReader& reader) {
+  return static_cast<float>(reader.readDouble());
+}
+
+template <>
+double readAs<double>(JsonReader& reader) {
+  return reader.readDouble();
+}
+
+template <>
+std::string readAs<std::string>(JsonReader& reader) {
+  return reader.readString();
+}
+
+struct ReadHelper {
+  // Capture environment
+  MetainfoMapImpl& map;
+  const std::string& key;
+  JsonReader& reader;
+
+  // Read value from the reader and insert it into the MetainfoMapImpl as type ´T´
+  template <class T>
+  void insertAs() {
+    map.insert(key, readAs<T>(reader));
+  }
+
+  // Read value from the reader as Array of type ´T´ and insert as array of type ´T´ into the
+  // MetainfoMapImpl
+  template <class T>
+  void insertAsArrayOf() {
+    Array<T> array;
+    reader.beginArray();
+    while(reader.nextElement())
+      array.push_back(readAs<T>(reader));
+    map.insert(key, array);
+  }
+};
+
 } // anonymous namespace
 
 std::vector<std::string> MetainfoMapImpl::keys() const {
@@ -82,6 +139,13 @@ MetainfoMapImpl::at(const MetainfoMapImpl::key_type& key) const {
   }
 }
 
+std::size_t MetainfoMapImpl::hash() const noexcept {
+  std::size_t seed = map_.size();
+  for(const auto& keyValuePair : map_)
+    seed += std::hash<std::string>()(keyValuePair.first) * 31 + keyValuePair.second.hash();
+  return seed;
+}
+
 json::json MetainfoMapImpl::toJSON() const {
   json::json jsonNode;
 
@@ -156,6 +220,87 @@ json::json MetainfoMapImpl::toJSON() const {
   return jsonNode;
 }
 
+namespace {
+
+template <class T>
+void writeValue(JsonWriter& writer, const MetainfoValueImpl& value, bool isArray) {
+  if(isArray) {
+    writer.beginArray();
+    for(const T& v : value.as<Array<T>>())
+      writer.value(v);
+    writer.endArray();
+  } else
+    writer.value(value.as<T>());
+}
+
+template <>
+void writeValue<bool>(JsonWriter& writer, const MetainfoValueImpl& value, bool isArray) {
+  if(isArray) {
+    writer.beginArray();
+    for(bool v : value.as<Array<bool>>())
+      writer.value(v);
+    writer.endArray();
+  } else
+    writer.value(value.as<bool>());
+}
+
+template <>
+void writeValue<float>(JsonWriter& writer, const MetainfoValueImpl& value, bool isArray) {
+  if(isArray) {
+    writer.beginArray();
+    for(const float& v : value.as<Array<float>>())
+      writer.value(static_cast<double>(v));
+    writer.endArray();
+  } else
+    writer.value(static_cast<double>(value.as<float>()));
+}
+
+} // anonymous namespace
+
+void MetainfoMapImpl::toJSON(JsonWriter& writer) const {
+  if(map_.empty()) {
+    writer.null();
+    return;
+  }
+
+  writer.beginObject();
+  for(auto it = map_.cbegin(), end = map_.cend(); it != end; ++it) {
+    const MetainfoValueImpl& value = it->second;
+    const bool isArray = TypeUtil::isArray(value.type());
+
+    writer.key(it->first);
+    writer.beginObject();
+    writer.key("type_id");
+    writer.value(static_cast<int>(value.type()));
+    writer.key("value");
+
+    switch(TypeUtil::getPrimitive(value.type())) {
+    case TypeID::Boolean:
+      writeValue<bool>(writer, value, isArray);
+      break;
+    case TypeID::Int32:
+      writeValue<int>(writer, value, isArray);
+      break;
+    case TypeID::Int64:
+      writeValue<std::int64_t>(writer, value, isArray);
+      break;
+    case TypeID::Float32:
+      writeValue<float>(writer, value, isArray);
+      break;
+    case TypeID::Float64:
+      writeValue<double>(writer, value, isArray);
+      break;
+    case TypeID::String:
+      writeValue<std::string>(writer, value, isArray);
+      break;
+    default:
+      serialbox_unreachable("Invalid TypeID");
+    }
+    writer.endObject();
+  }
+  writer.endObject();
+}
+
 void MetainfoMapImpl::fromJSON(const json::json& jsonNode) {
   map_.clear();
 
@@ -227,6 +372,103 @@ void MetainfoMapImpl::fromJSON(const json::json& jsonNode) {
   }
 }
 
+void MetainfoMapImpl::fromJSON(JsonReader& reader) {
+  map_.clear();
+
+  if(reader.isNull()) {
+    reader.readNull();
+    return;
+  }
+
+  std::string key, member;
+
+  reader.beginObject();
+  while(reader.nextMember(key)) {
+    int typeAsInt = -1;
+    bool hasValue = false, isDeferred = false;
+    json::json valueNode;
+
+    reader.beginObject();
+    while(reader.nextMember(member)) {
+      if(member == "type_id") {
+        typeAsInt = static_cast<int>(reader.readInteger());
+      } else if(member == "value") {
+        hasValue = true;
+
+        // The value precedes the type, fall back to the DOM
+        if(typeAsInt == -1) {
+          valueNode = reader.readValue();
+          isDeferred = true;
+          continue;
+        }
+
+        const TypeID type = static_cast<TypeID>(typeAsInt);
+        const bool isArray = TypeUtil::isArray(type);
+
+        ReadHelper readHelper{*this, key, reader};
+
+        switch(TypeUtil::getPrimitive(type)) {
+        case TypeID::Boolean:
+          if(isArray)
+            readHelper.insertAsArrayOf<bool>();
+          else
+            readHelper.insertAs<bool>();
+          break;
+        case TypeID::Int32:
+          if(isArray)
+            readHelper.insertAsArrayOf<int>();
+          else
+            readHelper.insertAs<int>();
+          break;
+        case TypeID::Int64:
+          if(isArray)
+            readHelper.insertAsArrayOf<std::int64_t>();
+          else
+            readHelper.insertAs<std::int64_t>();
+          break;
+        case TypeID::Float32:
+          if(isArray)
+            readHelper.insertAsArrayOf<float>();
+          else
+            readHelper.insertAs<float>();
+          break;
+        case TypeID::Float64:
+          if(isArray)
+            readHelper.insertAsArrayOf<double>();
+          else
+            readHelper.insertAs<double>();
+          break;
+        case TypeID::String:
+          if(isArray)
+            readHelper.insertAsArrayOf<std::string>();
+          else
+            readHelper.insertAs<std::string>();
+          break;
+        default:
+          throw Exception("sub-node '%s' has an invalid 'type_id'", key);
+        }
+      } else
+        reader.skipValue();
+    }
+
+    if(typeAsInt == -1)
+      throw Exception("sub-node '%s' has no node 'type_id'", key);
+
+    if(!hasValue)
+      throw Exception("sub-node '%s' has no node 'value'", key);
+
+    if(isDeferred) {
+      json::json jsonNode;
+      jsonNode[key]["type_id"] = typeAsInt;
+      jsonNode[key]["value"] = valueNode;
+
+      MetainfoMapImpl map;
+      map.fromJSON(jsonNode);
+      map_.insert(*map.begin());
+    }
+  }
+}
+
 std::ostream& operator<<(std::ostream& stream, const MetainfoMapImpl& s) {
   std::stringstream ss;
   ss << "{";
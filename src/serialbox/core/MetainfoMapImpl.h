@@ -17,6 +17,8 @@
 
 #include "serialbox/core/Exception.h"
 #include "serialbox/core/Json.h"
+#include "serialbox/core/JsonReader.h"
+#include "serialbox/core/JsonWriter.h"
 #include "serialbox/core/MetainfoValueImpl.h"
 #include "serialbox/core/Type.h"
 #include <iosfwd>
@@ -196,14 +198,25 @@ public:
   /// \brief Test for inequality
   bool operator!=(const MetainfoMapImpl& right) const noexcept { return (!(*this == right)); }
 
+  /// \brief Compute a hash of all key-value pairs (independent of their order)
+  std::size_t hash() const noexcept;
+
   /// \brief Convert to JSON
   json::json toJSON() const;
 
+  /// \brief Write as the next value of `writer`
+  void toJSON(JsonWriter& writer) const;
+
   /// \brief Construct from JSON node
   ///
   /// \throw Exception  JSON node is ill-formed
   void fromJSON(const json::json& jsonNode);
 
+  /// \brief Construct from the next value of `reader`
+  ///
+  /// \throw Exception  JSON node is ill-formed
+  void fromJSON(JsonReader& reader);
+
   /// \brief Convert to stream
   friend std::ostream& operator<<(std::ostream& stream, const MetainfoMapImpl& s);
 
@@ -278,6 +278,54 @@ bool MetainfoValueImpl::operator==(const MetainfoValueImpl& right) const noexcep
   }
 }
 
+namespace internal {
+
+template <class T>
+std::size_t hashArray(const Array<T>& array) noexcept {
+  std::size_t seed = array.size();
+  for(const T& value : array)
+    seed ^= std::hash<T>()(value) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+  return seed;
+}
+
+} // namespace internal
+
+std::size_t MetainfoValueImpl::hash() const noexcept {
+  switch(type_) {
+
+  // Primitive
+  case TypeID::Boolean:
+    return std::hash<bool>()(convert<bool>());
+  case TypeID::Int32:
+    return std::hash<int>()(convert<int>());
+  case TypeID::Int64:
+    return std::hash<std::int64_t>()(convert<std::int64_t>());
+  case TypeID::Float32:
+    return std::hash<float>()(convert<float>());
+  case TypeID::Float64:
+    return std::hash<double>()(convert<double>());
+  case TypeID::String:
+    return std::hash<std::string>()(convert<std::string>());
+
+  // Array
+  case TypeID::ArrayOfBoolean:
+    return internal::hashArray(convert<Array<bool>>());
+  case TypeID::ArrayOfInt32:
+    return internal::hashArray(convert<Array<int>>());
+  case TypeID::ArrayOfInt64:
+    return internal::hashArray(convert<Array<std::int64_t>>());
+  case TypeID::ArrayOfFloat32:
+    return internal::hashArray(convert<Array<float>>());
+  case TypeID::ArrayOfFloat64:
+    return internal::hashArray(convert<Array<double>>());
+  case TypeID::ArrayOfString:
+    return internal::hashArray(convert<Array<std::string>>());
+
+  default:
+    serialbox_unreachable("Invalid TypeID");
+  }
+}
+
 std::string MetainfoValueImpl::toString() const { return as<std::string>(); }
 
 template <>
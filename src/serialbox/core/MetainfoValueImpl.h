@@ -99,6 +99,11 @@ public:
   /// \brief Test for inequality
   bool operator!=(const MetainfoValueImpl& right) const noexcept { return (!(*this == right)); }
 
+  /// \brief Compute a hash of the value
+  ///
+  /// Values which compare equal have the same hash.
+  std::size_t hash() const noexcept;
+
   /// \brief Get TypeID
   TypeID type() const noexcept { return type_; }
 
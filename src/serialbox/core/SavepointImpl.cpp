@@ -31,6 +31,15 @@ json::json SavepointImpl::toJSON() const {
   return jsonNode;
 }
 
+void SavepointImpl::toJSON(JsonWriter& writer) const {
+  writer.beginObject();
+  writer.key("meta_info");
+  metaInfo_->toJSON(writer);
+  writer.key("name");
+  writer.value(name_);
+  writer.endObject();
+}
+
 void SavepointImpl::fromJSON(const json::json& jsonNode) {
   if(!metaInfo_)
     metaInfo_ = std::make_shared<MetainfoMapImpl>();
@@ -49,6 +58,34 @@ void SavepointImpl::fromJSON(const json::json& jsonNode) {
     metaInfo_->fromJSON(jsonNode["meta_info"]);
 }
 
+void SavepointImpl::fromJSON(JsonReader& reader) {
+  if(!metaInfo_)
+    metaInfo_ = std::make_shared<MetainfoMapImpl>();
+
+  name_.clear();
+  metaInfo_->clear();
+
+  if(reader.isNull())
+    throw Exception("node is empty");
+
+  bool hasName = false;
+  std::string key;
+
+  reader.beginObject();
+  while(reader.nextMember(key)) {
+    if(key == "name") {
+      name_ = reader.readString();
+      hasName = true;
+    } else if(key == "meta_info")
+      metaInfo_->fromJSON(reader);
+    else
+      reader.skipValue();
+  }
+
+  if(!hasName)
+    throw Exception("no node 'name'");
+}
+
 std::string SavepointImpl::toString() const {
   std::stringstream ss;
   ss << *this;
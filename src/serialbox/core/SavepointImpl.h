@@ -17,6 +17,8 @@
 
 #include "serialbox/core/Exception.h"
 #include "serialbox/core/Json.h"
+#include "serialbox/core/JsonReader.h"
+#include "serialbox/core/JsonWriter.h"
 #include "serialbox/core/MetainfoMapImpl.h"
 #include <functional>
 #include <iosfwd>
@@ -119,11 +121,19 @@ public:
   /// \brief Convert to JSON
   json::json toJSON() const;
 
+  /// \brief Write as the next value of `writer`
+  void toJSON(JsonWriter& writer) const;
+
   /// \brief Construct from JSON node
   ///
   /// \throw Exception  JSON node is ill-formed
   void fromJSON(const json::json& jsonNode);
 
+  /// \brief Construct from the next value of `reader`
+  ///
+  /// \throw Exception  JSON node is ill-formed
+  void fromJSON(JsonReader& reader);
+
   /// \brief Convert savepoint to string
   std::string toString() const;
 
@@ -147,13 +157,14 @@ namespace std {
 
 /// \brief Specialization of `std::hash<T>` for [T = serialbox::Savepoint]
 ///
-/// Savepoints are hashed on their name (std::string). Although, the name of a savepoint is not
-/// unique, it is a reasoanble compromise as we assume there are only O(1) savepoints sharing the
-/// same name.
+/// Savepoints are hashed on their name and meta-information. Runs usually register a large number
+/// of savepoints sharing the same name (e.g differing only in the time step), hashing on the name
+/// alone would degrade the lookup in the SavepointVector to a linear search.
 template <>
 struct hash<serialbox::SavepointImpl> {
   std::size_t operator()(const serialbox::SavepointImpl& s) const noexcept {
-    return std::hash<std::string>()(s.name());
+    std::size_t seed = std::hash<std::string>()(s.name());
+    return seed ^ (s.metaInfo().hash() + 0x9e3779b9 + (seed << 6) + (seed >> 2));
   }
 };
 
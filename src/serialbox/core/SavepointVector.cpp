@@ -15,42 +15,223 @@
 
 #include "serialbox/core/SavepointVector.h"
 #include "serialbox/core/Logging.h"
+#include <algorithm>
+#include <fstream>
 
 namespace serialbox {
 
-int SavepointVector::insert(const SavepointImpl& savepoint) noexcept {
+namespace {
+
+/// \brief Parse the savepoints and the fields of each savepoint as pair of savepoint name and
+/// fields (the fields may precede the savepoints)
+///
+/// \return True iff the fields of each savepoint are present
+template <class FieldsOfSavepointVectorType>
+bool parseSavepoints(JsonReader& reader, std::vector<SavepointImpl>& savepoints,
+                     FieldsOfSavepointVectorType& fieldsPerSavepoint) {
+  if(reader.isNull()) {
+    reader.readNull();
+    return false;
+  }
+
+  bool hasFieldsPerSavepoint = false;
+  std::string key, fieldName;
+
+  reader.beginObject();
+  while(reader.nextMember(key)) {
+
+    // Add savepoints
+    if(key == "savepoints") {
+      if(reader.isNull()) {
+        reader.readNull();
+        continue;
+      }
+
+      if(hasFieldsPerSavepoint)
+        savepoints.reserve(fieldsPerSavepoint.size());
+
+      reader.beginArray();
+      while(reader.nextElement()) {
+        savepoints.emplace_back("");
+        savepoints.back().fromJSON(reader);
+      }
+
+    // Add fields
+    } else if(key == "fields_per_savepoint") {
+      hasFieldsPerSavepoint = true;
+      if(reader.isNull()) {
+        reader.readNull();
+        continue;
+      }
+
+      fieldsPerSavepoint.reserve(savepoints.size());
+
+      reader.beginArray();
+      while(reader.nextElement()) {
+        fieldsPerSavepoint.emplace_back();
+        auto& fields = fieldsPerSavepoint.back();
+
+        reader.beginObject();
+        while(reader.nextMember(fields.first)) {
+
+          // Savepoint has no fields
+          if(reader.isNull()) {
+            reader.readNull();
+            continue;
+          }
+
+          reader.beginObject();
+          while(reader.nextMember(fieldName))
+            fields.second.insert({fieldName, static_cast<unsigned int>(reader.readInteger())});
+        }
+      }
+    } else
+      reader.skipValue();
+  }
+  return hasFieldsPerSavepoint;
+}
+
+} // anonymous namespace
+
+SavepointVector::SavepointVector(const SavepointVector& other) : SavepointVector() {
+  other.loadAll();
+  index_ = other.index_;
+  savepoints_ = other.savepoints_;
+  fields_ = other.fields_;
+  fieldIndex_ = other.fieldIndex_;
+}
+
+SavepointVector& SavepointVector::operator=(const SavepointVector& other) {
+  SavepointVector copy(other);
+  swap(copy);
+  return *this;
+}
+
+SavepointVector& SavepointVector::operator=(SavepointVector&& other) noexcept {
+  SavepointVector moved(std::move(other));
+  swap(moved);
+  return *this;
+}
+
+int SavepointVector::insert(const SavepointImpl& savepoint) {
+  return insert(SavepointImpl(savepoint));
+}
+
+int SavepointVector::insert(SavepointImpl&& savepoint) {
+  // The savepoint may be in a shard which is not yet loaded
+  if(numUnloadedShards_ > 0 && find(savepoint) != -1)
+    return -1;
+  return append(std::move(savepoint));
+}
+
+int SavepointVector::append(SavepointImpl&& savepoint) noexcept {
   int idx = savepoints_.size();
   if(index_.insert(typename index_type::value_type{savepoint, idx}).second) {
-    savepoints_.push_back(std::make_shared<SavepointImpl>(savepoint));
+    savepoints_.push_back(std::make_shared<SavepointImpl>(std::move(savepoint)));
     fields_.push_back(fields_per_savepoint_type());
     return idx;
   }
   return -1;
 }
 
-bool SavepointVector::addField(const SavepointImpl& savepoint, const FieldID& fieldID) noexcept {
+void SavepointVector::reserve(std::size_t size) {
+  index_.reserve(size);
+  savepoints_.reserve(size);
+  fields_.reserve(size);
+}
+
+bool SavepointVector::addField(const SavepointImpl& savepoint, const FieldID& fieldID) {
   int idx = find(savepoint);
   if(idx != -1)
     return addField(idx, fieldID);
   return false;
 }
 
-bool SavepointVector::addField(int idx, const FieldID& fieldID) noexcept {
-  return fields_[idx].insert({fieldID.name, fieldID.id}).second;
+bool SavepointVector::addField(int idx, const FieldID& fieldID) {
+  ensureLoaded(idx);
+  if(!fields_[idx].insert({fieldID.name, fieldID.id}).second)
+    return false;
+  indexField(idx, fieldID.name);
+  return true;
+}
+
+void SavepointVector::indexField(int idx, const std::string& field) const {
+  // Fields are usually added to the most recent savepoint
+  std::vector<int>& indices = fieldIndex_[field];
+  if(indices.empty() || indices.back() < idx)
+    indices.push_back(idx);
+  else
+    indices.insert(std::lower_bound(indices.begin(), indices.end(), idx), idx);
+}
+
+int SavepointVector::findFieldAtOrBefore(int idx, const std::string& field) const {
+  if(numUnloadedShards_ == 0 || idx < 0)
+    return findLoadedFieldAtOrBefore(idx, field);
+
+  // Load the shards backwards, starting at the shard of `idx`, until the field is found in a shard
+  // which is loaded
+  std::lock_guard<std::mutex> lock(*shardMutex_);
+  for(std::size_t shard = std::min(idx / shardSize_, shardFiles_.size());; --shard) {
+    if(shard < shardFiles_.size() && !shardFiles_[shard].empty())
+      loadShard(shard);
+
+    int found = findLoadedFieldAtOrBefore(idx, field);
+    if(shard == 0 || (found != -1 && std::size_t(found) >= shard * shardSize_))
+      return found;
+  }
+}
+
+int SavepointVector::findFieldAfter(int idx, const std::string& field) const {
+  if(numUnloadedShards_ == 0)
+    return findLoadedFieldAfter(idx, field);
+
+  // Load the shards forwards, starting at the shard following `idx`, until the field is found
+  std::lock_guard<std::mutex> lock(*shardMutex_);
+  for(std::size_t shard = (idx + 1) / shardSize_; shard < shardFiles_.size(); ++shard) {
+    if(!shardFiles_[shard].empty())
+      loadShard(shard);
+
+    int found = findLoadedFieldAfter(idx, field);
+    if(found != -1 && std::size_t(found) < (shard + 1) * shardSize_)
+      return found;
+  }
+  return findLoadedFieldAfter(idx, field);
 }
 
-bool SavepointVector::hasField(const SavepointImpl& savepoint, const std::string& field) noexcept {
+int SavepointVector::findLoadedFieldAtOrBefore(int idx, const std::string& field) const noexcept {
+  auto it = fieldIndex_.find(field);
+  if(it == fieldIndex_.end())
+    return -1;
+
+  const std::vector<int>& indices = it->second;
+  auto pos = std::upper_bound(indices.begin(), indices.end(), idx);
+  return pos == indices.begin() ? -1 : *(pos - 1);
+}
+
+int SavepointVector::findLoadedFieldAfter(int idx, const std::string& field) const noexcept {
+  auto it = fieldIndex_.find(field);
+  if(it == fieldIndex_.end())
+    return -1;
+
+  const std::vector<int>& indices = it->second;
+  auto pos = std::upper_bound(indices.begin(), indices.end(), idx);
+  return pos == indices.end() ? -1 : *pos;
+}
+
+bool SavepointVector::hasField(const SavepointImpl& savepoint, const std::string& field) {
   int idx = find(savepoint);
   if(idx != -1)
     return hasField(idx, field);
   return false;
 }
 
-bool SavepointVector::hasField(int idx, const std::string& field) noexcept {
+bool SavepointVector::hasField(int idx, const std::string& field) {
+  ensureLoaded(idx);
   return (fields_[idx].find(field) != fields_[idx].end());
 }
 
 FieldID SavepointVector::getFieldID(int idx, const std::string& field) const {
+  ensureLoaded(idx);
   auto it = fields_[idx].find(field);
   if(it != fields_[idx].end())
     return FieldID{it->first, it->second};
@@ -69,27 +250,44 @@ void SavepointVector::swap(SavepointVector& other) noexcept {
   index_.swap(other.index_);
   savepoints_.swap(other.savepoints_);
   fields_.swap(other.fields_);
+  fieldIndex_.swap(other.fieldIndex_);
+  std::swap(shardSize_, other.shardSize_);
+  shardFiles_.swap(other.shardFiles_);
+  numUnloadedShards_ = other.numUnloadedShards_.exchange(numUnloadedShards_);
+  shardMutex_.swap(other.shardMutex_);
 }
 
-bool SavepointVector::exists(const SavepointImpl& savepoint) const noexcept {
+bool SavepointVector::exists(const SavepointImpl& savepoint) const {
   return (find(savepoint) != -1);
 }
 
-int SavepointVector::find(const SavepointImpl& savepoint) const noexcept {
+int SavepointVector::find(const SavepointImpl& savepoint) const {
+  if(numUnloadedShards_ == 0) {
+    auto it = index_.find(savepoint);
+    return ((it != index_.end()) ? it->second : -1);
+  }
+
+  // Load the shards, the most recent first, until the savepoint is found
+  std::lock_guard<std::mutex> lock(*shardMutex_);
   auto it = index_.find(savepoint);
+  for(std::size_t shard = shardFiles_.size(); it == index_.end() && shard > 0; --shard)
+    if(!shardFiles_[shard - 1].empty()) {
+      loadShard(shard - 1);
+      it = index_.find(savepoint);
+    }
   return ((it != index_.end()) ? it->second : -1);
 }
 
-const SavepointVector::fields_per_savepoint_type& SavepointVector::fieldsOf(int idx) const
-    noexcept {
+const SavepointVector::fields_per_savepoint_type& SavepointVector::fieldsOf(int idx) const {
+  ensureLoaded(idx);
   return fields_[idx];
 }
 
 const SavepointVector::fields_per_savepoint_type&
 SavepointVector::fieldsOf(const SavepointImpl& savepoint) const {
-  auto it = index_.find(savepoint);
-  if(it != index_.end())
-    return fieldsOf(it->second);
+  int idx = find(savepoint);
+  if(idx != -1)
+    return fieldsOf(idx);
   throw Exception("savepoint '%' does not exist", savepoint.toString());
 }
 
@@ -97,9 +295,117 @@ void SavepointVector::clear() noexcept {
   savepoints_.clear();
   index_.clear();
   fields_.clear();
+  fieldIndex_.clear();
+  shardSize_ = 0;
+  shardFiles_.clear();
+  numUnloadedShards_ = 0;
+}
+
+void SavepointVector::setLazyShards(std::size_t shardSize, std::vector<std::string> shardFiles) {
+  if(!savepoints_.empty())
+    throw Exception("lazily loaded shards require an empty savepoint vector");
+  if(shardSize == 0)
+    throw Exception("invalid shard size 0");
+
+  const std::size_t size = shardSize * shardFiles.size();
+  index_.reserve(size);
+  savepoints_.resize(size);
+  fields_.resize(size);
+
+  if(!shardMutex_)
+    shardMutex_.reset(new std::mutex);
+  shardSize_ = shardSize;
+  shardFiles_ = std::move(shardFiles);
+  numUnloadedShards_ = shardFiles_.size();
+}
+
+void SavepointVector::load(std::size_t first, std::size_t last) const {
+  if(numUnloadedShards_ == 0 || first >= last)
+    return;
+
+  std::lock_guard<std::mutex> lock(*shardMutex_);
+  const std::size_t lastShard = std::min((last - 1) / shardSize_ + 1, shardFiles_.size());
+  for(std::size_t shard = first / shardSize_; shard < lastShard; ++shard)
+    if(!shardFiles_[shard].empty())
+      loadShard(shard);
+}
+
+void SavepointVector::loadShard(std::size_t shard) const {
+  const std::string& file = shardFiles_[shard];
+  LOG(info) << "Loading meta-data shard " << file;
+
+  std::ifstream fs(file, std::ios::in);
+  if(!fs.is_open())
+    throw Exception("cannot open meta-data shard: %s", file);
+
+  const std::size_t first = shard * shardSize_;
+  try {
+    std::vector<SavepointImpl> savepoints;
+    fields_of_savepoint_vector_type fieldsPerSavepoint;
+
+    JsonReader reader(fs);
+    const bool hasFieldsPerSavepoint = parseSavepoints(reader, savepoints, fieldsPerSavepoint);
+    reader.end();
+
+    if(savepoints.size() != shardSize_)
+      throw Exception("expected %i savepoints, got %i", shardSize_, savepoints.size());
+
+    // Each savepoint needs an entry in the fields array (it can be null though)
+    if(hasFieldsPerSavepoint && fieldsPerSavepoint.size() != savepoints.size())
+      throw Exception("inconsistent number of 'fields_per_savepoint' and 'savepoints'");
+
+    // Fill the slots of the shard, the shard is discarded as a whole if it is ill-formed
+    std::size_t numInserted = 0;
+    try {
+      for(; numInserted < savepoints.size(); ++numInserted) {
+        const SavepointImpl& savepoint = savepoints[numInserted];
+        if(!index_.insert(typename index_type::value_type{savepoint, first + numInserted}).second)
+          throw Exception("duplicate savepoint '%s'", savepoint.toString());
+        savepoints_[first + numInserted] =
+            std::make_shared<SavepointImpl>(std::move(savepoints[numInserted]));
+      }
+      setFields(first, fieldsPerSavepoint);
+    } catch(Exception&) {
+      for(std::size_t i = 0; i < numInserted; ++i) {
+        index_.erase(*savepoints_[first + i]);
+        savepoints_[first + i].reset();
+      }
+      throw;
+    }
+  } catch(Exception& e) {
+    throw Exception("error while parsing %s: %s", file, e.what());
+  }
+
+  shardFiles_[shard].clear();
+  --numUnloadedShards_;
+}
+
+void SavepointVector::setFields(std::size_t first,
+                                fields_of_savepoint_vector_type& fieldsPerSavepoint) const {
+  // An empty entry (i.e `{}`) is a savepoint without fields
+  auto isEmpty = [](const std::pair<std::string, fields_per_savepoint_type>& fields) {
+    return fields.first.empty() && fields.second.empty();
+  };
+
+  for(std::size_t i = 0; i < fieldsPerSavepoint.size(); ++i)
+    if(!isEmpty(fieldsPerSavepoint[i]) &&
+       fieldsPerSavepoint[i].first != savepoints_[first + i]->name())
+      throw Exception("inconsistent 'fields_per_savepoint': entry %i refers to savepoint '%s' "
+                      "instead of '%s'",
+                      first + i, fieldsPerSavepoint[i].first, savepoints_[first + i]->name());
+
+  for(std::size_t i = 0; i < fieldsPerSavepoint.size(); ++i) {
+    if(isEmpty(fieldsPerSavepoint[i]))
+      continue;
+
+    fields_[first + i].swap(fieldsPerSavepoint[i].second);
+    for(const auto& field : fields_[first + i])
+      indexField(first + i, field.first);
+  }
 }
 
 json::json SavepointVector::toJSON() const {
+  loadAll();
   json::json jsonNode;
   assert(savepoints_.size() == fields_.size());
 
@@ -122,16 +428,59 @@ json::json SavepointVector::toJSON() const {
   return jsonNode;
 }
 
+void SavepointVector::toJSON(JsonWriter& writer) const { toJSON(writer, 0, savepoints_.size()); }
+
+void SavepointVector::toJSON(JsonWriter& writer, std::size_t first, std::size_t last) const {
+  load(first, last);
+  assert(savepoints_.size() == fields_.size());
+  assert(first <= last && last <= savepoints_.size());
+
+  if(first == last) {
+    writer.null();
+    return;
+  }
+
+  writer.beginObject();
+
+  // The fields are written first, allowing the reader to preallocate the savepoints
+  writer.key("fields_per_savepoint");
+  writer.beginArray();
+  for(std::size_t i = first; i < last; ++i) {
+    writer.beginObject();
+    writer.key(savepoints_[i]->name());
+    if(fields_[i].empty())
+      writer.null();
+    else {
+      writer.beginObject();
+      for(auto it = fields_[i].begin(), end = fields_[i].end(); it != end; ++it) {
+        writer.key(it->first);
+        writer.value(it->second);
+      }
+      writer.endObject();
+    }
+    writer.endObject();
+  }
+  writer.endArray();
+
+  writer.key("savepoints");
+  writer.beginArray();
+  for(std::size_t i = first; i < last; ++i)
+    savepoints_[i]->toJSON(writer);
+  writer.endArray();
+
+  writer.endObject();
+}
+
 void SavepointVector::fromJSON(const json::json& jsonNode) {
-  index_.clear();
-  savepoints_.clear();
-  fields_.clear();
+  clear();
 
   if(jsonNode.is_null() || jsonNode.empty())
     return;
 
   // Add savepoints
   if(jsonNode.count("savepoints")) {
+    reserve(jsonNode["savepoints"].size());
+
     for(auto it = jsonNode["savepoints"].begin(), end = jsonNode["savepoints"].end(); it != end;
         ++it) {
       SavepointImpl sp(*it);
@@ -149,14 +498,38 @@ void SavepointVector::fromJSON(const json::json& jsonNode) {
 
     // Savepoint has no fields
     if(fieldNode.is_null() || fieldNode.empty())
-      break;
+      continue;
 
     // Add fields
     for(auto it = fieldNode.begin(), end = fieldNode.end(); it != end; ++it)
-      fields_[i].insert({it.key(), static_cast<unsigned int>(it.value())});
+      if(fields_[i].insert({it.key(), static_cast<unsigned int>(it.value())}).second)
+        fieldIndex_[it.key()].push_back(i);
   }
 }
 
+void SavepointVector::fromJSON(JsonReader& reader) {
+  clear();
+  appendFromJSON(reader);
+}
+
+void SavepointVector::appendFromJSON(JsonReader& reader) {
+  std::vector<SavepointImpl> savepoints;
+  fields_of_savepoint_vector_type fieldsPerSavepoint;
+  const bool hasFieldsPerSavepoint = parseSavepoints(reader, savepoints, fieldsPerSavepoint);
+
+  // The appended savepoints are not looked up in the shards which are not yet loaded
+  const std::size_t first = savepoints_.size();
+  reserve(first + savepoints.size());
+  for(auto& savepoint : savepoints)
+    append(std::move(savepoint));
+
+  // Each savepoint needs an entry in the fields array (it can be null though)
+  if(hasFieldsPerSavepoint && fieldsPerSavepoint.size() != fields_.size() - first)
+    throw Exception("inconsistent number of 'fields_per_savepoint' and 'savepoints'");
+
+  setFields(first, fieldsPerSavepoint);
+}
+
 std::ostream& operator<<(std::ostream& stream, const SavepointVector& s) {
   stream << "SavepointVector = " << s.toJSON().dump(4);
   return stream;
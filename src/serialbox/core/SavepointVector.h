@@ -19,7 +19,11 @@
 #include "serialbox/core/FieldID.h"
 #include "serialbox/core/Json.h"
 #include "serialbox/core/SavepointImpl.h"
+#include <atomic>
 #include <iosfwd>
+#include <memory>
+#include <mutex>
+#include <string>
 #include <unordered_map>
 #include <vector>
 
@@ -32,8 +36,15 @@ namespace serialbox {
 /// fields
 ///
 /// The savepoints are ordered in the sequence they were registred.
+///
+/// The savepoints of sharded meta-data can be loaded lazily (see SavepointVector::setLazyShards),
+/// the savepoints of a shard are only parsed once they are accessed. Accessing a savepoint by index
+/// loads its shard, looking up a savepoint which is not in the loaded shards loads the remaining
+/// shards (the most recent first) until it is found and accessing all savepoints (e.g iterating
+/// them) loads all shards. Shards may be loaded while the vector is read concurrently.
 class SavepointVector {
   using index_type = std::unordered_map<SavepointImpl, int>;
+  using field_index_type = std::unordered_map<std::string, std::vector<int>>;
 
 public:
   /// \brief Vector of savepoints
@@ -52,57 +63,65 @@ public:
   using const_iterator = savepoint_vector_type::const_iterator;
 
   /// \brief Default constructor (empty)
-  SavepointVector() : index_(), savepoints_(), fields_(){};
+  SavepointVector() : shardSize_(0), numUnloadedShards_(0) {}
 
-  /// \brief Copy constructor
-  SavepointVector(const SavepointVector&) = default;
+  /// \brief Copy constructor (loads all shards of `other`)
+  SavepointVector(const SavepointVector& other);
 
   /// \brief Move constructor
-  SavepointVector(SavepointVector&&) = default;
+  SavepointVector(SavepointVector&& other) noexcept : SavepointVector() { swap(other); }
 
   /// \brief Construct from JSON
-  explicit SavepointVector(const json::json& jsonNode) { fromJSON(jsonNode); }
+  explicit SavepointVector(const json::json& jsonNode) : SavepointVector() { fromJSON(jsonNode); }
 
-  /// \brief Copy assignment
-  SavepointVector& operator=(const SavepointVector&) = default;
+  /// \brief Copy assignment (loads all shards of `other`)
+  SavepointVector& operator=(const SavepointVector& other);
 
   /// \brief Move assignment
-  SavepointVector& operator=(SavepointVector&&) = default;
+  SavepointVector& operator=(SavepointVector&& other) noexcept;
 
   /// \brief Check if savepoint exists
   ///
   /// \return True iff the savepoint exists
-  bool exists(const SavepointImpl& savepoint) const noexcept;
+  bool exists(const SavepointImpl& savepoint) const;
 
   /// \brief Find savepoint
   ///
   /// \return Index of `savepoint` in the savepoint-vector or -1 if savepoint does not exist
-  int find(const SavepointImpl& savepoint) const noexcept;
+  int find(const SavepointImpl& savepoint) const;
 
   /// \brief Insert savepoint in savepoint vector
   ///
   /// \return Index of the newly inserted savepoint or -1 if savepoint already exists
-  int insert(const SavepointImpl& savepoint) noexcept;
+  int insert(const SavepointImpl& savepoint);
+
+  /// \brief Move savepoint into the savepoint vector
+  ///
+  /// \return Index of the newly inserted savepoint or -1 if savepoint already exists
+  int insert(SavepointImpl&& savepoint);
+
+  /// \brief Reserve storage for `size` savepoints
+  void reserve(std::size_t size);
 
   /// \brief Add a field to the savepoint
   ///
   /// \return True iff the field was successfully addeed to the savepoint
-  bool addField(const SavepointImpl& savepoint, const FieldID& fieldID) noexcept;
+  bool addField(const SavepointImpl& savepoint, const FieldID& fieldID);
 
   /// \brief Add a field to the savepoint given a valid savepoint index `idx`
   ///
   /// \return True iff the field was successfully addeed to the savepoint
-  bool addField(int idx, const FieldID& fieldID) noexcept;
+  bool addField(int idx, const FieldID& fieldID);
 
   /// \brief Check if savepoint has field `field`
   ///
   /// \return True iff the field `field` exists at savepoint
-  bool hasField(const SavepointImpl& savepoint, const std::string& field) noexcept;
+  bool hasField(const SavepointImpl& savepoint, const std::string& field);
 
   /// \brief Check if savepoint has field `field` given a valid savepoint index `idx`
   ///
   /// \return True iff the field `field` exists at savepoint
-  bool hasField(int idx, const std::string& field) noexcept;
+  bool hasField(int idx, const std::string& field);
 
   /// \brief Get the FielID of field `field` at savepoint `savepoint`
   ///
@@ -114,16 +133,38 @@ public:
   /// \throw Exception  Savepoint or field at savepoint do not exist
   FieldID getFieldID(int idx, const std::string& field) const;
 
+  /// \brief Find the last savepoint at or before the savepoint index `idx` which has field `field`
+  ///
+  /// The lookup is a binary search in the sorted savepoint indices of the field. Shards are loaded
+  /// backwards from the shard of `idx` until the field is found.
+  ///
+  /// \return Index of the savepoint or -1 if no such savepoint exists
+  int findFieldAtOrBefore(int idx, const std::string& field) const;
+
+  /// \brief Find the first savepoint after the savepoint index `idx` which has field `field`
+  ///
+  /// Shards are loaded forwards from the shard following `idx` until the field is found.
+  ///
+  /// \return Index of the savepoint or -1 if no such savepoint exists
+  int findFieldAfter(int idx, const std::string& field) const;
+
   /// \brief Access fields of savepoint
   ///
   /// \throw Exception  Savepoint does not exists
   const fields_per_savepoint_type& fieldsOf(const SavepointImpl& savepoint) const;
 
   /// \brief Access fields of savepoint given a valid savepoint index `idx`
-  const fields_per_savepoint_type& fieldsOf(int idx) const noexcept;
+  ///
+  /// Only the ids of the fields may be modified through the non-const overload, adding or removing
+  /// fields has to go through SavepointVector::addField.
+  const fields_per_savepoint_type& fieldsOf(int idx) const;
+  fields_per_savepoint_type& fieldsOf(int idx) {
+    ensureLoaded(idx);
+    return fields_[idx];
+  }
 
   /// \brief Returns a bool value indicating whether the savepoint vector is empty
-  bool empty() const noexcept { return index_.empty(); }
+  bool empty() const noexcept { return savepoints_.empty(); }
 
   /// \brief Returns the number of savepoints in the vector
   std::size_t size() const noexcept { return savepoints_.size(); }
@@ -136,40 +177,140 @@ public:
   void swap(SavepointVector& other) noexcept;
 
   /// \brief Returns an iterator pointing to the first savepoint in the vector
-  iterator begin() noexcept { return savepoints_.begin(); }
-  const_iterator begin() const noexcept { return savepoints_.begin(); }
+  iterator begin() {
+    loadAll();
+    return savepoints_.begin();
+  }
+  const_iterator begin() const {
+    loadAll();
+    return savepoints_.begin();
+  }
 
   /// \brief Returns an iterator pointing to the past-the-end savepoint in the vector
   iterator end() noexcept { return savepoints_.end(); }
   const_iterator end() const noexcept { return savepoints_.end(); }
 
   /// \brief Get savepoint
-  SavepointImpl& operator[](int idx) noexcept { return *savepoints_[idx]; }
-  const SavepointImpl& operator[](int idx) const noexcept { return *savepoints_[idx]; }
+  SavepointImpl& operator[](int idx) {
+    ensureLoaded(idx);
+    return *savepoints_[idx];
+  }
+  const SavepointImpl& operator[](int idx) const {
+    ensureLoaded(idx);
+    return *savepoints_[idx];
+  }
 
   /// \brief Returns a reference to the last element in the savepoint vector
-  std::shared_ptr<SavepointImpl>& back() noexcept { return savepoints_.back(); }
-  const std::shared_ptr<SavepointImpl>& back() const noexcept { return savepoints_.back(); }
+  std::shared_ptr<SavepointImpl>& back() {
+    ensureLoaded(savepoints_.size() - 1);
+    return savepoints_.back();
+  }
+  const std::shared_ptr<SavepointImpl>& back() const {
+    ensureLoaded(savepoints_.size() - 1);
+    return savepoints_.back();
+  }
 
   /// \brief Access the savepoints
-  const savepoint_vector_type& savepoints() const noexcept { return savepoints_; }
-  savepoint_vector_type& savepoints() noexcept { return savepoints_; }
+  const savepoint_vector_type& savepoints() const {
+    loadAll();
+    return savepoints_;
+  }
+  savepoint_vector_type& savepoints() {
+    loadAll();
+    return savepoints_;
+  }
+
+  //===----------------------------------------------------------------------------------------===//
+  //     Lazily loaded shards
+  //===----------------------------------------------------------------------------------------===//
+
+  /// \brief Register the shards in `shardFiles` of `shardSize` savepoints each, which are loaded on
+  /// first access
+  ///
+  /// The savepoint vector has to be empty. The savepoints following the registered shards (e.g the
+  /// ones of the last shard, which is usually not full) are appended as usual.
+  ///
+  /// \throw Exception  The savepoint vector is not empty or `shardSize` is 0
+  void setLazyShards(std::size_t shardSize, std::vector<std::string> shardFiles);
+
+  /// \brief Get the number of shards which have not been loaded yet
+  std::size_t numUnloadedShards() const noexcept { return numUnloadedShards_; }
+
+  /// \brief Load the shards holding the savepoints in the range [`first`, `last`)
+  ///
+  /// \throw Exception  A shard cannot be opened or is ill-formed
+  void load(std::size_t first, std::size_t last) const;
+
+  /// \brief Load all shards
+  void loadAll() const { load(0, savepoints_.size()); }
 
   /// \brief Convert to JSON
   json::json toJSON() const;
 
+  /// \brief Write as the next value of `writer`
+  ///
+  /// The savepoints are written directly, without building a DOM of the savepoint vector.
+  void toJSON(JsonWriter& writer) const;
+
+  /// \brief Write the savepoints in the range [`first`, `last`) as the next value of `writer`
+  void toJSON(JsonWriter& writer, std::size_t first, std::size_t last) const;
+
   /// \brief Construct from JSON node
   ///
   /// \throw Exception  JSON node is ill-formed
   void fromJSON(const json::json& jsonNode);
 
+  /// \brief Construct from the next value of `reader`
+  ///
+  /// The savepoints are constructed while parsing, without building a DOM of the savepoint
+  /// vector.
+  ///
+  /// \throw Exception  JSON node is ill-formed
+  void fromJSON(JsonReader& reader);
+
+  /// \brief Append the savepoints of the next value of `reader`
+  ///
+  /// \throw Exception  JSON node is ill-formed
+  void appendFromJSON(JsonReader& reader);
+
   /// \brief Convert to stream
   friend std::ostream& operator<<(std::ostream& stream, const SavepointVector& s);
 
 private:
-  index_type index_;                        ///< Hash-map for fast lookup
-  savepoint_vector_type savepoints_;        ///< Vector of stored savepoints
-  fields_per_savepoint_vector_type fields_; ///< Fields of each savepoint
+  using fields_of_savepoint_vector_type =
+      std::vector<std::pair<std::string, fields_per_savepoint_type>>;
+
+  /// \brief Append `savepoint` without looking for it in the shards which are not yet loaded
+  int append(SavepointImpl&& savepoint) noexcept;
+
+  /// \brief Load the shard holding savepoint `idx` if it is not yet loaded
+  void ensureLoaded(std::size_t idx) const {
+    if(numUnloadedShards_ > 0)
+      load(idx, idx + 1);
+  }
+
+  /// \brief Load shard `shard` (the caller holds the lock of the shards)
+  void loadShard(std::size_t shard) const;
+
+  /// \brief Set the fields of the savepoints starting at `first`
+  ///
+  /// \throw Exception  An entry refers to another savepoint
+  void setFields(std::size_t first, fields_of_savepoint_vector_type& fieldsPerSavepoint) const;
+
+  void indexField(int idx, const std::string& field) const;
+  int findLoadedFieldAtOrBefore(int idx, const std::string& field) const noexcept;
+  int findLoadedFieldAfter(int idx, const std::string& field) const noexcept;
+
+  // The containers are filled when a shard is loaded on first access, hence they are mutable
+  mutable index_type index_;                        ///< Hash-map for fast lookup
+  mutable savepoint_vector_type savepoints_;        ///< Vector of stored savepoints
+  mutable fields_per_savepoint_vector_type fields_; ///< Fields of each savepoint
+  mutable field_index_type fieldIndex_;             ///< Sorted savepoint indices of each field
+
+  std::size_t shardSize_;                            ///< Savepoints per lazily loaded shard
+  mutable std::vector<std::string> shardFiles_;      ///< Files of the shards (empty once loaded)
+  mutable std::atomic<std::size_t> numUnloadedShards_; ///< Shards which are not yet loaded
+  std::unique_ptr<std::mutex> shardMutex_;           ///< Protects the loading of the shards
 };
 
 /// @}
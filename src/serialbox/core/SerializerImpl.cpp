@@ -15,16 +15,26 @@
 #include "serialbox/core/SerializerImpl.h"
 #include "serialbox/core/Compiler.h"
 #include "serialbox/core/Filesystem.h"
+#include "serialbox/core/JsonReader.h"
+#include "serialbox/core/JsonWriter.h"
 #include "serialbox/core/STLExtras.h"
+#include "serialbox/core/Timer.h"
 #include "serialbox/core/Type.h"
 #include "serialbox/core/Unreachable.h"
+#include "serialbox/core/Validator.h"
 #include "serialbox/core/Version.h"
 #include "serialbox/core/archive/ArchiveFactory.h"
 #include "serialbox/core/archive/BinaryArchive.h"
 #include "serialbox/core/hash/HashFactory.h"
+#include <algorithm>
+#include <atomic>
 #include <boost/algorithm/string.hpp>
+#include <cstring>
+#include <exception>
 #include <fstream>
 #include <memory>
+#include <sstream>
+#include <thread>
 #include <type_traits>
 
 #ifdef SERIALBOX_ASYNC_API
@@ -38,7 +48,9 @@ int SerializerImpl::enabled_ = 0;
 
 SerializerImpl::SerializerImpl(OpenModeKind mode, const std::string& directory,
                                const std::string& prefix, const std::string& archiveName)
-    : mode_(mode), directory_(directory), prefix_(prefix) {
+    : mode_(mode), directory_(directory), prefix_(prefix), haloStripping_(false), shardSize_(0),
+      numPersistedSavepoints_(0), numShardFiles_(0), clearArchiveOnValidationEnd_(false),
+      mutex_(new SharedMutex), archiveMutex_(new std::mutex) {
 
   if(enabled_ == 0) {
     const char* envvar = std::getenv("SERIALBOX_SERIALIZATION_DISABLED");
@@ -53,16 +65,22 @@ SerializerImpl::SerializerImpl(OpenModeKind mode, const std::string& directory,
 
   LOG(info) << "Creating Serializer (mode = " << mode_ << ") from directory " << directory_;
 
-  // Validate integrity of directory (non-existent directories are created by the archive)
-
-  try {
-    if(mode_ == OpenModeKind::Read && !filesystem::exists(directory_))
-      //    if(mode_ == OpenModeKind::Read && !filesystem::exists(directory_))
-      throw Exception("cannot create Serializer: directory %s does not exist", directory_);
-  } catch(filesystem::filesystem_error& e) {
-    throw Exception("filesystem error: %s", e.what());
+  // Compare against a reference instead of writing. This needs to happen before the archive is
+  // opened as opening it in Write mode drops the files of the previous run, which may be the
+  // reference itself.
+  if(mode_ != OpenModeKind::Read) {
+    const char* reference = std::getenv("SERIALBOX_VALIDATION_REFERENCE");
+    if(reference && *reference) {
+      Validator& validator = enableValidation(reference, prefix_);
+      const char* tolerance = std::getenv("SERIALBOX_VALIDATION_TOLERANCE");
+      if(tolerance && *tolerance)
+        validator.setTolerance(std::atof(tolerance));
+    }
   }
 
+  // Non-existent directories are created by the archive (when reading, a missing directory is
+  // reported if the meta-data cannot be opened)
+
   // Check if we deal with an older version of serialbox and perform necessary upgrades, otherwise
   // construct from meta-datafrom JSON
   if(!upgradeMetaData()) {
@@ -70,19 +88,181 @@ SerializerImpl::SerializerImpl(OpenModeKind mode, const std::string& directory,
     constructArchive(archiveName);
   }
 
-  // If mode is writing drop all files
-  if(mode_ == OpenModeKind::Write)
-    clear();
+  // If mode is writing drop all meta-data and the shards of the previous run, the archive already
+  // removed its files when it was opened. In validation mode nothing but the report is written,
+  // the files are only dropped once validation is disabled.
+  if(mode_ == OpenModeKind::Write) {
+    clearMetaData();
+    if(!validator_)
+      removeMetaDataShards(0);
+    shardSize_ = 0;
+  }
+
+  // Split the savepoints of the meta-data into shards
+  if(mode_ != OpenModeKind::Read) {
+    const char* shardSize = std::getenv("SERIALBOX_METADATA_SHARD_SIZE");
+    if(shardSize && std::atoi(shardSize) > 0)
+      enableMetaDataSharding(std::atoi(shardSize));
+  }
+
+  // Hold the writes in a write-back cache (this turns repeated writes of a field at a savepoint
+  // into overwrites)
+  if(mode_ != OpenModeKind::Read) {
+    const char* cacheSize = std::getenv("SERIALBOX_WRITE_BACK_CACHE_SIZE");
+    if(cacheSize && std::atoll(cacheSize) > 0)
+      enableWriteBackCache(std::atoll(cacheSize));
+  }
+}
+
+SerializerImpl::~SerializerImpl() {
+  if(validator_) {
+    try {
+      writeValidationReport();
+    } catch(std::exception& e) {
+      LOG(warning) << "Serializer: failed to write validation report: " << e.what();
+    }
+  }
+
+  if(!writeBackCache_)
+    return;
+
+  try {
+    flushWriteBackCache();
+  } catch(std::exception& e) {
+    LOG(warning) << "Serializer: failed to flush write-back cache: " << e.what();
+  }
 }
 
 void SerializerImpl::clear() noexcept {
+  std::lock_guard<SharedMutex> lock(*mutex_);
+  clearMetaData();
+
+  // In validation mode no files are written, hence there are none to drop
+  if(validator_)
+    return;
+
+  removeMetaDataShards(0);
+  archive_->clear();
+}
+
+void SerializerImpl::clearMetaData() noexcept {
+  if(writeBackCache_)
+    writeBackCache_->clear();
   savepointVector_->clear();
   fieldMap_->clear();
   globalMetainfo_->clear();
-  archive_->clear();
+  strippedHalos_.clear();
+  numPersistedSavepoints_ = 0;
+  modifiedShards_.clear();
+}
+
+//===------------------------------------------------------------------------------------------===//
+//     Meta-Data Sharding
+//===------------------------------------------------------------------------------------------===//
+
+void SerializerImpl::enableMetaDataSharding(std::size_t savepointsPerShard) {
+  if(savepointsPerShard == 0)
+    throw Exception("cannot enable meta-data sharding: shard size must be positive");
+
+  // Changing the shard size invalidates all shards on disk (which are hence loaded before they are
+  // overwritten)
+  if(savepointsPerShard != shardSize_) {
+    savepointVector_->loadAll();
+    shardSize_ = savepointsPerShard;
+    numPersistedSavepoints_ = 0;
+    modifiedShards_.clear();
+  }
+}
+
+void SerializerImpl::disableMetaDataSharding() noexcept {
+  shardSize_ = 0;
+  numPersistedSavepoints_ = 0;
+  modifiedShards_.clear();
+}
+
+void SerializerImpl::readMetaDataShards(JsonReader& reader) {
+  std::vector<std::string> shards;
+  std::size_t shardSize = 0;
+  std::string key;
+
+  reader.beginObject();
+  while(reader.nextMember(key)) {
+    if(key == "shard_size") {
+      std::int64_t size = reader.readInteger();
+      if(size <= 0)
+        throw Exception("invalid shard size %i", size);
+      shardSize = size;
+    } else if(key == "shards") {
+      reader.beginArray();
+      while(reader.nextElement())
+        shards.push_back(reader.readString());
+    } else
+      reader.skipValue();
+  }
+
+  if(shardSize == 0)
+    throw Exception("node 'savepoint_shards' has no 'shard_size'");
+
+  shardSize_ = shardSize;
+  numShardFiles_ = shards.size();
+
+  // When writing, the shards are only registered to be removed
+  if(mode_ == OpenModeKind::Write || shards.empty())
+    return;
+
+  // Only the last shard is parsed, the other shards are loaded on first access
+  std::vector<std::string> shardFiles;
+  shardFiles.reserve(shards.size() - 1);
+  for(std::size_t shard = 0; shard + 1 < shards.size(); ++shard)
+    shardFiles.push_back((directory_ / shards[shard]).string());
+  savepointVector_->setLazyShards(shardSize, std::move(shardFiles));
+
+  filesystem::path shardFile = directory_ / shards.back();
+  std::ifstream fs(shardFile.string(), std::ios::in);
+  if(!fs.is_open())
+    throw Exception("cannot open meta-data shard: %s", shardFile);
+
+  try {
+    JsonReader shardReader(fs);
+    savepointVector_->appendFromJSON(shardReader);
+    shardReader.end();
+  } catch(Exception& e) {
+    throw Exception("error while parsing %s: %s", shardFile, e.what());
+  }
+}
+
+void SerializerImpl::removeMetaDataShards(std::size_t first) noexcept {
+  for(std::size_t shard = first; shard < numShardFiles_; ++shard) {
+    filesystem::path shardFile = metaDataShardFile(shard);
+    try {
+      filesystem::remove(shardFile);
+    } catch(filesystem::filesystem_error& e) {
+      LOG(warning) << "Serializer: cannot remove file " << shardFile << ": " << e.what();
+    }
+  }
+  numShardFiles_ = std::min(numShardFiles_, first);
+}
+
+void SerializerImpl::writeMetaDataShard(std::size_t shard) const {
+  const std::size_t first = shard * shardSize_;
+  const std::size_t last = std::min(first + shardSize_, savepointVector_->size());
+
+  // The shard has to be loaded before its file is truncated
+  savepointVector_->load(first, last);
+
+  filesystem::path shardFile = metaDataShardFile(shard);
+  std::ofstream fs(shardFile.string(), std::ios::out | std::ios::trunc);
+  if(!fs.is_open())
+    throw Exception("cannot open file: %s", shardFile);
+
+  JsonWriter writer(fs, 1);
+  savepointVector_->toJSON(writer, first, last);
+  writer.flush();
+  fs << std::endl;
 }
 
 std::vector<std::string> SerializerImpl::fieldnames() const {
+  SharedLock lock(*mutex_);
   std::vector<std::string> fields;
   fields.reserve(fieldMap_->size());
   for(auto it = fieldMap_->begin(), end = fieldMap_->end(); it != end; ++it)
@@ -110,8 +290,12 @@ SerializerImpl::checkStorageView(const std::string& name, const StorageView& sto
   if(fieldIt == fieldMap_->end())
     throw Exception("field '%s' is not registerd within the Serializer", name);
 
-  const FieldMetainfoImpl& fieldInfo = *fieldIt->second;
+  checkStorageView(name, *fieldIt->second, storageView);
+  return fieldIt->second;
+}
 
+void SerializerImpl::checkStorageView(const std::string& name, const FieldMetainfoImpl& fieldInfo,
+                                      const StorageView& storageView) {
   // Check if types match
   if(fieldInfo.type() != storageView.type())
     throw Exception("field '%s' has type '%s' but was registrered as type '%s'", name,
@@ -125,7 +309,112 @@ SerializerImpl::checkStorageView(const std::string& name, const StorageView& sto
                     name, ArrayUtil::toString(fieldInfo.dims()),
                     ArrayUtil::toString(storageView.dims()));
   }
-  return fieldIt->second;
+}
+
+//===------------------------------------------------------------------------------------------===//
+//     Halo Stripping
+//===------------------------------------------------------------------------------------------===//
+
+/// \brief Extract the halo widths of a field from its meta-information
+///
+/// \return Halo widths or an empty vector if the field has no (usable) halos
+static SerializerImpl::HaloWidths haloWidthsOf(const FieldMetainfoImpl& info,
+                                               const std::vector<int>& dims) {
+  static const char dimNames[] = "ijkl";
+  const MetainfoMapImpl& metaInfo = info.metaInfo();
+
+  SerializerImpl::HaloWidths halos(dims.size(), std::make_pair(0, 0));
+  bool hasHalos = false;
+
+  for(std::size_t i = 0; i < dims.size() && i < 4; ++i) {
+    const std::string minusKey = std::string("__") + dimNames[i] + "minushalosize";
+    const std::string plusKey = std::string("__") + dimNames[i] + "plushalosize";
+
+    if(!metaInfo.hasKey(minusKey) || !metaInfo.hasKey(plusKey))
+      continue;
+
+    int minus, plus;
+    try {
+      minus = metaInfo.as<int>(minusKey);
+      plus = metaInfo.as<int>(plusKey);
+    } catch(Exception&) {
+      return SerializerImpl::HaloWidths();
+    }
+
+    // Inconsistent halos are ignored, the full field will be stored
+    if(minus < 0 || plus < 0 || (minus + plus > 0 && minus + plus >= dims[i]))
+      return SerializerImpl::HaloWidths();
+
+    halos[i] = std::make_pair(minus, plus);
+    hasHalos |= (minus + plus > 0);
+  }
+
+  return hasHalos ? halos : SerializerImpl::HaloWidths();
+}
+
+/// \brief Construct a StorageView of the compute domain of `storageView`
+///
+/// If `storageView` is sliced, the slice is translated to the compute domain. The function returns
+/// false if the slice does not contain any element of the compute domain.
+static bool computeDomainOf(const StorageView& storageView,
+                            const SerializerImpl::HaloWidths& halos, StorageView& computeDomain) {
+  const std::vector<int>& strides = storageView.strides();
+  std::vector<int> dims(storageView.dims());
+
+  std::ptrdiff_t offset = 0;
+  for(std::size_t i = 0; i < dims.size(); ++i) {
+    offset += std::ptrdiff_t(halos[i].first) * strides[i];
+    dims[i] -= halos[i].first + halos[i].second;
+  }
+
+  computeDomain = StorageView(const_cast<Byte*>(storageView.originPtr()) +
+                                  offset * storageView.bytesPerElement(),
+                              storageView.type(), std::move(dims), strides);
+
+  const Slice& slice = storageView.getSlice();
+  if(slice.empty())
+    return true;
+
+  Slice computeDomainSlice((Slice::Empty()));
+  for(std::size_t i = 0; i < slice.sliceTriples().size(); ++i) {
+    const SliceTriple& triple = slice.sliceTriples()[i];
+    const int lower = halos[i].first;
+    const int upper = storageView.dims()[i] - halos[i].second;
+
+    // Advance the start to the first sliced index inside the compute domain
+    int start = triple.start;
+    if(start < lower)
+      start += ((lower - start + triple.step - 1) / triple.step) * triple.step;
+    int stop = std::min(triple.stop, upper);
+
+    if(start >= stop)
+      return false;
+    computeDomainSlice(start - lower, stop - lower, triple.step);
+  }
+  computeDomain.setSlice(computeDomainSlice);
+  return true;
+}
+
+const SerializerImpl::HaloWidths*
+SerializerImpl::haloWidthsForWrite(const std::string& name, const FieldMetainfoImpl& info,
+                                   const StorageView& storageView) {
+  auto it = strippedHalos_.find(name);
+  if(it != strippedHalos_.end())
+    return &it->second;
+
+  if(!haloStripping_)
+    return nullptr;
+
+  // Fields which already have data in the archive keep storing their halos
+  if(savepointVector_->findFieldAfter(-1, name) != -1)
+    return nullptr;
+
+  HaloWidths halos = haloWidthsOf(info, storageView.dims());
+  if(halos.empty())
+    return nullptr;
+
+  LOG(info) << "Stripping halos of field \"" << name << "\"";
+  return &strippedHalos_.emplace(name, std::move(halos)).first->second;
 }
 
 //===------------------------------------------------------------------------------------------===//
@@ -142,11 +431,38 @@ void SerializerImpl::write(const std::string& name, const SavepointImpl& savepoi
   if(mode_ == OpenModeKind::Read)
     throw Exception("serializer not open in write mode, but write operation requested");
 
+  std::lock_guard<SharedMutex> lock(*mutex_);
+
+  // In write-back mode the field is only committed to the archive once it is evicted
+  if(writeBackCache_ && !validator_) {
+    writeBack(name, savepoint, storageView);
+    return;
+  }
+
+  if(!writeImpl(name, savepoint, storageView))
+    return;
+
+  //
+  // 6) Update meta-data on disk
+  //
+  updateMetaDataImpl();
+
+  LOG(info) << "Successfully serialized field \"" << name << "\"";
+}
+
+bool SerializerImpl::writeImpl(const std::string& name, const SavepointImpl& savepoint,
+                               const StorageView& storageView) {
   //
   // 1) Check if field is registered within the Serializer and perform some consistency checks
   //
   auto info = checkStorageView(name, storageView);
 
+  // In validation mode the field is compared against the reference instead of being written
+  if(validator_) {
+    validator_->validate(name, savepoint, storageView);
+    return false;
+  }
+
   //
   // 2) Locate savepoint and register it if necessary
   //
@@ -167,19 +483,184 @@ void SerializerImpl::write(const std::string& name, const SavepointImpl& savepoi
   //
   // 4) Pass the StorageView to the backend Archive and perform actual data-serialization.
   //
-  FieldID fieldID = archive_->write(storageView, name, info);
+  FieldID fieldID = writeToArchive(name, info, storageView);
 
   //
   // 5) Register FieldID within Savepoint.
   //
   savepointVector_->addField(savepointIdx, fieldID);
+  markSavepointModified(savepointIdx);
+  return true;
+}
 
-  //
-  // 6) Update meta-data on disk
-  //
-  updateMetaData();
+FieldID SerializerImpl::writeToArchive(const std::string& name,
+                                       const std::shared_ptr<FieldMetainfoImpl>& info,
+                                       const StorageView& storageView) {
+  if(const HaloWidths* halos = haloWidthsForWrite(name, *info, storageView)) {
+    StorageView computeDomain(storageView);
+    computeDomainOf(storageView, *halos, computeDomain);
+    return archive_->write(computeDomain, name, info);
+  }
+  return archive_->write(storageView, name, info);
+}
 
-  LOG(info) << "Successfully serialized field \"" << name << "\"";
+//===------------------------------------------------------------------------------------------===//
+//     Write-Back Cache
+//===------------------------------------------------------------------------------------------===//
+
+void SerializerImpl::enableWriteBackCache(std::size_t capacity,
+                                          WriteBackCache::PolicyKind policy) {
+  if(mode_ == OpenModeKind::Read)
+    throw Exception("cannot enable write-back cache: serializer not open in write mode");
+
+  std::lock_guard<SharedMutex> lock(*mutex_);
+  if(writeBackCache_)
+    flushWriteBackCacheImpl();
+  writeBackCache_.reset(new WriteBackCache(capacity, policy));
+}
+
+void SerializerImpl::disableWriteBackCache() {
+  std::lock_guard<SharedMutex> lock(*mutex_);
+  if(writeBackCache_) {
+    flushWriteBackCacheImpl();
+    writeBackCache_.reset();
+  }
+}
+
+void SerializerImpl::flushWriteBackCache() {
+  std::lock_guard<SharedMutex> lock(*mutex_);
+  if(writeBackCache_)
+    flushWriteBackCacheImpl();
+}
+
+void SerializerImpl::flushWriteBackCacheImpl() {
+  if(writeBackCache_->numRecords() == 0)
+    return;
+
+  LOG(info) << "Flushing write-back cache (" << writeBackCache_->numRecords() << " records)";
+
+  // A record is only dropped from the cache once it has been committed
+  while(writeBackCache_->numRecords() > 0) {
+    commitRecord(writeBackCache_->oldest());
+    writeBackCache_->popOldest();
+  }
+  updateMetaDataImpl();
+}
+
+void SerializerImpl::writeBack(const std::string& name, const SavepointImpl& savepoint,
+                               const StorageView& storageView) {
+  auto info = checkStorageView(name, storageView);
+
+  // Decide now whether the halos are stripped, reads of the cached record depend on it
+  haloWidthsForWrite(name, *info, storageView);
+
+  int savepointIdx = savepointVector_->find(savepoint);
+  if(savepointIdx == -1) {
+    LOG(info) << "Registering new savepoint \"" << savepoint << "\"";
+    savepointIdx = savepointVector_->insert(savepoint);
+  }
+
+  writeBackCache_->insert(name, savepointIdx, storageView);
+
+  // Evict records until the cache is within its capacity, a record is only dropped from the cache
+  // once it has been committed
+  if(writeBackCache_->exceedsCapacity()) {
+    while(writeBackCache_->exceedsCapacity()) {
+      commitRecord(writeBackCache_->oldest());
+      writeBackCache_->popOldest();
+    }
+    updateMetaDataImpl();
+  }
+}
+
+void SerializerImpl::commitRecord(const WriteBackCache::Record& record) {
+  auto fieldIt = fieldMap_->findField(record.name);
+  if(fieldIt == fieldMap_->end())
+    throw Exception("field '%s' is not registerd within the Serializer", record.name);
+
+  FieldID fieldID = writeToArchive(record.name, fieldIt->second, record.toStorageView());
+
+  // A record which already exists at the savepoint is replaced
+  auto& fields = savepointVector_->fieldsOf(record.savepointIdx);
+  auto it = fields.find(record.name);
+  if(it != fields.end())
+    it->second = fieldID.id;
+  else
+    savepointVector_->addField(record.savepointIdx, fieldID);
+  markSavepointModified(record.savepointIdx);
+}
+
+void SerializerImpl::readFromWriteBackCache(const WriteBackCache::Record& record,
+                                            StorageView& storageView) const {
+  auto haloIt = strippedHalos_.find(record.name);
+  if(haloIt == strippedHalos_.end()) {
+    record.copyTo(storageView);
+    return;
+  }
+
+  StorageView computeDomain(storageView);
+  if(!computeDomainOf(storageView, haloIt->second, computeDomain))
+    return;
+
+  StorageView cachedView = record.toStorageView();
+  cachedView.setSlice(storageView.getSlice());
+  StorageView cachedComputeDomain(cachedView);
+  computeDomainOf(cachedView, haloIt->second, cachedComputeDomain);
+
+  const int bytesPerElement = storageView.bytesPerElement();
+  for(auto it = computeDomain.begin(), end = computeDomain.end(),
+           cachedIt = cachedComputeDomain.begin();
+      it != end; ++it, ++cachedIt)
+    std::memcpy(it.ptr(), cachedIt.ptr(), bytesPerElement);
+}
+
+//===------------------------------------------------------------------------------------------===//
+//     Validation
+//===------------------------------------------------------------------------------------------===//
+
+Validator& SerializerImpl::enableValidation(const std::string& directory, const std::string& prefix,
+                                            const std::string& archiveName) {
+  LOG(info) << "Enabling validation against " << directory << " (prefix = " << prefix << ")";
+
+  try {
+    if(prefix == prefix_ && filesystem::exists(directory_) &&
+       filesystem::equivalent(filesystem::path(directory), directory_))
+      throw Exception("cannot validate against the data of the serializer itself (%s)", directory);
+  } catch(filesystem::filesystem_error& e) {
+    throw Exception("filesystem error: %s", e.what());
+  }
+
+  auto validator = std::make_shared<Validator>(directory, prefix, archiveName);
+
+  // Fields held back by the write-back cache are written before validation starts
+  if(writeBackCache_) {
+    std::lock_guard<SharedMutex> lock(*mutex_);
+    flushWriteBackCacheImpl();
+  }
+
+  validator_ = validator;
+  return *validator_;
+}
+
+void SerializerImpl::disableValidation() {
+  if(!validator_)
+    return;
+
+  writeValidationReport();
+  validator_.reset();
+
+  // The serializer was opened in Write mode while validating, drop the files of the previous run
+  // now that fields are written again
+  if(clearArchiveOnValidationEnd_) {
+    clearArchiveOnValidationEnd_ = false;
+    removeMetaDataShards(0);
+    archive_->clear();
+  }
+}
+
+void SerializerImpl::writeValidationReport() const {
+  if(validator_)
+    validator_->writeReport(validationReportFile().string());
 }
 
 //===------------------------------------------------------------------------------------------===//
@@ -193,6 +674,8 @@ void SerializerImpl::read(const std::string& name, const SavepointImpl& savepoin
 
   LOG(info) << "Deserializing field \"" << name << "\" at savepoint \"" << savepoint << "\" ... ";
 
+  SharedLock lock(*mutex_);
+
   //
   // 1) Check if field is registred within the Serializer and perform some consistency checks
   //
@@ -206,29 +689,45 @@ void SerializerImpl::read(const std::string& name, const SavepointImpl& savepoin
   if(savepointIdx == -1)
     throw Exception("savepoint '%s' does not exist", savepoint.toString());
 
-  FieldID fieldID;
-  while (savepointIdx >= 0)
-  {
-      if (savepointVector_->hasField(savepointIdx, name) || !alsoPrevious)
-      {
-          fieldID = savepointVector_->getFieldID(savepointIdx, name);
-          break;
-      }
-      else
-      {
-          // If alsoPrevious is speicifed AND the field was not found,
-          // keep searching backwards
-          --savepointIdx;
-      }
+  // Records held in the write-back cache take precedence over the archive
+  if(writeBackCache_) {
+    const WriteBackCache::Record* record =
+        alsoPrevious ? writeBackCache_->findAtOrBefore(name, savepointIdx)
+                     : writeBackCache_->find(name, savepointIdx);
+    if(record && (!alsoPrevious || record->savepointIdx >= savepointVector_->findFieldAtOrBefore(
+                                                               savepointIdx, name))) {
+      readFromWriteBackCache(*record, storageView);
+      LOG(info) << "Successfully deserialized field \"" << name << "\" (write-back cache)";
+      return;
+    }
   }
 
-  if(savepointIdx == -1)
-    throw Exception("field '%s' not found at or before savepoint '%s'", name, savepoint.toString());
+  // If alsoPrevious is specified, the field is looked up in the index of the savepoints at which
+  // the field exists
+  if(alsoPrevious) {
+    savepointIdx = savepointVector_->findFieldAtOrBefore(savepointIdx, name);
+    if(savepointIdx == -1)
+      throw Exception("field '%s' not found at or before savepoint '%s'", name,
+                      savepoint.toString());
+  }
+
+  FieldID fieldID = savepointVector_->getFieldID(savepointIdx, name);
 
   //
-  // 3) Pass the StorageView to the backend Archive and perform actual data-deserialization.
+  // 3) Pass the StorageView to the backend Archive and perform actual data-deserialization. Fields
+  //    stored without halos only fill the compute domain.
   //
-  archive_->read(storageView, fieldID, info);
+  std::unique_lock<std::mutex> archiveLock(*archiveMutex_, std::defer_lock);
+  if(!archive_->isReadingThreadSafe())
+    archiveLock.lock();
+
+  auto haloIt = strippedHalos_.find(name);
+  if(haloIt != strippedHalos_.end()) {
+    StorageView computeDomain(storageView);
+    if(computeDomainOf(storageView, haloIt->second, computeDomain))
+      archive_->read(computeDomain, fieldID, info);
+  } else
+    archive_->read(storageView, fieldID, info);
 
   LOG(info) << "Successfully deserialized field \"" << name << "\"";
 }
@@ -242,13 +741,207 @@ void SerializerImpl::readSliced(const std::string& name, const SavepointImpl& sa
   this->read(name, savepoint, storageView);
 }
 
+SerializerImpl::ReadStatistics
+SerializerImpl::readSavepoint(const SavepointImpl& savepoint,
+                              std::unordered_map<std::string, StorageView>& storageViews,
+                              int numThreads) {
+  ReadStatistics statistics{0, 0, 0, 0.0};
+  if(SerializerImpl::serializationStatus() < 0)
+    return statistics;
+
+  LOG(info) << "Deserializing " << storageViews.size() << " fields at savepoint \"" << savepoint
+            << "\" ... ";
+
+  Timer timer;
+  SharedLock lock(*mutex_);
+
+  int savepointIdx = savepointVector_->find(savepoint);
+  if(savepointIdx == -1)
+    throw Exception("savepoint '%s' does not exist", savepoint.toString());
+
+  struct Request {
+    Archive::RecordLocation location;
+    FieldID fieldID;
+    std::shared_ptr<FieldMetainfoImpl> info;
+    StorageView storageView;
+  };
+
+  // Locate all records upfront to fail before anything is read
+  std::vector<Request> requests;
+  requests.reserve(storageViews.size());
+
+  for(auto& fieldView : storageViews) {
+    const std::string& name = fieldView.first;
+    StorageView& storageView = fieldView.second;
+    auto info = checkStorageView(name, storageView);
+
+    if(writeBackCache_) {
+      if(const WriteBackCache::Record* record = writeBackCache_->find(name, savepointIdx)) {
+        readFromWriteBackCache(*record, storageView);
+        statistics.numBytes += storageView.sizeInBytes();
+        ++statistics.numFields;
+        continue;
+      }
+    }
+
+    FieldID fieldID = savepointVector_->getFieldID(savepointIdx, name);
+
+    // Fields stored without halos only fill the compute domain
+    StorageView computeDomain(storageView);
+    auto haloIt = strippedHalos_.find(name);
+    if(haloIt != strippedHalos_.end() &&
+       !computeDomainOf(storageView, haloIt->second, computeDomain))
+      continue;
+
+    requests.push_back(Request{archive_->locate(fieldID), fieldID, info, computeDomain});
+  }
+
+  // Sort the records by file and offset and split them into one group per file
+  std::sort(requests.begin(), requests.end(), [](const Request& a, const Request& b) {
+    return (a.location.file != b.location.file ? a.location.file < b.location.file
+                                               : a.location.offset < b.location.offset);
+  });
+
+  std::vector<std::size_t> groups;
+  for(std::size_t i = 0; i < requests.size(); ++i)
+    if(i == 0 || requests[i].location.file.empty() ||
+       requests[i].location.file != requests[i - 1].location.file)
+      groups.push_back(i);
+  groups.push_back(requests.size());
+
+  const std::size_t numGroups = groups.size() - 1;
+
+  if(numThreads <= 0)
+    numThreads = int(std::thread::hardware_concurrency());
+  if(!archive_->isReadingThreadSafe())
+    numThreads = 1;
+  numThreads = std::max(1, std::min(numThreads, int(numGroups)));
+
+  std::unique_lock<std::mutex> archiveLock(*archiveMutex_, std::defer_lock);
+  if(!archive_->isReadingThreadSafe())
+    archiveLock.lock();
+
+  std::atomic<std::size_t> nextGroup(0);
+  std::atomic<bool> aborted(false);
+  std::mutex errorMutex;
+  std::exception_ptr error;
+
+  auto reader = [&]() {
+    for(std::size_t g = nextGroup++; g < numGroups && !aborted; g = nextGroup++) {
+      try {
+        for(std::size_t i = groups[g]; i < groups[g + 1]; ++i)
+          archive_->read(requests[i].storageView, requests[i].fieldID, requests[i].info);
+      } catch(...) {
+        std::lock_guard<std::mutex> errorLock(errorMutex);
+        if(!error)
+          error = std::current_exception();
+        aborted = true;
+      }
+    }
+  };
+
+  if(numThreads == 1)
+    reader();
+  else {
+    std::vector<std::thread> threads;
+    for(int i = 0; i < numThreads; ++i)
+      threads.emplace_back(reader);
+    for(auto& thread : threads)
+      thread.join();
+  }
+
+  if(error)
+    std::rethrow_exception(error);
+
+  for(const Request& request : requests)
+    statistics.numBytes += request.storageView.sizeInBytes();
+  statistics.numFields += requests.size();
+  statistics.numFiles = numGroups;
+  statistics.milliseconds = timer.stop();
+
+  LOG(info) << "Successfully deserialized " << statistics.numFields << " fields ("
+            << statistics.bandwidth() << " MB/s)";
+  return statistics;
+}
+
+std::size_t SerializerImpl::BatchReadResult::numFailed() const noexcept {
+  return std::count_if(entries.begin(), entries.end(),
+                       [](const Entry& entry) { return !entry.success; });
+}
+
+std::vector<std::size_t> SerializerImpl::BatchReadResult::failed() const {
+  std::vector<std::size_t> indices;
+  for(std::size_t i = 0; i < entries.size(); ++i)
+    if(!entries[i].success)
+      indices.push_back(i);
+  return indices;
+}
+
+std::string SerializerImpl::BatchReadResult::toString() const {
+  std::stringstream ss;
+  ss << numFailed() << " of " << entries.size() << " reads failed";
+  for(const Entry& entry : entries)
+    if(!entry.success)
+      ss << "\n  field '" << entry.name << "' at savepoint '" << entry.savepoint
+         << "': " << entry.error;
+  return ss.str();
+}
+
+SerializerImpl::BatchReadResult SerializerImpl::readBatch(std::vector<ReadRequest>& requests,
+                                                          int numThreads) {
+  BatchReadResult result;
+  result.entries.reserve(requests.size());
+  for(const ReadRequest& request : requests)
+    result.entries.push_back(
+        BatchReadResult::Entry{request.name, request.savepoint.toString(), false, ""});
+
+  if(numThreads <= 0)
+    numThreads = int(std::thread::hardware_concurrency());
+  if(!archive_->isReadingThreadSafe())
+    numThreads = 1;
+  numThreads = std::max(1, std::min(numThreads, int(requests.size())));
+
+  // Each request is read by exactly one thread which records its outcome
+  std::atomic<std::size_t> nextRequest(0);
+  auto reader = [&]() {
+    for(std::size_t i = nextRequest++; i < requests.size(); i = nextRequest++) {
+      try {
+        this->read(requests[i].name, requests[i].savepoint, requests[i].storageView);
+        result.entries[i].success = true;
+      } catch(std::exception& e) {
+        result.entries[i].error = e.what();
+      }
+    }
+  };
+
+  if(numThreads == 1)
+    reader();
+  else {
+    std::vector<std::thread> threads;
+    for(int i = 0; i < numThreads; ++i)
+      threads.emplace_back(reader);
+    for(auto& thread : threads)
+      thread.join();
+  }
+
+  if(!result.success())
+    LOG(warning) << "SerializerImpl: " << result.toString();
+  return result;
+}
+
 // This is the global task vector. If we would put the tasks inside SerializerImpl, we would have a
 // conditional member in a class (i.e depending on a macro) which can cause trouble if someone
 // compiled the library with SERIALBOX_ASYNC_API but doesn't use it when linking the library which
 // will smash the stack!
 #ifdef SERIALBOX_ASYNC_API
 namespace global {
-static std::vector<std::future<void>> tasks;
+struct Task {
+  std::string name;
+  std::string savepoint;
+  std::future<void> future;
+};
+static std::vector<Task> tasks;
+static std::mutex tasksMutex;
 }
 #endif
 
@@ -262,27 +955,48 @@ void SerializerImpl::readAsync(const std::string& name, const SavepointImpl& sav
 #ifdef SERIALBOX_ASYNC_API
   if(!archive_->isReadingThreadSafe())
     this->read(name, savepoint, storageView);
-  else
+  else {
     // Bad things can happen if we forward the refrences and directly call the SerializerImpl::read,
     // we thus just make a copy of the arguments.
-    global::tasks.emplace_back(std::async(std::launch::async, &SerializerImpl::readAsyncImpl, this,
-                                          name, savepoint, storageView));
+    std::lock_guard<std::mutex> lock(global::tasksMutex);
+    global::tasks.push_back(
+        global::Task{name, savepoint.toString(),
+                     std::async(std::launch::async, &SerializerImpl::readAsyncImpl, this, name,
+                                savepoint, storageView)});
+  }
 #else
   this->read(name, savepoint, storageView);
 #endif
 }
 
 void SerializerImpl::waitForAll() {
+  BatchReadResult result = waitForAllResults();
+  if(!result.success())
+    throw Exception("%s", result.toString());
+}
+
+SerializerImpl::BatchReadResult SerializerImpl::waitForAllResults() {
+  BatchReadResult result;
 #ifdef SERIALBOX_ASYNC_API
-  try {
-    for(auto& task : global::tasks)
-      task.get();
-  } catch(std::exception& e) {
-    global::tasks.clear();
-    throw Exception(e.what());
+  std::vector<global::Task> tasks;
+  {
+    std::lock_guard<std::mutex> lock(global::tasksMutex);
+    tasks.swap(global::tasks);
+  }
+
+  // Wait for all tasks, a failed task does not abort the others
+  for(auto& task : tasks) {
+    BatchReadResult::Entry entry{task.name, task.savepoint, true, ""};
+    try {
+      task.future.get();
+    } catch(std::exception& e) {
+      entry.success = false;
+      entry.error = e.what();
+    }
+    result.entries.push_back(std::move(entry));
   }
-  global::tasks.clear();
 #endif
+  return result;
 }
 
 //===------------------------------------------------------------------------------------------===//
@@ -292,54 +1006,88 @@ void SerializerImpl::waitForAll() {
 void SerializerImpl::constructMetaDataFromJson() {
   LOG(info) << "Constructing Serializer from MetaData ... ";
 
-  // Try open meta-data file
-  if(!filesystem::exists(metaDataFile_)) {
+  // Try open meta-data file (opening it directly saves probing for it)
+  std::ifstream fs(metaDataFile_.string(), std::ios::in);
+  if(!fs.is_open()) {
     if(mode_ != OpenModeKind::Read)
       return;
-    else
-      throw Exception("cannot create Serializer: MetaData-%s.json not found in %s", prefix_,
-                      directory_);
+    if(!filesystem::exists(directory_))
+      throw Exception("cannot create Serializer: directory %s does not exist", directory_);
+    throw Exception("cannot create Serializer: MetaData-%s.json not found in %s", prefix_,
+                    directory_);
   }
 
-  json::json jsonNode;
-  try {
-    std::ifstream fs(metaDataFile_.string(), std::ios::in);
-    fs >> jsonNode;
-    fs.close();
-  } catch(std::exception& e) {
-    throw Exception("JSON parser error: %s", e.what());
-  }
+  // When writing, the meta-data is dropped anyway
+  const bool isWriting = (mode_ == OpenModeKind::Write);
 
+  // The meta-data is parsed in a streaming fashion, the large parts (i.e the savepoints) are
+  // constructed directly from the token stream
   try {
-    // Check consistency
-    if(!jsonNode.count("serialbox_version"))
-      throw Exception("node 'serialbox_version' not found");
+    JsonReader reader(fs);
+    bool hasSerialboxVersion = false, hasPrefix = false;
+    std::string key;
+
+    reader.beginObject();
+    while(reader.nextMember(key)) {
+      if(key == "serialbox_version") {
+        // Check consistency
+        int serialboxVersion = reader.readInteger();
+        hasSerialboxVersion = true;
+
+        if(!Version::isCompatible(serialboxVersion))
+          throw Exception(
+              "serialbox version of MetaData (%s) does not match the version of the library (%s)",
+              Version::toString(serialboxVersion), SERIALBOX_VERSION_STRING);
+
+      } else if(key == "prefix") {
+        // Check if prefix match
+        std::string prefix = reader.readString();
+        hasPrefix = true;
+
+        if(prefix != prefix_)
+          throw Exception("inconsistent prefixes: expected '%s' got '%s'", prefix, prefix_);
+
+      } else if(isWriting && key != "savepoint_shards") {
+        reader.skipValue();
+
+      } else if(key == "global_meta_info") {
+        // Construct globalMetainfo
+        globalMetainfo_->fromJSON(reader);
+
+      } else if(key == "savepoint_vector") {
+        // Construct Savepoints
+        savepointVector_->fromJSON(reader);
+
+      } else if(key == "savepoint_shards") {
+        // Construct Savepoints from the shards listed in the manifest
+        readMetaDataShards(reader);
+
+      } else if(key == "field_map") {
+        // Construct FieldMap
+        fieldMap_->fromJSON(reader.readValue());
+
+      } else if(key == "stripped_halos") {
+        // Construct halo widths of the fields stored without halos
+        const json::json haloNode = reader.readValue();
+        for(auto it = haloNode.begin(), end = haloNode.end(); it != end; ++it) {
+          HaloWidths halos;
+          for(const auto& dimNode : it.value())
+            halos.emplace_back(int(dimNode[0]), int(dimNode[1]));
+          strippedHalos_[it.key()] = std::move(halos);
+        }
 
-    int serialboxVersion = jsonNode["serialbox_version"];
+      } else
+        reader.skipValue();
+    }
+    reader.end();
 
-    if(!Version::isCompatible(serialboxVersion))
-      throw Exception(
-          "serialbox version of MetaData (%s) does not match the version of the library (%s)",
-          Version::toString(serialboxVersion), SERIALBOX_VERSION_STRING);
+    if(!hasSerialboxVersion)
+      throw Exception("node 'serialbox_version' not found");
 
-    // Check if prefix match
-    if(!jsonNode.count("prefix"))
+    if(!hasPrefix)
       throw Exception("node 'prefix' not found");
 
-    if(jsonNode["prefix"] != prefix_)
-      throw Exception("inconsistent prefixes: expected '%s' got '%s'", jsonNode["prefix"], prefix_);
-
-    // Construct globalMetainfo
-    if(jsonNode.count("global_meta_info"))
-      globalMetainfo_->fromJSON(jsonNode["global_meta_info"]);
-
-    // Construct Savepoints
-    if(jsonNode.count("savepoint_vector"))
-      savepointVector_->fromJSON(jsonNode["savepoint_vector"]);
-
-    // Construct FieldMap
-    if(jsonNode.count("field_map"))
-      fieldMap_->fromJSON(jsonNode["field_map"]);
+    numPersistedSavepoints_ = savepointVector_->size();
 
   } catch(Exception& e) {
     throw Exception("error while parsing %s: %s", metaDataFile_, e.what());
@@ -347,6 +1095,7 @@ void SerializerImpl::constructMetaDataFromJson() {
 }
 
 std::string SerializerImpl::toString() const {
+  SharedLock lock(*mutex_);
   std::stringstream ss;
   ss << "mode = " << mode_ << "\n";
   ss << "directory = " << directory_ << "\n";
@@ -370,6 +1119,7 @@ std::ostream& operator<<(std::ostream& stream, const SerializerImpl& s) {
 
 json::json SerializerImpl::toJSON() const {
   LOG(info) << "Converting Serializer MetaData to JSON";
+  SharedLock lock(*mutex_);
 
   json::json jsonNode;
 
@@ -389,28 +1139,126 @@ json::json SerializerImpl::toJSON() const {
   // Serialize FieldMap
   jsonNode["field_map"] = fieldMap_->toJSON();
 
+  // Serialize halo widths of the fields stored without halos
+  if(!strippedHalos_.empty()) {
+    for(const auto& fieldHalos : strippedHalos_) {
+      json::json haloNode = json::json::array();
+      for(const auto& halo : fieldHalos.second)
+        haloNode.push_back({halo.first, halo.second});
+      jsonNode["stripped_halos"][fieldHalos.first] = haloNode;
+    }
+  }
+
   return jsonNode;
 }
 
 void SerializerImpl::updateMetaData() {
+  std::lock_guard<SharedMutex> lock(*mutex_);
+  updateMetaDataImpl();
+}
+
+void SerializerImpl::updateMetaDataImpl() {
+  // In validation mode the meta-data and the archive on disk are left untouched
+  if(validator_) {
+    writeValidationReport();
+    return;
+  }
+
   LOG(info) << "Update MetaData of Serializer";
 
-  json::json jsonNode = toJSON();
+  // Write the new and modified shards before the manifest which refers to them
+  std::size_t numShards = 0;
+  if(shardSize_ > 0) {
+    numShards = (savepointVector_->size() + shardSize_ - 1) / shardSize_;
+    for(std::size_t shard = numPersistedSavepoints_ / shardSize_; shard < numShards; ++shard)
+      modifiedShards_.insert(shard);
+
+    for(std::size_t shard : modifiedShards_)
+      if(shard < numShards)
+        writeMetaDataShard(shard);
+
+    modifiedShards_.clear();
+    numPersistedSavepoints_ = savepointVector_->size();
+  }
 
   // Write metaData to disk (just overwrite the file, we assume that there is never more than one
   // Serializer per data set and thus our in-memory copy is always the up-to-date one)
   std::ofstream fs(metaDataFile_.string(), std::ios::out | std::ios::trunc);
   if(!fs.is_open())
     throw Exception("cannot open file: %s", metaDataFile_);
-  fs << jsonNode.dump(1) << std::endl;
+
+  // The meta-data is streamed to disk, this produces the same document as toJSON() without
+  // building the DOM of all savepoints
+  JsonWriter writer(fs, 1);
+  writer.beginObject();
+
+  writer.key("field_map");
+  writer.value(fieldMap_->toJSON());
+
+  writer.key("global_meta_info");
+  globalMetainfo_->toJSON(writer);
+
+  writer.key("prefix");
+  writer.value(prefix_);
+
+  if(shardSize_ > 0) {
+    writer.key("savepoint_shards");
+    writer.beginObject();
+    writer.key("shard_size");
+    writer.value(static_cast<std::uint64_t>(shardSize_));
+    writer.key("shards");
+    writer.beginArray();
+    for(std::size_t shard = 0; shard < numShards; ++shard)
+      writer.value(metaDataShardFile(shard).filename().string());
+    writer.endArray();
+    writer.endObject();
+  } else {
+    writer.key("savepoint_vector");
+    savepointVector_->toJSON(writer);
+  }
+
+  writer.key("serialbox_version");
+  writer.value(100 * SERIALBOX_VERSION_MAJOR + 10 * SERIALBOX_VERSION_MINOR +
+               SERIALBOX_VERSION_PATCH);
+
+  if(!strippedHalos_.empty()) {
+    writer.key("stripped_halos");
+    writer.beginObject();
+    for(const auto& fieldHalos : strippedHalos_) {
+      writer.key(fieldHalos.first);
+      writer.beginArray();
+      for(const auto& halo : fieldHalos.second) {
+        writer.beginArray();
+        writer.value(halo.first);
+        writer.value(halo.second);
+        writer.endArray();
+      }
+      writer.endArray();
+    }
+    writer.endObject();
+  }
+
+  writer.endObject();
+  fs << std::endl;
   fs.close();
 
+  // Remove the shards which are no longer referenced
+  removeMetaDataShards(numShards);
+  numShardFiles_ = numShards;
+
   // Update archive meta-data
   archive_->updateMetaData();
 }
 
 void SerializerImpl::constructArchive(const std::string& archiveName) {
-  archive_ = ArchiveFactory::create(archiveName, mode_, directory_.string(), prefix_);
+  // Opening the archive in Write mode drops its files, in validation mode this is deferred until
+  // validation is disabled
+  OpenModeKind mode = mode_;
+  if(mode_ == OpenModeKind::Write && validator_) {
+    mode = OpenModeKind::Append;
+    clearArchiveOnValidationEnd_ = true;
+  }
+  archive_ = ArchiveFactory::create(archiveName, mode, directory_.string(), prefix_);
 }
 
 //===------------------------------------------------------------------------------------------===//
@@ -424,7 +1272,15 @@ bool SerializerImpl::upgradeMetaData() {
   // Check if upgrade is necessary
   //
 
+  if(ArchiveFactory::trustMetaData())
+    return false;
+
   try {
+    // Old archives cannot be written or appended to, don't probe for the old meta-data if we are
+    // writing to an archive in the current format
+    if(mode_ != OpenModeKind::Read && filesystem::exists(metaDataFile_))
+      return false;
+
     // Check if prefix.json exists
     if(!filesystem::exists(oldMetaDataFile))
       return false;
@@ -619,7 +1475,8 @@ bool SerializerImpl::upgradeMetaData() {
         std::string fieldname = it.key();
 
         FieldID fieldID{fieldname, 0};
-        BinaryArchive::FileOffsetType fileOffset{it.value()[0], it.value()[1]};
+        BinaryArchive::FileOffsetType fileOffset{it.value()[0], it.value()[1],
+                                                 BinaryArchive::EncodingKind::Dense};
 
         // Insert offsets into the field table (This mimics the write operation of the
         // Binary archive)
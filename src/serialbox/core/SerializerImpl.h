@@ -20,12 +20,23 @@
 #include "serialbox/core/Json.h"
 #include "serialbox/core/MetainfoMapImpl.h"
 #include "serialbox/core/SavepointVector.h"
+#include "serialbox/core/SharedMutex.h"
 #include "serialbox/core/StorageView.h"
+#include "serialbox/core/WriteBackCache.h"
 #include "serialbox/core/archive/Archive.h"
 #include <iosfwd>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <string>
+#include <unordered_map>
+#include <utility>
 
 namespace serialbox {
 
+class SerializerSession;
+class Validator;
+
 /// \addtogroup core
 /// @{
 
@@ -33,8 +44,78 @@ namespace serialbox {
 ///
 /// Direct usage of this class is discouraged, use the Serializer classes provided by the Frontends
 /// instead.
+///
+/// \par Thread-safety
+/// The Serializer is internally synchronized by a reader-writer lock: reading fields and querying
+/// the meta-data (SerializerImpl::read, SerializerImpl::hasField, SerializerImpl::fieldnames, ...)
+/// can be done concurrently from any number of threads while writing fields and modifying the
+/// meta-data (SerializerImpl::write, SerializerImpl::registerField,
+/// SerializerImpl::registerSavepoint, SerializerImpl::updateMetaData, ...) acquire the Serializer
+/// exclusively. Reads of archives which are not thread-safe (see Archive::isReadingThreadSafe) are
+/// serialized. Writes are always serialized as they modify the meta-data of the archive and the
+/// Serializer.
+///
+/// The guarantees only cover the methods of this class. The references to the savepoint vector,
+/// the field map, the global meta-information and the archive as well as the references returned
+/// by SerializerImpl::getFieldMetainfoImplOf are not protected and must not be accessed while
+/// other threads write to the Serializer. The configuration (halo stripping, meta-data sharding
+/// and validation) should be set before the Serializer is shared between threads.
 class SerializerImpl {
+  friend class SerializerSession;
+
 public:
+  /// \brief Widths of the halos (`minus`, `plus`) in each dimension of a field
+  using HaloWidths = std::vector<std::pair<int, int>>;
+
+  /// \brief Statistics of SerializerImpl::readSavepoint
+  struct ReadStatistics {
+    std::size_t numFields; ///< Number of deserialized fields
+    std::size_t numFiles;  ///< Number of distinct files the fields were read from
+    std::size_t numBytes;  ///< Number of deserialized bytes
+    double milliseconds;   ///< Elapsed wall-clock time
+
+    /// \brief Achieved bandwidth in MB/s
+    double bandwidth() const noexcept {
+      return (milliseconds > 0 ? numBytes / (1e3 * milliseconds) : 0.0);
+    }
+  };
+
+  /// \brief Request of SerializerImpl::readBatch
+  struct ReadRequest {
+    std::string name;        ///< Name of the field
+    SavepointImpl savepoint; ///< Savepoint at which the field will be deserialized
+    StorageView storageView; ///< StorageView of the field
+  };
+
+  /// \brief Outcome of a batch of reads (see SerializerImpl::readBatch and
+  /// SerializerImpl::waitForAllResults)
+  ///
+  /// A failed read does not abort the other reads of the batch, hence only the failed entries need
+  /// to be read again.
+  struct BatchReadResult {
+    /// \brief Outcome of a single read
+    struct Entry {
+      std::string name;      ///< Name of the field
+      std::string savepoint; ///< Savepoint of the field
+      bool success;          ///< The field was read
+      std::string error;     ///< Error message of a failed read
+    };
+
+    std::vector<Entry> entries;
+
+    /// \brief Check if all reads succeeded
+    bool success() const noexcept { return (numFailed() == 0); }
+
+    /// \brief Get the number of failed reads
+    std::size_t numFailed() const noexcept;
+
+    /// \brief Get the indices of the failed entries
+    std::vector<std::size_t> failed() const;
+
+    /// \brief Describe the failed reads
+    std::string toString() const;
+  };
+
   /// \brief Get the status of serialization
   ///
   /// The status is represented as an integer which can take the following values:
@@ -98,6 +179,9 @@ public:
   SerializerImpl(OpenModeKind mode, const std::string& directory, const std::string& prefix,
                  const std::string& archiveName);
 
+  /// \brief Write the validation report and commit the records held in the write-back cache
+  ~SerializerImpl();
+
   /// \brief Access the mode of the serializer
   OpenModeKind mode() const noexcept { return mode_; }
 
@@ -110,12 +194,137 @@ public:
   /// \brief Name of the archive in use
   std::string archiveName() const noexcept { return archive_->name(); }
 
+  /// \brief Access the archive in use
+  Archive& archive() noexcept { return *archive_; }
+  const Archive& archive() const noexcept { return *archive_; }
+
   /// \brief Access the path to the meta-data file
   const filesystem::path& metaDataFile() const noexcept { return metaDataFile_; }
 
+  //===----------------------------------------------------------------------------------------===//
+  //     Halo Stripping
+  //===----------------------------------------------------------------------------------------===//
+
+  /// \brief Only store the compute domain of fields which carry halo meta-information
+  ///
+  /// Fields registered with the halo sizes `__iminushalosize`, `__iplushalosize`, ...,
+  /// `__lplushalosize` (as done by the STELLA and Fortran frontends) are written without their
+  /// halos. The halo widths are recorded in the meta-data (see SerializerImpl::strippedHalos) and
+  /// reading such a field only fills the compute domain of the StorageView, the halos are left
+  /// untouched.
+  ///
+  /// Halo stripping is disabled by default. The decision is taken once per field, at its first
+  /// write: fields which already have data in the archive keep their full layout.
+  void enableHaloStripping() noexcept { haloStripping_ = true; }
+
+  /// \brief Write the full field, including the halos (default)
+  ///
+  /// Fields which have already been written without halos keep being stored without halos.
+  void disableHaloStripping() noexcept { haloStripping_ = false; }
+
+  /// \brief Check if halo stripping is enabled
+  bool isHaloStrippingEnabled() const noexcept { return haloStripping_; }
+
+  /// \brief Get the fields which are stored without halos mapped to their halo widths
+  ///
+  /// Adding a field is only required if its records are written directly to the archive (e.g when
+  /// copying records between archives).
+  std::unordered_map<std::string, HaloWidths>& strippedHalos() noexcept { return strippedHalos_; }
+  const std::unordered_map<std::string, HaloWidths>& strippedHalos() const noexcept {
+    return strippedHalos_;
+  }
+
+  //===----------------------------------------------------------------------------------------===//
+  //     Meta-Data Sharding
+  //===----------------------------------------------------------------------------------------===//
+
+  /// \brief Split the savepoints of the meta-data into shards of `savepointsPerShard` savepoints
+  ///
+  /// `MetaData-prefix.json` becomes a manifest holding the global meta-information, the field map
+  /// and the list of shards, while the savepoints are stored in `MetaData-prefix.shard-N.json`.
+  /// Updating the meta-data only rewrites the manifest and the shards whose savepoints changed
+  /// (usually only the last one) instead of the savepoints of the whole run.
+  ///
+  /// Sharding is disabled by default. It is also enabled if the Serializer is opened in `Write` or
+  /// `Append` mode and the environment variable `SERIALBOX_METADATA_SHARD_SIZE` is set to a
+  /// positive value. Sharded meta-data which is appended to keeps its shard size.
+  ///
+  /// When sharded meta-data is opened in `Read` or `Append` mode only the manifest and the last
+  /// shard are parsed, the other shards are loaded once one of their savepoints is accessed (see
+  /// SavepointVector::setLazyShards). Registering a new savepoint hence loads the remaining shards
+  /// once, as it has to be checked against all stored savepoints, while writing to the savepoints
+  /// of the last shard leaves them unloaded.
+  ///
+  /// \throw Exception  `savepointsPerShard` is 0
+  void enableMetaDataSharding(std::size_t savepointsPerShard);
+
+  /// \brief Store all savepoints in `MetaData-prefix.json` (default)
+  void disableMetaDataSharding() noexcept;
+
+  /// \brief Check if the savepoints of the meta-data are split into shards
+  bool isMetaDataShardingEnabled() const noexcept { return (shardSize_ > 0); }
+
+  /// \brief Get the number of savepoints per shard (0 if sharding is disabled)
+  std::size_t metaDataShardSize() const noexcept { return shardSize_; }
+
+  /// \brief Record that the savepoint `idx` changed since the last update of the meta-data
+  ///
+  /// This is only required if the savepoint vector is modified directly (e.g by remapping the
+  /// FieldIDs of a savepoint), such that the shard of the savepoint is rewritten.
+  void markSavepointModified(int idx) {
+    if(shardSize_ > 0 && std::size_t(idx) < numPersistedSavepoints_)
+      modifiedShards_.insert(idx / shardSize_);
+  }
+
+  /// \brief Access the path to the meta-data shard `shard`
+  filesystem::path metaDataShardFile(std::size_t shard) const {
+    return directory_ / ("MetaData-" + prefix_ + ".shard-" + std::to_string(shard) + ".json");
+  }
+
+  //===----------------------------------------------------------------------------------------===//
+  //     Write-Back Cache
+  //===----------------------------------------------------------------------------------------===//
+
+  /// \brief Hold the written fields in a write-back cache of `capacity` bytes
+  ///
+  /// In write-back mode SerializerImpl::write copies the field to an in-memory cache keyed by field
+  /// and savepoint instead of writing it to the archive. Writing a field at a savepoint at which it
+  /// is already cached (e.g in each iteration of an outer solver loop) replaces the cached data
+  /// without any I/O. Records are only committed to the archive when they are evicted from the
+  /// cache (see WriteBackCache::PolicyKind), when the cache is flushed or disabled and when the
+  /// Serializer is destroyed. A committed record replaces the record of the field at the same
+  /// savepoint, if any, such that only the last write is kept. A record which fails to be
+  /// committed (e.g due to an I/O error) is kept in the cache.
+  ///
+  /// Note that this changes the semantics of writing a field twice at the same savepoint: without
+  /// the cache SerializerImpl::write throws, with the cache the last write replaces the earlier
+  /// one. This also applies if the cache is enabled via `SERIALBOX_WRITE_BACK_CACHE_SIZE`.
+  ///
+  /// The savepoints are registered right away but the cached fields are only visible to
+  /// SerializerImpl::read until they are committed. The write-back cache is also enabled if the
+  /// Serializer is opened in `Write` or `Append` mode and the environment variable
+  /// `SERIALBOX_WRITE_BACK_CACHE_SIZE` is set to a positive value (in bytes).
+  ///
+  /// \throw Exception  Serializer is opened in `Read` mode
+  void enableWriteBackCache(std::size_t capacity,
+                            WriteBackCache::PolicyKind policy = WriteBackCache::PolicyKind::LRU);
+
+  /// \brief Commit the cached records and write directly to the archive again (default)
+  void disableWriteBackCache();
+
+  /// \brief Commit the cached records to the archive and update the meta-data on disk
+  void flushWriteBackCache();
+
+  /// \brief Check if the writes are held in a write-back cache
+  bool isWriteBackCacheEnabled() const noexcept { return (writeBackCache_ != nullptr); }
+
+  /// \brief Get the write-back cache (`nullptr` if the write-back cache is disabled)
+  const WriteBackCache* writeBackCache() const noexcept { return writeBackCache_.get(); }
+
   /// \brief Drop all field and savepoint meta-data.
   ///
-  /// This will also call Archive::clear() which may \b remove all related files on the disk.
+  /// This removes the meta-data shards and calls Archive::clear() which may \b remove all related
+  /// files on the disk.
   void clear() noexcept;
 
   //===----------------------------------------------------------------------------------------===//
@@ -130,6 +339,7 @@ public:
   /// \throw Exception  Value cannot be inserted as it already exists
   template <class StringType, class ValueType>
   void addGlobalMetainfo(StringType&& key, ValueType&& value) {
+    std::lock_guard<SharedMutex> lock(*mutex_);
     if(!globalMetainfo_->insert(std::forward<StringType>(key), std::forward<ValueType>(value)))
       throw Exception("cannot add element with key '%s' to globalMetainfo: element already exists",
                       key);
@@ -143,6 +353,7 @@ public:
   ///                   converted to type `T`
   template <class T, class StringType>
   T getGlobalMetainfoAs(StringType&& key) const {
+    SharedLock lock(*mutex_);
     try {
       return globalMetainfo_->at(key).template as<T>();
     } catch(Exception& e) {
@@ -172,6 +383,7 @@ public:
   /// \throw Exception  Field with same name already exists
   template <class StringType, typename... Args>
   void registerField(StringType&& name, Args&&... args) {
+    std::lock_guard<SharedMutex> lock(*mutex_);
     if(!fieldMap_->insert(std::forward<StringType>(name), std::forward<Args>(args)...))
       throw Exception("cannot register field '%s': field already exists", name);
   }
@@ -182,6 +394,7 @@ public:
   /// \return True iff the field is present
   template <class StringType>
   bool hasField(StringType&& name) const noexcept {
+    SharedLock lock(*mutex_);
     return fieldMap_->hasField(std::forward<StringType>(name));
   }
 
@@ -195,6 +408,7 @@ public:
   /// \throw Exception  Field with name `name` does not exist in FieldMap
   template <class StringType, class KeyType, class ValueType>
   bool addFieldMetainfoImpl(StringType&& name, KeyType&& key, ValueType&& value) {
+    std::lock_guard<SharedMutex> lock(*mutex_);
     return fieldMap_->getMetainfoOf(name).insert(std::forward<KeyType>(key),
                                                  std::forward<ValueType>(value));
   }
@@ -206,6 +420,7 @@ public:
   /// \throw Exception  Field `name` does not exist in FieldMap
   template <class StringType>
   const FieldMetainfoImpl& getFieldMetainfoImplOf(StringType&& name) const {
+    SharedLock lock(*mutex_);
     return fieldMap_->getFieldMetainfoImplOf(std::forward<StringType>(name));
   }
 
@@ -230,28 +445,35 @@ public:
   /// \param Args  Arguments forwarded to the constructor of Savepoint
   /// \return True iff the savepoint was successfully inserted
   template <typename... Args>
-  bool registerSavepoint(Args&&... args) noexcept {
+  bool registerSavepoint(Args&&... args) {
+    std::lock_guard<SharedMutex> lock(*mutex_);
     return (savepointVector_->insert(SavepointImpl(std::forward<Args>(args)...)) != -1);
   }
 
   /// \brief Add a field to the savepoint
   /// \return True iff the field was successfully addeed to the savepoint
-  bool addFieldToSavepoint(const SavepointImpl& savepoint, const FieldID& fieldID) noexcept {
-    return savepointVector_->addField(savepoint, fieldID);
+  bool addFieldToSavepoint(const SavepointImpl& savepoint, const FieldID& fieldID) {
+    std::lock_guard<SharedMutex> lock(*mutex_);
+    int idx = savepointVector_->find(savepoint);
+    if(idx == -1 || !savepointVector_->addField(idx, fieldID))
+      return false;
+    markSavepointModified(idx);
+    return true;
   }
 
   /// \brief Get the FielID of field `field` at savepoint `savepoint`
   ///
   /// \throw Exception  Savepoint or field at savepoint do not exist
   FieldID getFieldIDAtSavepoint(const SavepointImpl& savepoint, const std::string& field) const {
+    SharedLock lock(*mutex_);
     return savepointVector_->getFieldID(savepoint, field);
   }
 
   /// \brief Get refrence to savepoint vector
-  const SavepointVector::savepoint_vector_type& savepoints() const noexcept {
+  const SavepointVector::savepoint_vector_type& savepoints() const {
     return savepointVector_->savepoints();
   }
-  SavepointVector::savepoint_vector_type& savepoints() noexcept {
+  SavepointVector::savepoint_vector_type& savepoints() {
     return savepointVector_->savepoints();
   }
 
@@ -275,14 +497,15 @@ public:
   ///
   /// 1. Check if field `name` is registred within the Serializer and perform a consistency check
   ///    concering the data-type and dimensions of the StorageView compared to to the registered
-  ///    field.
+  ///    field. In validation mode, compare the field against the reference and stop.
   ///
   /// 2. Locate the `savepoint` in the savepoint vector and, if the `savepoint` does not exist,
   ///    register it within the Serializer.
   ///
   /// 3. Check if field `name` can be added to Savepoint.
   ///
-  /// 4. Pass the StorageView to the backend Archive and perform actual data-serialization.
+  /// 4. Pass the StorageView (or only its compute domain if the halos of the field are stripped)
+  ///    to the backend Archive and perform actual data-serialization.
   ///
   /// 5. Register field `name` within the Savepoint.
   ///
@@ -299,6 +522,56 @@ public:
   void write(const std::string& name, const SavepointImpl& savepoint,
              const StorageView& storageView);
 
+  //===----------------------------------------------------------------------------------------===//
+  //     Validation
+  //===----------------------------------------------------------------------------------------===//
+
+  /// \brief Compare all subsequent writes against a reference instead of writing them
+  ///
+  /// In validation mode SerializerImpl::write does not write any data. Each field is compared
+  /// against the record of the same field at the same savepoint of the reference (see Validator)
+  /// and only the mismatches and per-field statistics are recorded. They are written to
+  /// `ValidationReport-prefix.json` when the meta-data is updated, when validation is disabled and
+  /// when the Serializer is destroyed (see SerializerImpl::writeValidationReport). The meta-data and
+  /// the archive on disk are not modified.
+  ///
+  /// Validation is also enabled if the Serializer is opened in `Write` or `Append` mode and the
+  /// environment variable `SERIALBOX_VALIDATION_REFERENCE` is set to the directory of a reference
+  /// with the same prefix. The tolerance can be set via `SERIALBOX_VALIDATION_TOLERANCE`. A
+  /// Serializer opened in `Write` mode then keeps the files of the previous run until validation is
+  /// disabled.
+  ///
+  /// \param directory    Directory of the reference
+  /// \param prefix       Prefix of the reference
+  /// \param archiveName  Archive of the reference
+  /// \return Validator used to compare the fields (e.g to set the tolerances)
+  ///
+  /// \throw Exception  Reference cannot be opened or refers to the data of this Serializer
+  Validator& enableValidation(const std::string& directory, const std::string& prefix,
+                              const std::string& archiveName = "Binary");
+
+  /// \brief Write the validation report and leave validation mode to write fields again
+  ///
+  /// If validation was enabled when the Serializer was opened in `Write` mode, the files of the
+  /// previous run are dropped.
+  void disableValidation();
+
+  /// \brief Write the mismatches and statistics recorded so far to the validation report
+  ///
+  /// Does nothing if validation is disabled.
+  void writeValidationReport() const;
+
+  /// \brief Check if the Serializer is in validation mode
+  bool isValidationEnabled() const noexcept { return (validator_ != nullptr); }
+
+  /// \brief Get the Validator (`nullptr` if validation is disabled)
+  const std::shared_ptr<Validator>& validator() const noexcept { return validator_; }
+
+  /// \brief Access the path to the validation report
+  filesystem::path validationReportFile() const {
+    return directory_ / ("ValidationReport-" + prefix_ + ".json");
+  }
+
   //===----------------------------------------------------------------------------------------===//
   //     Reading
   //===----------------------------------------------------------------------------------------===//
@@ -318,6 +591,8 @@ public:
   /// \param name           Name of the field
   /// \param savepoint      Savepoint at which the field will be deserialized
   /// \param storageView    StorageView of the field
+  /// \param alsoPrevious   Read the field at the last savepoint at or before `savepoint` at which
+  ///                       it exists (see SavepointVector::findFieldAtOrBefore)
   ///
   /// \throw Exception
   ///
@@ -340,6 +615,35 @@ public:
   void readSliced(const std::string& name, const SavepointImpl& savepoint, StorageView& storageView,
                   Slice slice);
 
+  /// \brief Deserialize all fields of `storageViews` (e.g the entire state of a restart) at
+  /// `savepoint` from disk
+  ///
+  /// All records are located upfront and sorted by file and offset (see Archive::locate). The
+  /// files are distributed over `numThreads` threads, each reading the records of its files
+  /// sequentially. Archives which are not thread-safe are read by a single thread.
+  ///
+  /// \param savepoint      Savepoint at which the fields will be deserialized
+  /// \param storageViews   StorageViews of the fields mapped to their names
+  /// \param numThreads     Number of threads (0 uses one per core)
+  /// \return Statistics of the read, including the achieved bandwidth
+  ///
+  /// \throw Exception  Savepoint does not exist, a field does not exist at the savepoint or is
+  ///                   inconsistent with its StorageView or one of the reads failed
+  ReadStatistics readSavepoint(const SavepointImpl& savepoint,
+                               std::unordered_map<std::string, StorageView>& storageViews,
+                               int numThreads = 0);
+
+  /// \brief Deserialize a batch of fields, continuing past failed reads
+  ///
+  /// The requests are distributed over `numThreads` threads (archives which are not thread-safe
+  /// are read by a single thread). Reads failing with an exception (e.g a truncated file) are
+  /// reported in the result instead of aborting the batch.
+  ///
+  /// \param requests     Fields to deserialize
+  /// \param numThreads   Number of threads (0 uses one per core)
+  /// \return Outcome of each request (in the order of `requests`)
+  BatchReadResult readBatch(std::vector<ReadRequest>& requests, int numThreads = 0);
+
   /// \brief Asynchronously deserialize field `name` (given as `storageView`) at `savepoint` from
   /// disk using std::async.
   ///
@@ -363,8 +667,14 @@ public:
   void readAsync(const std::string& name, const SavepointImpl& savepoint, StorageView& storageView);
 
   /// \brief Wait for all pending asynchronous read operations and reset the internal queue
+  ///
+  /// \throw Exception  One or more reads failed (the message lists all failed reads)
   void waitForAll();
 
+  /// \brief Wait for all pending asynchronous read operations, reset the internal queue and
+  /// report the outcome of each read (in the order of the calls to SerializerImpl::readAsync)
+  BatchReadResult waitForAllResults();
+
   //===----------------------------------------------------------------------------------------===//
   //     JSON Serialization
   //===----------------------------------------------------------------------------------------===//
@@ -389,9 +699,13 @@ protected:
   /// \brief Construct meta-data from JSON
   ///
   /// This will read MetaData-prefix.json to initialize the savepoint vector, the fieldMap and
-  /// globalMetainfo.
+  /// globalMetainfo. In `OpenModeKind::Write` only the shards are registered (to remove them right
+  /// away), the rest of the meta-data is dropped anyway.
   void constructMetaDataFromJson();
 
+  /// \brief Drop all field and savepoint meta-data without clearing the archive
+  void clearMetaData() noexcept;
+
   /// \brief Construct Archive from JSON
   ///
   /// This will read ArchiveMetaData-prefix.json and initialize the archive.
@@ -406,6 +720,12 @@ protected:
   std::shared_ptr<FieldMetainfoImpl> checkStorageView(const std::string& name,
                                                       const StorageView& storageView) const;
 
+  /// \brief Check if `storageView` is consistent with the field `name` described by `fieldInfo`
+  ///
+  /// \throw Exception    Inconsistency is detected
+  static void checkStorageView(const std::string& name, const FieldMetainfoImpl& fieldInfo,
+                               const StorageView& storageView);
+
   /// \brief Check if the current directory contains meta-information of an older version of
   /// serialbox and upgrade it if necessary
   ///
@@ -414,13 +734,63 @@ protected:
   /// `ArchiveMetaData.json`.
   ///
   /// Older versions of serialbox can only be \b opened in `OpenModeKind::Read` and will use the
-  /// BinaryArchive.
+  /// BinaryArchive. If the meta-data is trusted (see ArchiveFactory::trustMetaData), no older
+  /// meta-data is looked for.
   ///
   /// \return True iff the upgrade was successful
   ///
   /// \throw Exception
   bool upgradeMetaData();
 
+  /// \brief Get the halo widths of field `name` if it is (or will be) stored without halos
+  ///
+  /// \return Pointer to the halo widths or `nullptr` if the full field is stored
+  const HaloWidths* haloWidthsForWrite(const std::string& name, const FieldMetainfoImpl& info,
+                                       const StorageView& storageView);
+
+  /// \brief Register the shards listed in the `savepoint_shards` node of the manifest
+  ///
+  /// Only the last shard is parsed, the other shards are loaded lazily by the savepoint vector. In
+  /// `OpenModeKind::Write` no shard is parsed.
+  void readMetaDataShards(JsonReader& reader);
+
+  /// \brief Write the savepoints of shard `shard` to disk
+  void writeMetaDataShard(std::size_t shard) const;
+
+  /// \brief Remove the shard files on disk starting from shard `first`
+  void removeMetaDataShards(std::size_t first) noexcept;
+
+  /// \brief Implementation of SerializerImpl::write without updating the meta-data on disk (the
+  /// caller holds the lock)
+  ///
+  /// \return True iff the field was written to the archive (i.e not validated)
+  bool writeImpl(const std::string& name, const SavepointImpl& savepoint,
+                 const StorageView& storageView);
+
+  /// \brief Pass `storageView` of field `name` (or only its compute domain if the halos are
+  /// stripped) to the archive
+  FieldID writeToArchive(const std::string& name, const std::shared_ptr<FieldMetainfoImpl>& info,
+                         const StorageView& storageView);
+
+  /// \brief Implementation of SerializerImpl::write in write-back mode (the caller holds the lock)
+  void writeBack(const std::string& name, const SavepointImpl& savepoint,
+                 const StorageView& storageView);
+
+  /// \brief Write a record evicted from the write-back cache to the archive
+  void commitRecord(const WriteBackCache::Record& record);
+
+  /// \brief Copy a record of the write-back cache to `storageView`
+  ///
+  /// Fields stored without halos only fill the compute domain, as if the record had been committed.
+  void readFromWriteBackCache(const WriteBackCache::Record& record,
+                              StorageView& storageView) const;
+
+  /// \brief Implementation of SerializerImpl::flushWriteBackCache (the caller holds the lock)
+  void flushWriteBackCacheImpl();
+
+  /// \brief Implementation of SerializerImpl::updateMetaData (the caller holds the lock)
+  void updateMetaDataImpl();
+
   /// \brief Implementation of SerializerImpl::readAsync
   void readAsyncImpl(const std::string name, const SavepointImpl savepoint,
                      StorageView storageView);
@@ -437,6 +807,22 @@ protected:
 
   std::unique_ptr<Archive> archive_;
 
+  bool haloStripping_;
+  std::unordered_map<std::string, HaloWidths> strippedHalos_;
+
+  std::size_t shardSize_;                ///< Savepoints per shard (0 if sharding is disabled)
+  std::size_t numPersistedSavepoints_;   ///< Savepoints written to the shards on disk
+  std::size_t numShardFiles_;            ///< Shard files present on disk
+  std::set<std::size_t> modifiedShards_; ///< Persisted shards with modified savepoints
+
+  std::shared_ptr<Validator> validator_;
+  bool clearArchiveOnValidationEnd_; ///< Archive was opened in Write mode while validating
+
+  std::unique_ptr<WriteBackCache> writeBackCache_;
+
+  std::unique_ptr<SharedMutex> mutex_;       ///< Protects the meta-data and the archive
+  std::unique_ptr<std::mutex> archiveMutex_; ///< Serializes reads of non thread-safe archives
+
   // This variable can take three values:
   //
   //  0: the variable is not yet initialized -> the serialization is enabled if the environment
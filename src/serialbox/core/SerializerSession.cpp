@@ -0,0 +1,172 @@
+//===-- serialbox/core/SerializerSession.cpp ----------------------------------------*- C++ -*-===//
+//
+//                                    S E R I A L B O X
+//
+// This file is distributed under terms of BSD license.
+// See LICENSE.txt for more information
+//
+//===------------------------------------------------------------------------------------------===//
+//
+/// \file
+/// This file contains the per-thread writer sessions of a Serializer.
+///
+//===------------------------------------------------------------------------------------------===//
+
+#include "serialbox/core/SerializerSession.h"
+#include "serialbox/core/Logging.h"
+#include <cstring>
+#include <mutex>
+
+namespace serialbox {
+
+const std::size_t SerializerSession::DefaultCapacity = 64 * 1024 * 1024;
+
+SerializerSession::SerializerSession(SerializerImpl& serializer, std::size_t capacity)
+    : serializer_(serializer), capacity_(capacity), size_(0) {
+  if(serializer_.mode() == OpenModeKind::Read)
+    throw Exception("cannot open session: serializer not open in write mode");
+}
+
+SerializerSession::~SerializerSession() {
+  try {
+    flush();
+  } catch(std::exception& e) {
+    LOG(warning) << "SerializerSession: failed to flush session: " << e.what();
+  }
+}
+
+void SerializerSession::write(const std::string& name, const SavepointImpl& savepoint,
+                              const StorageView& storageView) {
+  if(SerializerImpl::serializationStatus() < 0)
+    return;
+
+  // Fields registered within the session take precedence over the fields of the serializer
+  std::shared_ptr<FieldMetainfoImpl> info;
+  auto fieldIt = fieldMap_.findField(name);
+  if(fieldIt != fieldMap_.end())
+    info = fieldIt->second;
+  else {
+    SharedLock lock(*serializer_.mutex_);
+    auto it = serializer_.fieldMap_->findField(name);
+    if(it == serializer_.fieldMap_->end())
+      throw Exception("field '%s' is not registerd within the Serializer", name);
+    info = it->second;
+  }
+
+  SerializerImpl::checkStorageView(name, *info, storageView);
+
+  if(!storageView.getSlice().empty())
+    throw Exception("cannot write field '%s': sliced StorageViews cannot be written", name);
+
+  int savepointIdx = savepointVector_.find(savepoint);
+  if(savepointIdx == -1)
+    savepointIdx = savepointVector_.insert(savepoint);
+
+  // The FieldIDs of the session only keep track of the written fields, the records are assigned
+  // their ids by the archive when the session is flushed
+  if(!savepointVector_.addField(savepointIdx, FieldID{name, 0}))
+    throw Exception("field '%s' already saved at savepoint '%s'", name, savepoint.toString());
+
+  Record record{name, savepointIdx, storageView.type(), storageView.dims(),
+                std::vector<char>(storageView.sizeInBytes())};
+
+  if(storageView.isMemCopyable())
+    std::memcpy(record.data.data(), storageView.originPtr(), record.data.size());
+  else {
+    char* dataPtr = record.data.data();
+    const int bytesPerElement = storageView.bytesPerElement();
+    for(auto it = storageView.begin(), end = storageView.end(); it != end;
+        ++it, dataPtr += bytesPerElement)
+      std::memcpy(dataPtr, it.ptr(), bytesPerElement);
+  }
+
+  size_ += record.data.size();
+  records_.push_back(std::move(record));
+
+  if(size_ > capacity_)
+    flush();
+}
+
+void SerializerSession::flush() {
+  if(records_.empty() && fieldMap_.empty() && savepointVector_.empty())
+    return;
+
+  LOG(info) << "Flushing session with " << records_.size() << " records (" << size_ << " bytes)";
+
+  std::lock_guard<SharedMutex> lock(*serializer_.mutex_);
+
+  //
+  // 1) Check for conflicts with the serializer before anything is merged
+  //
+  for(auto it = fieldMap_.begin(), end = fieldMap_.end(); it != end; ++it) {
+    auto fieldIt = serializer_.fieldMap_->findField(it->first);
+    if(fieldIt != serializer_.fieldMap_->end() && !(*fieldIt->second == *it->second))
+      throw Exception("field '%s' of the session is inconsistent with the registered field",
+                      it->first);
+  }
+
+  if(!serializer_.validator_) {
+    for(const Record& record : records_) {
+      const SavepointImpl& savepoint = savepointVector_[record.savepointIdx];
+      int savepointIdx = serializer_.savepointVector_->find(savepoint);
+      if(savepointIdx == -1)
+        continue;
+
+      if(serializer_.savepointVector_->hasField(savepointIdx, record.name) ||
+         (serializer_.writeBackCache_ &&
+          serializer_.writeBackCache_->find(record.name, savepointIdx)))
+        throw Exception("field '%s' already saved at savepoint '%s'", record.name,
+                        savepoint.toString());
+    }
+  }
+
+  //
+  // 2) Merge the fields and savepoints (in the order of the session)
+  //
+  for(auto it = fieldMap_.begin(), end = fieldMap_.end(); it != end; ++it)
+    if(!serializer_.fieldMap_->hasField(it->first))
+      serializer_.fieldMap_->insert(it->first, *it->second);
+
+  for(const auto& savepoint : savepointVector_)
+    if(serializer_.savepointVector_->find(*savepoint) == -1)
+      serializer_.savepointVector_->insert(*savepoint);
+
+  //
+  // 3) Write the records. If the archive fails, the written records are dropped from the session
+  //    and the meta-data of the serializer is brought up to date, the remaining records are kept.
+  //
+  std::size_t numWritten = 0;
+  try {
+    for(Record& record : records_) {
+      std::vector<int> strides(record.dims.size());
+      int stride = 1;
+      for(std::size_t i = 0; i < record.dims.size(); ++i) {
+        strides[i] = stride;
+        stride *= record.dims[i];
+      }
+
+      StorageView storageView(record.data.data(), record.type, record.dims, strides);
+      serializer_.writeImpl(record.name, savepointVector_[record.savepointIdx], storageView);
+      ++numWritten;
+    }
+  } catch(...) {
+    for(std::size_t i = 0; i < numWritten; ++i)
+      size_ -= records_[i].data.size();
+    records_.erase(records_.begin(), records_.begin() + numWritten);
+    if(numWritten > 0)
+      serializer_.updateMetaDataImpl();
+    throw;
+  }
+
+  serializer_.updateMetaDataImpl();
+  clear();
+}
+
+void SerializerSession::clear() noexcept {
+  fieldMap_.clear();
+  savepointVector_.clear();
+  records_.clear();
+  size_ = 0;
+}
+
+} // namespace serialbox
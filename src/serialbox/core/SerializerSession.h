@@ -0,0 +1,149 @@
+//===-- serialbox/core/SerializerSession.h ------------------------------------------*- C++ -*-===//
+//
+//                                    S E R I A L B O X
+//
+// This file is distributed under terms of BSD license.
+// See LICENSE.txt for more information
+//
+//===------------------------------------------------------------------------------------------===//
+//
+/// \file
+/// This file contains the per-thread writer sessions of a Serializer.
+///
+//===------------------------------------------------------------------------------------------===//
+
+#ifndef SERIALBOX_CORE_SERIALIZERSESSION_H
+#define SERIALBOX_CORE_SERIALIZERSESSION_H
+
+#include "serialbox/core/FieldMap.h"
+#include "serialbox/core/SavepointVector.h"
+#include "serialbox/core/SerializerImpl.h"
+#include <string>
+#include <vector>
+
+namespace serialbox {
+
+/// \addtogroup core
+/// @{
+
+/// \brief Writer session of a single thread which is merged into a SerializerImpl at flush time
+///
+/// A session buffers the registered fields and savepoints as well as the data of the written
+/// fields (its segment) without touching the serializer. Hence, many threads can write
+/// concurrently, each through its own session, without any contention. SerializerSession::flush
+/// acquires the serializer once, merges the registrations into its meta-data, passes the buffered
+/// records to the archive and updates the meta-data on disk a single time. The result is the same
+/// single, consistent archive as if all fields were written through SerializerImpl::write.
+///
+/// The savepoints of a session keep their order. Savepoints of different sessions are ordered by
+/// the time they are flushed. A session is flushed automatically once its buffered data exceeds
+/// the capacity and when it is destroyed.
+///
+/// A session must only be used by one thread at a time.
+class SerializerSession {
+public:
+  /// \brief Default capacity of the buffered data in bytes
+  static const std::size_t DefaultCapacity;
+
+  /// \brief Open a session of `serializer`
+  ///
+  /// \param serializer  Serializer opened in `Write` or `Append` mode, which must outlive the
+  ///                    session
+  /// \param capacity    Flush the session once the buffered data exceeds `capacity` bytes
+  ///
+  /// \throw Exception  Serializer is opened in `Read` mode
+  SerializerSession(SerializerImpl& serializer, std::size_t capacity = DefaultCapacity);
+
+  /// \brief Copy constructor [deleted]
+  SerializerSession(const SerializerSession&) = delete;
+
+  /// \brief Copy assignment [deleted]
+  SerializerSession& operator=(const SerializerSession&) = delete;
+
+  /// \brief Flush the session
+  ~SerializerSession();
+
+  /// \brief Register a new field within the session
+  ///
+  /// The field is registered within the serializer when the session is flushed. Fields which are
+  /// registered by several sessions (or are already present in the serializer) need to have the
+  /// same type, dimensions and meta-information.
+  ///
+  /// \param name  Name of the the new field
+  /// \param Args  Arguments forwarded to the constructor of FieldMetainfoImpl
+  ///
+  /// \throw Exception  Field with same name already exists in the session
+  template <class StringType, typename... Args>
+  void registerField(StringType&& name, Args&&... args) {
+    if(!fieldMap_.insert(std::forward<StringType>(name), std::forward<Args>(args)...))
+      throw Exception("cannot register field '%s': field already exists", name);
+  }
+
+  /// \brief Register a savepoint within the session
+  ///
+  /// \return True iff the savepoint was not yet registered within the session
+  bool registerSavepoint(const SavepointImpl& savepoint) {
+    return (savepointVector_.insert(savepoint) != -1);
+  }
+
+  /// \brief Buffer field `name` (given as `storageView`) at `savepoint`
+  ///
+  /// The field needs to be registered within the session or the serializer. The data of the
+  /// StorageView is copied, the StorageView can be reused as soon as the method returns.
+  ///
+  /// \throw Exception  Field is not registered, inconsistent with the StorageView or already
+  ///                   written at `savepoint` within the session
+  void write(const std::string& name, const SavepointImpl& savepoint,
+             const StorageView& storageView);
+
+  /// \brief Merge the buffered registrations and records into the serializer
+  ///
+  /// All conflicts are checked before the serializer is modified. If a check fails, neither the
+  /// serializer nor the session are modified and the flush can be retried (e.g after resolving the
+  /// conflict). If the archive fails while writing the records, the records which were written
+  /// are merged and dropped from the session while the remaining records are kept.
+  ///
+  /// The records are written straight to the archive, bypassing the write-back cache of the
+  /// serializer (see SerializerImpl::enableWriteBackCache).
+  ///
+  /// \throw Exception  Fields are inconsistent with the fields of the serializer, a field is
+  ///                   already written (or cached) at the same savepoint or the archive fails
+  void flush();
+
+  /// \brief Get the number of buffered records
+  std::size_t numRecords() const noexcept { return records_.size(); }
+
+  /// \brief Get the size of the buffered data in bytes
+  std::size_t size() const noexcept { return size_; }
+
+  /// \brief Get the capacity of the buffered data in bytes
+  std::size_t capacity() const noexcept { return capacity_; }
+
+  /// \brief Access the serializer of the session
+  SerializerImpl& serializer() noexcept { return serializer_; }
+
+private:
+  struct Record {
+    std::string name;
+    int savepointIdx;
+    TypeID type;
+    std::vector<int> dims;
+    std::vector<char> data; ///< Elements in col-major order
+  };
+
+  void clear() noexcept;
+
+  SerializerImpl& serializer_;
+  std::size_t capacity_;
+
+  FieldMap fieldMap_;
+  SavepointVector savepointVector_;
+  std::vector<Record> records_;
+  std::size_t size_;
+};
+
+/// @}
+
+} // namespace serialbox
+
+#endif
@@ -0,0 +1,101 @@
+//===-- serialbox/core/SharedMutex.h ------------------------------------------------*- C++ -*-===//
+//
+//                                    S E R I A L B O X
+//
+// This file is distributed under terms of BSD license.
+// See LICENSE.txt for more information
+//
+//===------------------------------------------------------------------------------------------===//
+//
+/// \file
+/// This file contains a reader-writer lock.
+///
+//===------------------------------------------------------------------------------------------===//
+
+#ifndef SERIALBOX_CORE_SHAREDMUTEX_H
+#define SERIALBOX_CORE_SHAREDMUTEX_H
+
+#include <condition_variable>
+#include <mutex>
+
+namespace serialbox {
+
+/// \addtogroup core
+/// @{
+
+/// \brief Reader-writer lock (replacement of the C++17 `std::shared_mutex`)
+///
+/// Any number of threads can hold the lock in shared mode while at most one thread can hold it in
+/// exclusive mode. Waiting writers take precedence over new readers such that a steady stream of
+/// reads cannot starve a writer.
+class SharedMutex {
+public:
+  SharedMutex() : numReaders_(0), numWaitingWriters_(0), hasWriter_(false) {}
+
+  SharedMutex(const SharedMutex&) = delete;
+  SharedMutex& operator=(const SharedMutex&) = delete;
+
+  /// \brief Acquire the lock in exclusive mode
+  void lock() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    ++numWaitingWriters_;
+    writerCond_.wait(lock, [this] { return !hasWriter_ && numReaders_ == 0; });
+    --numWaitingWriters_;
+    hasWriter_ = true;
+  }
+
+  /// \brief Release the lock held in exclusive mode
+  void unlock() {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      hasWriter_ = false;
+    }
+    writerCond_.notify_one();
+    readerCond_.notify_all();
+  }
+
+  /// \brief Acquire the lock in shared mode
+  void lock_shared() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    readerCond_.wait(lock, [this] { return !hasWriter_ && numWaitingWriters_ == 0; });
+    ++numReaders_;
+  }
+
+  /// \brief Release the lock held in shared mode
+  void unlock_shared() {
+    bool isLastReader;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      isLastReader = (--numReaders_ == 0);
+    }
+    if(isLastReader)
+      writerCond_.notify_one();
+  }
+
+private:
+  std::mutex mutex_;
+  std::condition_variable readerCond_;
+  std::condition_variable writerCond_;
+  unsigned int numReaders_;
+  unsigned int numWaitingWriters_;
+  bool hasWriter_;
+};
+
+/// \brief RAII lock holding a SharedMutex in shared mode (replacement of `std::shared_lock`)
+class SharedLock {
+public:
+  explicit SharedLock(SharedMutex& mutex) : mutex_(mutex) { mutex_.lock_shared(); }
+  ~SharedLock() { mutex_.unlock_shared(); }
+
+  SharedLock(const SharedLock&) = delete;
+  SharedLock& operator=(const SharedLock&) = delete;
+
+private:
+  SharedMutex& mutex_;
+};
+
+/// @}
+
+} // namespace serialbox
+
+#endif
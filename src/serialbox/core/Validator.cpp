@@ -0,0 +1,313 @@
+//===-- serialbox/core/Validator.cpp ------------------------------------------------*- C++ -*-===//
+//
+//                                    S E R I A L B O X
+//
+// This file is distributed under terms of BSD license.
+// See LICENSE.txt for more information
+//
+//===------------------------------------------------------------------------------------------===//
+//
+/// \file
+/// This file implements the Validator which compares fields against the records of a reference
+/// serializer.
+///
+//===------------------------------------------------------------------------------------------===//
+
+#include "serialbox/core/Validator.h"
+#include "serialbox/core/Logging.h"
+#include "serialbox/core/STLExtras.h"
+#include "serialbox/core/Unreachable.h"
+#include <cmath>
+#include <cstdint>
+#include <fstream>
+#include <type_traits>
+
+namespace serialbox {
+
+namespace {
+
+/// \brief Result of the comparison of a record
+struct Comparison {
+  std::size_t numErrors;
+  double maxAbsError;
+  double maxRelError;
+};
+
+template <class T>
+typename std::enable_if<std::is_floating_point<T>::value>::type
+compareElement(T value, T reference, double tolerance, Comparison& comparison) {
+  const bool valueIsNaN = std::isnan(value);
+  const bool referenceIsNaN = std::isnan(reference);
+
+  if(valueIsNaN || referenceIsNaN) {
+    comparison.numErrors += (valueIsNaN != referenceIsNaN);
+    return;
+  }
+
+  const double absError = std::abs(double(value) - double(reference));
+  const double relError = std::abs(double(reference)) > 1.0 ? absError / std::abs(reference) : 0;
+  const double error = std::abs(double(reference)) > 1.0 ? relError : absError;
+
+  if(error > tolerance) {
+    comparison.numErrors++;
+    comparison.maxAbsError = std::max(comparison.maxAbsError, absError);
+    comparison.maxRelError = std::max(comparison.maxRelError, relError);
+  }
+}
+
+template <class T>
+typename std::enable_if<!std::is_floating_point<T>::value>::type
+compareElement(T value, T reference, double, Comparison& comparison) {
+  if(value != reference) {
+    const double absError = std::abs(double(value) - double(reference));
+    comparison.numErrors++;
+    comparison.maxAbsError = std::max(comparison.maxAbsError, absError);
+    if(reference != T(0))
+      comparison.maxRelError =
+          std::max(comparison.maxRelError, absError / std::abs(double(reference)));
+  }
+}
+
+/// \brief Compare `storageView` to the contiguous (col-major) `reference`
+template <class T>
+Comparison compareRecord(const StorageView& storageView, const Byte* reference, double tolerance) {
+  Comparison comparison{0, 0.0, 0.0};
+  const T* referencePtr = reinterpret_cast<const T*>(reference);
+
+  for(auto it = storageView.begin(), end = storageView.end(); it != end; ++it, ++referencePtr)
+    compareElement<T>(it.template as<T>(), *referencePtr, tolerance, comparison);
+  return comparison;
+}
+
+} // anonymous namespace
+
+Validator::Validator(const std::string& directory, const std::string& prefix,
+                     const std::string& archiveName)
+    : tolerance_(1e-12) {
+  LOG(info) << "Creating Validator with reference " << directory << " (prefix = " << prefix
+            << ")";
+
+  reference_ = std::make_unique<SerializerImpl>(OpenModeKind::Read, directory, prefix, archiveName);
+
+#ifdef SERIALBOX_ASYNC_API
+  launchPolicy_ = reference_->archive().isReadingThreadSafe() ? std::launch::async
+                                                                : std::launch::deferred;
+#else
+  launchPolicy_ = std::launch::deferred;
+#endif
+}
+
+Validator::~Validator() {
+  // Pending prefetches refer to the reference serializer
+  for(auto& savepointFields : prefetched_)
+    for(auto& field : savepointFields.second)
+      field.second.wait();
+}
+
+double Validator::tolerance(const std::string& name) const noexcept {
+  auto it = tolerances_.find(name);
+  return (it != tolerances_.end() ? it->second : tolerance_);
+}
+
+Validator::Buffer Validator::readReference(int savepointIdx, const std::string& name) {
+  const FieldMetainfoImpl& info = reference_->getFieldMetainfoImplOf(name);
+  const std::vector<int>& dims = info.dims();
+
+  // Contiguous col-major storage
+  std::vector<int> strides(dims.size(), 1);
+  for(std::size_t i = 1; i < dims.size(); ++i)
+    strides[i] = strides[i - 1] * (dims[i - 1] == 0 ? 1 : dims[i - 1]);
+
+  std::size_t size = TypeUtil::sizeOf(info.type());
+  for(int dim : dims)
+    size *= (dim == 0 ? 1 : dim);
+
+  Buffer buffer(size);
+  StorageView storageView(buffer.data(), info.type(), dims, strides);
+
+  reference_->read(name, reference_->savepointVector()[savepointIdx], storageView);
+  return buffer;
+}
+
+void Validator::prefetch(int savepointIdx) {
+  if(savepointIdx < 0 || savepointIdx >= int(reference_->savepointVector().size()) ||
+     prefetched_.count(savepointIdx))
+    return;
+
+  auto& fields = prefetched_[savepointIdx];
+  for(const auto& field : reference_->savepointVector().fieldsOf(savepointIdx))
+    fields.emplace(field.first, std::async(launchPolicy_, &Validator::readReference, this,
+                                           savepointIdx, field.first)
+                                    .share());
+}
+
+void Validator::addMismatch(Mismatch mismatch) {
+  LOG(warning) << "Validation of field \"" << mismatch.field << "\" at savepoint \""
+               << mismatch.savepoint << "\" failed: " << mismatch.message;
+
+  FieldStatistics& statistics = statistics_[mismatch.field];
+  statistics.numFailedRecords++;
+  statistics.numErrors += mismatch.numErrors;
+  statistics.maxAbsError = std::max(statistics.maxAbsError, mismatch.maxAbsError);
+  statistics.maxRelError = std::max(statistics.maxRelError, mismatch.maxRelError);
+
+  mismatches_.push_back(std::move(mismatch));
+}
+
+bool Validator::validate(const std::string& name, const SavepointImpl& savepoint,
+                         const StorageView& storageView) {
+  LOG(info) << "Validating field \"" << name << "\" at savepoint \"" << savepoint << "\" ... ";
+
+  auto statisticsIt = statistics_.find(name);
+  if(statisticsIt == statistics_.end())
+    statisticsIt = statistics_.emplace(name, FieldStatistics{0, 0, 0, 0, 0.0, 0.0}).first;
+  statisticsIt->second.numRecords++;
+
+  Mismatch mismatch{name, savepoint.toString(), "", 0, 0.0, 0.0};
+
+  //
+  // 1) Locate the record in the reference
+  //
+  const SavepointVector& savepointVector = reference_->savepointVector();
+  int savepointIdx = savepointVector.find(savepoint);
+
+  if(savepointIdx == -1) {
+    mismatch.message = "savepoint does not exist in the reference";
+    addMismatch(std::move(mismatch));
+    return false;
+  }
+
+  if(!savepointVector.fieldsOf(savepointIdx).count(name)) {
+    mismatch.message = "field does not exist at this savepoint in the reference";
+    addMismatch(std::move(mismatch));
+    return false;
+  }
+
+  const FieldMetainfoImpl& info = reference_->getFieldMetainfoImplOf(name);
+  bool dimsMatch = (info.dims().size() == storageView.dims().size());
+  for(std::size_t i = 0; dimsMatch && i < info.dims().size(); ++i)
+    dimsMatch = (info.dims()[i] == storageView.dims()[i]) ||
+                (info.dims()[i] <= 1 && storageView.dims()[i] <= 1);
+
+  if(info.type() != storageView.type() || !dimsMatch) {
+    mismatch.message = "type or dimensions differ from the reference";
+    addMismatch(std::move(mismatch));
+    return false;
+  }
+
+  //
+  // 2) Obtain the reference data and prefetch the next savepoint. Only the current and the next
+  //    savepoint are kept in flight.
+  //
+  for(auto it = prefetched_.begin(); it != prefetched_.end();)
+    if(it->first != savepointIdx && it->first != savepointIdx + 1)
+      it = prefetched_.erase(it);
+    else
+      ++it;
+
+  prefetch(savepointIdx);
+  prefetch(savepointIdx + 1);
+
+  std::shared_future<Buffer> reference;
+  auto& fields = prefetched_[savepointIdx];
+  auto fieldIt = fields.find(name);
+  if(fieldIt != fields.end()) {
+    reference = fieldIt->second;
+    fields.erase(fieldIt);
+  } else
+    // The record has already been consumed (i.e the field is validated twice)
+    reference = std::async(std::launch::deferred, &Validator::readReference, this, savepointIdx,
+                           name)
+                    .share();
+
+  //
+  // 3) Compare the data
+  //
+  Comparison comparison{0, 0.0, 0.0};
+  try {
+    const Byte* referenceData = reference.get().data();
+    const double tol = tolerance(name);
+
+    switch(storageView.type()) {
+    case TypeID::Boolean:
+      comparison = compareRecord<bool>(storageView, referenceData, tol);
+      break;
+    case TypeID::Int32:
+      comparison = compareRecord<int>(storageView, referenceData, tol);
+      break;
+    case TypeID::Int64:
+      comparison = compareRecord<std::int64_t>(storageView, referenceData, tol);
+      break;
+    case TypeID::Float32:
+      comparison = compareRecord<float>(storageView, referenceData, tol);
+      break;
+    case TypeID::Float64:
+      comparison = compareRecord<double>(storageView, referenceData, tol);
+      break;
+    default:
+      serialbox_unreachable("Invalid TypeID");
+    }
+  } catch(Exception& e) {
+    mismatch.message = std::string("cannot read reference: ") + e.what();
+    addMismatch(std::move(mismatch));
+    return false;
+  }
+
+  statisticsIt->second.numElements += storageView.size();
+
+  if(comparison.numErrors == 0) {
+    LOG(info) << "Successfully validated field \"" << name << "\"";
+    return true;
+  }
+
+  mismatch.message = std::to_string(comparison.numErrors) + " of " +
+                     std::to_string(storageView.size()) + " elements exceed the tolerance";
+  mismatch.numErrors = comparison.numErrors;
+  mismatch.maxAbsError = comparison.maxAbsError;
+  mismatch.maxRelError = comparison.maxRelError;
+  addMismatch(std::move(mismatch));
+  return false;
+}
+
+json::json Validator::toJSON() const {
+  json::json jsonNode;
+
+  jsonNode["reference"]["directory"] = reference_->directory().string();
+  jsonNode["reference"]["prefix"] = reference_->prefix();
+  jsonNode["success"] = success();
+
+  for(const auto& fieldStatistics : statistics_) {
+    const FieldStatistics& statistics = fieldStatistics.second;
+    json::json& node = jsonNode["statistics"][fieldStatistics.first];
+    node["num_records"] = statistics.numRecords;
+    node["num_failed_records"] = statistics.numFailedRecords;
+    node["num_elements"] = statistics.numElements;
+    node["num_errors"] = statistics.numErrors;
+    node["max_abs_error"] = statistics.maxAbsError;
+    node["max_rel_error"] = statistics.maxRelError;
+  }
+
+  jsonNode["mismatches"] = json::json::array();
+  for(const Mismatch& mismatch : mismatches_) {
+    json::json node;
+    node["field"] = mismatch.field;
+    node["savepoint"] = mismatch.savepoint;
+    node["message"] = mismatch.message;
+    node["num_errors"] = mismatch.numErrors;
+    node["max_abs_error"] = mismatch.maxAbsError;
+    node["max_rel_error"] = mismatch.maxRelError;
+    jsonNode["mismatches"].push_back(node);
+  }
+
+  return jsonNode;
+}
+
+void Validator::writeReport(const std::string& filename) const {
+  std::ofstream fs(filename, std::ios::out | std::ios::trunc);
+  if(!fs.is_open())
+    throw Exception("cannot open file: %s", filename);
+  fs << toJSON().dump(2) << std::endl;
+  fs.close();
+}
+
+} // namespace serialbox
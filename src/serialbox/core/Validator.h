@@ -0,0 +1,151 @@
+//===-- serialbox/core/Validator.h --------------------------------------------------*- C++ -*-===//
+//
+//                                    S E R I A L B O X
+//
+// This file is distributed under terms of BSD license.
+// See LICENSE.txt for more information
+//
+//===------------------------------------------------------------------------------------------===//
+//
+/// \file
+/// This file contains the Validator which compares fields against the records of a reference
+/// serializer.
+///
+//===------------------------------------------------------------------------------------------===//
+
+#ifndef SERIALBOX_CORE_VALIDATOR_H
+#define SERIALBOX_CORE_VALIDATOR_H
+
+#include "serialbox/core/Json.h"
+#include "serialbox/core/SavepointImpl.h"
+#include "serialbox/core/SerializerImpl.h"
+#include "serialbox/core/StorageView.h"
+#include <future>
+#include <map>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace serialbox {
+
+/// \addtogroup core
+/// @{
+
+/// \brief Compare fields against the corresponding records of a reference serializer
+///
+/// The elements are compared in the same way as `compare.py` does: the error of an element is the
+/// relative error if the absolute value of the reference is larger than 1 and the absolute error
+/// otherwise. A record mismatches if any error exceeds the tolerance of the field or if only one
+/// of the two values is NaN. Integer and boolean fields have to match exactly.
+///
+/// Only mismatching records and per-field statistics are kept. The reference records of the
+/// savepoint being validated and of the following savepoint are prefetched asynchronously (if the
+/// library was configured with `SERIALBOX_ASYNC_API` and the reference archive supports
+/// thread-safe reading).
+class Validator {
+public:
+  /// \brief Statistics of a field
+  struct FieldStatistics {
+    std::size_t numRecords;       ///< Number of validated records
+    std::size_t numFailedRecords; ///< Number of records which did not match the reference
+    std::size_t numElements;      ///< Number of compared elements
+    std::size_t numErrors;        ///< Number of elements which did not match the reference
+    double maxAbsError;           ///< Maximum absolute error of all mismatching elements
+    double maxRelError;           ///< Maximum relative error of all mismatching elements
+  };
+
+  /// \brief Record which did not match the reference
+  struct Mismatch {
+    std::string field;     ///< Name of the field
+    std::string savepoint; ///< Savepoint of the record
+    std::string message;   ///< Description of the mismatch
+    std::size_t numErrors; ///< Number of elements which did not match the reference
+    double maxAbsError;    ///< Maximum absolute error of the mismatching elements
+    double maxRelError;    ///< Maximum relative error of the mismatching elements
+  };
+
+  /// \brief Open the reference serializer
+  ///
+  /// \param directory    Directory of the reference
+  /// \param prefix       Prefix of the reference
+  /// \param archiveName  Archive of the reference
+  ///
+  /// \throw Exception  Reference cannot be opened
+  Validator(const std::string& directory, const std::string& prefix,
+            const std::string& archiveName = "Binary");
+
+  /// \brief Copy constructor [deleted]
+  Validator(const Validator&) = delete;
+
+  /// \brief Copy assignment [deleted]
+  Validator& operator=(const Validator&) = delete;
+
+  /// \brief Wait for all pending prefetches
+  ~Validator();
+
+  /// \brief Set the tolerance of all fields without an individual tolerance [default: 1e-12]
+  void setTolerance(double tolerance) noexcept { tolerance_ = tolerance; }
+
+  /// \brief Set the tolerance of field `name`
+  void setTolerance(const std::string& name, double tolerance) { tolerances_[name] = tolerance; }
+
+  /// \brief Get the tolerance of field `name`
+  double tolerance(const std::string& name) const noexcept;
+
+  /// \brief Compare field `name` (given as `storageView`) against the reference at `savepoint`
+  ///
+  /// \return True iff the field matches the reference
+  bool validate(const std::string& name, const SavepointImpl& savepoint,
+                const StorageView& storageView);
+
+  /// \brief Check if all validated records matched the reference
+  bool success() const noexcept { return mismatches_.empty(); }
+
+  /// \brief Get the records which did not match the reference
+  const std::vector<Mismatch>& mismatches() const noexcept { return mismatches_; }
+
+  /// \brief Get the statistics of all validated fields
+  const std::map<std::string, FieldStatistics>& statistics() const noexcept {
+    return statistics_;
+  }
+
+  /// \brief Get the reference serializer
+  const SerializerImpl& reference() const noexcept { return *reference_; }
+
+  /// \brief Convert the statistics and mismatches to JSON
+  json::json toJSON() const;
+
+  /// \brief Write the statistics and mismatches to `filename` (JSON)
+  void writeReport(const std::string& filename) const;
+
+private:
+  using Buffer = std::vector<Byte>;
+
+  /// \brief Asynchronously read all fields of the reference at savepoint `savepointIdx`
+  void prefetch(int savepointIdx);
+
+  /// \brief Read field `name` at savepoint `savepointIdx` of the reference
+  Buffer readReference(int savepointIdx, const std::string& name);
+
+  /// \brief Record a mismatch
+  void addMismatch(Mismatch mismatch);
+
+private:
+  std::unique_ptr<SerializerImpl> reference_;
+  std::launch launchPolicy_;
+
+  double tolerance_;
+  std::unordered_map<std::string, double> tolerances_;
+
+  std::map<int, std::unordered_map<std::string, std::shared_future<Buffer>>> prefetched_;
+
+  std::vector<Mismatch> mismatches_;
+  std::map<std::string, FieldStatistics> statistics_;
+};
+
+/// @}
+
+} // namespace serialbox
+
+#endif
@@ -0,0 +1,202 @@
+//===-- serialbox/core/VirtualSerializer.cpp ----------------------------------------*- C++ -*-===//
+//
+//                                    S E R I A L B O X
+//
+// This file is distributed under terms of BSD license.
+// See LICENSE.txt for more information
+//
+//===------------------------------------------------------------------------------------------===//
+//
+/// \file
+/// This file implements the VirtualSerializer which provides read access to many serializers
+/// through a single savepoint index.
+///
+//===------------------------------------------------------------------------------------------===//
+
+#include "serialbox/core/VirtualSerializer.h"
+#include "serialbox/core/Logging.h"
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <map>
+#include <set>
+#include <thread>
+
+namespace serialbox {
+
+namespace {
+
+/// \brief Serializers opened by VirtualSerializer::open
+struct OpenSerializers {
+  std::mutex mutex;
+  std::map<std::string, std::weak_ptr<SerializerImpl>> serializers;
+};
+
+OpenSerializers& openSerializers() {
+  static OpenSerializers instance;
+  return instance;
+}
+
+const std::vector<VirtualSerializer::Location> NoLocations;
+
+} // anonymous namespace
+
+std::shared_ptr<SerializerImpl> VirtualSerializer::open(const std::string& directory,
+                                                        const std::string& prefix,
+                                                        const std::string& archive) {
+  std::string key = archive + ":" + prefix + ":" +
+                    (filesystem::exists(directory) ? filesystem::canonical(directory).string()
+                                                   : directory);
+
+  OpenSerializers& open = openSerializers();
+  std::lock_guard<std::mutex> lock(open.mutex);
+
+  auto& weakSerializer = open.serializers[key];
+  std::shared_ptr<SerializerImpl> serializer = weakSerializer.lock();
+  if(!serializer) {
+    serializer = std::make_shared<SerializerImpl>(OpenModeKind::Read, directory, prefix, archive);
+    weakSerializer = serializer;
+  }
+  return serializer;
+}
+
+std::size_t VirtualSerializer::addSerializer(const std::string& directory,
+                                             const std::string& prefix,
+                                             const std::string& archive) {
+  return addSerializer(open(directory, prefix, archive));
+}
+
+std::size_t VirtualSerializer::addSerializer(std::shared_ptr<SerializerImpl> serializer) {
+  if(serializer->mode() != OpenModeKind::Read)
+    throw Exception("serializer '%s' needs to be opened in mode 'Read' (current mode: %s)",
+                    serializer->prefix(), serializer->mode());
+
+  const std::size_t member = members_.size();
+
+  // Members sharing the same instance share the mutex as well
+  std::shared_ptr<std::mutex> mutex;
+  for(const auto& m : members_)
+    if(m.serializer == serializer)
+      mutex = m.mutex;
+  if(!mutex)
+    mutex = std::make_shared<std::mutex>();
+
+  const SavepointVector& savepoints = serializer->savepointVector();
+  for(std::size_t i = 0; i < savepoints.size(); ++i) {
+    int idx = savepointVector_.find(savepoints[i]);
+    if(idx == -1) {
+      idx = savepointVector_.insert(savepoints[i]);
+      locations_.emplace_back();
+    }
+    locations_[idx].push_back(Location{member, int(i)});
+  }
+
+  members_.push_back(Member{std::move(serializer), std::move(mutex)});
+
+  LOG(info) << "Added serializer \"" << members_.back().serializer->prefix() << "\" as member "
+            << member << " (" << savepoints.size() << " savepoints)";
+  return member;
+}
+
+const std::vector<VirtualSerializer::Location>&
+VirtualSerializer::locationsOf(const SavepointImpl& savepoint) const noexcept {
+  int idx = savepointVector_.find(savepoint);
+  return idx == -1 ? NoLocations : locations_[idx];
+}
+
+bool VirtualSerializer::hasField(const std::string& name,
+                                 const SavepointImpl& savepoint) const noexcept {
+  for(const Location& location : locationsOf(savepoint))
+    if(members_[location.member].serializer->savepointVector().hasField(location.savepointIdx,
+                                                                        name))
+      return true;
+  return false;
+}
+
+std::vector<std::string> VirtualSerializer::fieldnames() const {
+  std::set<std::string> names;
+  for(const Member& member : members_)
+    for(const auto& field : member.serializer->fieldMap())
+      names.insert(field.first);
+  return std::vector<std::string>(names.begin(), names.end());
+}
+
+std::vector<std::string> VirtualSerializer::fieldnamesAt(const SavepointImpl& savepoint) const {
+  std::set<std::string> names;
+  for(const Location& location : locationsOf(savepoint))
+    for(const auto& field :
+        members_[location.member].serializer->savepointVector().fieldsOf(location.savepointIdx))
+      names.insert(field.first);
+  return std::vector<std::string>(names.begin(), names.end());
+}
+
+const VirtualSerializer::Location&
+VirtualSerializer::locate(const std::string& name, const SavepointImpl& savepoint) const {
+  const std::vector<Location>& locations = locationsOf(savepoint);
+  if(locations.empty())
+    throw Exception("savepoint '%s' does not exist", savepoint.toString());
+
+  for(const Location& location : locations)
+    if(members_[location.member].serializer->savepointVector().hasField(location.savepointIdx,
+                                                                        name))
+      return location;
+
+  throw Exception("field '%s' does not exist at savepoint '%s'", name, savepoint.toString());
+}
+
+void VirtualSerializer::read(const std::string& name, const SavepointImpl& savepoint,
+                             StorageView& storageView) {
+  const Member& member = members_[locate(name, savepoint).member];
+  member.serializer->read(name, savepoint, storageView);
+}
+
+void VirtualSerializer::read(std::vector<ReadRequest>& requests, int numThreads) {
+  // Locate all requests upfront to fail before anything is read
+  std::vector<std::size_t> memberOf(requests.size());
+  for(std::size_t i = 0; i < requests.size(); ++i)
+    memberOf[i] = locate(requests[i].name, requests[i].savepoint).member;
+
+  if(numThreads <= 0)
+    numThreads = int(std::thread::hardware_concurrency());
+  numThreads = std::max(1, std::min(numThreads, int(requests.size())));
+
+  std::atomic<std::size_t> nextRequest(0);
+  std::atomic<bool> aborted(false);
+  std::mutex errorMutex;
+  std::exception_ptr error;
+
+  auto reader = [&]() {
+    for(std::size_t i = nextRequest++; i < requests.size() && !aborted; i = nextRequest++) {
+      try {
+        const Member& member = members_[memberOf[i]];
+        ReadRequest& request = requests[i];
+        if(member.serializer->archive().isReadingThreadSafe())
+          member.serializer->read(request.name, request.savepoint, request.storageView);
+        else {
+          std::lock_guard<std::mutex> lock(*member.mutex);
+          member.serializer->read(request.name, request.savepoint, request.storageView);
+        }
+      } catch(...) {
+        std::lock_guard<std::mutex> lock(errorMutex);
+        if(!error)
+          error = std::current_exception();
+        aborted = true;
+      }
+    }
+  };
+
+  if(numThreads == 1)
+    reader();
+  else {
+    std::vector<std::thread> threads;
+    for(int i = 0; i < numThreads; ++i)
+      threads.emplace_back(reader);
+    for(auto& thread : threads)
+      thread.join();
+  }
+
+  if(error)
+    std::rethrow_exception(error);
+}
+
+} // namespace serialbox
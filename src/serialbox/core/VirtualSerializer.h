@@ -0,0 +1,154 @@
+//===-- serialbox/core/VirtualSerializer.h ------------------------------------------*- C++ -*-===//
+//
+//                                    S E R I A L B O X
+//
+// This file is distributed under terms of BSD license.
+// See LICENSE.txt for more information
+//
+//===------------------------------------------------------------------------------------------===//
+//
+/// \file
+/// This file contains the VirtualSerializer which provides read access to many serializers
+/// through a single savepoint index.
+///
+//===------------------------------------------------------------------------------------------===//
+
+#ifndef SERIALBOX_CORE_VIRTUALSERIALIZER_H
+#define SERIALBOX_CORE_VIRTUALSERIALIZER_H
+
+#include "serialbox/core/SerializerImpl.h"
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace serialbox {
+
+/// \addtogroup core
+/// @{
+
+/// \brief Read-only view of many serializers (e.g one per rank or per segment of a run) behind a
+/// single savepoint index
+///
+/// The savepoints of all members are unified in one SavepointVector, ordered by their first
+/// occurrence. Reads are dispatched to the first member (in the order the members were added)
+/// which stores the requested field at the requested savepoint.
+///
+/// The members are opened through VirtualSerializer::open, hence a serializer which is part of
+/// several VirtualSerializers (or added more than once) is opened only once and its meta-data and
+/// archive are shared.
+class VirtualSerializer {
+public:
+  /// \brief Location of a savepoint within a member
+  struct Location {
+    std::size_t member;  ///< Index of the member
+    int savepointIdx;    ///< Index of the savepoint in the SavepointVector of the member
+  };
+
+  /// \brief Request of VirtualSerializer::read
+  struct ReadRequest {
+    std::string name;          ///< Name of the field
+    SavepointImpl savepoint;   ///< Savepoint at which the field will be deserialized
+    StorageView storageView;   ///< StorageView of the field
+  };
+
+  /// \brief Construct empty
+  VirtualSerializer() = default;
+
+  /// \brief Copy constructor [deleted]
+  VirtualSerializer(const VirtualSerializer&) = delete;
+
+  /// \brief Copy assignment [deleted]
+  VirtualSerializer& operator=(const VirtualSerializer&) = delete;
+
+  /// \brief Open the serializer `prefix` in `directory` (read-only) and add it as the next member
+  ///
+  /// \return Index of the member
+  ///
+  /// \throw Exception  Serializer cannot be opened
+  std::size_t addSerializer(const std::string& directory, const std::string& prefix,
+                            const std::string& archive);
+
+  /// \brief Add the serializer `serializer` (opened in `Read` mode) as the next member
+  ///
+  /// \return Index of the member
+  ///
+  /// \throw Exception  Serializer is not opened in `Read` mode
+  std::size_t addSerializer(std::shared_ptr<SerializerImpl> serializer);
+
+  /// \brief Get the number of members
+  std::size_t numSerializers() const noexcept { return members_.size(); }
+
+  /// \brief Get member `member`
+  const SerializerImpl& serializer(std::size_t member) const noexcept {
+    return *members_[member].serializer;
+  }
+
+  /// \brief Get the unified savepoints of all members
+  const SavepointVector& savepointVector() const noexcept { return savepointVector_; }
+
+  /// \brief Get the locations of `savepoint` in the members (empty if no member contains it)
+  const std::vector<Location>& locationsOf(const SavepointImpl& savepoint) const noexcept;
+
+  /// \brief Check if a member stores field `name` at `savepoint`
+  bool hasField(const std::string& name, const SavepointImpl& savepoint) const noexcept;
+
+  /// \brief Get the names of the fields of all members (sorted)
+  std::vector<std::string> fieldnames() const;
+
+  /// \brief Get the names of the fields stored at `savepoint` by any member (sorted)
+  std::vector<std::string> fieldnamesAt(const SavepointImpl& savepoint) const;
+
+  /// \brief Deserialize field `name` (given as `storageView`) at `savepoint`
+  ///
+  /// The read is dispatched to the first member storing field `name` at `savepoint`.
+  ///
+  /// \throw Exception  No member stores field `name` at `savepoint` or the read failed
+  ///
+  /// \see SerializerImpl::read
+  void read(const std::string& name, const SavepointImpl& savepoint, StorageView& storageView);
+
+  /// \brief Deserialize the fields given by `requests` using `numThreads` threads
+  ///
+  /// Requests dispatched to different members are read in parallel. Requests dispatched to the
+  /// same member are only read in parallel if the archive of the member supports it (see
+  /// Archive::isReadingThreadSafe). Concurrent calls of different VirtualSerializers sharing a
+  /// member are only safe for such archives.
+  ///
+  /// \param requests    Fields to deserialize
+  /// \param numThreads  Number of threads (0 uses one per core)
+  ///
+  /// \throw Exception  One of the reads failed (the remaining requests are skipped)
+  void read(std::vector<ReadRequest>& requests, int numThreads = 0);
+
+  /// \brief Open the serializer `prefix` in `directory` in `Read` mode or return the already
+  /// opened instance
+  ///
+  /// The instances are shared by all VirtualSerializers of the process as long as one of them
+  /// holds a reference.
+  ///
+  /// \throw Exception  Serializer cannot be opened
+  static std::shared_ptr<SerializerImpl> open(const std::string& directory,
+                                              const std::string& prefix,
+                                              const std::string& archive);
+
+private:
+  /// \brief Get the member which stores field `name` at `savepoint`
+  const Location& locate(const std::string& name, const SavepointImpl& savepoint) const;
+
+  struct Member {
+    std::shared_ptr<SerializerImpl> serializer;
+    std::shared_ptr<std::mutex> mutex; ///< Serializes reads of archives which are not thread-safe
+  };
+
+  std::vector<Member> members_;
+  SavepointVector savepointVector_;
+  std::vector<std::vector<Location>> locations_;
+};
+
+/// @}
+
+} // namespace serialbox
+
+#endif
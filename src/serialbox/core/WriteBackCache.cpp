@@ -0,0 +1,104 @@
+//===-- serialbox/core/WriteBackCache.cpp -------------------------------------------*- C++ -*-===//
+//
+//                                    S E R I A L B O X
+//
+// This file is distributed under terms of BSD license.
+// See LICENSE.txt for more information
+//
+//===------------------------------------------------------------------------------------------===//
+//
+/// \file
+/// This file contains the write-back cache of the Serializer.
+///
+//===------------------------------------------------------------------------------------------===//
+
+#include "serialbox/core/WriteBackCache.h"
+#include <cstring>
+
+namespace serialbox {
+
+StorageView WriteBackCache::Record::toStorageView() const {
+  std::vector<int> strides(dims.size());
+  int stride = 1;
+  for(std::size_t i = 0; i < dims.size(); ++i) {
+    strides[i] = stride;
+    stride *= dims[i];
+  }
+  return StorageView(const_cast<char*>(data.data()), type, dims, strides);
+}
+
+void WriteBackCache::Record::copyTo(StorageView& storageView) const {
+  StorageView cachedView = toStorageView();
+  cachedView.setSlice(storageView.getSlice());
+
+  const int bytesPerElement = storageView.bytesPerElement();
+  for(auto it = storageView.begin(), end = storageView.end(), cachedIt = cachedView.begin();
+      it != end; ++it, ++cachedIt)
+    std::memcpy(it.ptr(), cachedIt.ptr(), bytesPerElement);
+}
+
+void WriteBackCache::insert(const std::string& name, int savepointIdx,
+                            const StorageView& storageView) {
+  auto indexIt = index_.find(Key(name, savepointIdx));
+
+  std::list<Record>::iterator recordIt;
+  if(indexIt != index_.end()) {
+    recordIt = indexIt->second;
+    size_ -= recordIt->data.size();
+    ++numOverwrites_;
+    if(policy_ == PolicyKind::LRU)
+      records_.splice(records_.end(), records_, recordIt);
+  } else {
+    recordIt = records_.insert(records_.end(), Record{name, savepointIdx, storageView.type(),
+                                                      storageView.dims(), std::vector<char>()});
+    index_.emplace(Key(name, savepointIdx), recordIt);
+  }
+
+  // Copy the data in col-major order
+  Record& record = *recordIt;
+  record.type = storageView.type();
+  record.dims = storageView.dims();
+  record.data.resize(storageView.sizeInBytes());
+
+  if(storageView.isMemCopyable())
+    std::memcpy(record.data.data(), storageView.originPtr(), record.data.size());
+  else {
+    char* dataPtr = record.data.data();
+    const int bytesPerElement = storageView.bytesPerElement();
+    for(auto it = storageView.begin(), end = storageView.end(); it != end;
+        ++it, dataPtr += bytesPerElement)
+      std::memcpy(dataPtr, it.ptr(), bytesPerElement);
+  }
+  size_ += record.data.size();
+}
+
+void WriteBackCache::popOldest() noexcept {
+  Record& front = records_.front();
+  size_ -= front.data.size();
+  index_.erase(Key(front.name, front.savepointIdx));
+  records_.pop_front();
+}
+
+const WriteBackCache::Record* WriteBackCache::find(const std::string& name, int savepointIdx) const
+    noexcept {
+  auto it = index_.find(Key(name, savepointIdx));
+  return (it == index_.end() ? nullptr : &*it->second);
+}
+
+const WriteBackCache::Record* WriteBackCache::findAtOrBefore(const std::string& name,
+                                                             int savepointIdx) const noexcept {
+  // The records of a field are adjacent in the index, ordered by savepoint
+  auto it = index_.upper_bound(Key(name, savepointIdx));
+  if(it == index_.begin())
+    return nullptr;
+  --it;
+  return (it->first.first == name ? &*it->second : nullptr);
+}
+
+void WriteBackCache::clear() noexcept {
+  records_.clear();
+  index_.clear();
+  size_ = 0;
+}
+
+} // namespace serialbox
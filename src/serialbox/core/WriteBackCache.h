@@ -0,0 +1,139 @@
+//===-- serialbox/core/WriteBackCache.h ---------------------------------------------*- C++ -*-===//
+//
+//                                    S E R I A L B O X
+//
+// This file is distributed under terms of BSD license.
+// See LICENSE.txt for more information
+//
+//===------------------------------------------------------------------------------------------===//
+//
+/// \file
+/// This file contains the write-back cache of the Serializer.
+///
+//===------------------------------------------------------------------------------------------===//
+
+#ifndef SERIALBOX_CORE_WRITEBACKCACHE_H
+#define SERIALBOX_CORE_WRITEBACKCACHE_H
+
+#include "serialbox/core/StorageView.h"
+#include <list>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace serialbox {
+
+/// \addtogroup core
+/// @{
+
+/// \brief Bounded in-memory cache of the records written to a Serializer, keyed by field and
+/// savepoint
+///
+/// Writing a field at a savepoint which is already cached replaces the cached data without any
+/// I/O. Note that a second write of a field at a savepoint is therefore not rejected, as it is by
+/// an uncached SerializerImpl::write, the last write wins.
+///
+/// Once the cached data exceeds the capacity, records have to be evicted according to the
+/// WriteBackCache::PolicyKind. The caller commits the oldest record to the archive before it
+/// removes the record from the cache (see WriteBackCache::oldest and WriteBackCache::popOldest),
+/// hence a record which fails to be committed is kept in the cache.
+///
+/// The cache is not synchronized (it is protected by the lock of the SerializerImpl).
+class WriteBackCache {
+public:
+  /// \brief Order in which the records are evicted
+  enum class PolicyKind : int {
+    LRU = 0, ///< Evict the least recently written record first (default)
+    FIFO     ///< Evict the record which was cached first, overwriting does not renew a record
+  };
+
+  /// \brief Cached record of a field at a savepoint
+  struct Record {
+    std::string name;       ///< Name of the field
+    int savepointIdx;       ///< Index of the savepoint in the SavepointVector
+    TypeID type;            ///< Type of the elements
+    std::vector<int> dims;  ///< Dimensions of the field
+    std::vector<char> data; ///< Elements in col-major order
+
+    /// \brief Get a StorageView of the data (which must not be used to modify the data)
+    StorageView toStorageView() const;
+
+    /// \brief Copy the data to `storageView` (taking its slice into account)
+    void copyTo(StorageView& storageView) const;
+  };
+
+  /// \brief Initialize the cache
+  ///
+  /// \param capacity  Maximum size of the cached data in bytes
+  /// \param policy    Order in which the records are evicted
+  WriteBackCache(std::size_t capacity, PolicyKind policy = PolicyKind::LRU)
+      : capacity_(capacity), policy_(policy), size_(0), numOverwrites_(0) {}
+
+  /// \brief Copy constructor [deleted]
+  WriteBackCache(const WriteBackCache&) = delete;
+
+  /// \brief Copy assignment [deleted]
+  WriteBackCache& operator=(const WriteBackCache&) = delete;
+
+  /// \brief Cache field `name` (given as `storageView`) at the savepoint `savepointIdx`
+  ///
+  /// The records are not evicted, the caller needs to evict records as long as the cache exceeds
+  /// its capacity. A record which is larger than the capacity has to be evicted right away.
+  void insert(const std::string& name, int savepointIdx, const StorageView& storageView);
+
+  /// \brief Check if the cached data exceeds the capacity
+  bool exceedsCapacity() const noexcept { return (size_ > capacity_); }
+
+  /// \brief Get the record which is evicted next (the cache must not be empty)
+  const Record& oldest() const noexcept { return records_.front(); }
+
+  /// \brief Remove the record which is evicted next (after it has been committed)
+  void popOldest() noexcept;
+
+  /// \brief Get the cached record of field `name` at the savepoint `savepointIdx`
+  ///
+  /// \return Pointer to the record or `nullptr` if the record is not cached
+  const Record* find(const std::string& name, int savepointIdx) const noexcept;
+
+  /// \brief Get the cached record of field `name` at the last savepoint at or before
+  /// `savepointIdx`
+  ///
+  /// \return Pointer to the record or `nullptr` if no such record is cached
+  const Record* findAtOrBefore(const std::string& name, int savepointIdx) const noexcept;
+
+  /// \brief Drop all records
+  void clear() noexcept;
+
+  /// \brief Get the number of cached records
+  std::size_t numRecords() const noexcept { return records_.size(); }
+
+  /// \brief Get the size of the cached data in bytes
+  std::size_t size() const noexcept { return size_; }
+
+  /// \brief Get the maximum size of the cached data in bytes
+  std::size_t capacity() const noexcept { return capacity_; }
+
+  /// \brief Get the eviction policy
+  PolicyKind policy() const noexcept { return policy_; }
+
+  /// \brief Get the number of writes which replaced a cached record (i.e which did not cause I/O)
+  std::size_t numOverwrites() const noexcept { return numOverwrites_; }
+
+private:
+  using Key = std::pair<std::string, int>;
+
+  std::size_t capacity_;
+  PolicyKind policy_;
+  std::size_t size_;
+  std::size_t numOverwrites_;
+
+  std::list<Record> records_; ///< Records in the order of eviction
+  std::map<Key, std::list<Record>::iterator> index_;
+};
+
+/// @}
+
+} // namespace serialbox
+
+#endif
@@ -20,7 +20,9 @@
 #include "serialbox/core/FieldMetainfoImpl.h"
 #include "serialbox/core/StorageView.h"
 #include "serialbox/core/Type.h"
+#include <cstdint>
 #include <iosfwd>
+#include <string>
 
 namespace serialbox {
 
@@ -29,6 +31,12 @@ namespace serialbox {
 /// \ingroup core
 class Archive {
 public:
+  /// \brief Location of a record on disk
+  struct RecordLocation {
+    std::string file;     ///< File storing the record (empty if unknown)
+    std::uint64_t offset; ///< Offset of the record within the file
+  };
+
   /// \brief Vritual destructor
   virtual ~Archive() {}
 
@@ -82,6 +90,14 @@ public:
   /// \brief Indicate whether the archive supports `StorageViews` with attached \ref Slice "slices"
   virtual bool isSlicedReadingSupported() const { return false; }
 
+  /// \brief Get the location of the record `fieldID` which is used to order batched reads
+  ///
+  /// Archives which do not store their records in files return an empty file and the id of the
+  /// record as offset.
+  virtual RecordLocation locate(const FieldID& fieldID) const {
+    return RecordLocation{std::string(), fieldID.id};
+  }
+
   /// \brief Convert the archive to stream
   virtual std::ostream& toStream(std::ostream& stream) const = 0;
 
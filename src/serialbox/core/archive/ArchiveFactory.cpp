@@ -16,8 +16,14 @@
 #include "serialbox/core/Exception.h"
 #include "serialbox/core/Unreachable.h"
 #include "serialbox/core/archive/BinaryArchive.h"
+#include "serialbox/core/archive/FingerprintArchive.h"
+#include "serialbox/core/archive/LogArchive.h"
 #include "serialbox/core/archive/MockArchive.h"
 #include "serialbox/core/archive/NetCDFArchive.h"
+#include "serialbox/core/archive/ObjectStoreArchive.h"
+#include "serialbox/core/archive/ZarrArchive.h"
+#include <atomic>
+#include <cstdlib>
 
 namespace serialbox {
 
@@ -28,6 +34,14 @@ std::unique_ptr<Archive> ArchiveFactory::create(const std::string& name, OpenMod
     return std::make_unique<BinaryArchive>(mode, directory, prefix);
   } else if(name == MockArchive::Name) {
     return std::make_unique<MockArchive>(mode);
+  } else if(name == FingerprintArchive::Name) {
+    return std::make_unique<FingerprintArchive>(mode, directory, prefix);
+  } else if(name == ObjectStoreArchive::Name) {
+    return std::make_unique<ObjectStoreArchive>(mode, directory, prefix);
+  } else if(name == ZarrArchive::Name) {
+    return std::make_unique<ZarrArchive>(mode, directory, prefix);
+  } else if(name == LogArchive::Name) {
+    return std::make_unique<LogArchive>(mode, directory, prefix);
 #ifdef SERIALBOX_HAS_NETCDF
   } else if(name == NetCDFArchive::Name) {
     return std::make_unique<NetCDFArchive>(mode, directory, prefix);
@@ -43,7 +57,8 @@ std::unique_ptr<Archive> ArchiveFactory::create(const std::string& name, OpenMod
 }
 
 std::vector<std::string> ArchiveFactory::registeredArchives() {
-  std::vector<std::string> archives{BinaryArchive::Name, MockArchive::Name
+  std::vector<std::string> archives{BinaryArchive::Name, MockArchive::Name, FingerprintArchive::Name,
+                                    ObjectStoreArchive::Name, ZarrArchive::Name, LogArchive::Name
 #ifdef SERIALBOX_HAS_NETCDF
                                     ,
                                     NetCDFArchive::Name
@@ -52,6 +67,19 @@ std::vector<std::string> ArchiveFactory::registeredArchives() {
   return archives;
 }
 
+// 0: not yet initialized from the environment, 1: trusted, -1: not trusted
+static std::atomic<int> trustMetaData_(0);
+
+bool ArchiveFactory::trustMetaData() noexcept {
+  if(trustMetaData_ == 0) {
+    const char* envvar = std::getenv("SERIALBOX_TRUST_METADATA");
+    trustMetaData_ = (envvar && std::atoi(envvar) > 0) ? 1 : -1;
+  }
+  return (trustMetaData_ > 0);
+}
+
+void ArchiveFactory::setTrustMetaData(bool trust) noexcept { trustMetaData_ = trust ? 1 : -1; }
+
 std::string ArchiveFactory::archiveFromExtension(std::string filename) {
   std::string extension = filesystem::path(filename).extension().string();
 
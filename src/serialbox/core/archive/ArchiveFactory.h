@@ -71,6 +71,22 @@ public:
   /// \param fieldname    Name of the field (might be unused for certain archives)
   static void readFromFile(std::string filename, StorageView& storageView, std::string archiveName,
                            std::string fieldname);
+
+  /// \brief Check if the meta-data of the archives is trusted
+  ///
+  /// Trusted meta-data is assumed to be up-to-date and to reference all files of an archive. This
+  /// saves filesystem probing when opening archives in large directories: no old serialbox
+  /// meta-data is looked for and archives opened in `Write` mode only remove the files referenced
+  /// by their meta-data instead of scanning the directory for their files.
+  ///
+  /// The meta-data is not trusted by default, it is trusted if the environment variable
+  /// `SERIALBOX_TRUST_METADATA` is set to a positive value or after calling
+  /// ArchiveFactory::setTrustMetaData.
+  static bool trustMetaData() noexcept;
+
+  /// \brief Set whether the meta-data of the archives is trusted (independently of the
+  /// environment)
+  static void setTrustMetaData(bool trust) noexcept;
 };
 
 } // namespace serialbox
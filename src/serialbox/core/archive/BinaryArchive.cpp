@@ -13,159 +13,230 @@
 //===------------------------------------------------------------------------------------------===//
 
 #include "serialbox/core/archive/BinaryArchive.h"
+#include "serialbox/core/archive/ArchiveFactory.h"
+#include "serialbox/core/archive/BinaryBuffer.h"
+#include "serialbox/core/JsonReader.h"
+#include "serialbox/core/JsonWriter.h"
 #include "serialbox/core/Logging.h"
 #include "serialbox/core/STLExtras.h"
 #include "serialbox/core/Version.h"
 #include "serialbox/core/hash/HashFactory.h"
+#include <algorithm>
 #include <boost/algorithm/string.hpp>
+#include <cstdint>
+#include <cstring>
 #include <fstream>
 
 namespace serialbox {
 
 //===------------------------------------------------------------------------------------------===//
-//     BinaryBuffer
+//     SparseBuffer
 //===------------------------------------------------------------------------------------------===//
 
-/// \brief Contiguous buffer with support for sliced loading
-class BinaryBuffer {
+/// \brief Sparse representation of a field
+///
+/// The encoded field consists of the number of non-zero elements (64-bit unsigned integer), a
+/// bitmap with one bit per element (set for non-zero elements) and the values of the non-zero
+/// elements. An element is zero if all its bytes are zero.
+class SparseBuffer {
 public:
-  /// \brief Allocate the buffer
-  BinaryBuffer(const StorageView& storageView) {
-    const auto& slice = storageView.getSlice();
-
-    if(slice.empty()) {
-      buffer_.resize(storageView.sizeInBytes());
-      offset_ = 0;
-    } else {
-      const auto& dims = storageView.dims();
-      const auto& triple = slice.sliceTriples().back();
-      const int bytesPerElement = storageView.bytesPerElement();
-
-      // Allocate a buffer which can be efficently loaded. The buffer will treat the
-      // dimensions dim_{1}, ..., dim_{N-1} as full while last the dimension dim_{N} as sliced but
-      // without incorporating the step. This is necessary as we only want to call ::write once.
-
-      // Compute dimensions
-      dims_ = dims;
-      dims_.back() = triple.stop - triple.start;
-
-      // Compute strides (col-major)
-      strides_.resize(dims_.size());
-
-      int stride = 1;
-      strides_[0] = stride;
+  using NumNonZerosType = std::uint64_t;
+
+  SparseBuffer(std::size_t numElements, int bytesPerElement)
+      : numElements_(numElements), bytesPerElement_(bytesPerElement), numNonZeros_(0) {}
+
+  /// \brief Check if element `data` is zero
+  static bool isZero(const Byte* data, int bytesPerElement) noexcept {
+    switch(bytesPerElement) {
+    case 8: {
+      std::uint64_t value;
+      std::memcpy(&value, data, 8);
+      return value == 0;
+    }
+    case 4: {
+      std::uint32_t value;
+      std::memcpy(&value, data, 4);
+      return value == 0;
+    }
+    default:
+      for(int i = 0; i < bytesPerElement; ++i)
+        if(data[i] != 0)
+          return false;
+      return true;
+    }
+  }
 
-      for(int i = 1; i < dims_.size(); ++i) {
-        stride *= dims_[i - 1];
-        strides_[i] = stride;
+  /// \brief Encode the dense `binaryBuffer`
+  ///
+  /// \return True iff the sparse encoding is smaller than SparseEncodingThreshold times the dense
+  /// size (otherwise the buffer is left empty)
+  bool encode(const BinaryBuffer& binaryBuffer) {
+    const Byte* data = binaryBuffer.data();
+    const double maxSize = BinaryArchive::SparseEncodingThreshold * double(binaryBuffer.size());
+
+    // Stop counting as soon as the sparse encoding cannot be smaller, dense fields are only
+    // scanned partially
+    if(encodedSize(0) >= maxSize)
+      return false;
+
+    std::size_t numNonZeros = 0;
+    for(std::size_t i = 0; i < numElements_; ++i)
+      if(!isZero(data + i * bytesPerElement_, bytesPerElement_) &&
+         encodedSize(++numNonZeros) >= maxSize)
+        return false;
+
+    numNonZeros_ = numNonZeros;
+    bitmap_.assign(bitmapSize(), 0);
+    values_.resize(numNonZeros * bytesPerElement_);
+
+    Byte* valuePtr = values_.data();
+    for(std::size_t i = 0; i < numElements_; ++i, data += bytesPerElement_)
+      if(!isZero(data, bytesPerElement_)) {
+        bitmap_[i / 8] |= (1 << (i % 8));
+        std::memcpy(valuePtr, data, bytesPerElement_);
+        valuePtr += bytesPerElement_;
       }
-
-      // Compute size
-      std::size_t size = 1;
-      for(std::size_t i = 0; i < dims_.size(); ++i)
-        size *= (dims_[i] == 0 ? 1 : dims_[i]);
-
-      // Compute initial offset in bytes
-      offset_ = (strides_.back() * triple.start) * bytesPerElement;
-
-      buffer_.resize(size * bytesPerElement);
-    }
+    return true;
   }
 
-  /// \brief Copy data from buffer to `storageView` while handling slicing
-  void copyBufferToStorageView(StorageView& storageView) {
-    const auto& slice = storageView.getSlice();
+  /// \brief Write the encoded field to `fs`
+  ///
+  /// The values are written as encoded, `swap` only affects the number of non-zeros.
+  void write(std::ostream& fs, bool swap) const {
+    NumNonZerosType numNonZeros = swap ? byteSwap(numNonZeros_) : numNonZeros_;
+    fs.write(reinterpret_cast<const char*>(&numNonZeros), sizeof(NumNonZerosType));
+    fs.write(bitmap_.data(), bitmap_.size());
+    fs.write(values_.data(), values_.size());
+  }
 
-    if(slice.empty()) {
-      Byte* dataPtr = buffer_.data();
-      const int bytesPerElement = storageView.bytesPerElement();
+  /// \brief Read the encoded field at `offset` of `fs` and byte-swap the number of non-zeros and
+  /// the values if `swap` is true
+  ///
+  /// \throw Exception  The field is truncated or corrupted
+  void read(std::istream& fs, std::uintmax_t offset, bool swap) {
+    readFully(fs, offset, reinterpret_cast<Byte*>(&numNonZeros_), sizeof(NumNonZerosType));
+    if(swap)
+      numNonZeros_ = byteSwap(numNonZeros_);
+    if(numNonZeros_ > numElements_)
+      throw Exception("corrupted sparse field: %i non-zeros in %i elements", numNonZeros_,
+                      numElements_);
+
+    offset += sizeof(NumNonZerosType);
+    bitmap_.resize(bitmapSize());
+    readFully(fs, offset, bitmap_.data(), bitmap_.size());
+    values_.resize(numNonZeros_ * bytesPerElement_);
+    readFully(fs, offset + bitmap_.size(), values_.data(), values_.size());
+    if(swap)
+      byteSwap(values_.data(), numNonZeros_, bytesPerElement_);
+  }
 
-      if(storageView.isMemCopyable()) {
-        std::memcpy(storageView.originPtr(), dataPtr, buffer_.size());
-      } else {
-        for(auto it = storageView.begin(), end = storageView.end(); it != end;
-            ++it, dataPtr += bytesPerElement)
-          std::memcpy(it.ptr(), dataPtr, bytesPerElement);
-      }
+  /// \brief Decode directly into the (unsliced) `storageView`
+  void decode(StorageView& storageView) const {
+    const Byte* valuePtr = values_.data();
 
+    if(storageView.isMemCopyable()) {
+      Byte* dataPtr = storageView.originPtr();
+      std::memset(dataPtr, 0, numElements_ * bytesPerElement_);
+      for(std::size_t i = 0; i < numElements_; ++i)
+        if(isSet(i)) {
+          std::memcpy(dataPtr + i * bytesPerElement_, valuePtr, bytesPerElement_);
+          valuePtr += bytesPerElement_;
+        }
     } else {
-      const int numDims = dims_.size();
-      const auto& triples = slice.sliceTriples();
-      const int bytesPerElement = storageView.bytesPerElement();
-      Byte* dataPtr = buffer_.data();
-
-      // Compute intial indices in the buffer
-      std::vector<int> index(numDims);
-      for(int i = 0; i < numDims - 1; ++i)
-        index[i] = triples[i].start;
-      index.back() = 0;
-
-      // Iterate over the the storageView and the Buffer
-      Byte* curPtr = buffer_.data();
-      for(auto it = storageView.begin(), end = storageView.end(); it != end; ++it) {
-
-        // Compute position of current element
-        int pos = 0;
-        for(int i = 0; i < numDims; ++i)
-          pos += bytesPerElement * (strides_[i] * index[i]);
-        curPtr = dataPtr + pos;
-
-        // Memcopy the current elemment to the storageView
-        std::memcpy(it.ptr(), curPtr, bytesPerElement);
-
-        // Compute the index of the next element in the buffer
-        for(int i = 0; i < numDims; ++i)
-          if((index[i] += triples[i].step) < triples[i].stop)
-            break;
-          else
-            index[i] = triples[i].start;
+      std::size_t i = 0;
+      for(auto it = storageView.begin(), end = storageView.end(); it != end; ++it, ++i) {
+        if(isSet(i)) {
+          std::memcpy(it.ptr(), valuePtr, bytesPerElement_);
+          valuePtr += bytesPerElement_;
+        } else
+          std::memset(it.ptr(), 0, bytesPerElement_);
       }
     }
   }
 
-  /// \brief Copy data from `storageView` to buffer
-  void copyStorageViewToBuffer(const StorageView& storageView) {
-    Byte* dataPtr = buffer_.data();
-    const int bytesPerElement = storageView.bytesPerElement();
-
-    if(storageView.isMemCopyable()) {
-      std::memcpy(dataPtr, storageView.originPtr(), buffer_.size());
-    } else {
-      for(auto it = storageView.begin(), end = storageView.end(); it != end;
-          ++it, dataPtr += bytesPerElement)
-        std::memcpy(dataPtr, it.ptr(), bytesPerElement);
+  /// \brief Decode into the (possibly sliced) `binaryBuffer`
+  void decode(BinaryBuffer& binaryBuffer) const {
+    const std::size_t first = binaryBuffer.offset() / bytesPerElement_;
+    const std::size_t last = first + binaryBuffer.size() / bytesPerElement_;
+
+    // Skip the values of the elements in front of the buffer
+    const Byte* valuePtr = values_.data();
+    for(std::size_t i = 0; i < first; ++i)
+      valuePtr += isSet(i) ? bytesPerElement_ : 0;
+
+    Byte* dataPtr = binaryBuffer.data();
+    for(std::size_t i = first; i < last; ++i, dataPtr += bytesPerElement_) {
+      if(isSet(i)) {
+        std::memcpy(dataPtr, valuePtr, bytesPerElement_);
+        valuePtr += bytesPerElement_;
+      } else
+        std::memset(dataPtr, 0, bytesPerElement_);
     }
   }
 
-  /// \brief Get Buffer size
-  std::size_t size() const noexcept { return buffer_.size(); }
+  /// \brief Size of the encoded field in bytes
+  std::size_t size() const noexcept { return encodedSize(numNonZeros_); }
 
-  /// \brief Get pointer to the beginning of the buffer
-  Byte* data() noexcept { return buffer_.data(); }
-  const Byte* data() const noexcept { return buffer_.data(); }
+private:
+  bool isSet(std::size_t i) const noexcept { return (bitmap_[i / 8] >> (i % 8)) & 1; }
 
-  /// \brief Get initial offset of the data on disk in bytes
-  std::size_t offset() const noexcept { return offset_; }
+  std::size_t bitmapSize() const noexcept { return (numElements_ + 7) / 8; }
 
-private:
-  std::vector<Byte> buffer_;
+  std::size_t encodedSize(std::size_t numNonZeros) const noexcept {
+    return sizeof(NumNonZerosType) + bitmapSize() + numNonZeros * bytesPerElement_;
+  }
 
-  std::vector<int> strides_;
-  std::vector<int> dims_;
-  std::size_t offset_;
+  std::size_t numElements_;
+  int bytesPerElement_;
+  NumNonZerosType numNonZeros_;
+  std::vector<Byte> bitmap_;
+  std::vector<Byte> values_;
 };
 
+static std::string encodingToString(BinaryArchive::EncodingKind encoding) {
+  return (encoding == BinaryArchive::EncodingKind::Sparse ? "sparse" : "dense");
+}
+
+static BinaryArchive::EncodingKind encodingFromString(const std::string& encoding) {
+  if(encoding == "sparse")
+    return BinaryArchive::EncodingKind::Sparse;
+  if(encoding == "dense")
+    return BinaryArchive::EncodingKind::Dense;
+  throw Exception("invalid encoding '%s' in binary archive", encoding);
+}
+
 //===------------------------------------------------------------------------------------------===//
 //     BinaryArchive
 //===------------------------------------------------------------------------------------------===//
 
 const std::string BinaryArchive::Name = "Binary";
 
-const int BinaryArchive::Version = 0;
+const int BinaryArchive::Version = 1;
+
+const double BinaryArchive::SparseEncodingThreshold = 0.75;
+
+BinaryArchive::ByteOrderKind BinaryArchive::nativeByteOrder() noexcept {
+  const std::uint16_t value = 1;
+  unsigned char firstByte;
+  std::memcpy(&firstByte, &value, 1);
+  return (firstByte == 1 ? ByteOrderKind::LittleEndian : ByteOrderKind::BigEndian);
+}
+
+std::string BinaryArchive::byteOrderToString(ByteOrderKind byteOrder) {
+  return (byteOrder == ByteOrderKind::BigEndian ? "big" : "little");
+}
+
+BinaryArchive::ByteOrderKind BinaryArchive::byteOrderFromString(const std::string& byteOrder) {
+  if(byteOrder == "little")
+    return ByteOrderKind::LittleEndian;
+  if(byteOrder == "big")
+    return ByteOrderKind::BigEndian;
+  throw Exception("invalid byte order '%s'", byteOrder);
+}
 
 BinaryArchive::BinaryArchive(OpenModeKind mode, const std::string& directory,
                              const std::string& prefix, bool skipMetaData)
-    : mode_(mode), directory_(directory), prefix_(prefix), json_() {
+    : mode_(mode), directory_(directory), prefix_(prefix), byteOrder_(nativeByteOrder()) {
 
   LOG(info) << "Creating BinaryArchive (mode = " << mode_ << ") from directory " << directory_;
 
@@ -173,18 +244,17 @@ BinaryArchive::BinaryArchive(OpenModeKind mode, const std::string& directory,
   hash_ = HashFactory::create(HashFactory::defaultHash());
 
   try {
-    bool isDir = filesystem::is_directory(directory_);
-
     switch(mode_) {
-    // We are reading, the directory needs to exist
+    // We are reading, the directory needs to exist (if we read the meta-data, this is only checked
+    // if the meta-data cannot be opened)
     case OpenModeKind::Read:
-      if(!isDir)
+      if(skipMetaData && !filesystem::is_directory(directory_))
         throw Exception("no such directory: '%s'", directory_.string());
       break;
     // We are writing or appending, create directories if it they don't exist
     case OpenModeKind::Write:
     case OpenModeKind::Append:
-      if(!isDir)
+      if(!filesystem::is_directory(directory_))
         filesystem::create_directories(directory_);
       break;
     }
@@ -192,7 +262,8 @@ BinaryArchive::BinaryArchive(OpenModeKind mode, const std::string& directory,
     throw Exception(e.what());
   }
 
-  if(!skipMetaData)
+  // When writing, the meta-data is only needed to remove the files it references
+  if(!skipMetaData && (mode_ != OpenModeKind::Write || ArchiveFactory::trustMetaData()))
     readMetaDataFromJson();
 
   // Remove all files
@@ -205,21 +276,78 @@ BinaryArchive::~BinaryArchive() {}
 void BinaryArchive::readMetaDataFromJson() {
   LOG(info) << "Reading MetaData for BinaryArchive ... ";
 
-  // Check if metaData file exists
-  if(!filesystem::exists(metaDatafile_)) {
+  // Opening the meta-data directly saves probing for it
+  std::ifstream fs(metaDatafile_.string(), std::ios::in);
+  if(!fs.is_open()) {
     if(mode_ != OpenModeKind::Read)
       return;
+    if(!filesystem::is_directory(directory_))
+      throw Exception("no such directory: '%s'", directory_.string());
     throw Exception("archive meta data not found in directory '%s'", directory_.string());
   }
 
-  std::ifstream fs(metaDatafile_.string(), std::ios::in);
-  fs >> json_;
-  fs.close();
+  int serialboxVersion = -1, archiveVersion = -1;
+  std::string archiveName, hashAlgorithm;
+  ByteOrderKind byteOrder = nativeByteOrder();
+
+  // Parse the meta-data in a streaming fashion and fill the FieldTable directly
+  try {
+    JsonReader reader(fs);
+    std::string key, field;
+
+    reader.beginObject();
+    while(reader.nextMember(key)) {
+      if(key == "serialbox_version")
+        serialboxVersion = reader.readInteger();
+      else if(key == "archive_name")
+        archiveName = reader.readString();
+      else if(key == "archive_version")
+        archiveVersion = reader.readInteger();
+      else if(key == "hash_algorithm")
+        hashAlgorithm = reader.readString();
+      else if(key == "byte_order")
+        byteOrder = byteOrderFromString(reader.readString());
+      else if(key == "fields_table" && !reader.isNull()) {
+
+        // Deserialize FieldTable
+        reader.beginObject();
+        while(reader.nextMember(field)) {
+          FieldOffsetTable& fieldOffsetTable = fieldTable_[field];
+          fieldOffsetTable.clear();
+
+          // Iterate over savepoint of this field (entries are [offset, checksum, (encoding)])
+          reader.beginArray();
+          while(reader.nextElement()) {
+            FileOffsetType fileOffset{0, "", EncodingKind::Dense};
+
+            reader.beginArray();
+            if(!reader.nextElement())
+              throw Exception("missing offset of field '%s'", field);
+            fileOffset.offset = reader.readInteger();
+
+            if(!reader.nextElement())
+              throw Exception("missing checksum of field '%s'", field);
+            fileOffset.checksum = reader.readString();
+
+            if(reader.nextElement()) {
+              fileOffset.encoding = encodingFromString(reader.readString());
+              if(reader.nextElement())
+                throw Exception("ill-formed entry of field '%s'", field);
+            }
+
+            fieldOffsetTable.push_back(std::move(fileOffset));
+          }
+        }
+      } else
+        reader.skipValue();
+    }
+    reader.end();
+  } catch(Exception& e) {
+    throw Exception("error while parsing %s: %s", metaDatafile_, e.what());
+  }
 
-  int serialboxVersion = json_["serialbox_version"];
-  std::string archiveName = json_["archive_name"];
-  int archiveVersion = json_["archive_version"];
-  std::string hashAlgorithm = json_["hash_algorithm"];
+  if(serialboxVersion == -1 || archiveVersion == -1 || hashAlgorithm.empty())
+    throw Exception("archive meta data %s is incomplete", metaDatafile_);
 
   // Check consistency
   if(!Version::isCompatible(serialboxVersion))
@@ -230,44 +358,35 @@ void BinaryArchive::readMetaDataFromJson() {
   if(archiveName != BinaryArchive::Name)
     throw Exception("archive is not a binary archive");
 
-  if(archiveVersion != BinaryArchive::Version)
+  if(archiveVersion < 0 || archiveVersion > BinaryArchive::Version)
     throw Exception("binary archive version (%s) does not match the version of the library (%s)",
                     archiveVersion, BinaryArchive::Version);
 
-  // Set the correct hash algorithm if we are not writing
-  if(mode_ != OpenModeKind::Write)
+  // Set the correct hash algorithm and byte order if we are not writing
+  if(mode_ != OpenModeKind::Write) {
     hash_ = HashFactory::create(hashAlgorithm);
+    byteOrder_ = byteOrder;
+  }
+}
 
-  // Deserialize FieldTable
-  for(auto it = json_["fields_table"].begin(); it != json_["fields_table"].end(); ++it) {
-    FieldOffsetTable fieldOffsetTable;
+BinaryArchive::ChecksumIndex&
+BinaryArchive::checksumIndexOf(const std::string& field, const FieldOffsetTable& fieldOffsetTable) {
+  ChecksumIndex& checksumIndex = checksumIndex_[field];
 
-    // Iterate over savepoint of this field
-    for(auto fileOffsetIt = it->begin(); fileOffsetIt != it->end(); ++fileOffsetIt)
-      fieldOffsetTable.push_back(FileOffsetType{fileOffsetIt->at(0), fileOffsetIt->at(1)});
+  // Records were removed from the FieldTable, rebuild the index
+  if(checksumIndex.numRecords > fieldOffsetTable.size())
+    checksumIndex = ChecksumIndex{0, {}};
 
-    fieldTable_[it.key()] = fieldOffsetTable;
-  }
+  // Index the records added since the last call (in case of equal checksums the first id is kept)
+  for(std::size_t i = checksumIndex.numRecords; i < fieldOffsetTable.size(); ++i)
+    checksumIndex.ids.emplace(fieldOffsetTable[i].checksum, i);
+  checksumIndex.numRecords = fieldOffsetTable.size();
+  return checksumIndex;
 }
 
 void BinaryArchive::writeMetaDataToJson() {
   LOG(info) << "Update MetaData of BinaryArchive";
 
-  json_.clear();
-
-  // Tag versions
-  json_["serialbox_version"] =
-      100 * SERIALBOX_VERSION_MAJOR + 10 * SERIALBOX_VERSION_MINOR + SERIALBOX_VERSION_PATCH;
-  json_["archive_name"] = BinaryArchive::Name;
-  json_["archive_version"] = BinaryArchive::Version;
-  json_["hash_algorithm"] = hash_->name();
-
-  // FieldsTable
-  for(auto it = fieldTable_.begin(), end = fieldTable_.end(); it != end; ++it) {
-    for(unsigned int id = 0; id < it->second.size(); ++id)
-      json_["fields_table"][it->first].push_back({it->second[id].offset, it->second[id].checksum});
-  }
-
   // Write metaData to disk (just overwrite the file, we assume that there is never more than one
   // Archive per data set and thus our in-memory copy is always the up-to-date one)
   std::ofstream fs(metaDatafile_.string(), std::ios::out | std::ios::trunc);
@@ -275,7 +394,53 @@ void BinaryArchive::writeMetaDataToJson() {
   if(!fs.is_open())
     throw Exception("cannot open file: %s", metaDatafile_);
 
-  fs << json_.dump(2) << std::endl;
+  JsonWriter writer(fs, 2);
+  writer.beginObject();
+
+  writer.key("archive_name");
+  writer.value(BinaryArchive::Name);
+  writer.key("archive_version");
+  writer.value(BinaryArchive::Version);
+  writer.key("byte_order");
+  writer.value(byteOrderToString(byteOrder_));
+
+  // FieldsTable (sorted by name to produce reproducible files)
+  std::vector<FieldTable::const_iterator> fields;
+  fields.reserve(fieldTable_.size());
+  for(auto it = fieldTable_.begin(), end = fieldTable_.end(); it != end; ++it)
+    fields.push_back(it);
+  std::sort(fields.begin(), fields.end(),
+            [](const FieldTable::const_iterator& a, const FieldTable::const_iterator& b) {
+              return a->first < b->first;
+            });
+
+  writer.key("fields_table");
+  writer.beginObject();
+  for(const auto& it : fields) {
+    writer.key(it->first);
+    writer.beginArray();
+    for(const FileOffsetType& fileOffset : it->second) {
+      writer.beginArray();
+      writer.value(static_cast<std::int64_t>(fileOffset.offset));
+      writer.value(fileOffset.checksum);
+      if(fileOffset.encoding != EncodingKind::Dense)
+        writer.value(encodingToString(fileOffset.encoding));
+      writer.endArray();
+    }
+    writer.endArray();
+  }
+  writer.endObject();
+
+  writer.key("hash_algorithm");
+  writer.value(hash_->name());
+
+  // Tag versions
+  writer.key("serialbox_version");
+  writer.value(100 * SERIALBOX_VERSION_MAJOR + 10 * SERIALBOX_VERSION_MINOR +
+               SERIALBOX_VERSION_PATCH);
+
+  writer.endObject();
+  fs << std::endl;
   fs.close();
 }
 
@@ -299,9 +464,19 @@ FieldID BinaryArchive::write(const StorageView& storageView, const std::string&
   BinaryBuffer binaryBuffer(storageView);
   binaryBuffer.copyStorageViewToBuffer(storageView);
 
+  // Convert to the byte order of the archive (before hashing to keep the checksums consistent)
+  const bool swap = needsByteSwap();
+  if(swap)
+    byteSwap(binaryBuffer.data(), storageView.size(), storageView.bytesPerElement());
+
   // Compute hash
   std::string checksum(hash_->hash(binaryBuffer.data(), binaryBuffer.size()));
 
+  // Use the sparse encoding if it is significantly smaller
+  SparseBuffer sparseBuffer(storageView.size(), storageView.bytesPerElement());
+  EncodingKind encoding =
+      sparseBuffer.encode(binaryBuffer) ? EncodingKind::Sparse : EncodingKind::Dense;
+
   // Check if field already exists
   auto it = fieldTable_.find(field);
   FieldID fieldID{field, 0};
@@ -311,21 +486,25 @@ FieldID BinaryArchive::write(const StorageView& storageView, const std::string&
     FieldOffsetTable& fieldOffsetTable = it->second;
 
     // Check if field has already been serialized by comparing the checksum
-    for(std::size_t i = 0; i < fieldOffsetTable.size(); ++i)
-      if(checksum == fieldOffsetTable[i].checksum) {
-        LOG(info) << "Field \"" << field << "\" already serialized (id = " << i << "). Stopping";
-        fieldID.id = i;
-        return fieldID;
-      }
+    ChecksumIndex& checksumIndex = checksumIndexOf(field, fieldOffsetTable);
+    auto checksumIt = checksumIndex.ids.find(checksum);
+    if(checksumIt != checksumIndex.ids.end()) {
+      LOG(info) << "Field \"" << field << "\" already serialized (id = " << checksumIt->second
+                << "). Stopping";
+      fieldID.id = checksumIt->second;
+      return fieldID;
+    }
 
     // Append field at the end
     fs.open(filename.string(), std::ofstream::out | std::ofstream::binary | std::ofstream::app);
+    if(!fs.is_open())
+      throw Exception("cannot open file: '%s'", filename.string());
 #ifdef SERIALBOX_COMPILER_MSVC
     fs.seekp(0, fs.end);
 #endif
     auto offset = fs.tellp();
     fieldID.id = fieldOffsetTable.size();
-    fieldOffsetTable.push_back(FileOffsetType{offset, checksum});
+    fieldOffsetTable.push_back(FileOffsetType{offset, checksum, encoding});
 
     LOG(info) << "Appending field \"" << fieldID.name << "\" (id = " << fieldID.id << ") to "
               << filename.filename();
@@ -333,20 +512,24 @@ FieldID BinaryArchive::write(const StorageView& storageView, const std::string&
   // Field does not exist, create new file and append data
   else {
     fs.open(filename.string(), std::ios::out | std::ios::binary | std::ios::trunc);
+    if(!fs.is_open())
+      throw Exception("cannot open file: '%s'", filename.string());
     fieldID.id = 0;
 
-    fieldTable_.insert(
-        FieldTable::value_type(fieldID.name, FieldOffsetTable(1, FileOffsetType{0, checksum})));
+    fieldTable_.insert(FieldTable::value_type(
+        fieldID.name, FieldOffsetTable(1, FileOffsetType{0, checksum, encoding})));
 
     LOG(info) << "Creating new file " << filename.filename() << " for field \"" << fieldID.name
               << "\" (id = " << fieldID.id << ")";
   }
 
-  if(!fs.is_open())
-    throw Exception("cannot open file: '%s'", filename.string());
-
   // Write binaryData to disk
-  fs.write(binaryBuffer.data(), binaryBuffer.size());
+  if(encoding == EncodingKind::Sparse) {
+    LOG(info) << "Using sparse encoding for field \"" << fieldID.name << "\" ("
+              << sparseBuffer.size() << " instead of " << binaryBuffer.size() << " bytes)";
+    sparseBuffer.write(fs, swap);
+  } else
+    fs.write(binaryBuffer.data(), binaryBuffer.size());
   fs.close();
 
   updateMetaData();
@@ -401,14 +584,41 @@ void BinaryArchive::read(StorageView& storageView, const FieldID& fieldID,
   if(!fs.is_open())
     throw Exception("cannot open file: '%s'", filename);
 
-  // Set position in the stream
-  auto offset = fieldOffsetTable[fieldID.id].offset + binaryBuffer.offset();
-  fs.seekg(offset);
+  // Sparse fields are decoded directly into the StorageView (or the buffer if we are slicing)
+  if(fieldOffsetTable[fieldID.id].encoding == EncodingKind::Sparse) {
+    SparseBuffer sparseBuffer(storageView.size(), storageView.bytesPerElement());
+    try {
+      sparseBuffer.read(fs, fieldOffsetTable[fieldID.id].offset, needsByteSwap());
+    } catch(Exception& e) {
+      throw Exception("cannot read field '%s' (id = %i) from '%s': %s", fieldID.name, fieldID.id,
+                      filename, e.what());
+    }
+    fs.close();
 
-  // Read data into contiguous memory
-  fs.read(binaryBuffer.data(), binaryBuffer.size());
+    if(storageView.getSlice().empty())
+      sparseBuffer.decode(storageView);
+    else {
+      sparseBuffer.decode(binaryBuffer);
+      binaryBuffer.copyBufferToStorageView(storageView);
+    }
+
+    LOG(info) << "Successfully read field \"" << fieldID.name << "\" (id = " << fieldID.id << ")";
+    return;
+  }
+
+  // Read the parts of the record covering the slice (all of it if we are not slicing)
+  auto extents = binaryBuffer.extents(storageView, BinaryBuffer::FileRequestCost);
+  try {
+    binaryBuffer.load(fs, fieldOffsetTable[fieldID.id].offset, extents);
+  } catch(Exception& e) {
+    throw Exception("cannot read field '%s' (id = %i) from '%s': %s", fieldID.name, fieldID.id,
+                    filename, e.what());
+  }
   fs.close();
 
+  if(needsByteSwap())
+    binaryBuffer.byteSwapExtents(extents, storageView.bytesPerElement());
+
   binaryBuffer.copyBufferToStorageView(storageView);
 
   LOG(info) << "Successfully read field \"" << fieldID.name << "\" (id = " << fieldID.id << ")";
@@ -429,22 +639,36 @@ void BinaryArchive::readFromFile(std::string filename, StorageView& storageView)
     throw Exception("cannot open file: '%s'", filename);
 
   // Read data into contiguous memory
-  fs.read(binaryBuffer.data(), binaryBuffer.size());
+  try {
+    readFully(fs, 0, binaryBuffer.data(), binaryBuffer.size());
+  } catch(Exception& e) {
+    throw Exception("cannot read %s: %s", filepath, e.what());
+  }
   fs.close();
 
   binaryBuffer.copyBufferToStorageView(storageView);
 }
 
+Archive::RecordLocation BinaryArchive::locate(const FieldID& fieldID) const {
+  auto it = fieldTable_.find(fieldID.name);
+  if(it == fieldTable_.end() || fieldID.id >= it->second.size())
+    return Archive::locate(fieldID);
+  return RecordLocation{(directory_ / (prefix_ + "_" + fieldID.name + ".dat")).string(),
+                        std::uint64_t(it->second[fieldID.id].offset)};
+}
+
 std::ostream& BinaryArchive::toStream(std::ostream& stream) const {
   stream << "BinaryArchive = {\n";
   stream << "  directory: " << directory_.string() << "\n";
   stream << "  mode: " << mode_ << "\n";
   stream << "  prefix: " << prefix_ << "\n";
+  stream << "  byteOrder: " << byteOrderToString(byteOrder_) << "\n";
   stream << "  fieldsTable = {\n";
   for(auto it = fieldTable_.begin(), end = fieldTable_.end(); it != end; ++it) {
     stream << "    " << it->first << " = {\n";
     for(std::size_t id = 0; id < it->second.size(); ++id)
-      stream << "      [ " << it->second[id].offset << ", " << it->second[id].checksum << " ]\n";
+      stream << "      [ " << it->second[id].offset << ", " << it->second[id].checksum << ", "
+             << encodingToString(it->second[id].encoding) << " ]\n";
     stream << "    }\n";
   }
   stream << "  }\n";
@@ -453,14 +677,31 @@ std::ostream& BinaryArchive::toStream(std::ostream& stream) const {
 }
 
 void BinaryArchive::clear() {
+  // Trusted meta-data references all files of the archive
+  if(ArchiveFactory::trustMetaData()) {
+    for(const auto& field : fieldTable_) {
+      filesystem::path file(directory_ / (prefix_ + "_" + field.first + ".dat"));
+      try {
+        filesystem::remove(file);
+      } catch(filesystem::filesystem_error& e) {
+        LOG(warning) << "BinaryArchive: cannot remove file " << file << ": " << e.what();
+      }
+    }
+    clearFieldTable();
+    return;
+  }
+
+  // Match the names before stat-ing the files, most files of large directories are not ours
+  const std::string filePrefix = prefix_ + "_";
   filesystem::directory_iterator end;
   for(filesystem::directory_iterator it(directory_); it != end; ++it) {
-    if(filesystem::is_regular_file(it->path()) &&
-       boost::algorithm::starts_with(it->path().filename().string(), prefix_ + "_") &&
-       filesystem::path(it->path()).extension() == ".dat") {
+    const filesystem::path& path = it->path();
+    if(path.extension() == ".dat" &&
+       boost::algorithm::starts_with(path.filename().string(), filePrefix) &&
+       filesystem::is_regular_file(path)) {
 
-      if(!filesystem::remove(it->path()))
-        LOG(warning) << "BinaryArchive: cannot remove file " << it->path();
+      if(!filesystem::remove(path))
+        LOG(warning) << "BinaryArchive: cannot remove file " << path;
     }
   }
   clearFieldTable();
@@ -468,7 +709,7 @@ void BinaryArchive::clear() {
 
 void BinaryArchive::clearFieldTable() {
   fieldTable_.clear();
-  json_.clear();
+  checksumIndex_.clear();
 }
 
 std::unique_ptr<Archive> BinaryArchive::create(OpenModeKind mode, const std::string& directory,
@@ -8,7 +8,7 @@
 //===------------------------------------------------------------------------------------------===//
 //
 /// \file
-/// This file implements the non-portable binary archive.
+/// This file implements the binary archive.
 ///
 //===------------------------------------------------------------------------------------------===//
 
@@ -26,7 +26,16 @@
 
 namespace serialbox {
 
-/// \brief Non-portable binary archive
+/// \brief Binary archive
+///
+/// The data is stored in the byte order of the host which created the archive. The byte order is
+/// recorded in the meta-data and the data is byte-swapped while copying it from/to the StorageView
+/// if the archive is read (or appended to) on a host of different byte order. Archives without
+/// recorded byte order are assumed to be in the byte order of the host.
+///
+/// Fields which are mostly zero are automatically stored in a sparse encoding (bitmap of the
+/// non-zero elements followed by their values) if it is significantly smaller than the dense
+/// representation.
 ///
 /// \ingroup core
 class BinaryArchive : public Archive {
@@ -35,12 +44,30 @@ public:
   static const std::string Name;
 
   /// \brief Revision of the binary archive
+  ///
+  /// Archives of all revisions up to (and including) `Version` can be read.
   static const int Version;
 
+  /// \brief Sparse encoding is only used if it needs less than this fraction of the dense size
+  static const double SparseEncodingThreshold;
+
+  /// \brief Encoding of a field on disk
+  enum class EncodingKind : int {
+    Dense = 0, ///< Contiguous (col-major) copy of the data
+    Sparse     ///< Number of non-zeros, bitmap of the non-zero elements followed by their values
+  };
+
+  /// \brief Byte order of the data on disk
+  enum class ByteOrderKind : int {
+    LittleEndian = 0, ///< Least significant byte first
+    BigEndian         ///< Most significant byte first
+  };
+
   /// \brief Offset within a file
   struct FileOffsetType {
     std::streamoff offset; ///< Binary offset within the file
-    std::string checksum;  ///< Checksum of the field
+    std::string checksum;  ///< Checksum of the dense data (in the byte order of the archive)
+    EncodingKind encoding; ///< Encoding of the field
   };
 
   /// \brief Table of ids and corresponding offsets whithin in each field (i.e file)
@@ -113,6 +140,8 @@ public:
 
   virtual bool isSlicedReadingSupported() const override { return true; }
 
+  virtual RecordLocation locate(const FieldID& fieldID) const override;
+
   /// @}
 
   /// \brief Clear fieldTable
@@ -147,6 +176,35 @@ public:
   /// \brief Get the hash algorithm
   const std::unique_ptr<Hash>& hash() const noexcept { return hash_; }
 
+  /// \brief Get the byte order of the data in the archive
+  ByteOrderKind byteOrder() const noexcept { return byteOrder_; }
+
+  /// \brief Get the byte order of the host
+  static ByteOrderKind nativeByteOrder() noexcept;
+
+  /// \brief Convert the byte order to its name in the meta-data (`"little"` or `"big"`)
+  static std::string byteOrderToString(ByteOrderKind byteOrder);
+
+  /// \brief Convert the name of a byte order in the meta-data to ByteOrderKind
+  ///
+  /// \throw Exception  Name is not a valid byte order
+  static ByteOrderKind byteOrderFromString(const std::string& byteOrder);
+
+private:
+  /// \brief Map of the checksums of a field to their ids
+  struct ChecksumIndex {
+    std::size_t numRecords; ///< Number of records of the field which have been indexed
+    std::unordered_map<std::string, unsigned int> ids;
+  };
+
+  /// \brief Get the checksum index of `field`, index records which have not been indexed yet
+  ///
+  /// The index is built on first use such that opening an archive does not have to pay for it.
+  ChecksumIndex& checksumIndexOf(const std::string& field, const FieldOffsetTable& fieldOffsetTable);
+
+  /// \brief Check if the data needs to be byte-swapped when copied from/to the host
+  bool needsByteSwap() const noexcept { return (byteOrder_ != nativeByteOrder()); }
+
 private:
   OpenModeKind mode_;
   filesystem::path directory_;
@@ -154,8 +212,9 @@ private:
 
   filesystem::path metaDatafile_;
   std::unique_ptr<Hash> hash_;
-  json::json json_;
+  ByteOrderKind byteOrder_;
   FieldTable fieldTable_;
+  std::unordered_map<std::string, ChecksumIndex> checksumIndex_;
 };
 
 } // namespace serialbox
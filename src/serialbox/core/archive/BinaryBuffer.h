@@ -0,0 +1,348 @@
+//===-- serialbox/core/archive/BinaryBuffer.h ---------------------------------------*- C++ -*-===//
+//
+//                                    S E R I A L B O X
+//
+// This file is distributed under terms of BSD license.
+// See LICENSE.txt for more information
+//
+//===------------------------------------------------------------------------------------------===//
+//
+/// \file
+/// This file contains the contiguous buffers and byte swapping shared by the binary archives.
+///
+//===------------------------------------------------------------------------------------------===//
+
+#ifndef SERIALBOX_CORE_ARCHIVE_BINARYBUFFER_H
+#define SERIALBOX_CORE_ARCHIVE_BINARYBUFFER_H
+
+#include "serialbox/core/Exception.h"
+#include "serialbox/core/StorageView.h"
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <istream>
+#include <vector>
+
+namespace serialbox {
+
+//===------------------------------------------------------------------------------------------===//
+//     Byte swapping
+//===------------------------------------------------------------------------------------------===//
+
+// The swaps are written as plain shifts which compilers recognize as byte-swaps, the loops below
+// are vectorized into byte shuffles.
+
+inline std::uint16_t byteSwap(std::uint16_t v) noexcept {
+  return static_cast<std::uint16_t>((v >> 8) | (v << 8));
+}
+
+inline std::uint32_t byteSwap(std::uint32_t v) noexcept {
+  return ((v >> 24) & 0x000000FFu) | ((v >> 8) & 0x0000FF00u) | ((v << 8) & 0x00FF0000u) |
+         ((v << 24) & 0xFF000000u);
+}
+
+inline std::uint64_t byteSwap(std::uint64_t v) noexcept {
+  return (std::uint64_t(byteSwap(std::uint32_t(v))) << 32) | byteSwap(std::uint32_t(v >> 32));
+}
+
+template <class T>
+inline void byteSwapElements(Byte* data, std::size_t numElements) noexcept {
+  for(std::size_t i = 0; i < numElements; ++i) {
+    T value;
+    std::memcpy(&value, data + i * sizeof(T), sizeof(T));
+    value = byteSwap(value);
+    std::memcpy(data + i * sizeof(T), &value, sizeof(T));
+  }
+}
+
+/// \brief Reverse the bytes of each of the `numElements` elements of `data` in place
+inline void byteSwap(Byte* data, std::size_t numElements, int bytesPerElement) noexcept {
+  switch(bytesPerElement) {
+  case 1:
+    break;
+  case 2:
+    byteSwapElements<std::uint16_t>(data, numElements);
+    break;
+  case 4:
+    byteSwapElements<std::uint32_t>(data, numElements);
+    break;
+  case 8:
+    byteSwapElements<std::uint64_t>(data, numElements);
+    break;
+  default:
+    for(std::size_t i = 0; i < numElements; ++i)
+      std::reverse(data + i * bytesPerElement, data + (i + 1) * bytesPerElement);
+  }
+}
+
+//===------------------------------------------------------------------------------------------===//
+//     Verified reading
+//===------------------------------------------------------------------------------------------===//
+
+/// \brief Number of times a failed read is retried before giving up
+constexpr int MaxReadRetries = 3;
+
+/// \brief Read exactly `size` bytes at `offset` of `stream` into `data`
+///
+/// A read which stops short of `size` bytes without reaching the end of the stream (i.e the
+/// stream reports an error, e.g an interrupted read) is resumed where it stopped, at most
+/// `MaxReadRetries` times. The streams do not report the cause of an error, hence all errors are
+/// treated as transient.
+///
+/// \throw Exception  Stream ends before `size` bytes were read (i.e the file is truncated) or the
+///                   read failed
+inline void readFully(std::istream& stream, std::uintmax_t offset, Byte* data, std::size_t size) {
+  std::size_t numRead = 0;
+  for(int retry = 0;; ++retry) {
+    stream.clear();
+    stream.seekg(offset + numRead);
+    stream.read(data + numRead, size - numRead);
+    numRead += static_cast<std::size_t>(stream.gcount());
+
+    if(numRead == size)
+      return;
+
+    if(stream.eof())
+      throw Exception("unexpected end of file: read %i of %i bytes at offset %i", numRead, size,
+                      offset);
+
+    if(retry == MaxReadRetries)
+      throw Exception("cannot read %i bytes at offset %i: I/O error after %i retries", size,
+                      offset, MaxReadRetries);
+  }
+}
+
+//===------------------------------------------------------------------------------------------===//
+//     BinaryBuffer
+//===------------------------------------------------------------------------------------------===//
+
+/// \brief Contiguous buffer with support for sliced loading
+class BinaryBuffer {
+public:
+  /// \brief Byte range of the buffer which is loaded from disk
+  struct Extent {
+    std::size_t offset; ///< Offset in the buffer (on disk it is BinaryBuffer::offset() + offset)
+    std::size_t size;   ///< Size in bytes
+  };
+
+  /// \brief Default cost of issuing a read request on a file, in bytes
+  ///
+  /// Reading a gap of up to this many bytes along is assumed to be cheaper than a separate request.
+  static constexpr std::size_t FileRequestCost = 32 * 1024;
+
+  /// \brief Allocate the buffer
+  BinaryBuffer(const StorageView& storageView) {
+    const auto& slice = storageView.getSlice();
+
+    if(slice.empty()) {
+      buffer_.resize(storageView.sizeInBytes());
+      offset_ = 0;
+    } else {
+      const auto& dims = storageView.dims();
+      const auto& triple = slice.sliceTriples().back();
+      const int bytesPerElement = storageView.bytesPerElement();
+
+      // Allocate a buffer which can be efficently loaded. The buffer will treat the
+      // dimensions dim_{1}, ..., dim_{N-1} as full while last the dimension dim_{N} as sliced but
+      // without incorporating the step. The parts of the buffer covering the slice are given by
+      // BinaryBuffer::extents.
+
+      // Compute dimensions
+      dims_ = dims;
+      dims_.back() = triple.stop - triple.start;
+
+      // Compute strides (col-major)
+      strides_.resize(dims_.size());
+
+      int stride = 1;
+      strides_[0] = stride;
+
+      for(int i = 1; i < dims_.size(); ++i) {
+        stride *= dims_[i - 1];
+        strides_[i] = stride;
+      }
+
+      // Compute size
+      std::size_t size = 1;
+      for(std::size_t i = 0; i < dims_.size(); ++i)
+        size *= (dims_[i] == 0 ? 1 : dims_[i]);
+
+      // Compute initial offset in bytes
+      offset_ = (strides_.back() * triple.start) * bytesPerElement;
+
+      buffer_.resize(size * bytesPerElement);
+    }
+  }
+
+  /// \brief Copy data from buffer to `storageView` while handling slicing
+  void copyBufferToStorageView(StorageView& storageView) {
+    const auto& slice = storageView.getSlice();
+
+    if(slice.empty()) {
+      Byte* dataPtr = buffer_.data();
+      const int bytesPerElement = storageView.bytesPerElement();
+
+      if(storageView.isMemCopyable()) {
+        std::memcpy(storageView.originPtr(), dataPtr, buffer_.size());
+      } else {
+        for(auto it = storageView.begin(), end = storageView.end(); it != end;
+            ++it, dataPtr += bytesPerElement)
+          std::memcpy(it.ptr(), dataPtr, bytesPerElement);
+      }
+
+    } else {
+      const int numDims = dims_.size();
+      const auto& triples = slice.sliceTriples();
+      const int bytesPerElement = storageView.bytesPerElement();
+      Byte* dataPtr = buffer_.data();
+
+      // Compute intial indices in the buffer
+      std::vector<int> index(numDims);
+      for(int i = 0; i < numDims - 1; ++i)
+        index[i] = triples[i].start;
+      index.back() = 0;
+
+      // Iterate over the the storageView and the Buffer
+      Byte* curPtr = buffer_.data();
+      for(auto it = storageView.begin(), end = storageView.end(); it != end; ++it) {
+
+        // Compute position of current element
+        int pos = 0;
+        for(int i = 0; i < numDims; ++i)
+          pos += bytesPerElement * (strides_[i] * index[i]);
+        curPtr = dataPtr + pos;
+
+        // Memcopy the current elemment to the storageView
+        std::memcpy(it.ptr(), curPtr, bytesPerElement);
+
+        // Compute the index of the next element in the buffer
+        for(int i = 0; i < numDims; ++i)
+          if((index[i] += triples[i].step) < triples[i].stop)
+            break;
+          else
+            index[i] = triples[i].start;
+      }
+    }
+  }
+
+  /// \brief Get the byte ranges of the buffer covering the elements of the slice of `storageView`
+  ///
+  /// The ranges are sorted and ranges separated by a gap of at most `requestCost` bytes are merged,
+  /// i.e the cost of loading the extents is modelled as `requestCost` bytes per request plus the
+  /// number of bytes read. Dense slices are hence loaded with a single request while slices with
+  /// large steps only load the touched rows and planes. Bytes of the buffer outside of the
+  /// extents are not used by BinaryBuffer::copyBufferToStorageView.
+  std::vector<Extent> extents(const StorageView& storageView, std::size_t requestCost) const {
+    const auto& slice = storageView.getSlice();
+    if(slice.empty() || buffer_.empty())
+      return std::vector<Extent>{Extent{0, buffer_.size()}};
+
+    const int numDims = dims_.size();
+    const std::size_t bytesPerElement = storageView.bytesPerElement();
+
+    // Slice of the buffer (the last dimension of the buffer starts at the start of the slice)
+    std::vector<int> start(numDims), stop(numDims), step(numDims);
+    for(int i = 0; i < numDims; ++i) {
+      const auto& triple = slice.sliceTriples()[i];
+      start[i] = triple.start;
+      stop[i] = triple.stop;
+      step[i] = triple.step;
+    }
+    stop.back() -= start.back();
+    start.back() = 0;
+
+    for(int i = 0; i < numDims; ++i)
+      if(start[i] >= stop[i])
+        return std::vector<Extent>();
+
+    // Leading dimensions which are read in full form contiguous blocks
+    int blockDim = 0;
+    std::size_t blockSize = 1;
+    while(blockDim < numDims && start[blockDim] == 0 && stop[blockDim] == dims_[blockDim] &&
+          step[blockDim] == 1)
+      blockSize *= dims_[blockDim++];
+
+    if(blockDim == numDims)
+      return std::vector<Extent>{Extent{0, buffer_.size()}};
+
+    blockSize *= bytesPerElement;
+
+    // Iterate over the blocks in increasing order and merge them if the gap is small enough
+    std::vector<Extent> extents;
+    std::vector<int> index(start);
+    while(true) {
+      std::size_t pos = 0;
+      for(int i = blockDim; i < numDims; ++i)
+        pos += std::size_t(strides_[i]) * index[i];
+      pos *= bytesPerElement;
+
+      if(!extents.empty() && pos <= extents.back().offset + extents.back().size + requestCost)
+        extents.back().size = pos + blockSize - extents.back().offset;
+      else
+        extents.push_back(Extent{pos, blockSize});
+
+      int i = blockDim;
+      for(; i < numDims; ++i)
+        if((index[i] += step[i]) < stop[i])
+          break;
+        else
+          index[i] = start[i];
+      if(i == numDims)
+        break;
+    }
+    return extents;
+  }
+
+  /// \brief Load `extents` of the record starting at `recordOffset` from `stream`
+  ///
+  /// \throw Exception  Stream is too short or the read failed (see readFully)
+  void load(std::istream& stream, std::uintmax_t recordOffset, const std::vector<Extent>& extents) {
+    for(const Extent& extent : extents)
+      readFully(stream, recordOffset + offset_ + extent.offset, buffer_.data() + extent.offset,
+                extent.size);
+  }
+
+  /// \brief Byte-swap the elements of `extents`
+  void byteSwapExtents(const std::vector<Extent>& extents, int bytesPerElement) noexcept {
+    for(const Extent& extent : extents)
+      byteSwap(buffer_.data() + extent.offset, extent.size / bytesPerElement, bytesPerElement);
+  }
+
+  /// \brief Copy data from `storageView` to buffer
+  void copyStorageViewToBuffer(const StorageView& storageView) {
+    Byte* dataPtr = buffer_.data();
+    const int bytesPerElement = storageView.bytesPerElement();
+
+    if(storageView.isMemCopyable()) {
+      std::memcpy(dataPtr, storageView.originPtr(), buffer_.size());
+    } else {
+      for(auto it = storageView.begin(), end = storageView.end(); it != end;
+          ++it, dataPtr += bytesPerElement)
+        std::memcpy(dataPtr, it.ptr(), bytesPerElement);
+    }
+  }
+
+  /// \brief Get Buffer size
+  std::size_t size() const noexcept { return buffer_.size(); }
+
+  /// \brief Get pointer to the beginning of the buffer
+  Byte* data() noexcept { return buffer_.data(); }
+  const Byte* data() const noexcept { return buffer_.data(); }
+
+  /// \brief Get initial offset of the data on disk in bytes
+  std::size_t offset() const noexcept { return offset_; }
+
+  /// \brief Move the data out of the buffer (the buffer is left empty)
+  std::vector<Byte> release() noexcept { return std::move(buffer_); }
+
+private:
+  std::vector<Byte> buffer_;
+
+  std::vector<int> strides_;
+  std::vector<int> dims_;
+  std::size_t offset_;
+};
+
+} // namespace serialbox
+
+#endif
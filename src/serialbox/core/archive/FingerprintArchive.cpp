@@ -0,0 +1,286 @@
+//===-- serialbox/core/archive/FingerprintArchive.cpp -------------------------------*- C++ -*-===//
+//
+//                                    S E R I A L B O X
+//
+// This file is distributed under terms of BSD license.
+// See LICENSE.txt for more information
+//
+//===------------------------------------------------------------------------------------------===//
+//
+/// \file
+/// This file implements the fingerprint archive which only records checksums and statistics.
+///
+//===------------------------------------------------------------------------------------------===//
+
+#include "serialbox/core/archive/FingerprintArchive.h"
+#include "serialbox/core/Logging.h"
+#include "serialbox/core/Unreachable.h"
+#include "serialbox/core/Version.h"
+#include "serialbox/core/hash/HashFactory.h"
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <limits>
+
+namespace serialbox {
+
+namespace {
+
+template <class T>
+void computeStatistics(const StorageView& storageView, FingerprintArchive::Fingerprint& fingerprint) {
+  double min = std::numeric_limits<double>::infinity();
+  double max = -std::numeric_limits<double>::infinity();
+  double sum = 0.0;
+  std::size_t n = 0;
+
+  for(auto it = storageView.begin(), end = storageView.end(); it != end; ++it) {
+    const double value = double(it.template as<T>());
+    if(std::isnan(value))
+      continue;
+    min = std::min(min, value);
+    max = std::max(max, value);
+    sum += value;
+    ++n;
+  }
+
+  const double nan = std::numeric_limits<double>::quiet_NaN();
+  fingerprint.min = n ? min : nan;
+  fingerprint.max = n ? max : nan;
+  fingerprint.mean = n ? sum / n : nan;
+}
+
+json::json toJSON(double value) { return std::isnan(value) ? json::json() : json::json(value); }
+
+double fromJSON(const json::json& node) {
+  return node.is_null() ? std::numeric_limits<double>::quiet_NaN() : double(node);
+}
+
+} // anonymous namespace
+
+const std::string FingerprintArchive::Name = "Fingerprint";
+
+const int FingerprintArchive::Version = 0;
+
+FingerprintArchive::FingerprintArchive(OpenModeKind mode, const std::string& directory,
+                                       const std::string& prefix)
+    : mode_(mode), directory_(directory), prefix_(prefix) {
+
+  LOG(info) << "Creating FingerprintArchive (mode = " << mode_ << ") from directory "
+            << directory_;
+
+  metaDatafile_ = directory_ / ("ArchiveMetaData-" + prefix_ + ".json");
+  hash_ = HashFactory::create(HashFactory::defaultHash());
+
+  try {
+    bool isDir = filesystem::is_directory(directory_);
+
+    switch(mode_) {
+    // We are reading, the directory needs to exist
+    case OpenModeKind::Read:
+      if(!isDir)
+        throw Exception("no such directory: '%s'", directory_.string());
+      break;
+    // We are writing or appending, create directories if it they don't exist
+    case OpenModeKind::Write:
+    case OpenModeKind::Append:
+      if(!isDir)
+        filesystem::create_directories(directory_);
+      break;
+    }
+  } catch(filesystem::filesystem_error& e) {
+    throw Exception(e.what());
+  }
+
+  if(mode_ != OpenModeKind::Write)
+    readMetaDataFromJson();
+}
+
+void FingerprintArchive::readMetaDataFromJson() {
+  LOG(info) << "Reading MetaData for FingerprintArchive ... ";
+
+  // Check if metaData file exists
+  if(!filesystem::exists(metaDatafile_)) {
+    if(mode_ != OpenModeKind::Read)
+      return;
+    throw Exception("archive meta data not found in directory '%s'", directory_.string());
+  }
+
+  json::json jsonNode;
+  try {
+    std::ifstream fs(metaDatafile_.string(), std::ios::in);
+    fs >> jsonNode;
+    fs.close();
+  } catch(std::exception& e) {
+    throw Exception("JSON parser error: %s", e.what());
+  }
+
+  int serialboxVersion = jsonNode["serialbox_version"];
+  std::string archiveName = jsonNode["archive_name"];
+  int archiveVersion = jsonNode["archive_version"];
+  std::string hashAlgorithm = jsonNode["hash_algorithm"];
+
+  // Check consistency
+  if(!Version::isCompatible(serialboxVersion))
+    throw Exception("serialbox version of fingerprint archive (%s) does not match the version "
+                    "of the library (%s)",
+                    Version::toString(serialboxVersion), SERIALBOX_VERSION_STRING);
+
+  if(archiveName != FingerprintArchive::Name)
+    throw Exception("archive is not a fingerprint archive");
+
+  if(archiveVersion != FingerprintArchive::Version)
+    throw Exception(
+        "fingerprint archive version (%s) does not match the version of the library (%s)",
+        archiveVersion, FingerprintArchive::Version);
+
+  hash_ = HashFactory::create(hashAlgorithm);
+
+  // Deserialize FieldTable
+  const json::json& fieldsTable = jsonNode["fields_table"];
+  for(auto it = fieldsTable.begin(); it != fieldsTable.end(); ++it) {
+    FieldFingerprintTable& fieldFingerprintTable = fieldTable_[it.key()];
+    for(const auto& fingerprintNode : it.value())
+      fieldFingerprintTable.push_back(
+          Fingerprint{fingerprintNode[0], fromJSON(fingerprintNode[1]),
+                      fromJSON(fingerprintNode[2]), fromJSON(fingerprintNode[3])});
+  }
+}
+
+void FingerprintArchive::writeMetaDataToJson() {
+  LOG(info) << "Update MetaData of FingerprintArchive";
+
+  json::json jsonNode;
+
+  // Tag versions
+  jsonNode["serialbox_version"] =
+      100 * SERIALBOX_VERSION_MAJOR + 10 * SERIALBOX_VERSION_MINOR + SERIALBOX_VERSION_PATCH;
+  jsonNode["archive_name"] = FingerprintArchive::Name;
+  jsonNode["archive_version"] = FingerprintArchive::Version;
+  jsonNode["hash_algorithm"] = hash_->name();
+
+  // FieldsTable
+  jsonNode["fields_table"] = json::json::object();
+  for(auto it = fieldTable_.begin(), end = fieldTable_.end(); it != end; ++it) {
+    json::json& fieldNode = jsonNode["fields_table"][it->first];
+    for(const Fingerprint& fingerprint : it->second)
+      fieldNode.push_back({fingerprint.checksum, toJSON(fingerprint.min), toJSON(fingerprint.max),
+                           toJSON(fingerprint.mean)});
+  }
+
+  std::ofstream fs(metaDatafile_.string(), std::ios::out | std::ios::trunc);
+
+  if(!fs.is_open())
+    throw Exception("cannot open file: %s", metaDatafile_);
+
+  fs << jsonNode.dump(2) << std::endl;
+  fs.close();
+}
+
+FingerprintArchive::Fingerprint FingerprintArchive::computeFingerprint(const StorageView& storageView,
+                                                                       Hash& hash) {
+  Fingerprint fingerprint;
+
+  // Compute hash of the contiguous data
+  if(storageView.isMemCopyable())
+    fingerprint.checksum = hash.hash(storageView.originPtr(), int(storageView.sizeInBytes()));
+  else {
+    std::vector<Byte> buffer(storageView.sizeInBytes());
+    Byte* dataPtr = buffer.data();
+    const int bytesPerElement = storageView.bytesPerElement();
+    for(auto it = storageView.begin(), end = storageView.end(); it != end;
+        ++it, dataPtr += bytesPerElement)
+      std::memcpy(dataPtr, it.ptr(), bytesPerElement);
+    fingerprint.checksum = hash.hash(buffer.data(), int(buffer.size()));
+  }
+
+  // Compute statistics
+  switch(storageView.type()) {
+  case TypeID::Boolean:
+    computeStatistics<bool>(storageView, fingerprint);
+    break;
+  case TypeID::Int32:
+    computeStatistics<int>(storageView, fingerprint);
+    break;
+  case TypeID::Int64:
+    computeStatistics<std::int64_t>(storageView, fingerprint);
+    break;
+  case TypeID::Float32:
+    computeStatistics<float>(storageView, fingerprint);
+    break;
+  case TypeID::Float64:
+    computeStatistics<double>(storageView, fingerprint);
+    break;
+  default:
+    serialbox_unreachable("Invalid TypeID");
+  }
+
+  return fingerprint;
+}
+
+FieldID FingerprintArchive::write(const StorageView& storageView, const std::string& field,
+                                  const std::shared_ptr<FieldMetainfoImpl> info) {
+  if(mode_ == OpenModeKind::Read)
+    throw Exception("Archive is not initialized with OpenModeKind set to 'Write' or 'Append'");
+
+  LOG(info) << "Attempting to write fingerprint of field \"" << field << "\" ...";
+
+  Fingerprint fingerprint = computeFingerprint(storageView, *hash_);
+
+  FieldFingerprintTable& fieldFingerprintTable = fieldTable_[field];
+  FieldID fieldID{field, 0};
+
+  // Check if field has already been recorded by comparing the checksum
+  for(std::size_t i = 0; i < fieldFingerprintTable.size(); ++i)
+    if(fingerprint.checksum == fieldFingerprintTable[i].checksum) {
+      LOG(info) << "Field \"" << field << "\" already recorded (id = " << i << "). Stopping";
+      fieldID.id = i;
+      return fieldID;
+    }
+
+  fieldID.id = fieldFingerprintTable.size();
+  fieldFingerprintTable.push_back(std::move(fingerprint));
+
+  updateMetaData();
+
+  LOG(info) << "Successfully recorded fingerprint of field \"" << fieldID.name
+            << "\" (id = " << fieldID.id << ")";
+  return fieldID;
+}
+
+void FingerprintArchive::read(StorageView& storageView, const FieldID& fieldID,
+                              std::shared_ptr<FieldMetainfoImpl> info) const {
+  throw Exception("cannot read field '%s': FingerprintArchive does not store any data",
+                  fieldID.name);
+}
+
+const FingerprintArchive::Fingerprint&
+FingerprintArchive::fingerprint(const FieldID& fieldID) const {
+  auto it = fieldTable_.find(fieldID.name);
+  if(it == fieldTable_.end())
+    throw Exception("no field '%s' registered in FingerprintArchive", fieldID.name);
+
+  if(fieldID.id >= it->second.size())
+    throw Exception("invalid id '%i' of field '%s'", fieldID.id, fieldID.name);
+  return it->second[fieldID.id];
+}
+
+std::ostream& FingerprintArchive::toStream(std::ostream& stream) const {
+  stream << "FingerprintArchive = {\n";
+  stream << "  directory: " << directory_.string() << "\n";
+  stream << "  mode: " << mode_ << "\n";
+  stream << "  prefix: " << prefix_ << "\n";
+  stream << "  fieldsTable = {\n";
+  for(auto it = fieldTable_.begin(), end = fieldTable_.end(); it != end; ++it) {
+    stream << "    " << it->first << " = {\n";
+    for(const Fingerprint& fingerprint : it->second)
+      stream << "      [ " << fingerprint.checksum << ", " << fingerprint.min << ", "
+             << fingerprint.max << ", " << fingerprint.mean << " ]\n";
+    stream << "    }\n";
+  }
+  stream << "  }\n";
+  stream << "}\n";
+  return stream;
+}
+
+} // namespace serialbox
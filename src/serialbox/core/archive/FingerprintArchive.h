@@ -0,0 +1,140 @@
+//===-- serialbox/core/archive/FingerprintArchive.h ---------------------------------*- C++ -*-===//
+//
+//                                    S E R I A L B O X
+//
+// This file is distributed under terms of BSD license.
+// See LICENSE.txt for more information
+//
+//===------------------------------------------------------------------------------------------===//
+//
+/// \file
+/// This file contains the fingerprint archive which only records checksums and statistics.
+///
+//===------------------------------------------------------------------------------------------===//
+
+#ifndef SERIALBOX_CORE_ARCHIVE_FINGERPRINTARCHIVE_H
+#define SERIALBOX_CORE_ARCHIVE_FINGERPRINTARCHIVE_H
+
+#include "serialbox/core/Filesystem.h"
+#include "serialbox/core/Json.h"
+#include "serialbox/core/archive/Archive.h"
+#include "serialbox/core/hash/Hash.h"
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace serialbox {
+
+/// \brief Archive which only records a fingerprint of each field
+///
+/// For each record, the checksum of the data and simple statistics (minimum, maximum and mean of
+/// all elements which are not NaN) are stored in `ArchiveMetaData-prefix.json`. No data files are
+/// written, making a fingerprint of a full run much cheaper than a normal dump. Fingerprints of two
+/// runs (or a fingerprint and a BinaryArchive using the same hash algorithm) can be compared with
+/// `fingerprint_diff.py` to locate the first savepoint and field which are not bit-identical.
+///
+/// Fields cannot be read back from this archive.
+///
+/// \ingroup core
+class FingerprintArchive : public Archive {
+public:
+  /// \brief Name of the fingerprint archive
+  static const std::string Name;
+
+  /// \brief Revision of the fingerprint archive
+  static const int Version;
+
+  /// \brief Fingerprint of a record
+  struct Fingerprint {
+    std::string checksum; ///< Checksum of the field
+    double min;           ///< Minimum of all non-NaN elements (NaN if there are none)
+    double max;           ///< Maximum of all non-NaN elements (NaN if there are none)
+    double mean;          ///< Mean of all non-NaN elements (NaN if there are none)
+  };
+
+  /// \brief Fingerprints of all records of a field
+  using FieldFingerprintTable = std::vector<Fingerprint>;
+
+  /// \brief Table of all fields owned by this archive
+  using FieldTable = std::unordered_map<std::string, FieldFingerprintTable>;
+
+  /// \brief Initialize the archive
+  ///
+  /// \param mode          Policy to open files in the archive
+  /// \param directory     Directory to write/read the meta-data. If the archive is opened in
+  ///                      ´Read´ mode, the directory is expected to supply an
+  ///                      ´ArchiveMetaData-prefix.json´.
+  /// \param prefix        Prefix of the meta-data file
+  FingerprintArchive(OpenModeKind mode, const std::string& directory, const std::string& prefix);
+
+  /// \brief Copy constructor [deleted]
+  FingerprintArchive(const FingerprintArchive&) = delete;
+
+  /// \brief Copy assignment [deleted]
+  FingerprintArchive& operator=(const FingerprintArchive&) = delete;
+
+  /// \brief Load meta-data from JSON file
+  void readMetaDataFromJson();
+
+  /// \brief Convert meta-data to JSON and serialize to file
+  void writeMetaDataToJson();
+
+  /// \name Archive implementation
+  /// \see Archive
+  /// @{
+  virtual FieldID write(const StorageView& storageView, const std::string& fieldID,
+                        const std::shared_ptr<FieldMetainfoImpl> info) override;
+
+  virtual void read(StorageView& storageView, const FieldID& fieldID,
+                    std::shared_ptr<FieldMetainfoImpl> info) const override;
+
+  virtual void updateMetaData() override { writeMetaDataToJson(); }
+
+  virtual OpenModeKind mode() const override { return mode_; }
+
+  virtual std::string directory() const override { return directory_.string(); }
+
+  virtual std::string prefix() const override { return prefix_; }
+
+  virtual std::string name() const override { return FingerprintArchive::Name; }
+
+  virtual std::string metaDataFile() const override { return metaDatafile_.string(); }
+
+  virtual std::ostream& toStream(std::ostream& stream) const override;
+
+  virtual void clear() override { fieldTable_.clear(); }
+
+  virtual bool isReadingThreadSafe() const override { return true; }
+
+  virtual bool isWritingThreadSafe() const override { return false; }
+
+  virtual bool isSlicedReadingSupported() const override { return false; }
+  /// @}
+
+  /// \brief Get field table
+  const FieldTable& fieldTable() const noexcept { return fieldTable_; }
+
+  /// \brief Get the fingerprint of the record `fieldID`
+  ///
+  /// \throw Exception  Record does not exist
+  const Fingerprint& fingerprint(const FieldID& fieldID) const;
+
+  /// \brief Compute the fingerprint of the field given by `storageView` using `hash`
+  static Fingerprint computeFingerprint(const StorageView& storageView, Hash& hash);
+
+  /// \brief Get the hash algorithm
+  const std::unique_ptr<Hash>& hash() const noexcept { return hash_; }
+
+private:
+  OpenModeKind mode_;
+  filesystem::path directory_;
+  std::string prefix_;
+
+  filesystem::path metaDatafile_;
+  std::unique_ptr<Hash> hash_;
+  FieldTable fieldTable_;
+};
+
+} // namespace serialbox
+
+#endif
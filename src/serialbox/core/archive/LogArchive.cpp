@@ -0,0 +1,370 @@
+//===-- serialbox/core/archive/LogArchive.cpp ---------------------------------------*- C++ -*-===//
+//
+//                                    S E R I A L B O X
+//
+// This file is distributed under terms of BSD license.
+// See LICENSE.txt for more information
+//
+//===------------------------------------------------------------------------------------------===//
+//
+/// \file
+/// This file implements the savepoint-major log archive.
+///
+//===------------------------------------------------------------------------------------------===//
+
+#include "serialbox/core/archive/LogArchive.h"
+#include "serialbox/core/archive/BinaryBuffer.h"
+#include "serialbox/core/JsonReader.h"
+#include "serialbox/core/JsonWriter.h"
+#include "serialbox/core/Logging.h"
+#include "serialbox/core/STLExtras.h"
+#include "serialbox/core/Version.h"
+#include "serialbox/core/hash/HashFactory.h"
+#include <algorithm>
+
+namespace serialbox {
+
+const std::string LogArchive::Name = "Log";
+
+const int LogArchive::Version = 0;
+
+LogArchive::LogArchive(OpenModeKind mode, const std::string& directory, const std::string& prefix)
+    : mode_(mode), directory_(directory), prefix_(prefix),
+      byteOrder_(BinaryArchive::nativeByteOrder()), logSize_(0), flushedSize_(0) {
+
+  LOG(info) << "Creating LogArchive (mode = " << mode_ << ") from directory " << directory_;
+
+  metaDatafile_ = directory_ / ("ArchiveMetaData-" + prefix_ + ".json");
+  logFile_ = directory_ / (prefix_ + ".log");
+  hash_ = HashFactory::create(HashFactory::defaultHash());
+
+  // We are writing or appending, create directories if it they don't exist (when reading, a
+  // missing directory is detected if the meta-data cannot be opened)
+  try {
+    if(mode_ != OpenModeKind::Read && !filesystem::is_directory(directory_))
+      filesystem::create_directories(directory_);
+  } catch(filesystem::filesystem_error& e) {
+    throw Exception(e.what());
+  }
+
+  // When writing, the log is removed regardless of its index
+  if(mode_ == OpenModeKind::Write)
+    clear();
+  else
+    readMetaDataFromJson();
+
+  // Continue at the end of the log (records past the end of the index are never referenced)
+  if(mode_ == OpenModeKind::Append && filesystem::exists(logFile_))
+    logSize_ = filesystem::file_size(logFile_);
+  flushedSize_ = logSize_;
+}
+
+LogArchive::~LogArchive() {}
+
+void LogArchive::readMetaDataFromJson() {
+  LOG(info) << "Reading MetaData for LogArchive ... ";
+
+  std::ifstream fs(metaDatafile_.string(), std::ios::in);
+  if(!fs.is_open()) {
+    if(mode_ != OpenModeKind::Read)
+      return;
+    if(!filesystem::is_directory(directory_))
+      throw Exception("no such directory: '%s'", directory_.string());
+    throw Exception("archive meta data not found in directory '%s'", directory_.string());
+  }
+
+  int serialboxVersion = -1, archiveVersion = -1;
+  std::string archiveName, hashAlgorithm;
+  BinaryArchive::ByteOrderKind byteOrder = BinaryArchive::nativeByteOrder();
+
+  try {
+    JsonReader reader(fs);
+    std::string key, field;
+
+    reader.beginObject();
+    while(reader.nextMember(key)) {
+      if(key == "serialbox_version")
+        serialboxVersion = reader.readInteger();
+      else if(key == "archive_name")
+        archiveName = reader.readString();
+      else if(key == "archive_version")
+        archiveVersion = reader.readInteger();
+      else if(key == "hash_algorithm")
+        hashAlgorithm = reader.readString();
+      else if(key == "byte_order")
+        byteOrder = BinaryArchive::byteOrderFromString(reader.readString());
+      else if(key == "fields_table" && !reader.isNull()) {
+
+        // Deserialize the index (entries are [offset, size, checksum])
+        reader.beginObject();
+        while(reader.nextMember(field)) {
+          FieldRecordTable& records = fieldTable_[field];
+          records.clear();
+
+          reader.beginArray();
+          while(reader.nextElement()) {
+            RecordType record{0, 0, ""};
+
+            reader.beginArray();
+            if(!reader.nextElement())
+              throw Exception("missing offset of field '%s'", field);
+            record.offset = reader.readInteger();
+
+            if(!reader.nextElement())
+              throw Exception("missing size of field '%s'", field);
+            record.size = reader.readInteger();
+
+            if(!reader.nextElement())
+              throw Exception("missing checksum of field '%s'", field);
+            record.checksum = reader.readString();
+
+            if(reader.nextElement())
+              throw Exception("ill-formed entry of field '%s'", field);
+
+            records.push_back(std::move(record));
+          }
+        }
+      } else
+        reader.skipValue();
+    }
+    reader.end();
+  } catch(Exception& e) {
+    throw Exception("error while parsing %s: %s", metaDatafile_, e.what());
+  }
+
+  if(serialboxVersion == -1 || archiveVersion == -1 || hashAlgorithm.empty())
+    throw Exception("archive meta data %s is incomplete", metaDatafile_);
+
+  // Check consistency
+  if(!Version::isCompatible(serialboxVersion))
+    throw Exception("serialbox version of log archive (%s) does not match the version "
+                    "of the library (%s)",
+                    Version::toString(serialboxVersion), SERIALBOX_VERSION_STRING);
+
+  if(archiveName != LogArchive::Name)
+    throw Exception("archive is not a log archive");
+
+  if(archiveVersion < 0 || archiveVersion > LogArchive::Version)
+    throw Exception("log archive version (%s) does not match the version of the library (%s)",
+                    archiveVersion, LogArchive::Version);
+
+  // Set the correct hash algorithm and byte order if we are not writing
+  if(mode_ != OpenModeKind::Write) {
+    hash_ = HashFactory::create(hashAlgorithm);
+    byteOrder_ = byteOrder;
+  }
+}
+
+void LogArchive::writeMetaDataToJson() {
+  LOG(info) << "Update MetaData of LogArchive";
+
+  // The index must only refer to records which have been flushed
+  if(logStream_.is_open()) {
+    logStream_.flush();
+    if(!logStream_)
+      throw Exception("cannot flush '%s'", logFile_.string());
+    flushedSize_ = logSize_;
+  }
+
+  std::ofstream fs(metaDatafile_.string(), std::ios::out | std::ios::trunc);
+
+  if(!fs.is_open())
+    throw Exception("cannot open file: %s", metaDatafile_);
+
+  JsonWriter writer(fs, 2);
+  writer.beginObject();
+
+  writer.key("archive_name");
+  writer.value(LogArchive::Name);
+  writer.key("archive_version");
+  writer.value(LogArchive::Version);
+  writer.key("byte_order");
+  writer.value(BinaryArchive::byteOrderToString(byteOrder_));
+
+  // Index (sorted by name to produce reproducible files)
+  std::vector<FieldTable::const_iterator> fields;
+  fields.reserve(fieldTable_.size());
+  for(auto it = fieldTable_.begin(), end = fieldTable_.end(); it != end; ++it)
+    fields.push_back(it);
+  std::sort(fields.begin(), fields.end(),
+            [](const FieldTable::const_iterator& a, const FieldTable::const_iterator& b) {
+              return a->first < b->first;
+            });
+
+  writer.key("fields_table");
+  writer.beginObject();
+  for(const auto& it : fields) {
+    writer.key(it->first);
+    writer.beginArray();
+    for(const RecordType& record : it->second) {
+      writer.beginArray();
+      writer.value(record.offset);
+      writer.value(record.size);
+      writer.value(record.checksum);
+      writer.endArray();
+    }
+    writer.endArray();
+  }
+  writer.endObject();
+
+  writer.key("hash_algorithm");
+  writer.value(hash_->name());
+
+  // Tag versions
+  writer.key("serialbox_version");
+  writer.value(100 * SERIALBOX_VERSION_MAJOR + 10 * SERIALBOX_VERSION_MINOR +
+               SERIALBOX_VERSION_PATCH);
+
+  writer.endObject();
+  fs << std::endl;
+  fs.close();
+}
+
+void LogArchive::updateMetaData() { writeMetaDataToJson(); }
+
+//===------------------------------------------------------------------------------------------===//
+//     Writing
+//===------------------------------------------------------------------------------------------===//
+
+FieldID LogArchive::write(const StorageView& storageView, const std::string& field,
+                          const std::shared_ptr<FieldMetainfoImpl> info) {
+  if(mode_ == OpenModeKind::Read)
+    throw Exception("Archive is not initialized with OpenModeKind set to 'Write' or 'Append'");
+
+  LOG(info) << "Attempting to write field \"" << field << "\" to LogArchive ...";
+
+  // Create binary data buffer (in the byte order of the archive)
+  BinaryBuffer binaryBuffer(storageView);
+  binaryBuffer.copyStorageViewToBuffer(storageView);
+  if(needsByteSwap())
+    byteSwap(binaryBuffer.data(), storageView.size(), storageView.bytesPerElement());
+
+  std::string checksum(hash_->hash(binaryBuffer.data(), binaryBuffer.size()));
+
+  // The log stays open for the lifetime of the archive
+  if(!logStream_.is_open()) {
+    logStream_.open(logFile_.string(), std::ios::out | std::ios::binary | std::ios::app);
+    if(!logStream_.is_open())
+      throw Exception("cannot open file: '%s'", logFile_.string());
+  }
+
+  // Append the record (it is flushed when the meta-data is updated)
+  logStream_.write(binaryBuffer.data(), binaryBuffer.size());
+  if(!logStream_)
+    throw Exception("cannot write field '%s' to '%s'", field, logFile_.string());
+
+  FieldRecordTable& records = fieldTable_[field];
+  FieldID fieldID{field, static_cast<unsigned int>(records.size())};
+  records.push_back(RecordType{logSize_, binaryBuffer.size(), checksum});
+  logSize_ += binaryBuffer.size();
+
+  LOG(info) << "Successfully wrote field \"" << fieldID.name << "\" (id = " << fieldID.id
+            << ") to " << logFile_.filename();
+  return fieldID;
+}
+
+//===------------------------------------------------------------------------------------------===//
+//     Reading
+//===------------------------------------------------------------------------------------------===//
+
+void LogArchive::read(StorageView& storageView, const FieldID& fieldID,
+                      std::shared_ptr<FieldMetainfoImpl> info) const {
+  LOG(info) << "Attempting to read field \"" << fieldID.name << "\" (id = " << fieldID.id
+            << ") via LogArchive ... ";
+
+  auto it = fieldTable_.find(fieldID.name);
+  if(it == fieldTable_.end())
+    throw Exception("no field '%s' registered in LogArchive", fieldID.name);
+
+  if(fieldID.id >= it->second.size())
+    throw Exception("invalid id '%i' of field '%s'", fieldID.id, fieldID.name);
+
+  // The record holds the whole field (even if we are slicing)
+  const RecordType& record = it->second[fieldID.id];
+  std::uint64_t size = storageView.bytesPerElement();
+  for(int dim : storageView.dims())
+    size *= dim;
+
+  if(record.size != size)
+    throw Exception("cannot read field '%s' (id = %i): record has %i bytes, expected %i bytes",
+                    fieldID.name, fieldID.id, record.size, size);
+
+  if(mode_ != OpenModeKind::Read && record.offset + record.size > flushedSize_)
+    throw Exception("cannot read field '%s' (id = %i): record has not been flushed yet (the "
+                    "meta-data needs to be updated first)",
+                    fieldID.name, fieldID.id);
+
+  BinaryBuffer binaryBuffer(storageView);
+
+  std::ifstream fs(logFile_.string(), std::ios::binary);
+  if(!fs.is_open())
+    throw Exception("cannot open file: '%s'", logFile_.string());
+
+  // Read the parts of the record covering the slice (all of it if we are not slicing)
+  auto extents = binaryBuffer.extents(storageView, BinaryBuffer::FileRequestCost);
+  try {
+    binaryBuffer.load(fs, record.offset, extents);
+  } catch(Exception& e) {
+    throw Exception("cannot read field '%s' (id = %i) from '%s': %s", fieldID.name, fieldID.id,
+                    logFile_.string(), e.what());
+  }
+  fs.close();
+
+  if(needsByteSwap())
+    binaryBuffer.byteSwapExtents(extents, storageView.bytesPerElement());
+
+  binaryBuffer.copyBufferToStorageView(storageView);
+
+  LOG(info) << "Successfully read field \"" << fieldID.name << "\" (id = " << fieldID.id << ")";
+}
+
+Archive::RecordLocation LogArchive::locate(const FieldID& fieldID) const {
+  auto it = fieldTable_.find(fieldID.name);
+  if(it == fieldTable_.end() || fieldID.id >= it->second.size())
+    return Archive::locate(fieldID);
+  return RecordLocation{logFile_.string(), it->second[fieldID.id].offset};
+}
+
+std::ostream& LogArchive::toStream(std::ostream& stream) const {
+  stream << "LogArchive = {\n";
+  stream << "  directory: " << directory_.string() << "\n";
+  stream << "  mode: " << mode_ << "\n";
+  stream << "  prefix: " << prefix_ << "\n";
+  stream << "  byteOrder: " << BinaryArchive::byteOrderToString(byteOrder_) << "\n";
+  stream << "  logSize: " << logSize_ << "\n";
+  stream << "  fieldsTable = {\n";
+  for(auto it = fieldTable_.begin(), end = fieldTable_.end(); it != end; ++it) {
+    stream << "    " << it->first << " = {\n";
+    for(const RecordType& record : it->second)
+      stream << "      [ " << record.offset << ", " << record.size << ", " << record.checksum
+             << " ]\n";
+    stream << "    }\n";
+  }
+  stream << "  }\n";
+  stream << "}\n";
+  return stream;
+}
+
+void LogArchive::clear() {
+  if(logStream_.is_open())
+    logStream_.close();
+
+  for(const filesystem::path& file : {logFile_, metaDatafile_}) {
+    try {
+      filesystem::remove(file);
+    } catch(filesystem::filesystem_error& e) {
+      LOG(warning) << "LogArchive: cannot remove file " << file << ": " << e.what();
+    }
+  }
+
+  fieldTable_.clear();
+  logSize_ = 0;
+  flushedSize_ = 0;
+}
+
+std::unique_ptr<Archive> LogArchive::create(OpenModeKind mode, const std::string& directory,
+                                            const std::string& prefix) {
+  return std::make_unique<LogArchive>(mode, directory, prefix);
+}
+
+} // namespace serialbox
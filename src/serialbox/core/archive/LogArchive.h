@@ -0,0 +1,166 @@
+//===-- serialbox/core/archive/LogArchive.h -----------------------------------------*- C++ -*-===//
+//
+//                                    S E R I A L B O X
+//
+// This file is distributed under terms of BSD license.
+// See LICENSE.txt for more information
+//
+//===------------------------------------------------------------------------------------------===//
+//
+/// \file
+/// This file implements the savepoint-major log archive.
+///
+//===------------------------------------------------------------------------------------------===//
+
+#ifndef SERIALBOX_CORE_ARCHIVE_LOGARCHIVE_H
+#define SERIALBOX_CORE_ARCHIVE_LOGARCHIVE_H
+
+#include "serialbox/core/Filesystem.h"
+#include "serialbox/core/archive/Archive.h"
+#include "serialbox/core/archive/BinaryArchive.h"
+#include "serialbox/core/hash/Hash.h"
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace serialbox {
+
+/// \brief Archive appending all records to a single log file
+///
+/// The records are appended to `prefix.log` in the order they are written. As the Serializer
+/// writes the fields of a savepoint one after another, all fields of a savepoint end up
+/// contiguous on disk (savepoint-major layout) and reading a whole savepoint (e.g for a restart)
+/// is a single sequential pass over one file instead of touching one file per field. Reading a
+/// single field over time on the other hand has to skip over the other fields (see
+/// BinaryArchive for the field-major layout).
+///
+/// The index of the log (offset, size and checksum of each record of each field) is stored in
+/// `ArchiveMetaData-prefix.json` and only refers to records which have been flushed to the log.
+/// The log is buffered and only flushed when the meta-data is updated (which the Serializer does
+/// after each write), records can be read once they have been flushed.
+/// The records are stored dense in the byte order of the host which created the archive and are
+/// not deduplicated.
+///
+/// \ingroup core
+class LogArchive : public Archive {
+public:
+  /// \brief Name of the log archive
+  static const std::string Name;
+
+  /// \brief Revision of the log archive
+  static const int Version;
+
+  /// \brief Record of a field in the log
+  struct RecordType {
+    std::uint64_t offset; ///< Binary offset within the log
+    std::uint64_t size;   ///< Size of the record in bytes
+    std::string checksum; ///< Checksum of the data (in the byte order of the archive)
+  };
+
+  /// \brief Records of a field (the id of a record is its position)
+  using FieldRecordTable = std::vector<RecordType>;
+
+  /// \brief Index of all fields owned by this archive
+  using FieldTable = std::unordered_map<std::string, FieldRecordTable>;
+
+  /// \brief Initialize the archive
+  ///
+  /// \param mode       Policy to open files in the archive
+  /// \param directory  Directory to write/read files. If the archive is opened in ´Read´ mode, the
+  ///                   directory is expected to supply an ´ArchiveMetaData-prefix.json´. In case
+  ///                   the archive is opened in ´Write´ mode, an existing log is removed. The
+  ///                   ´Append´ mode continues at the end of an existing log.
+  /// \param prefix     Prefix of the log file
+  LogArchive(OpenModeKind mode, const std::string& directory, const std::string& prefix);
+
+  /// \brief Copy constructor [deleted]
+  LogArchive(const LogArchive&) = delete;
+
+  /// \brief Copy assignment [deleted]
+  LogArchive& operator=(const LogArchive&) = delete;
+
+  /// \brief Destructor
+  virtual ~LogArchive();
+
+  /// \brief Load meta-data from JSON file
+  void readMetaDataFromJson();
+
+  /// \brief Convert meta-data to JSON and serialize to file
+  void writeMetaDataToJson();
+
+  /// \name Archive implementation
+  /// \see Archive
+  /// @{
+  virtual FieldID write(const StorageView& storageView, const std::string& field,
+                        const std::shared_ptr<FieldMetainfoImpl> info) override;
+
+  virtual void read(StorageView& storageView, const FieldID& fieldID,
+                    std::shared_ptr<FieldMetainfoImpl> info) const override;
+
+  virtual void updateMetaData() override;
+
+  virtual OpenModeKind mode() const override { return mode_; }
+
+  virtual std::string directory() const override { return directory_.string(); }
+
+  virtual std::string prefix() const override { return prefix_; }
+
+  virtual std::string name() const override { return LogArchive::Name; }
+
+  virtual std::string metaDataFile() const override { return metaDatafile_.string(); }
+
+  virtual std::ostream& toStream(std::ostream& stream) const override;
+
+  virtual void clear() override;
+
+  virtual bool isReadingThreadSafe() const override { return true; }
+
+  virtual bool isWritingThreadSafe() const override { return false; }
+
+  virtual bool isSlicedReadingSupported() const override { return true; }
+
+  virtual RecordLocation locate(const FieldID& fieldID) const override;
+
+  /// @}
+
+  /// \brief Create a LogArchive
+  static std::unique_ptr<Archive> create(OpenModeKind mode, const std::string& directory,
+                                         const std::string& prefix);
+
+  /// \brief Get the index of the log
+  const FieldTable& fieldTable() const noexcept { return fieldTable_; }
+
+  /// \brief Get the path of the log
+  std::string logFile() const { return logFile_.string(); }
+
+  /// \brief Get the size of the log in bytes
+  std::uint64_t logSize() const noexcept { return logSize_; }
+
+  /// \brief Get the byte order of the data in the archive
+  BinaryArchive::ByteOrderKind byteOrder() const noexcept { return byteOrder_; }
+
+private:
+  /// \brief Check if the data needs to be byte-swapped when copied from/to the host
+  bool needsByteSwap() const noexcept { return (byteOrder_ != BinaryArchive::nativeByteOrder()); }
+
+private:
+  OpenModeKind mode_;
+  filesystem::path directory_;
+  std::string prefix_;
+
+  filesystem::path metaDatafile_;
+  filesystem::path logFile_;
+  std::unique_ptr<Hash> hash_;
+  BinaryArchive::ByteOrderKind byteOrder_;
+  FieldTable fieldTable_;
+
+  std::ofstream logStream_; ///< Opened on first write
+  std::uint64_t logSize_;
+  std::uint64_t flushedSize_; ///< Size of the log which has been flushed
+};
+
+} // namespace serialbox
+
+#endif
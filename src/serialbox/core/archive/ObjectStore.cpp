@@ -0,0 +1,97 @@
+//===-- serialbox/core/archive/ObjectStore.cpp --------------------------------------*- C++ -*-===//
+//
+//                                    S E R I A L B O X
+//
+// This file is distributed under terms of BSD license.
+// See LICENSE.txt for more information
+//
+//===------------------------------------------------------------------------------------------===//
+//
+/// \file
+/// This file implements the object store in a local directory.
+///
+//===------------------------------------------------------------------------------------------===//
+
+#include "serialbox/core/archive/ObjectStore.h"
+#include "serialbox/core/Exception.h"
+#include <atomic>
+#include <fstream>
+
+namespace serialbox {
+
+namespace {
+
+/// \brief Unique suffix of the temporary files of LocalObjectStore::put
+std::string temporarySuffix() {
+  static std::atomic<unsigned long> counter(0);
+  return ".tmp." + std::to_string(counter++);
+}
+
+} // anonymous namespace
+
+LocalObjectStore::LocalObjectStore(const std::string& directory) : directory_(directory) {}
+
+void LocalObjectStore::put(const std::string& key, const Byte* data, std::size_t size) {
+  filesystem::path file(pathOf(key));
+  filesystem::path tmpFile(file.string() + temporarySuffix());
+
+  try {
+    if(!filesystem::is_directory(file.parent_path()))
+      filesystem::create_directories(file.parent_path());
+  } catch(filesystem::filesystem_error& e) {
+    throw Exception(e.what());
+  }
+
+  std::ofstream fs(tmpFile.string(), std::ios::out | std::ios::binary | std::ios::trunc);
+  if(!fs.is_open())
+    throw Exception("cannot open file: '%s'", tmpFile.string());
+  fs.write(data, size);
+  fs.close();
+  if(!fs)
+    throw Exception("cannot write file: '%s'", tmpFile.string());
+
+  try {
+    filesystem::rename(tmpFile, file);
+  } catch(filesystem::filesystem_error& e) {
+    filesystem::remove(tmpFile);
+    throw Exception(e.what());
+  }
+}
+
+std::vector<Byte> LocalObjectStore::get(const std::string& key) const {
+  std::ifstream fs(pathOf(key).string(), std::ios::in | std::ios::binary | std::ios::ate);
+  if(!fs.is_open())
+    throw Exception("object '%s' does not exist in '%s'", key, directory_.string());
+
+  std::vector<Byte> data(static_cast<std::size_t>(fs.tellg()));
+  fs.seekg(0);
+  fs.read(data.data(), data.size());
+  if(!fs)
+    throw Exception("cannot read object '%s' in '%s'", key, directory_.string());
+  return data;
+}
+
+void LocalObjectStore::getRange(const std::string& key, std::uintmax_t offset, std::size_t size,
+                                Byte* data) const {
+  std::ifstream fs(pathOf(key).string(), std::ios::in | std::ios::binary);
+  if(!fs.is_open())
+    throw Exception("object '%s' does not exist in '%s'", key, directory_.string());
+
+  fs.seekg(offset);
+  fs.read(data, size);
+  if(!fs)
+    throw Exception("cannot read %i bytes at offset %i of object '%s' in '%s'", size, offset, key,
+                    directory_.string());
+}
+
+bool LocalObjectStore::exists(const std::string& key) const {
+  return filesystem::exists(pathOf(key));
+}
+
+void LocalObjectStore::remove(const std::string& key) {
+  filesystem::path file(pathOf(key));
+  if(filesystem::exists(file))
+    filesystem::remove(file);
+}
+
+} // namespace serialbox
@@ -0,0 +1,100 @@
+//===-- serialbox/core/archive/ObjectStore.h ----------------------------------------*- C++ -*-===//
+//
+//                                    S E R I A L B O X
+//
+// This file is distributed under terms of BSD license.
+// See LICENSE.txt for more information
+//
+//===------------------------------------------------------------------------------------------===//
+//
+/// \file
+/// This file contains the interface to object stores and an object store in a local directory.
+///
+//===------------------------------------------------------------------------------------------===//
+
+#ifndef SERIALBOX_CORE_ARCHIVE_OBJECTSTORE_H
+#define SERIALBOX_CORE_ARCHIVE_OBJECTSTORE_H
+
+#include "serialbox/core/Filesystem.h"
+#include "serialbox/core/Type.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace serialbox {
+
+/// \brief Abstract interface of an object store (e.g S3)
+///
+/// Objects are identified by a key (using `/` as separator) and are written as a whole. All
+/// methods need to be thread-safe.
+///
+/// \ingroup core
+class ObjectStore {
+public:
+  /// \brief Virtual destructor
+  virtual ~ObjectStore() {}
+
+  /// \brief Store the `size` bytes of `data` as object `key` (replacing an existing object)
+  ///
+  /// \throw Exception  Object cannot be stored
+  virtual void put(const std::string& key, const Byte* data, std::size_t size) = 0;
+
+  /// \brief Get the object `key`
+  ///
+  /// \throw Exception  Object does not exist
+  virtual std::vector<Byte> get(const std::string& key) const = 0;
+
+  /// \brief Get `size` bytes of the object `key` starting at `offset` into `data`
+  ///
+  /// \throw Exception  Object does not exist or is too small
+  virtual void getRange(const std::string& key, std::uintmax_t offset, std::size_t size,
+                        Byte* data) const = 0;
+
+  /// \brief Check if the object `key` exists
+  virtual bool exists(const std::string& key) const = 0;
+
+  /// \brief Remove the object `key` (if it exists)
+  virtual void remove(const std::string& key) = 0;
+
+  /// \brief Location of the store (e.g the URL of the bucket)
+  virtual std::string location() const = 0;
+};
+
+/// \brief Object store in a local directory
+///
+/// Each object is a file in the directory, keys containing `/` create sub-directories. Objects are
+/// written to a temporary file which is renamed, hence readers never see a partial object.
+///
+/// \ingroup core
+class LocalObjectStore : public ObjectStore {
+public:
+  /// \brief Use the directory `directory` (created on the first write if it does not exist)
+  explicit LocalObjectStore(const std::string& directory);
+
+  /// \name ObjectStore implementation
+  /// \see ObjectStore
+  /// @{
+  virtual void put(const std::string& key, const Byte* data, std::size_t size) override;
+
+  virtual std::vector<Byte> get(const std::string& key) const override;
+
+  virtual void getRange(const std::string& key, std::uintmax_t offset, std::size_t size,
+                        Byte* data) const override;
+
+  virtual bool exists(const std::string& key) const override;
+
+  virtual void remove(const std::string& key) override;
+
+  virtual std::string location() const override { return directory_.string(); }
+  /// @}
+
+  /// \brief Path of the file of object `key`
+  filesystem::path pathOf(const std::string& key) const { return directory_ / key; }
+
+private:
+  filesystem::path directory_;
+};
+
+} // namespace serialbox
+
+#endif
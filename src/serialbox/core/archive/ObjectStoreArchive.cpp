@@ -0,0 +1,395 @@
+//===-- serialbox/core/archive/ObjectStoreArchive.cpp -------------------------------*- C++ -*-===//
+//
+//                                    S E R I A L B O X
+//
+// This file is distributed under terms of BSD license.
+// See LICENSE.txt for more information
+//
+//===------------------------------------------------------------------------------------------===//
+//
+/// \file
+/// This file implements the archive storing the records as objects in an object store.
+///
+//===------------------------------------------------------------------------------------------===//
+
+#include "serialbox/core/archive/ObjectStoreArchive.h"
+#include "serialbox/core/JsonReader.h"
+#include "serialbox/core/JsonWriter.h"
+#include "serialbox/core/Logging.h"
+#include "serialbox/core/Version.h"
+#include "serialbox/core/archive/BinaryBuffer.h"
+#include "serialbox/core/hash/HashFactory.h"
+#include "serialbox/core/hash/SHA256.h"
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <sstream>
+#include <thread>
+
+namespace serialbox {
+
+const std::string ObjectStoreArchive::Name = "ObjectStore";
+
+const int ObjectStoreArchive::Version = 0;
+
+const std::size_t ObjectStoreArchive::BatchSize = 64 * 1024 * 1024;
+
+const std::size_t ObjectStoreArchive::RequestCost = 1024 * 1024;
+
+ObjectStoreArchive::ObjectStoreArchive(OpenModeKind mode, const std::string& directory,
+                                       const std::string& prefix)
+    : mode_(mode), store_(std::make_shared<LocalObjectStore>(directory)), prefix_(prefix),
+      numThreads_(0) {
+  if(mode_ == OpenModeKind::Read && !filesystem::is_directory(directory))
+    throw Exception("no such directory: '%s'", directory);
+  init();
+}
+
+ObjectStoreArchive::ObjectStoreArchive(OpenModeKind mode, std::shared_ptr<ObjectStore> store,
+                                       const std::string& prefix)
+    : mode_(mode), store_(std::move(store)), prefix_(prefix), numThreads_(0) {
+  init();
+}
+
+void ObjectStoreArchive::init() {
+  LOG(info) << "Creating ObjectStoreArchive (mode = " << mode_ << ") from object store "
+            << store_->location();
+
+  // The checksums are the keys of the objects, a collision-resistant hash is required
+  hash_ = HashFactory::create(SHA256::Name);
+  byteOrder_ = BinaryArchive::nativeByteOrder();
+  pendingBytes_ = 0;
+  isManifestOutdated_ = false;
+
+  if(mode_ == OpenModeKind::Write)
+    clear();
+  else
+    readMetaDataFromJson();
+}
+
+ObjectStoreArchive::~ObjectStoreArchive() {
+  if(mode_ == OpenModeKind::Read || (pending_.empty() && !isManifestOutdated_))
+    return;
+
+  try {
+    flush();
+  } catch(std::exception& e) {
+    LOG(warning) << "Failed to upload the records of ObjectStoreArchive: " << e.what();
+  }
+}
+
+void ObjectStoreArchive::readMetaDataFromJson() {
+  LOG(info) << "Reading MetaData for ObjectStoreArchive ... ";
+
+  fieldTable_.clear();
+  ids_.clear();
+
+  if(!store_->exists(manifestKey())) {
+    if(mode_ != OpenModeKind::Read)
+      return;
+    throw Exception("archive meta data not found in '%s'", store_->location());
+  }
+
+  std::vector<Byte> manifest = store_->get(manifestKey());
+  std::istringstream ss(std::string(manifest.data(), manifest.size()));
+
+  int serialboxVersion = -1, archiveVersion = -1;
+  std::string archiveName, hashAlgorithm;
+  BinaryArchive::ByteOrderKind byteOrder = BinaryArchive::nativeByteOrder();
+
+  try {
+    JsonReader reader(ss);
+    std::string key, field;
+
+    reader.beginObject();
+    while(reader.nextMember(key)) {
+      if(key == "serialbox_version")
+        serialboxVersion = reader.readInteger();
+      else if(key == "archive_name")
+        archiveName = reader.readString();
+      else if(key == "archive_version")
+        archiveVersion = reader.readInteger();
+      else if(key == "hash_algorithm")
+        hashAlgorithm = reader.readString();
+      else if(key == "byte_order")
+        byteOrder = BinaryArchive::byteOrderFromString(reader.readString());
+      else if(key == "fields_table") {
+        reader.beginObject();
+        while(reader.nextMember(field)) {
+          FieldObjectTable& fieldObjectTable = fieldTable_[field];
+          reader.beginArray();
+          while(reader.nextElement()) {
+            fieldObjectTable.push_back(reader.readString());
+            ids_[field].emplace(fieldObjectTable.back(), fieldObjectTable.size() - 1);
+          }
+        }
+      } else
+        reader.skipValue();
+    }
+    reader.end();
+  } catch(Exception& e) {
+    throw Exception("error while parsing %s: %s", manifestKey(), e.what());
+  }
+
+  if(serialboxVersion == -1 || archiveVersion == -1 || hashAlgorithm.empty())
+    throw Exception("archive meta data %s is incomplete", manifestKey());
+
+  if(!Version::isCompatible(serialboxVersion))
+    throw Exception("serialbox version of object store archive (%s) does not match the version "
+                    "of the library (%s)",
+                    Version::toString(serialboxVersion), SERIALBOX_VERSION_STRING);
+
+  if(archiveName != ObjectStoreArchive::Name)
+    throw Exception("archive is not an object store archive");
+
+  if(archiveVersion < 0 || archiveVersion > ObjectStoreArchive::Version)
+    throw Exception(
+        "object store archive version (%s) does not match the version of the library (%s)",
+        archiveVersion, ObjectStoreArchive::Version);
+
+  if(hashAlgorithm != hash_->name())
+    throw Exception("unsupported hash algorithm '%s' of object store archive", hashAlgorithm);
+
+  byteOrder_ = byteOrder;
+}
+
+void ObjectStoreArchive::writeMetaDataToJson() {
+  LOG(info) << "Update MetaData of ObjectStoreArchive";
+
+  std::ostringstream ss;
+  JsonWriter writer(ss, 2);
+  writer.beginObject();
+
+  writer.key("archive_name");
+  writer.value(ObjectStoreArchive::Name);
+  writer.key("archive_version");
+  writer.value(ObjectStoreArchive::Version);
+  writer.key("byte_order");
+  writer.value(BinaryArchive::byteOrderToString(byteOrder_));
+
+  // FieldsTable (sorted by name to produce reproducible manifests)
+  std::vector<FieldTable::const_iterator> fields;
+  fields.reserve(fieldTable_.size());
+  for(auto it = fieldTable_.begin(), end = fieldTable_.end(); it != end; ++it)
+    fields.push_back(it);
+  std::sort(fields.begin(), fields.end(),
+            [](const FieldTable::const_iterator& a, const FieldTable::const_iterator& b) {
+              return a->first < b->first;
+            });
+
+  writer.key("fields_table");
+  writer.beginObject();
+  for(const auto& it : fields) {
+    writer.key(it->first);
+    writer.beginArray();
+    for(const std::string& checksum : it->second)
+      writer.value(checksum);
+    writer.endArray();
+  }
+  writer.endObject();
+
+  writer.key("hash_algorithm");
+  writer.value(hash_->name());
+
+  writer.key("serialbox_version");
+  writer.value(100 * SERIALBOX_VERSION_MAJOR + 10 * SERIALBOX_VERSION_MINOR +
+               SERIALBOX_VERSION_PATCH);
+
+  writer.endObject();
+  ss << std::endl;
+
+  const std::string manifest = ss.str();
+  store_->put(manifestKey(), manifest.data(), manifest.size());
+  isManifestOutdated_ = false;
+}
+
+void ObjectStoreArchive::flush() {
+  if(mode_ == OpenModeKind::Read)
+    return;
+
+  // Upload the pending records in parallel (records are immutable, existing objects are kept)
+  std::vector<std::unordered_map<std::string, std::vector<Byte>>::iterator> records;
+  for(auto it = pending_.begin(); it != pending_.end(); ++it)
+    records.push_back(it);
+
+  if(!records.empty()) {
+    LOG(info) << "Uploading " << records.size() << " records (" << pendingBytes_ << " bytes) to "
+              << store_->location();
+
+    int numThreads = numThreads_ > 0 ? numThreads_ : int(std::thread::hardware_concurrency());
+    numThreads = std::max(1, std::min(numThreads, int(records.size())));
+
+    std::vector<char> isUploaded(records.size(), false);
+    std::atomic<std::size_t> nextRecord(0);
+    std::mutex errorMutex;
+    std::exception_ptr error;
+
+    auto uploader = [&]() {
+      for(std::size_t i = nextRecord++; i < records.size(); i = nextRecord++) {
+        try {
+          const std::string key = objectKey(records[i]->first);
+          if(!store_->exists(key))
+            store_->put(key, records[i]->second.data(), records[i]->second.size());
+          isUploaded[i] = true;
+        } catch(...) {
+          std::lock_guard<std::mutex> lock(errorMutex);
+          if(!error)
+            error = std::current_exception();
+        }
+      }
+    };
+
+    if(numThreads == 1)
+      uploader();
+    else {
+      std::vector<std::thread> threads;
+      for(int i = 0; i < numThreads; ++i)
+        threads.emplace_back(uploader);
+      for(auto& thread : threads)
+        thread.join();
+    }
+
+    {
+      std::lock_guard<std::mutex> lock(pendingMutex_);
+      for(std::size_t i = 0; i < records.size(); ++i)
+        if(isUploaded[i]) {
+          pendingBytes_ -= records[i]->second.size();
+          pending_.erase(records[i]);
+        }
+    }
+
+    if(error)
+      std::rethrow_exception(error);
+  }
+
+  writeMetaDataToJson();
+}
+
+void ObjectStoreArchive::updateMetaData() {
+  if(pendingBytes_ >= BatchSize || (pending_.empty() && isManifestOutdated_))
+    flush();
+}
+
+void ObjectStoreArchive::clear() {
+  std::lock_guard<std::mutex> lock(pendingMutex_);
+  fieldTable_.clear();
+  ids_.clear();
+  pending_.clear();
+  pendingBytes_ = 0;
+  isManifestOutdated_ = false;
+
+  // The objects might be shared with other serializers, only the manifest is removed
+  if(mode_ != OpenModeKind::Read)
+    store_->remove(manifestKey());
+}
+
+//===------------------------------------------------------------------------------------------===//
+//     Writing
+//===------------------------------------------------------------------------------------------===//
+
+FieldID ObjectStoreArchive::write(const StorageView& storageView, const std::string& field,
+                                  const std::shared_ptr<FieldMetainfoImpl> info) {
+  if(mode_ == OpenModeKind::Read)
+    throw Exception("Archive is not initialized with OpenModeKind set to 'Write' or 'Append'");
+
+  LOG(info) << "Attempting to write field \"" << field << "\" to ObjectStoreArchive ...";
+
+  BinaryBuffer binaryBuffer(storageView);
+  binaryBuffer.copyStorageViewToBuffer(storageView);
+
+  // Convert to the byte order of the archive (before hashing to keep the checksums consistent)
+  if(byteOrder_ != BinaryArchive::nativeByteOrder())
+    byteSwap(binaryBuffer.data(), storageView.size(), storageView.bytesPerElement());
+
+  std::string checksum(hash_->hash(binaryBuffer.data(), binaryBuffer.size()));
+
+  // Check if field has already been serialized by comparing the checksum
+  FieldObjectTable& fieldObjectTable = fieldTable_[field];
+  auto idIt = ids_[field].emplace(checksum, fieldObjectTable.size());
+  FieldID fieldID{field, idIt.first->second};
+  if(!idIt.second) {
+    LOG(info) << "Field \"" << field << "\" already serialized (id = " << fieldID.id
+              << "). Stopping";
+    return fieldID;
+  }
+
+  fieldObjectTable.push_back(checksum);
+  isManifestOutdated_ = true;
+
+  // Identical records of other fields share the object
+  std::lock_guard<std::mutex> lock(pendingMutex_);
+  if(!pending_.count(checksum)) {
+    pendingBytes_ += binaryBuffer.size();
+    pending_.emplace(checksum, binaryBuffer.release());
+  }
+
+  LOG(info) << "Successfully wrote field \"" << fieldID.name << "\" (id = " << fieldID.id
+            << ") as object " << checksum;
+  return fieldID;
+}
+
+//===------------------------------------------------------------------------------------------===//
+//     Reading
+//===------------------------------------------------------------------------------------------===//
+
+void ObjectStoreArchive::read(StorageView& storageView, const FieldID& fieldID,
+                              std::shared_ptr<FieldMetainfoImpl> info) const {
+  LOG(info) << "Attempting to read field \"" << fieldID.name << "\" (id = " << fieldID.id
+            << ") via ObjectStoreArchive ... ";
+
+  auto it = fieldTable_.find(fieldID.name);
+  if(it == fieldTable_.end())
+    throw Exception("no field '%s' registered in ObjectStoreArchive", fieldID.name);
+
+  if(fieldID.id >= it->second.size())
+    throw Exception("invalid id '%i' of field '%s'", fieldID.id, fieldID.name);
+
+  const std::string& checksum = it->second[fieldID.id];
+
+  // Sliced reads only fetch the ranges of the object covering the slice
+  BinaryBuffer binaryBuffer(storageView);
+  bool isPending = false;
+  {
+    std::lock_guard<std::mutex> lock(pendingMutex_);
+    auto pendingIt = pending_.find(checksum);
+    if(pendingIt != pending_.end()) {
+      if(binaryBuffer.offset() + binaryBuffer.size() > pendingIt->second.size())
+        throw Exception("record of field '%s' (id = %i) is too small", fieldID.name, fieldID.id);
+      std::memcpy(binaryBuffer.data(), pendingIt->second.data() + binaryBuffer.offset(),
+                  binaryBuffer.size());
+      isPending = true;
+    }
+  }
+
+  auto extents = binaryBuffer.extents(storageView, RequestCost);
+  if(!isPending)
+    for(const auto& extent : extents)
+      store_->getRange(objectKey(checksum), binaryBuffer.offset() + extent.offset, extent.size,
+                       binaryBuffer.data() + extent.offset);
+
+  if(byteOrder_ != BinaryArchive::nativeByteOrder())
+    binaryBuffer.byteSwapExtents(extents, storageView.bytesPerElement());
+
+  binaryBuffer.copyBufferToStorageView(storageView);
+
+  LOG(info) << "Successfully read field \"" << fieldID.name << "\" (id = " << fieldID.id << ")";
+}
+
+std::ostream& ObjectStoreArchive::toStream(std::ostream& stream) const {
+  stream << "ObjectStoreArchive = {\n";
+  stream << "  store: " << store_->location() << "\n";
+  stream << "  mode: " << mode_ << "\n";
+  stream << "  prefix: " << prefix_ << "\n";
+  stream << "  fieldsTable = {\n";
+  for(auto it = fieldTable_.begin(), end = fieldTable_.end(); it != end; ++it) {
+    stream << "    " << it->first << " = {\n";
+    for(const std::string& checksum : it->second)
+      stream << "      " << checksum << "\n";
+    stream << "    }\n";
+  }
+  stream << "  }\n";
+  stream << "}\n";
+  return stream;
+}
+
+} // namespace serialbox
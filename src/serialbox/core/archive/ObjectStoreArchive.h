@@ -0,0 +1,178 @@
+//===-- serialbox/core/archive/ObjectStoreArchive.h ---------------------------------*- C++ -*-===//
+//
+//                                    S E R I A L B O X
+//
+// This file is distributed under terms of BSD license.
+// See LICENSE.txt for more information
+//
+//===------------------------------------------------------------------------------------------===//
+//
+/// \file
+/// This file contains the archive storing the records as objects in an object store.
+///
+//===------------------------------------------------------------------------------------------===//
+
+#ifndef SERIALBOX_CORE_ARCHIVE_OBJECTSTOREARCHIVE_H
+#define SERIALBOX_CORE_ARCHIVE_OBJECTSTOREARCHIVE_H
+
+#include "serialbox/core/archive/Archive.h"
+#include "serialbox/core/archive/BinaryArchive.h"
+#include "serialbox/core/archive/ObjectStore.h"
+#include "serialbox/core/hash/Hash.h"
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace serialbox {
+
+/// \brief Archive storing each record as an immutable, content-addressed object in an ObjectStore
+///
+/// The record of a field is stored (contiguous, col-major) as the object `objects/<checksum>`,
+/// identical records of all fields and serializers sharing the store are stored once. The
+/// meta-data of the archive (the checksums of the records of each field) is the manifest object
+/// `ArchiveMetaData-prefix.json`. Sliced reads only fetch the required ranges of the object.
+///
+/// Records are uploaded in batches of up to ObjectStoreArchive::BatchSize bytes by several
+/// threads. The manifest is written after each batch, i.e records of an incomplete batch (and
+/// the manifest referring to them) are only persisted once the batch is full, ObjectStoreArchive::
+/// flush is called or the archive is destroyed.
+///
+/// Constructed by the ArchiveFactory, the archive uses a LocalObjectStore in the directory of the
+/// serializer.
+///
+/// \ingroup core
+class ObjectStoreArchive : public Archive {
+public:
+  /// \brief Name of the object store archive
+  static const std::string Name;
+
+  /// \brief Revision of the object store archive
+  static const int Version;
+
+  /// \brief Maximal number of bytes of records which are buffered before they are uploaded
+  static const std::size_t BatchSize;
+
+  /// \brief Cost of a range request in bytes, sliced reads fetch gaps of up to this size along
+  ///
+  /// \see BinaryBuffer::extents
+  static const std::size_t RequestCost;
+
+  /// \brief Checksums of the records of a field
+  using FieldObjectTable = std::vector<std::string>;
+
+  /// \brief Table of all fields owned by this archive
+  using FieldTable = std::unordered_map<std::string, FieldObjectTable>;
+
+  /// \brief Initialize the archive using a LocalObjectStore in `directory`
+  ///
+  /// \param mode       Policy to open the archive
+  /// \param directory  Directory of the LocalObjectStore. If the archive is opened in ´Read´
+  ///                   mode, the directory is expected to supply an ´ArchiveMetaData-prefix.json´.
+  /// \param prefix     Prefix of the manifest
+  ObjectStoreArchive(OpenModeKind mode, const std::string& directory, const std::string& prefix);
+
+  /// \brief Initialize the archive using the object store `store`
+  ///
+  /// \param mode    Policy to open the archive
+  /// \param store   Object store of the records and the manifest
+  /// \param prefix  Prefix of the manifest
+  ObjectStoreArchive(OpenModeKind mode, std::shared_ptr<ObjectStore> store,
+                     const std::string& prefix);
+
+  /// \brief Copy constructor [deleted]
+  ObjectStoreArchive(const ObjectStoreArchive&) = delete;
+
+  /// \brief Copy assignment [deleted]
+  ObjectStoreArchive& operator=(const ObjectStoreArchive&) = delete;
+
+  /// \brief Upload the pending records and the manifest
+  virtual ~ObjectStoreArchive();
+
+  /// \brief Load the manifest from the object store
+  void readMetaDataFromJson();
+
+  /// \brief Write the manifest to the object store
+  void writeMetaDataToJson();
+
+  /// \brief Upload the pending records and write the manifest
+  ///
+  /// \throw Exception  Upload failed (the failed records stay pending)
+  void flush();
+
+  /// \brief Set the number of threads used to upload a batch (0 uses one per core)
+  void setNumThreads(int numThreads) noexcept { numThreads_ = numThreads; }
+
+  /// \name Archive implementation
+  /// \see Archive
+  /// @{
+  virtual FieldID write(const StorageView& storageView, const std::string& field,
+                        const std::shared_ptr<FieldMetainfoImpl> info) override;
+
+  virtual void read(StorageView& storageView, const FieldID& fieldID,
+                    std::shared_ptr<FieldMetainfoImpl> info) const override;
+
+  virtual void updateMetaData() override;
+
+  virtual OpenModeKind mode() const override { return mode_; }
+
+  virtual std::string directory() const override { return store_->location(); }
+
+  virtual std::string prefix() const override { return prefix_; }
+
+  virtual std::string name() const override { return ObjectStoreArchive::Name; }
+
+  virtual std::string metaDataFile() const override { return manifestKey(); }
+
+  virtual std::ostream& toStream(std::ostream& stream) const override;
+
+  virtual void clear() override;
+
+  virtual bool isReadingThreadSafe() const override { return true; }
+
+  virtual bool isWritingThreadSafe() const override { return false; }
+
+  virtual bool isSlicedReadingSupported() const override { return true; }
+  /// @}
+
+  /// \brief Get field table
+  const FieldTable& fieldTable() const noexcept { return fieldTable_; }
+
+  /// \brief Get the object store
+  const std::shared_ptr<ObjectStore>& store() const noexcept { return store_; }
+
+  /// \brief Get the number of bytes of the records which have not been uploaded yet
+  std::size_t numPendingBytes() const noexcept { return pendingBytes_; }
+
+  /// \brief Key of the manifest object
+  std::string manifestKey() const { return "ArchiveMetaData-" + prefix_ + ".json"; }
+
+  /// \brief Key of the object of the record with checksum `checksum`
+  static std::string objectKey(const std::string& checksum) { return "objects/" + checksum; }
+
+private:
+  void init();
+
+  OpenModeKind mode_;
+  std::shared_ptr<ObjectStore> store_;
+  std::string prefix_;
+  int numThreads_;
+
+  std::unique_ptr<Hash> hash_;
+  BinaryArchive::ByteOrderKind byteOrder_;
+  FieldTable fieldTable_;
+
+  // Ids of the records of each field by checksum
+  std::unordered_map<std::string, std::unordered_map<std::string, unsigned int>> ids_;
+
+  // Records which are referenced by the field table but not uploaded yet (by checksum)
+  mutable std::mutex pendingMutex_;
+  std::unordered_map<std::string, std::vector<Byte>> pending_;
+  std::size_t pendingBytes_;
+  bool isManifestOutdated_;
+};
+
+} // namespace serialbox
+
+#endif
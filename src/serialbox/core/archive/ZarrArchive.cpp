@@ -0,0 +1,388 @@
+//===-- serialbox/core/archive/ZarrArchive.cpp --------------------------------------*- C++ -*-===//
+//
+//                                    S E R I A L B O X
+//
+// This file is distributed under terms of BSD license.
+// See LICENSE.txt for more information
+//
+//===------------------------------------------------------------------------------------------===//
+//
+/// \file
+/// This file implements the archive storing the fields as chunked Zarr arrays.
+///
+//===------------------------------------------------------------------------------------------===//
+
+#include "serialbox/core/archive/ZarrArchive.h"
+#include "serialbox/core/Logging.h"
+#include "serialbox/core/Version.h"
+#include "serialbox/core/archive/BinaryBuffer.h"
+#include <fstream>
+
+namespace serialbox {
+
+namespace {
+
+json::json readJSON(const filesystem::path& file) {
+  json::json jsonNode;
+  try {
+    std::ifstream fs(file.string(), std::ios::in);
+    if(!fs.is_open())
+      throw Exception("cannot open file: %s", file.string());
+    fs >> jsonNode;
+  } catch(std::exception& e) {
+    throw Exception("JSON parser error in %s: %s", file.string(), e.what());
+  }
+  return jsonNode;
+}
+
+void writeJSON(const filesystem::path& file, const json::json& jsonNode) {
+  std::ofstream fs(file.string(), std::ios::out | std::ios::trunc);
+  if(!fs.is_open())
+    throw Exception("cannot open file: %s", file.string());
+  fs << jsonNode.dump(2) << std::endl;
+}
+
+/// \brief Parse the Zarr data type `dtype` (e.g `<f8`)
+void parseDtype(const std::string& dtype, TypeID& type, BinaryArchive::ByteOrderKind& byteOrder) {
+  const BinaryArchive::ByteOrderKind native = BinaryArchive::nativeByteOrder();
+  if(dtype.size() == 3) {
+    byteOrder = dtype[0] == '<' ? BinaryArchive::ByteOrderKind::LittleEndian
+                                : (dtype[0] == '>' ? BinaryArchive::ByteOrderKind::BigEndian : native);
+
+    const std::string kind = dtype.substr(1);
+    if(kind == "b1") {
+      type = TypeID::Boolean;
+      return;
+    } else if(kind == "i4") {
+      type = TypeID::Int32;
+      return;
+    } else if(kind == "i8") {
+      type = TypeID::Int64;
+      return;
+    } else if(kind == "f4") {
+      type = TypeID::Float32;
+      return;
+    } else if(kind == "f8") {
+      type = TypeID::Float64;
+      return;
+    }
+  }
+  throw Exception("unsupported data type '%s' of Zarr array", dtype);
+}
+
+} // anonymous namespace
+
+const std::string ZarrArchive::Name = "Zarr";
+
+const int ZarrArchive::Version = 0;
+
+std::string ZarrArchive::dtypeOf(TypeID type, BinaryArchive::ByteOrderKind byteOrder) {
+  const char order = byteOrder == BinaryArchive::ByteOrderKind::LittleEndian ? '<' : '>';
+  switch(type) {
+  case TypeID::Boolean:
+    return "|b1";
+  case TypeID::Int32:
+    return order + std::string("i4");
+  case TypeID::Int64:
+    return order + std::string("i8");
+  case TypeID::Float32:
+    return order + std::string("f4");
+  case TypeID::Float64:
+    return order + std::string("f8");
+  default:
+    throw Exception("type '%s' cannot be stored in a Zarr array", TypeUtil::toString(type));
+  }
+}
+
+std::string ZarrArchive::chunkKey(unsigned int id, std::size_t numDims) {
+  std::string key = std::to_string(id);
+  for(std::size_t i = 0; i < numDims; ++i)
+    key += ".0";
+  return key;
+}
+
+ZarrArchive::ZarrArchive(OpenModeKind mode, const std::string& directory,
+                         const std::string& prefix)
+    : mode_(mode), directory_(directory), prefix_(prefix), isGroupWritten_(false) {
+
+  LOG(info) << "Creating ZarrArchive (mode = " << mode_ << ") from directory " << directory_;
+
+  group_ = directory_ / (prefix_ + ".zarr");
+
+  try {
+    bool isDir = filesystem::is_directory(directory_);
+
+    switch(mode_) {
+    // We are reading, the directory needs to exist
+    case OpenModeKind::Read:
+      if(!isDir)
+        throw Exception("no such directory: '%s'", directory_.string());
+      break;
+    // We are writing or appending, create directories if it they don't exist
+    case OpenModeKind::Write:
+    case OpenModeKind::Append:
+      if(!isDir)
+        filesystem::create_directories(directory_);
+      break;
+    }
+  } catch(filesystem::filesystem_error& e) {
+    throw Exception(e.what());
+  }
+
+  if(mode_ == OpenModeKind::Write)
+    clear();
+  else
+    readMetaDataFromJson();
+}
+
+void ZarrArchive::readMetaDataFromJson() {
+  LOG(info) << "Reading MetaData for ZarrArchive ... ";
+
+  fieldTable_.clear();
+
+  if(!filesystem::exists(group_ / ".zgroup")) {
+    if(mode_ != OpenModeKind::Read)
+      return;
+    throw Exception("archive meta data not found in directory '%s'", directory_.string());
+  }
+  isGroupWritten_ = true;
+
+  json::json groupAttributes = readJSON(group_ / ".zattrs");
+  if(!groupAttributes.count("serialbox_archive") ||
+     groupAttributes["serialbox_archive"] != ZarrArchive::Name)
+    throw Exception("archive is not a Zarr archive");
+
+  int serialboxVersion = groupAttributes["serialbox_version"];
+  int archiveVersion = groupAttributes["serialbox_archive_version"];
+
+  if(!Version::isCompatible(serialboxVersion))
+    throw Exception("serialbox version of Zarr archive (%s) does not match the version "
+                    "of the library (%s)",
+                    Version::toString(serialboxVersion), SERIALBOX_VERSION_STRING);
+
+  if(archiveVersion < 0 || archiveVersion > ZarrArchive::Version)
+    throw Exception("Zarr archive version (%s) does not match the version of the library (%s)",
+                    archiveVersion, ZarrArchive::Version);
+
+  // Each sub-directory containing a .zarray is a field
+  for(filesystem::directory_iterator it(group_), end; it != end; ++it) {
+    if(!filesystem::exists(it->path() / ".zarray"))
+      continue;
+
+    const std::string field = it->path().filename().string();
+    json::json arrayNode = readJSON(it->path() / ".zarray");
+
+    FieldArray array{TypeID::Invalid, {}, 0, BinaryArchive::nativeByteOrder(), json::json(),
+                     false};
+    try {
+      parseDtype(arrayNode["dtype"], array.type, array.byteOrder);
+
+      std::vector<int> shape = arrayNode["shape"];
+      std::vector<int> chunks = arrayNode["chunks"];
+      if(shape.empty() || chunks.size() != shape.size() || chunks[0] != 1 ||
+         !std::equal(shape.begin() + 1, shape.end(), chunks.begin() + 1) ||
+         arrayNode["order"] != "F" || !arrayNode["compressor"].is_null())
+        throw Exception("only uncompressed arrays of col-major chunks of one record are supported");
+
+      array.numRecords = shape[0];
+      array.dims.assign(shape.begin() + 1, shape.end());
+    } catch(std::exception& e) {
+      throw Exception("invalid Zarr array '%s': %s", field, e.what());
+    }
+
+    if(filesystem::exists(it->path() / ".zattrs"))
+      array.attributes = readJSON(it->path() / ".zattrs");
+
+    fieldTable_.emplace(field, std::move(array));
+  }
+}
+
+void ZarrArchive::writeMetaDataToJson() {
+  LOG(info) << "Update MetaData of ZarrArchive";
+
+  if(!isGroupWritten_) {
+    filesystem::create_directories(group_);
+
+    json::json groupNode;
+    groupNode["zarr_format"] = 2;
+    writeJSON(group_ / ".zgroup", groupNode);
+
+    json::json groupAttributes;
+    groupAttributes["serialbox_archive"] = ZarrArchive::Name;
+    groupAttributes["serialbox_archive_version"] = ZarrArchive::Version;
+    groupAttributes["serialbox_version"] =
+        100 * SERIALBOX_VERSION_MAJOR + 10 * SERIALBOX_VERSION_MINOR + SERIALBOX_VERSION_PATCH;
+    writeJSON(group_ / ".zattrs", groupAttributes);
+    isGroupWritten_ = true;
+  }
+
+  // Only the arrays which have been written to since the last update are touched
+  for(auto& fieldArray : fieldTable_) {
+    FieldArray& array = fieldArray.second;
+    if(!array.isModified)
+      continue;
+
+    std::vector<int> shape(1, int(array.numRecords));
+    shape.insert(shape.end(), array.dims.begin(), array.dims.end());
+    std::vector<int> chunks(shape);
+    chunks[0] = 1;
+
+    json::json arrayNode;
+    arrayNode["zarr_format"] = 2;
+    arrayNode["shape"] = shape;
+    arrayNode["chunks"] = chunks;
+    arrayNode["dtype"] = dtypeOf(array.type, array.byteOrder);
+    arrayNode["compressor"] = nullptr;
+    arrayNode["fill_value"] = nullptr;
+    arrayNode["filters"] = nullptr;
+    arrayNode["order"] = "F";
+    arrayNode["dimension_separator"] = ".";
+
+    filesystem::path arrayDir(group_ / fieldArray.first);
+    writeJSON(arrayDir / ".zarray", arrayNode);
+    writeJSON(arrayDir / ".zattrs",
+              array.attributes.is_null() ? json::json::object() : array.attributes);
+    array.isModified = false;
+  }
+}
+
+void ZarrArchive::clear() {
+  fieldTable_.clear();
+  isGroupWritten_ = false;
+  try {
+    if(filesystem::exists(group_))
+      filesystem::remove_all(group_);
+  } catch(filesystem::filesystem_error& e) {
+    throw Exception(e.what());
+  }
+}
+
+//===------------------------------------------------------------------------------------------===//
+//     Writing
+//===------------------------------------------------------------------------------------------===//
+
+FieldID ZarrArchive::write(const StorageView& storageView, const std::string& field,
+                           const std::shared_ptr<FieldMetainfoImpl> info) {
+  if(mode_ == OpenModeKind::Read)
+    throw Exception("Archive is not initialized with OpenModeKind set to 'Write' or 'Append'");
+
+  LOG(info) << "Attempting to write field \"" << field << "\" to ZarrArchive ...";
+
+  filesystem::path arrayDir(group_ / field);
+
+  auto it = fieldTable_.find(field);
+  if(it == fieldTable_.end()) {
+    dtypeOf(storageView.type(), BinaryArchive::nativeByteOrder()); // Check the type
+
+    FieldArray array{storageView.type(), storageView.dims(),         0,
+                     BinaryArchive::nativeByteOrder(), json::json(), true};
+    if(info) {
+      array.attributes["serialbox_type"] = TypeUtil::toString(info->type());
+      array.attributes["serialbox_dims"] = info->dims();
+      array.attributes["serialbox_metainfo"] = info->metaInfo().toJSON();
+    }
+
+    try {
+      filesystem::create_directories(arrayDir);
+    } catch(filesystem::filesystem_error& e) {
+      throw Exception(e.what());
+    }
+    it = fieldTable_.emplace(field, std::move(array)).first;
+  }
+
+  FieldArray& array = it->second;
+  if(array.type != storageView.type() || array.dims != storageView.dims())
+    throw Exception("record of field '%s' does not match the type and dimensions of the Zarr "
+                    "array",
+                    field);
+
+  BinaryBuffer binaryBuffer(storageView);
+  binaryBuffer.copyStorageViewToBuffer(storageView);
+
+  if(array.byteOrder != BinaryArchive::nativeByteOrder())
+    byteSwap(binaryBuffer.data(), storageView.size(), storageView.bytesPerElement());
+
+  FieldID fieldID{field, array.numRecords};
+  filesystem::path chunkFile(arrayDir / chunkKey(fieldID.id, array.dims.size()));
+
+  std::ofstream fs(chunkFile.string(), std::ios::out | std::ios::binary | std::ios::trunc);
+  if(!fs.is_open())
+    throw Exception("cannot open file: '%s'", chunkFile.string());
+  fs.write(binaryBuffer.data(), binaryBuffer.size());
+  fs.close();
+  if(!fs)
+    throw Exception("cannot write file: '%s'", chunkFile.string());
+
+  array.numRecords++;
+  array.isModified = true;
+
+  LOG(info) << "Successfully wrote field \"" << fieldID.name << "\" (id = " << fieldID.id << ") to "
+            << chunkFile;
+  return fieldID;
+}
+
+//===------------------------------------------------------------------------------------------===//
+//     Reading
+//===------------------------------------------------------------------------------------------===//
+
+void ZarrArchive::read(StorageView& storageView, const FieldID& fieldID,
+                       std::shared_ptr<FieldMetainfoImpl> info) const {
+  LOG(info) << "Attempting to read field \"" << fieldID.name << "\" (id = " << fieldID.id
+            << ") via ZarrArchive ... ";
+
+  auto it = fieldTable_.find(fieldID.name);
+  if(it == fieldTable_.end())
+    throw Exception("no field '%s' registered in ZarrArchive", fieldID.name);
+
+  const FieldArray& array = it->second;
+  if(fieldID.id >= array.numRecords)
+    throw Exception("invalid id '%i' of field '%s'", fieldID.id, fieldID.name);
+
+  // Only the parts of the chunk covering the slice are read
+  BinaryBuffer binaryBuffer(storageView);
+
+  filesystem::path chunkFile(group_ / fieldID.name / chunkKey(fieldID.id, array.dims.size()));
+  std::ifstream fs(chunkFile.string(), std::ios::binary);
+  if(!fs.is_open())
+    throw Exception("cannot open file: '%s'", chunkFile.string());
+
+  auto extents = binaryBuffer.extents(storageView, BinaryBuffer::FileRequestCost);
+  try {
+    binaryBuffer.load(fs, 0, extents);
+  } catch(Exception& e) {
+    throw Exception("cannot read file: '%s': %s", chunkFile.string(), e.what());
+  }
+  fs.close();
+
+  if(array.byteOrder != BinaryArchive::nativeByteOrder())
+    binaryBuffer.byteSwapExtents(extents, storageView.bytesPerElement());
+
+  binaryBuffer.copyBufferToStorageView(storageView);
+
+  LOG(info) << "Successfully read field \"" << fieldID.name << "\" (id = " << fieldID.id << ")";
+}
+
+Archive::RecordLocation ZarrArchive::locate(const FieldID& fieldID) const {
+  auto it = fieldTable_.find(fieldID.name);
+  if(it == fieldTable_.end())
+    return Archive::locate(fieldID);
+  return RecordLocation{
+      (group_ / fieldID.name / chunkKey(fieldID.id, it->second.dims.size())).string(), 0};
+}
+
+std::ostream& ZarrArchive::toStream(std::ostream& stream) const {
+  stream << "ZarrArchive = {\n";
+  stream << "  directory: " << directory_.string() << "\n";
+  stream << "  mode: " << mode_ << "\n";
+  stream << "  prefix: " << prefix_ << "\n";
+  stream << "  fieldsTable = {\n";
+  for(auto it = fieldTable_.begin(), end = fieldTable_.end(); it != end; ++it) {
+    stream << "    " << it->first << " = [ " << dtypeOf(it->second.type, it->second.byteOrder)
+           << ", " << it->second.numRecords << " records ]\n";
+  }
+  stream << "  }\n";
+  stream << "}\n";
+  return stream;
+}
+
+} // namespace serialbox
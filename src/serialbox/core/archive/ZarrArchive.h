@@ -0,0 +1,143 @@
+//===-- serialbox/core/archive/ZarrArchive.h ----------------------------------------*- C++ -*-===//
+//
+//                                    S E R I A L B O X
+//
+// This file is distributed under terms of BSD license.
+// See LICENSE.txt for more information
+//
+//===------------------------------------------------------------------------------------------===//
+//
+/// \file
+/// This file contains the archive storing the fields as chunked Zarr arrays.
+///
+//===------------------------------------------------------------------------------------------===//
+
+#ifndef SERIALBOX_CORE_ARCHIVE_ZARRARCHIVE_H
+#define SERIALBOX_CORE_ARCHIVE_ZARRARCHIVE_H
+
+#include "serialbox/core/Filesystem.h"
+#include "serialbox/core/Json.h"
+#include "serialbox/core/archive/Archive.h"
+#include "serialbox/core/archive/BinaryArchive.h"
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace serialbox {
+
+/// \brief Archive storing each field as an array of a Zarr (v2) group
+///
+/// The archive is the group `prefix.zarr` in the directory of the serializer. The records of a
+/// field are stacked along the first axis of the array `prefix.zarr/field` of shape
+/// `(records, dim_1, ..., dim_N)` which has one (uncompressed, col-major) chunk per record. The
+/// meta-information of the field is stored in the attributes of the array. Hence, the data can be
+/// read in parallel by any Zarr implementation (e.g `xarray.open_zarr` or `dask.array.from_zarr`)
+/// while Serialbox reads and writes whole chunks with a single I/O operation.
+///
+/// The records are not deduplicated, the n-th record of a field is the n-th call to
+/// ZarrArchive::write of the field. All records of a field need to have the same type and
+/// dimensions.
+///
+/// \ingroup core
+class ZarrArchive : public Archive {
+public:
+  /// \brief Name of the Zarr archive
+  static const std::string Name;
+
+  /// \brief Revision of the Zarr archive
+  static const int Version;
+
+  /// \brief Zarr array of a field
+  struct FieldArray {
+    TypeID type;                             ///< Type of the elements
+    std::vector<int> dims;                   ///< Dimensions of a record
+    unsigned int numRecords;                 ///< Number of records (extent of the first axis)
+    BinaryArchive::ByteOrderKind byteOrder;  ///< Byte order of the chunks
+    json::json attributes;                   ///< Attributes of the array
+    bool isModified;                         ///< Meta-data needs to be written
+  };
+
+  /// \brief Table of all fields owned by this archive
+  using FieldTable = std::unordered_map<std::string, FieldArray>;
+
+  /// \brief Initialize the archive
+  ///
+  /// \param mode       Policy to open the archive
+  /// \param directory  Directory of the group. If the archive is opened in ´Read´ mode, the
+  ///                   directory is expected to supply a ´prefix.zarr´ group.
+  /// \param prefix     Prefix of the group
+  ZarrArchive(OpenModeKind mode, const std::string& directory, const std::string& prefix);
+
+  /// \brief Copy constructor [deleted]
+  ZarrArchive(const ZarrArchive&) = delete;
+
+  /// \brief Copy assignment [deleted]
+  ZarrArchive& operator=(const ZarrArchive&) = delete;
+
+  /// \brief Load the meta-data of the group and its arrays
+  void readMetaDataFromJson();
+
+  /// \brief Write the meta-data of the group and the modified arrays
+  void writeMetaDataToJson();
+
+  /// \name Archive implementation
+  /// \see Archive
+  /// @{
+  virtual FieldID write(const StorageView& storageView, const std::string& field,
+                        const std::shared_ptr<FieldMetainfoImpl> info) override;
+
+  virtual void read(StorageView& storageView, const FieldID& fieldID,
+                    std::shared_ptr<FieldMetainfoImpl> info) const override;
+
+  virtual void updateMetaData() override { writeMetaDataToJson(); }
+
+  virtual OpenModeKind mode() const override { return mode_; }
+
+  virtual std::string directory() const override { return directory_.string(); }
+
+  virtual std::string prefix() const override { return prefix_; }
+
+  virtual std::string name() const override { return ZarrArchive::Name; }
+
+  virtual std::string metaDataFile() const override { return (group_ / ".zattrs").string(); }
+
+  virtual std::ostream& toStream(std::ostream& stream) const override;
+
+  virtual void clear() override;
+
+  virtual bool isReadingThreadSafe() const override { return true; }
+
+  virtual bool isWritingThreadSafe() const override { return false; }
+
+  virtual bool isSlicedReadingSupported() const override { return true; }
+
+  virtual RecordLocation locate(const FieldID& fieldID) const override;
+  /// @}
+
+  /// \brief Get field table
+  const FieldTable& fieldTable() const noexcept { return fieldTable_; }
+
+  /// \brief Directory of the Zarr group
+  const filesystem::path& group() const noexcept { return group_; }
+
+  /// \brief Get the Zarr data type (e.g `<f8`) of `type` in byte order `byteOrder`
+  ///
+  /// \throw Exception  Type cannot be stored in a Zarr array
+  static std::string dtypeOf(TypeID type, BinaryArchive::ByteOrderKind byteOrder);
+
+  /// \brief Get the chunk key of record `id` of an array with `numDims` dimensions per record
+  static std::string chunkKey(unsigned int id, std::size_t numDims);
+
+private:
+  OpenModeKind mode_;
+  filesystem::path directory_;
+  std::string prefix_;
+
+  filesystem::path group_;
+  bool isGroupWritten_;
+  FieldTable fieldTable_;
+};
+
+} // namespace serialbox
+
+#endif
@@ -230,7 +230,7 @@ public:
   /// \param Args  Arguments forwarded to the constructor of Savepoint
   /// \return True iff the savepoint was successfully inserted
   template <typename... Args>
-  bool register_savepoint(Args&&... args) noexcept {
+  bool register_savepoint(Args&&... args) {
     return serializerImpl_->registerSavepoint(*savepoint(std::forward<Args>(args)...).impl());
   }
 
@@ -239,7 +239,7 @@ public:
   /// \param sp     Savepoint to check for
   /// \return True iff the savepoint was successfully inserted
   template <typename... Args>
-  bool has_savepoint(const savepoint sp) const noexcept {
+  bool has_savepoint(const savepoint sp) const {
     return serializerImpl_->savepointVector().exists(*sp.impl());
   }
 
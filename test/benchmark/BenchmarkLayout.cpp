@@ -0,0 +1,130 @@
+//===-- benchmark/BenchmarkLayout.cpp -----------------------------------------------*- C++ -*-===//
+//
+//                                    S E R I A L B O X
+//
+// This file is distributed under terms of BSD license.
+// See LICENSE.txt for more information
+//
+//===------------------------------------------------------------------------------------------===//
+//
+/// \file
+/// This file contains the benchmarks comparing the field-major (Binary) and savepoint-major (Log)
+/// layouts for time-series and snapshot access.
+///
+//===------------------------------------------------------------------------------------------===//
+
+#include "utility/SerializerTestBase.h"
+#include "utility/Storage.h"
+#include "serialbox/core/SerializerImpl.h"
+#include "serialbox/core/Timer.h"
+#include "serialbox/core/Type.h"
+#include <gtest/gtest.h>
+#include <unordered_map>
+
+using namespace serialbox;
+using namespace unittest;
+
+namespace {
+
+const int NumFields = 16;
+const int NumSavepoints = 8;
+
+SavepointImpl savepoint(int t) {
+  SavepointImpl sp("step");
+  sp.addMetainfo("t", t);
+  return sp;
+}
+
+std::string fieldname(int i) { return "field_" + std::to_string(i); }
+
+} // anonymous namespace
+
+class LayoutBenchmark : public SerializerBenchmarkBase,
+                        public ::testing::WithParamInterface<std::string> {};
+
+TEST_P(LayoutBenchmark, Benchmark) {
+  BenchmarkResult timeSeriesResult, snapshotResult;
+  timeSeriesResult.name = GetParam() + " (time-series)";
+  snapshotResult.name = GetParam() + " (snapshot)";
+
+  const auto& sizes = BenchmarkEnvironment::getInstance().sizes();
+
+  using Storage = Storage<double>;
+
+  for(std::size_t i = 0; i < sizes.size(); ++i) {
+    const Size& size = sizes[i];
+
+    //
+    // Allocate data
+    //
+    std::vector<Storage> storages;
+    for(int f = 0; f < NumFields; ++f)
+      storages.emplace_back(Storage::ColMajor, size.dimensions, Storage::random);
+
+    //
+    // Write data (savepoint after savepoint, as a simulation would)
+    //
+    double timingWrite = 0.0;
+    for(int n = 0; n < BenchmarkEnvironment::NumRepetitions; ++n) {
+      SerializerImpl ser_write(OpenModeKind::Write, this->directory->path().string(), "field",
+                               GetParam());
+      for(int f = 0; f < NumFields; ++f)
+        ser_write.registerField(fieldname(f), TypeID::Float64, size.dimensions);
+
+      Timer t;
+      for(int sp = 0; sp < NumSavepoints; ++sp)
+        for(int f = 0; f < NumFields; ++f) {
+          StorageView storageView(storages[f].toStorageView());
+          ser_write.write(fieldname(f), savepoint(sp), storageView);
+        }
+      timingWrite += t.stop();
+    }
+    timingWrite /= BenchmarkEnvironment::NumRepetitions;
+
+    timeSeriesResult.timingsWrite.push_back(std::make_pair(size, timingWrite));
+    snapshotResult.timingsWrite.push_back(std::make_pair(size, timingWrite));
+
+    SerializerImpl ser_read(OpenModeKind::Read, this->directory->path().string(), "field",
+                            GetParam());
+
+    //
+    // Time-series access: read each field over all savepoints
+    //
+    double timingTimeSeries = 0.0;
+    for(int n = 0; n < BenchmarkEnvironment::NumRepetitions; ++n) {
+      Timer t;
+      for(int f = 0; f < NumFields; ++f)
+        for(int sp = 0; sp < NumSavepoints; ++sp) {
+          StorageView storageView(storages[f].toStorageView());
+          ser_read.read(fieldname(f), savepoint(sp), storageView);
+        }
+      timingTimeSeries += t.stop();
+    }
+    timingTimeSeries /= BenchmarkEnvironment::NumRepetitions;
+
+    timeSeriesResult.timingsRead.push_back(std::make_pair(size, timingTimeSeries));
+
+    //
+    // Snapshot access: read all fields of each savepoint at once (i.e a restart)
+    //
+    std::unordered_map<std::string, StorageView> storageViews;
+    for(int f = 0; f < NumFields; ++f)
+      storageViews.emplace(fieldname(f), storages[f].toStorageView());
+
+    double timingSnapshot = 0.0;
+    for(int n = 0; n < BenchmarkEnvironment::NumRepetitions; ++n) {
+      Timer t;
+      for(int sp = 0; sp < NumSavepoints; ++sp)
+        ser_read.readSavepoint(savepoint(sp), storageViews);
+      timingSnapshot += t.stop();
+    }
+    timingSnapshot /= BenchmarkEnvironment::NumRepetitions;
+
+    snapshotResult.timingsRead.push_back(std::make_pair(size, timingSnapshot));
+  }
+
+  BenchmarkEnvironment::getInstance().appendResult(timeSeriesResult);
+  BenchmarkEnvironment::getInstance().appendResult(snapshotResult);
+}
+
+INSTANTIATE_TEST_CASE_P(BenchmarkTest, LayoutBenchmark, ::testing::Values("Binary", "Log"));
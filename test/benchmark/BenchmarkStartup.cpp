@@ -0,0 +1,110 @@
+//===-- benchmark/BenchmarkStartup.cpp ----------------------------------------------*- C++ -*-===//
+//
+//                                    S E R I A L B O X
+//
+// This file is distributed under terms of BSD license.
+// See LICENSE.txt for more information
+//
+//===------------------------------------------------------------------------------------------===//
+//
+/// \file
+/// This file contains the benchmarks of the construction of Serializers in directories holding
+/// many unrelated files.
+///
+//===------------------------------------------------------------------------------------------===//
+
+#include "utility/SerializerTestBase.h"
+#include "utility/Storage.h"
+#include "serialbox/core/SerializerImpl.h"
+#include "serialbox/core/Timer.h"
+#include "serialbox/core/archive/ArchiveFactory.h"
+#include <fstream>
+#include <gtest/gtest.h>
+
+using namespace serialbox;
+using namespace unittest;
+
+namespace {
+
+const int NumFields = 16;
+
+std::string fieldname(int i) { return "field_" + std::to_string(i); }
+
+} // anonymous namespace
+
+class StartupBenchmark : public SerializerBenchmarkBase,
+                         public ::testing::WithParamInterface<bool> {
+protected:
+  virtual void SetUp() override {
+    SerializerBenchmarkBase::SetUp();
+    ArchiveFactory::setTrustMetaData(GetParam());
+  }
+
+  virtual void TearDown() override {
+    ArchiveFactory::setTrustMetaData(false);
+    SerializerBenchmarkBase::TearDown();
+  }
+
+  /// \brief Write a small archive with `NumFields` fields at a single savepoint
+  void writeArchive(StorageView& storageView) {
+    SerializerImpl ser_write(OpenModeKind::Write, this->directory->path().string(), "field",
+                             "Binary");
+    for(int f = 0; f < NumFields; ++f) {
+      ser_write.registerField(fieldname(f), storageView.type(), storageView.dims());
+      ser_write.write(fieldname(f), SavepointImpl("step"), storageView);
+    }
+  }
+};
+
+TEST_P(StartupBenchmark, Benchmark) {
+  BenchmarkResult result;
+  result.name = GetParam() ? "Startup (trust meta-data)" : "Startup (default)";
+
+  using Storage = Storage<double>;
+  Storage storage(Storage::ColMajor, {8, 8}, Storage::random);
+  StorageView storageView(storage.toStorageView());
+
+  // The number of unrelated files in the directory (same extension, different prefix)
+  const std::vector<int> numUnrelatedFiles{0, 1000, 10000};
+  int numFilesCreated = 0;
+
+  for(int numFiles : numUnrelatedFiles) {
+    for(; numFilesCreated < numFiles; ++numFilesCreated)
+      std::ofstream((this->directory->path() / ("other_" + std::to_string(numFilesCreated) +
+                                                ".dat")).string());
+
+    const Size size{{numFiles}};
+
+    //
+    // Open in write mode (removes the previous archive)
+    //
+    double timingWrite = 0.0;
+    for(int n = 0; n < BenchmarkEnvironment::NumRepetitions; ++n) {
+      writeArchive(storageView);
+      Timer t;
+      SerializerImpl ser_write(OpenModeKind::Write, this->directory->path().string(), "field",
+                               "Binary");
+      timingWrite += t.stop();
+    }
+    timingWrite /= BenchmarkEnvironment::NumRepetitions;
+    result.timingsWrite.push_back(std::make_pair(size, timingWrite));
+
+    //
+    // Open in read mode
+    //
+    writeArchive(storageView);
+    double timingRead = 0.0;
+    for(int n = 0; n < BenchmarkEnvironment::NumRepetitions; ++n) {
+      Timer t;
+      SerializerImpl ser_read(OpenModeKind::Read, this->directory->path().string(), "field",
+                              "Binary");
+      timingRead += t.stop();
+    }
+    timingRead /= BenchmarkEnvironment::NumRepetitions;
+    result.timingsRead.push_back(std::make_pair(size, timingRead));
+  }
+
+  BenchmarkEnvironment::getInstance().appendResult(result);
+}
+
+INSTANTIATE_TEST_CASE_P(BenchmarkTest, StartupBenchmark, ::testing::Values(false, true));
@@ -184,6 +184,16 @@ TEST_F(CMetainfoTest, Test) {
   ASSERT_FALSE(this->hasErrorAndReset()) << this->getLastErrorMsg();      
   ASSERT_TRUE(internal::arraysAreEqual(arrayOfString, arrayOfStringRef));
   serialboxArrayOfStringDestroy(arrayOfString);
+
+  serialboxStringTable_t* stringTable =
+      serialboxMetainfoGetArrayOfStringTable(metaInfo, "ArrayOfString");
+  ASSERT_FALSE(this->hasErrorAndReset()) << this->getLastErrorMsg();
+  ASSERT_EQ(stringTable->len, arrayOfStringRef->len);
+  for(int i = 0; i < stringTable->len; ++i) {
+    EXPECT_STREQ(stringTable->data[i], arrayOfStringRef->data[i]);
+    EXPECT_STREQ(stringTable->table + stringTable->offsets[i], arrayOfStringRef->data[i]);
+  }
+  serialboxStringTableDestroy(stringTable);
   serialboxArrayOfStringDestroy(arrayOfStringRef);
 
   //
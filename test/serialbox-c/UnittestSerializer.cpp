@@ -18,6 +18,7 @@
 #include "serialbox-c/Metainfo.h"
 #include "serialbox-c/Savepoint.h"
 #include "serialbox-c/Serializer.h"
+#include <algorithm>
 #include <gtest/gtest.h>
 
 namespace {
@@ -167,9 +168,15 @@ TEST_F(CSerializerUtilityTest, RegisterSavepoints) {
   EXPECT_TRUE(serialboxSavepointEqual(savepoints[0], savepoint1));
   EXPECT_TRUE(serialboxSavepointEqual(savepoints[1], savepoint2));
 
+  serialboxArrayOfSavepoint_t* savepointArray = serialboxSerializerGetSavepointArray(ser);
+  ASSERT_EQ(savepointArray->len, 2);
+  EXPECT_TRUE(serialboxSavepointEqual(&savepointArray->data[0], savepoint1));
+  EXPECT_TRUE(serialboxSavepointEqual(&savepointArray->data[1], savepoint2));
+
   serialboxSavepointDestroy(savepoint1);
   serialboxSavepointDestroy(savepoint2);
   serialboxSerializerDestroySavepointVector(savepoints, numSavepoints);
+  serialboxSerializerDestroySavepointArray(savepointArray);
   serialboxSerializerDestroy(ser);
 }
 
@@ -202,6 +209,15 @@ TEST_F(CSerializerUtilityTest, RegisterFields) {
 
   serialboxArrayOfStringDestroy(fieldnames);
 
+  serialboxStringTable_t* fieldnameTable = serialboxSerializerGetFieldnamesTable(ser);
+  ASSERT_EQ(fieldnameTable->len, 2);
+  std::vector<std::string> fieldnameVector(fieldnameTable->data,
+                                           fieldnameTable->data + fieldnameTable->len);
+  EXPECT_NE(std::find(fieldnameVector.begin(), fieldnameVector.end(), "field2"),
+            fieldnameVector.end());
+  EXPECT_EQ(std::string(fieldnameTable->table + fieldnameTable->offsets[1]), fieldnameVector[1]);
+  serialboxStringTableDestroy(fieldnameTable);
+
   //
   // Get FieldMetainfoImpl of "field"
   //
@@ -519,6 +535,17 @@ TYPED_TEST(CSerializerReadWriteTest, WriteAndRead) {
 
     serialboxArrayOfStringDestroy(fieldsAtSavepoint);
 
+    serialboxStringTable_t* fieldsAtSavepointTable =
+        serialboxSerializerGetFieldnamesAtSavepointTable(ser_read, savepoint1_t_1);
+    ASSERT_EQ(fieldsAtSavepointTable->len, 2);
+    serialboxStringTableDestroy(fieldsAtSavepointTable);
+
+    // Find savepoints of fields
+    EXPECT_EQ(serialboxSerializerFindFieldAtOrBefore(ser_read, "u", savepoint_v_1), 2);
+    EXPECT_EQ(serialboxSerializerFindFieldAtOrBefore(ser_read, "field_6d", savepoint_v_1), -1);
+    EXPECT_EQ(serialboxSerializerFindFieldAfter(ser_read, "v", savepoint1_t_2), 3);
+    EXPECT_EQ(serialboxSerializerFindFieldAfter(ser_read, "u", savepoint_u_1), -1);
+
     // Read
 
     // u_0 at savepoint1_t_1
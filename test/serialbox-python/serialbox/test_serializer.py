@@ -154,6 +154,22 @@ class TestSerializer(unittest.TestCase):
         savepoint_list_2 = ser.savepoint_list()
         self.assertEqual(id(savepoint_list_1), id(savepoint_list_2))
 
+    def test_find_field(self):
+        ser = Serializer(OpenModeKind.Write, self.path, "field", self.archive)
+        field = np.random.rand(4, 4)
+
+        savepoints = [Savepoint('step', {"t": t}) for t in range(6)]
+        ser.write('u', savepoints[0], field)
+        for sp in savepoints[1:]:
+            ser.register_savepoint(sp)
+        ser.write('u', savepoints[3], field)
+
+        self.assertEqual(ser.find_field_at_or_before('u', savepoints[2]), savepoints[0])
+        self.assertEqual(ser.find_field_at_or_before('u', savepoints[5]), savepoints[3])
+        self.assertEqual(ser.find_field_after('u', savepoints[0]), savepoints[3])
+        self.assertEqual(ser.find_field_after('u', savepoints[3]), None)
+        self.assertEqual(ser.find_field_at_or_before('v', savepoints[5]), None)
+
     def test_savepoint(self):
         ser = Serializer(OpenModeKind.Write, self.path, "field", self.archive)
         ser.register_savepoint(Savepoint('sp', {"key": 1}))
@@ -0,0 +1,213 @@
+//===-- serialbox/core/UnittestArchiveCompactor.cpp ---------------------------------*- C++ -*-===//
+//
+//                                    S E R I A L B O X
+//
+// This file is distributed under terms of BSD license.
+// See LICENSE.txt for more information
+//
+//===------------------------------------------------------------------------------------------===//
+//
+/// \file
+/// This file implements the unittests of the ArchiveCompactor.
+///
+//===------------------------------------------------------------------------------------------===//
+
+#include "utility/SerializerTestBase.h"
+#include "utility/Storage.h"
+#include "serialbox/core/ArchiveCompactor.h"
+#include "serialbox/core/archive/BinaryArchive.h"
+#include <fstream>
+#include <gtest/gtest.h>
+
+using namespace serialbox;
+using namespace unittest;
+
+namespace {
+
+class ArchiveCompactorTest : public SerializerUnittestBase {};
+
+} // anonymous namespace
+
+TEST_F(ArchiveCompactorTest, Compact) {
+  using Storage = Storage<double>;
+  Storage u_0(Storage::ColMajor, {5, 1, 1}, Storage::random);
+  Storage u_1(Storage::ColMajor, {5, 1, 1}, Storage::random);
+  Storage u_unreferenced(Storage::ColMajor, {5, 1, 1}, Storage::random);
+  Storage w_0(Storage::ColMajor, {10, 10, 1});
+  w_0.forEach([](int) { return 0.0; });
+  w_0(1, 2, 0) = 5.0;
+  Storage w_1(Storage::ColMajor, {10, 10, 1});
+  w_1.forEach([](int) { return 0.0; });
+  w_1(7, 3, 0) = -1.0;
+  w_1(8, 3, 0) = -2.0;
+
+  auto sv_u_0 = u_0.toStorageView();
+  auto sv_u_1 = u_1.toStorageView();
+  auto sv_w_0 = w_0.toStorageView();
+  auto sv_w_1 = w_1.toStorageView();
+
+  SavepointImpl sp0("sp0"), sp1("sp1"), sp2("sp2");
+  const std::string dir = directory->path().string();
+
+  auto appendGarbage = [&](const std::string& field) {
+    std::ofstream ofs((directory->path() / ("Field_" + field + ".dat")).string(),
+                      std::ios::binary | std::ios::app);
+    ofs << "aborted write";
+  };
+
+  {
+    SerializerImpl s(OpenModeKind::Write, dir, "Field", "Binary");
+    s.enableMetaDataSharding(2);
+    s.registerField("u", sv_u_0.type(), sv_u_0.dims());
+    s.registerField("w", sv_w_0.type(), sv_w_0.dims());
+    s.write("u", sp0, sv_u_0);
+    s.write("u", sp1, sv_u_1);
+    s.write("w", sp0, sv_w_0);
+    s.write("w", sp1, sv_w_1);
+
+    // Records which are not referenced by any savepoint
+    BinaryArchive& archive = static_cast<BinaryArchive&>(s.archive());
+    ASSERT_EQ(archive.write(u_unreferenced.toStorageView(), "u", nullptr), (FieldID{"u", 2}));
+    ASSERT_EQ(archive.write(sv_u_0, "z", nullptr), (FieldID{"z", 0}));
+    EXPECT_EQ(archive.fieldTable().at("w")[0].encoding, BinaryArchive::EncodingKind::Sparse);
+
+    // Duplicate of the first record of u (e.g from an earlier run)
+    auto uFile = directory->path() / "Field_u.dat";
+    std::ifstream ifs(uFile.string(), std::ios::binary);
+    std::string u0Bytes(sv_u_0.sizeInBytes(), '\0');
+    ifs.read(&u0Bytes[0], u0Bytes.size());
+    ifs.close();
+    std::ofstream ofs(uFile.string(), std::ios::binary | std::ios::app);
+    ofs.write(u0Bytes.data(), u0Bytes.size());
+    ofs.close();
+
+    auto& uTable = archive.fieldTable().at("u");
+    uTable.push_back(BinaryArchive::FileOffsetType{std::streamoff(3 * u0Bytes.size()),
+                                                   uTable[0].checksum, uTable[0].encoding});
+    ASSERT_EQ(s.savepointVector().insert(sp2), 2);
+    ASSERT_TRUE(s.savepointVector().addField(sp2, FieldID{"u", 3}));
+    s.updateMetaData();
+  }
+  appendGarbage("u");
+  appendGarbage("w");
+
+  auto wFile = directory->path() / "Field_w.dat";
+  auto wBytesBefore = filesystem::file_size(wFile);
+
+  {
+    ArchiveCompactor compactor(dir, "Field");
+    compactor.setNumThreads(2);
+    compactor.compact();
+
+    const auto& statistics = compactor.statistics();
+    ASSERT_EQ(statistics.size(), 3);
+    EXPECT_EQ(statistics.at("u").numRecords, 4);
+    EXPECT_EQ(statistics.at("u").numKeptRecords, 2);
+    EXPECT_EQ(statistics.at("u").bytesAfter, 2 * sv_u_0.sizeInBytes());
+    EXPECT_EQ(statistics.at("w").numKeptRecords, 2);
+    EXPECT_EQ(statistics.at("w").bytesBefore, wBytesBefore);
+    EXPECT_EQ(statistics.at("w").bytesAfter, wBytesBefore - std::string("aborted write").size());
+    EXPECT_EQ(statistics.at("z").numKeptRecords, 0);
+    EXPECT_EQ(compactor.numRemovedRecords(), 3);
+  }
+
+  EXPECT_EQ(filesystem::file_size(directory->path() / "Field_u.dat"), 2 * sv_u_0.sizeInBytes());
+  EXPECT_FALSE(filesystem::exists(directory->path() / "Field_z.dat"));
+  EXPECT_FALSE(filesystem::exists(directory->path() / "Field_u.dat.compact"));
+  EXPECT_FALSE(filesystem::exists(directory->path() / "Field_u.dat.orig"));
+  EXPECT_FALSE(filesystem::exists(directory->path() / "MetaData-Field.json.orig"));
+  EXPECT_FALSE(filesystem::exists(ArchiveCompactor::journalFile(dir, "Field")));
+
+  // Read the compacted archive
+  {
+    SerializerImpl s(OpenModeKind::Read, dir, "Field", "Binary");
+    EXPECT_EQ(s.metaDataShardSize(), 2);
+    EXPECT_EQ(s.savepointVector().getFieldID(2, "u"), (FieldID{"u", 0}));
+    EXPECT_EQ(s.savepointVector().getFieldID(1, "u"), (FieldID{"u", 1}));
+
+    const BinaryArchive& archive = static_cast<const BinaryArchive&>(s.archive());
+    EXPECT_EQ(archive.fieldTable().count("z"), 0);
+    EXPECT_EQ(archive.fieldTable().at("u").size(), 2);
+
+    Storage u_output(Storage::ColMajor, {5, 1, 1});
+    Storage w_output(Storage::ColMajor, {10, 10, 1});
+    auto sv_u_output = u_output.toStorageView();
+    auto sv_w_output = w_output.toStorageView();
+
+    s.read("u", sp0, sv_u_output);
+    EXPECT_TRUE(Storage::verify(u_output, u_0));
+    s.read("u", sp1, sv_u_output);
+    EXPECT_TRUE(Storage::verify(u_output, u_1));
+    s.read("u", sp2, sv_u_output);
+    EXPECT_TRUE(Storage::verify(u_output, u_0));
+    s.read("w", sp0, sv_w_output);
+    EXPECT_TRUE(Storage::verify(w_output, w_0));
+    s.read("w", sp1, sv_w_output);
+    EXPECT_TRUE(Storage::verify(w_output, w_1));
+  }
+
+  // Compacting a compact archive is a no-op
+  {
+    ArchiveCompactor compactor(dir, "Field");
+    compactor.compact();
+    EXPECT_EQ(compactor.numRemovedRecords(), 0);
+  }
+}
+
+TEST_F(ArchiveCompactorTest, RollbackInterruptedCompaction) {
+  using Storage = Storage<double>;
+  Storage u(Storage::ColMajor, {5, 1, 1}, Storage::random);
+  auto sv_u = u.toStorageView();
+
+  SavepointImpl sp0("sp0");
+  const std::string dir = directory->path().string();
+
+  {
+    SerializerImpl s(OpenModeKind::Write, dir, "Field", "Binary");
+    s.registerField("u", sv_u.type(), sv_u.dims());
+    s.write("u", sp0, sv_u);
+  }
+
+  // Simulate a compaction which was interrupted after the files were backed up and partially
+  // replaced
+  {
+    std::ofstream journal(ArchiveCompactor::journalFile(dir, "Field").string());
+    for(std::string file : {"MetaData-Field.json", "ArchiveMetaData-Field.json", "Field_u.dat"}) {
+      auto path = directory->path() / file;
+      std::ifstream ifs(path.string(), std::ios::binary);
+      std::ofstream ofs(path.string() + ".orig", std::ios::binary);
+      ofs << ifs.rdbuf();
+      journal << file << "\n";
+    }
+    std::ofstream((directory->path() / "ArchiveMetaData-Field.json").string()) << "{";
+    std::ofstream((directory->path() / "Field_u.dat").string()) << "truncated";
+    std::ofstream((directory->path() / "Field_u.dat.compact").string()) << "compacted";
+  }
+
+  {
+    ArchiveCompactor compactor(dir, "Field");
+    EXPECT_FALSE(filesystem::exists(ArchiveCompactor::journalFile(dir, "Field")));
+    EXPECT_FALSE(filesystem::exists(directory->path() / "Field_u.dat.orig"));
+    EXPECT_FALSE(filesystem::exists(directory->path() / "Field_u.dat.compact"));
+    compactor.compact();
+    EXPECT_EQ(compactor.numRemovedRecords(), 0);
+  }
+
+  SerializerImpl s(OpenModeKind::Read, dir, "Field", "Binary");
+  Storage u_output(Storage::ColMajor, {5, 1, 1});
+  auto sv_u_output = u_output.toStorageView();
+  s.read("u", sp0, sv_u_output);
+  EXPECT_TRUE(Storage::verify(u_output, u));
+}
+
+TEST_F(ArchiveCompactorTest, InvalidSerializer) {
+  // Non-existing serializer
+  EXPECT_THROW(ArchiveCompactor(directory->path().string(), "Field"), Exception);
+  EXPECT_FALSE(filesystem::exists(directory->path() / "MetaData-Field.json"));
+
+  // Serializer which does not use the BinaryArchive
+  {
+    SerializerImpl s(OpenModeKind::Write, directory->path().string(), "Field", "Fingerprint");
+  }
+  EXPECT_THROW(ArchiveCompactor(directory->path().string(), "Field"), Exception);
+}
@@ -0,0 +1,126 @@
+//===-- serialbox/core/UnittestArchiveConverter.cpp ---------------------------------*- C++ -*-===//
+//
+//                                    S E R I A L B O X
+//
+// This file is distributed under terms of BSD license.
+// See LICENSE.txt for more information
+//
+//===------------------------------------------------------------------------------------------===//
+//
+/// \file
+/// This file implements the unittests of the ArchiveConverter.
+///
+//===------------------------------------------------------------------------------------------===//
+
+#include "utility/SerializerTestBase.h"
+#include "utility/Storage.h"
+#include "serialbox/core/ArchiveConverter.h"
+#include "serialbox/core/archive/BinaryArchive.h"
+#include <gtest/gtest.h>
+
+using namespace serialbox;
+using namespace unittest;
+
+namespace {
+
+class ArchiveConverterTest : public SerializerUnittestBase {};
+
+} // anonymous namespace
+
+TEST_F(ArchiveConverterTest, Convert) {
+  using Storage = Storage<double>;
+  Storage u_0(Storage::ColMajor, {10, 12, 5}, Storage::random);
+  Storage u_1(Storage::ColMajor, {10, 12, 5}, Storage::random);
+  Storage v_0(Storage::ColMajor, {7, 3}, Storage::random);
+  Storage u_output(Storage::ColMajor, {10, 12, 5});
+  Storage v_output(Storage::ColMajor, {7, 3});
+
+  MetainfoMapImpl haloInfo;
+  haloInfo.insert("__iminushalosize", 2);
+  haloInfo.insert("__iplushalosize", 3);
+  haloInfo.insert("__jminushalosize", 1);
+  haloInfo.insert("__jplushalosize", 1);
+
+  auto sv_u_0 = u_0.toStorageView();
+  auto sv_u_1 = u_1.toStorageView();
+  auto sv_v_0 = v_0.toStorageView();
+
+  std::vector<SavepointImpl> savepoints;
+  for(int i = 0; i < 5; ++i) {
+    savepoints.emplace_back("sp");
+    savepoints.back().addMetainfo("time", i);
+  }
+
+  const std::string sourceDir = (directory->path() / "source").string();
+  const std::string targetDir = (directory->path() / "target").string();
+
+  {
+    SerializerImpl s(OpenModeKind::Write, sourceDir, "Field", "Binary");
+    s.enableHaloStripping();
+    s.enableMetaDataSharding(2);
+    s.addGlobalMetainfo("key", std::string("value"));
+    s.registerField("u", sv_u_0.type(), sv_u_0.dims(), haloInfo);
+    s.registerField("v", sv_v_0.type(), sv_v_0.dims());
+
+    // Savepoints 0, 2 and 3 share the same record of u, savepoint 1 has no fields
+    s.write("u", savepoints[0], sv_u_0);
+    s.registerSavepoint(savepoints[1]);
+    s.write("u", savepoints[2], sv_u_0);
+    s.write("u", savepoints[3], sv_u_0);
+    s.write("u", savepoints[4], sv_u_1);
+    s.write("v", savepoints[4], sv_v_0);
+  }
+
+  // Converting onto itself is refused
+  EXPECT_THROW(ArchiveConverter(sourceDir, "Field", "Binary", sourceDir, "Field", "Binary"),
+               Exception);
+
+  {
+    ArchiveConverter converter(sourceDir, "Field", "Binary", targetDir, "Converted", "Binary");
+    converter.setNumThreads(2);
+    converter.convert();
+
+    const auto& statistics = converter.statistics();
+    EXPECT_EQ(statistics.numRecords, 3);
+    EXPECT_EQ(statistics.numFields, 5);
+    EXPECT_EQ(statistics.numBytes, (2 * 5 * 10 * 5 + 7 * 3) * sizeof(double));
+    EXPECT_GE(statistics.throughput(), 0.0);
+  }
+
+  {
+    SerializerImpl s(OpenModeKind::Read, targetDir, "Converted", "Binary");
+    EXPECT_EQ(s.getGlobalMetainfoAs<std::string>("key"), "value");
+    EXPECT_EQ(s.metaDataShardSize(), 2);
+    EXPECT_EQ(s.strippedHalos().count("u"), 1);
+    EXPECT_TRUE(s.getFieldMetainfoImplOf("u").metaInfo().hasKey("__iminushalosize"));
+
+    ASSERT_EQ(s.savepointVector().size(), 5);
+    for(int i = 0; i < 5; ++i)
+      EXPECT_EQ(s.savepointVector()[i], savepoints[i]);
+    EXPECT_TRUE(s.savepointVector().fieldsOf(1).empty());
+    EXPECT_EQ(s.savepointVector().getFieldID(3, "u"), s.savepointVector().getFieldID(0, "u"));
+
+    // Only the compute domain of u is stored, each unique record once
+    EXPECT_EQ(filesystem::file_size(filesystem::path(targetDir) / "Converted_u.dat"),
+              2 * 5 * 10 * 5 * sizeof(double));
+
+    auto sv_u_output = u_output.toStorageView();
+    auto sv_v_output = v_output.toStorageView();
+
+    u_output.forEach([](int) { return 0.0; });
+    s.read("u", savepoints[3], sv_u_output);
+    for(int k = 0; k < 5; ++k)
+      for(int j = 1; j < 11; ++j)
+        for(int i = 2; i < 7; ++i)
+          ASSERT_EQ(u_output(i, j, k), u_0(i, j, k));
+
+    s.read("u", savepoints[4], sv_u_output);
+    for(int k = 0; k < 5; ++k)
+      for(int j = 1; j < 11; ++j)
+        for(int i = 2; i < 7; ++i)
+          ASSERT_EQ(u_output(i, j, k), u_1(i, j, k));
+
+    s.read("v", savepoints[4], sv_v_output);
+    EXPECT_TRUE(Storage::verify(v_output, v_0));
+  }
+}
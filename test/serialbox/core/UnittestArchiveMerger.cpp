@@ -0,0 +1,205 @@
+//===-- serialbox/core/UnittestArchiveMerger.cpp ------------------------------------*- C++ -*-===//
+//
+//                                    S E R I A L B O X
+//
+// This file is distributed under terms of BSD license.
+// See LICENSE.txt for more information
+//
+//===------------------------------------------------------------------------------------------===//
+//
+/// \file
+/// This file implements the unittests of the ArchiveMerger.
+///
+//===------------------------------------------------------------------------------------------===//
+
+#include "utility/SerializerTestBase.h"
+#include "utility/Storage.h"
+#include "serialbox/core/ArchiveMerger.h"
+#include <gtest/gtest.h>
+
+using namespace serialbox;
+using namespace unittest;
+
+namespace {
+
+class ArchiveMergerTest : public SerializerUnittestBase {
+protected:
+  using Storage = unittest::Storage<double>;
+
+  /// \brief Write a segment with the savepoints `time = first, ..., last` each storing `u` filled
+  /// with `value + time`
+  void writeSegment(const std::string& dir, int first, int last, double value,
+                    std::vector<int> dims = {5, 4}, const std::string& prefix = "Field") {
+    Storage u(Storage::ColMajor, dims);
+    auto sv_u = u.toStorageView();
+
+    SerializerImpl s(OpenModeKind::Write, dir, prefix, "Binary");
+    s.addGlobalMetainfo("segment" + std::to_string(first), first);
+    s.registerField("u", sv_u.type(), sv_u.dims());
+    for(int time = first; time <= last; ++time) {
+      u.forEach([&](int) { return value + time; });
+      s.write("u", savepointAt(time), sv_u);
+    }
+  }
+
+  /// \brief Check the value of `u` at savepoint `time = time`
+  void expectValue(SerializerImpl& s, int time, double value) {
+    Storage u(Storage::ColMajor, {5, 4});
+    auto sv_u = u.toStorageView();
+    s.read("u", savepointAt(time), sv_u);
+    for(int j = 0; j < 4; ++j)
+      for(int i = 0; i < 5; ++i)
+        ASSERT_EQ(u(i, j), value) << "time = " << time;
+  }
+
+  static SavepointImpl savepointAt(int time) {
+    SavepointImpl savepoint("sp");
+    savepoint.addMetainfo("time", time);
+    return savepoint;
+  }
+
+  std::string dir(const std::string& name) const { return (directory->path() / name).string(); }
+};
+
+} // anonymous namespace
+
+TEST_F(ArchiveMergerTest, Merge) {
+  writeSegment(dir("run1"), 0, 3, 0.0);
+  writeSegment(dir("run2"), 2, 5, 100.0); // Restarted at time = 2
+
+  // Conflicting savepoints are an error by default
+  {
+    ArchiveMerger merger(dir("merged"), "Field");
+    merger.addSegment(dir("run1"), "Field");
+    merger.addSegment(dir("run2"), "Field");
+    EXPECT_THROW(merger.merge(), Exception);
+  }
+
+  // Keep the last occurrence
+  {
+    ArchiveMerger merger(dir("merged"), "Field");
+    merger.setConflictPolicy(ArchiveMerger::ConflictPolicyKind::KeepLast);
+    merger.addSegment(dir("run1"), "Field");
+    merger.addSegment(dir("run2"), "Field");
+    EXPECT_EQ(merger.merge(), 6);
+    EXPECT_EQ(merger.numConflicts(), 2);
+
+    // The data of each segment starts block-aligned
+    EXPECT_EQ(filesystem::file_size(filesystem::path(dir("merged")) / "Field_u.dat"),
+              ArchiveMerger::Alignment + 4 * 5 * 4 * sizeof(double));
+  }
+  {
+    SerializerImpl s(OpenModeKind::Read, dir("merged"), "Field", "Binary");
+    ASSERT_EQ(s.savepointVector().size(), 6);
+    for(int time = 0; time < 6; ++time)
+      EXPECT_EQ(s.savepointVector()[time], savepointAt(time));
+    EXPECT_TRUE(s.globalMetainfo().hasKey("segment0"));
+    EXPECT_TRUE(s.globalMetainfo().hasKey("segment2"));
+
+    expectValue(s, 0, 0.0);
+    expectValue(s, 1, 1.0);
+    expectValue(s, 2, 102.0);
+    expectValue(s, 5, 105.0);
+  }
+
+  // Keep the first occurrence
+  {
+    ArchiveMerger merger(dir("merged"), "Field");
+    merger.setConflictPolicy(ArchiveMerger::ConflictPolicyKind::KeepFirst);
+    merger.addSegment(dir("run1"), "Field");
+    merger.addSegment(dir("run2"), "Field");
+    EXPECT_EQ(merger.merge(), 6);
+    EXPECT_EQ(merger.numConflicts(), 2);
+  }
+  {
+    SerializerImpl s(OpenModeKind::Read, dir("merged"), "Field", "Binary");
+    expectValue(s, 2, 2.0);
+    expectValue(s, 3, 3.0);
+    expectValue(s, 4, 104.0);
+  }
+}
+
+TEST_F(ArchiveMergerTest, MergeInPlace) {
+  writeSegment(dir("run1"), 0, 1, 0.0);
+  writeSegment(dir("run2"), 2, 3, 100.0);
+
+  const auto size = filesystem::file_size(filesystem::path(dir("run1")) / "Field_u.dat");
+
+  {
+    ArchiveMerger merger(dir("run1"), "Field");
+    merger.addSegment(dir("run1"), "Field");
+    merger.addSegment(dir("run2"), "Field");
+    EXPECT_EQ(merger.merge(), 4);
+    EXPECT_EQ(merger.numConflicts(), 0);
+  }
+
+  EXPECT_GT(filesystem::file_size(filesystem::path(dir("run1")) / "Field_u.dat"), size);
+
+  {
+    SerializerImpl s(OpenModeKind::Read, dir("run1"), "Field", "Binary");
+    ASSERT_EQ(s.savepointVector().size(), 4);
+    expectValue(s, 0, 0.0);
+    expectValue(s, 1, 1.0);
+    expectValue(s, 2, 102.0);
+    expectValue(s, 3, 103.0);
+  }
+
+  // The target can only be the first segment
+  {
+    ArchiveMerger merger(dir("run1"), "Field");
+    merger.addSegment(dir("run2"), "Field");
+    merger.addSegment(dir("run1"), "Field");
+    EXPECT_THROW(merger.merge(), Exception);
+  }
+}
+
+TEST_F(ArchiveMergerTest, SegmentsNextToTarget) {
+  writeSegment(dir("run"), 0, 1, 0.0, {5, 4}, "Field_1");
+  writeSegment(dir("run"), 2, 3, 100.0, {5, 4}, "Field_2");
+
+  // Creating the target would remove the data of the segments
+  {
+    ArchiveMerger merger(dir("run"), "Field");
+    merger.addSegment(dir("run"), "Field_1");
+    merger.addSegment(dir("run"), "Field_2");
+    EXPECT_THROW(merger.merge(), Exception);
+  }
+  EXPECT_TRUE(filesystem::exists(filesystem::path(dir("run")) / "Field_1_u.dat"));
+  EXPECT_TRUE(filesystem::exists(filesystem::path(dir("run")) / "Field_2_u.dat"));
+
+  {
+    ArchiveMerger merger(dir("run"), "Merged");
+    merger.addSegment(dir("run"), "Field_1");
+    merger.addSegment(dir("run"), "Field_2");
+    EXPECT_EQ(merger.merge(), 4);
+  }
+  {
+    SerializerImpl s(OpenModeKind::Read, dir("run"), "Merged", "Binary");
+    expectValue(s, 0, 0.0);
+    expectValue(s, 3, 103.0);
+  }
+}
+
+TEST_F(ArchiveMergerTest, Inconsistent) {
+  writeSegment(dir("run1"), 0, 1, 0.0);
+  writeSegment(dir("run2"), 2, 3, 0.0, {6, 4});
+
+  {
+    ArchiveMerger merger(dir("merged"), "Field");
+    EXPECT_THROW(merger.merge(), Exception);
+  }
+
+  {
+    ArchiveMerger merger(dir("merged"), "Field");
+    merger.addSegment(dir("run1"), "Field");
+    merger.addSegment(dir("run2"), "Field");
+    EXPECT_THROW(merger.merge(), Exception);
+  }
+
+  {
+    ArchiveMerger merger(dir("merged"), "Field");
+    merger.addSegment(dir("run1"), "Field");
+    merger.addSegment(dir("missing"), "Field");
+    EXPECT_THROW(merger.merge(), Exception);
+  }
+}
@@ -0,0 +1,194 @@
+//===-- serialbox/core/UnittestJsonReader.cpp ---------------------------------------*- C++ -*-===//
+//
+//                                    S E R I A L B O X
+//
+// This file is distributed under terms of BSD license.
+// See LICENSE.txt for more information
+//
+//===------------------------------------------------------------------------------------------===//
+//
+/// \file
+/// This file implements the unittests of the JsonReader.
+///
+//===------------------------------------------------------------------------------------------===//
+
+#include "serialbox/core/JsonReader.h"
+#include "serialbox/core/Exception.h"
+#include "serialbox/core/SavepointVector.h"
+#include <gtest/gtest.h>
+#include <sstream>
+
+using namespace serialbox;
+
+TEST(JsonReaderTest, Parse) {
+  std::stringstream ss(R"(
+    {
+      "int": -42,
+      "double": 1.5e2,
+      "string": "a\"b\\cé",
+      "bool": [true, false],
+      "null": null,
+      "empty": {},
+      "nested": {"a": [1, {"b": "]}"}], "c": []}
+    }
+  )");
+
+  JsonReader reader(ss);
+  std::string key;
+
+  reader.beginObject();
+
+  ASSERT_TRUE(reader.nextMember(key));
+  EXPECT_EQ(key, "int");
+  EXPECT_TRUE(reader.peek() == JsonReader::ValueKind::Number);
+  EXPECT_EQ(reader.readInteger(), -42);
+
+  ASSERT_TRUE(reader.nextMember(key));
+  EXPECT_EQ(key, "double");
+  EXPECT_DOUBLE_EQ(reader.readDouble(), 150.0);
+
+  ASSERT_TRUE(reader.nextMember(key));
+  EXPECT_EQ(key, "string");
+  EXPECT_EQ(reader.readString(), "a\"b\\c\xc3\xa9");
+
+  ASSERT_TRUE(reader.nextMember(key));
+  EXPECT_EQ(key, "bool");
+  reader.beginArray();
+  ASSERT_TRUE(reader.nextElement());
+  EXPECT_TRUE(reader.readBoolean());
+  ASSERT_TRUE(reader.nextElement());
+  EXPECT_FALSE(reader.readBoolean());
+  EXPECT_FALSE(reader.nextElement());
+
+  ASSERT_TRUE(reader.nextMember(key));
+  EXPECT_EQ(key, "null");
+  EXPECT_TRUE(reader.isNull());
+  reader.readNull();
+
+  ASSERT_TRUE(reader.nextMember(key));
+  EXPECT_EQ(key, "empty");
+  reader.beginObject();
+  EXPECT_FALSE(reader.nextMember(key));
+
+  ASSERT_TRUE(reader.nextMember(key));
+  EXPECT_EQ(key, "nested");
+  json::json nested = reader.readValue();
+  EXPECT_EQ(nested["a"][1]["b"], "]}");
+  EXPECT_TRUE(nested["c"].empty());
+
+  EXPECT_FALSE(reader.nextMember(key));
+  EXPECT_NO_THROW(reader.end());
+}
+
+TEST(JsonReaderTest, Skip) {
+  std::stringstream ss(R"({"a": {"x": [1, 2, "}"]}, "b": 3.0, "c": "str", "d": true})");
+
+  JsonReader reader(ss);
+  std::string key;
+  int d = 0;
+
+  reader.beginObject();
+  while(reader.nextMember(key)) {
+    if(key == "b")
+      EXPECT_EQ(reader.readInteger(), 3);
+    else if(key == "d")
+      d = reader.readBoolean();
+    else
+      reader.skipValue();
+  }
+  EXPECT_EQ(d, 1);
+  EXPECT_NO_THROW(reader.end());
+}
+
+TEST(JsonReaderTest, Errors) {
+  auto parse = [](const std::string& str) {
+    std::stringstream ss(str);
+    JsonReader reader(ss);
+    std::string key;
+    reader.beginObject();
+    while(reader.nextMember(key))
+      reader.skipValue();
+    reader.end();
+  };
+
+  EXPECT_NO_THROW(parse(R"({"a": 1, "b": [1, 2]})"));
+  EXPECT_THROW(parse(R"({"a": 1 "b": 2})"), Exception);
+  EXPECT_THROW(parse(R"({"a" 1})"), Exception);
+  EXPECT_THROW(parse(R"({"a": 1,})"), Exception);
+  EXPECT_THROW(parse(R"({"a": "unterminated})"), Exception);
+  EXPECT_THROW(parse(R"({"a": 1)"), Exception);
+  EXPECT_THROW(parse(R"({"a": 1} x)"), Exception);
+  EXPECT_THROW(parse(R"([1])"), Exception);
+
+  std::stringstream ss("1.5");
+  JsonReader reader(ss);
+  EXPECT_THROW(reader.readInteger(), Exception);
+}
+
+TEST(JsonReaderTest, SavepointVector) {
+  SavepointImpl savepoint1("savepoint");
+  savepoint1.addMetainfo("key1", 5);
+  SavepointImpl savepoint2("savepoint");
+  savepoint2.addMetainfo("key1", 6);
+  SavepointImpl savepoint3("different-savepoint");
+
+  SavepointVector s;
+  ASSERT_EQ(s.insert(savepoint1), 0);
+  ASSERT_EQ(s.insert(savepoint2), 1);
+  ASSERT_EQ(s.insert(savepoint3), 2);
+  ASSERT_TRUE(s.addField(savepoint1, FieldID{"u", 0}));
+  ASSERT_TRUE(s.addField(savepoint1, FieldID{"v", 1}));
+  ASSERT_TRUE(s.addField(savepoint3, FieldID{"u", 1}));
+
+  std::stringstream ss(s.toJSON().dump(1));
+  JsonReader reader(ss);
+
+  SavepointVector s_from_reader;
+  s_from_reader.fromJSON(reader);
+  reader.end();
+
+  ASSERT_EQ(s_from_reader.size(), 3);
+  for(int i = 0; i < 3; ++i) {
+    EXPECT_EQ(s_from_reader[i], s[i]);
+    EXPECT_EQ(s_from_reader.fieldsOf(i), s.fieldsOf(i));
+  }
+  EXPECT_EQ(s_from_reader.find(savepoint2), 1);
+}
+
+TEST(JsonReaderTest, MetainfoMap) {
+  MetainfoMapImpl map;
+  ASSERT_TRUE(map.insert("bool", true));
+  ASSERT_TRUE(map.insert("int32", int(32)));
+  ASSERT_TRUE(map.insert("int64", std::int64_t(64)));
+  ASSERT_TRUE(map.insert("float32", float(32.0f)));
+  ASSERT_TRUE(map.insert("float64", double(64.0)));
+  ASSERT_TRUE(map.insert("string", "str"));
+  ASSERT_TRUE(map.insert("array_of_int32", Array<int>{1, 2, 3}));
+  ASSERT_TRUE(map.insert("array_of_string", Array<std::string>{"a", "b"}));
+
+  {
+    std::stringstream ss(map.toJSON().dump());
+    JsonReader reader(ss);
+    MetainfoMapImpl map_from_reader;
+    map_from_reader.fromJSON(reader);
+    EXPECT_TRUE(map_from_reader == map);
+  }
+
+  // Value precedes the type
+  {
+    std::stringstream ss(R"({"key": {"value": [1.5, 2.5], "type_id": 21}})");
+    JsonReader reader(ss);
+    MetainfoMapImpl map_from_reader;
+    map_from_reader.fromJSON(reader);
+    ASSERT_EQ(map_from_reader.size(), 1);
+    EXPECT_EQ(map_from_reader.at("key").type(), TypeID::ArrayOfFloat64);
+  }
+
+  // Missing type
+  {
+    std::stringstream ss(R"({"key": {"value": 1}})");
+    JsonReader reader(ss);
+    MetainfoMapImpl map_from_reader;
+    EXPECT_THROW(map_from_reader.fromJSON(reader), Exception);
+  }
+}
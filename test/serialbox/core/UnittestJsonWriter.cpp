@@ -0,0 +1,163 @@
+//===-- serialbox/core/UnittestJsonWriter.cpp ---------------------------------------*- C++ -*-===//
+//
+//                                    S E R I A L B O X
+//
+// This file is distributed under terms of BSD license.
+// See LICENSE.txt for more information
+//
+//===------------------------------------------------------------------------------------------===//
+//
+/// \file
+/// This file implements the unittests of the JsonWriter.
+///
+//===------------------------------------------------------------------------------------------===//
+
+#include "serialbox/core/JsonWriter.h"
+#include "serialbox/core/JsonReader.h"
+#include "serialbox/core/SavepointVector.h"
+#include <cmath>
+#include <gtest/gtest.h>
+#include <limits>
+#include <sstream>
+
+using namespace serialbox;
+
+TEST(JsonWriterTest, Write) {
+  std::stringstream ss;
+  {
+    JsonWriter writer(ss);
+    writer.beginObject();
+    writer.key("int");
+    writer.value(-42);
+    writer.key("double");
+    writer.value(0.1);
+    writer.key("integral_double");
+    writer.value(2.0);
+    writer.key("nan");
+    writer.value(std::numeric_limits<double>::quiet_NaN());
+    writer.key("string");
+    writer.value("a\"b\\c\n\x01");
+    writer.key("bool");
+    writer.beginArray();
+    writer.value(true);
+    writer.value(false);
+    writer.endArray();
+    writer.key("empty_object");
+    writer.beginObject();
+    writer.endObject();
+    writer.key("empty_array");
+    writer.beginArray();
+    writer.endArray();
+    writer.key("dom");
+    writer.value(json::json{{"a", 1}});
+    writer.endObject();
+  }
+
+  EXPECT_EQ(ss.str(), "{\"int\":-42,\"double\":0.10000000000000001,\"integral_double\":2.0,"
+                      "\"nan\":null,\"string\":\"a\\\"b\\\\c\\n\\u0001\",\"bool\":[true,false],"
+                      "\"empty_object\":{},\"empty_array\":[],\"dom\":{\"a\":1}}");
+
+  // Round trip
+  JsonReader reader(ss);
+  std::string key;
+  reader.beginObject();
+  ASSERT_TRUE(reader.nextMember(key));
+  EXPECT_EQ(reader.readInteger(), -42);
+  ASSERT_TRUE(reader.nextMember(key));
+  EXPECT_EQ(reader.readDouble(), 0.1);
+  ASSERT_TRUE(reader.nextMember(key));
+  EXPECT_EQ(reader.readDouble(), 2.0);
+  ASSERT_TRUE(reader.nextMember(key));
+  EXPECT_TRUE(reader.isNull());
+  reader.skipValue();
+  ASSERT_TRUE(reader.nextMember(key));
+  EXPECT_EQ(reader.readString(), "a\"b\\c\n\x01");
+}
+
+TEST(JsonWriterTest, Indent) {
+  std::stringstream ss;
+  {
+    JsonWriter writer(ss, 2);
+    writer.beginObject();
+    writer.key("a");
+    writer.beginArray();
+    writer.value(1);
+    writer.endArray();
+    writer.key("b");
+    writer.beginObject();
+    writer.endObject();
+    writer.endObject();
+  }
+  EXPECT_EQ(ss.str(), "{\n  \"a\": [\n    1\n  ],\n  \"b\": {}\n}");
+}
+
+TEST(JsonWriterTest, SavepointVector) {
+  SavepointImpl savepoint1("savepoint");
+  savepoint1.addMetainfo("key1", 5);
+  savepoint1.addMetainfo("key2", float(0.1f));
+  SavepointImpl savepoint2("savepoint");
+  savepoint2.addMetainfo("key1", 6);
+  savepoint2.addMetainfo("key2", Array<std::string>{"a", "b"});
+  SavepointImpl savepoint3("different-savepoint");
+
+  SavepointVector s;
+  ASSERT_EQ(s.insert(savepoint1), 0);
+  ASSERT_EQ(s.insert(savepoint2), 1);
+  ASSERT_EQ(s.insert(savepoint3), 2);
+  ASSERT_TRUE(s.addField(savepoint1, FieldID{"u", 0}));
+  ASSERT_TRUE(s.addField(savepoint1, FieldID{"v", 1}));
+  ASSERT_TRUE(s.addField(savepoint3, FieldID{"u", 1}));
+
+  std::stringstream ss;
+  {
+    JsonWriter writer(ss, 1);
+    s.toJSON(writer);
+  }
+
+  // Same document as the DOM
+  EXPECT_EQ(json::json::parse(ss.str()), s.toJSON());
+
+  JsonReader reader(ss);
+  SavepointVector s_from_reader;
+  s_from_reader.fromJSON(reader);
+  reader.end();
+
+  ASSERT_EQ(s_from_reader.size(), 3);
+  for(int i = 0; i < 3; ++i) {
+    EXPECT_EQ(s_from_reader[i], s[i]);
+    EXPECT_EQ(s_from_reader.fieldsOf(i), s.fieldsOf(i));
+  }
+
+  // Empty savepoint vector
+  std::stringstream ssEmpty;
+  {
+    JsonWriter writer(ssEmpty);
+    SavepointVector().toJSON(writer);
+  }
+  EXPECT_EQ(ssEmpty.str(), "null");
+}
+
+TEST(JsonWriterTest, MetainfoMap) {
+  MetainfoMapImpl map;
+  ASSERT_TRUE(map.insert("bool", true));
+  ASSERT_TRUE(map.insert("int32", int(32)));
+  ASSERT_TRUE(map.insert("int64", std::int64_t(-64)));
+  ASSERT_TRUE(map.insert("float32", float(1.0f / 3.0f)));
+  ASSERT_TRUE(map.insert("float64", double(1.0 / 3.0)));
+  ASSERT_TRUE(map.insert("string", "str"));
+  ASSERT_TRUE(map.insert("array_of_bool", Array<bool>{true, false}));
+  ASSERT_TRUE(map.insert("array_of_float32", Array<float>{1.5f, 0.1f}));
+  ASSERT_TRUE(map.insert("array_of_string", Array<std::string>{"a", "b"}));
+
+  std::stringstream ss;
+  {
+    JsonWriter writer(ss);
+    map.toJSON(writer);
+  }
+  EXPECT_EQ(json::json::parse(ss.str()), map.toJSON());
+
+  JsonReader reader(ss);
+  MetainfoMapImpl map_from_reader;
+  map_from_reader.fromJSON(reader);
+  EXPECT_TRUE(map_from_reader == map);
+}
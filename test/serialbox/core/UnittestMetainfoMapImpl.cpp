@@ -124,6 +124,14 @@ TEST(MetainfoMapImplTest, Comparison) {
   ASSERT_TRUE(map1.insert("double", double(1)));
   ASSERT_TRUE(map2.insert("double", double(2)));
   EXPECT_TRUE(map1 != map2);
+  EXPECT_NE(map1.hash(), map2.hash());
+
+  // Equal maps have equal hashes
+  MetainfoMapImpl map3;
+  ASSERT_TRUE(map3.insert("double", double(1)));
+  ASSERT_TRUE(map3.insert("bool", bool(true)));
+  EXPECT_TRUE(map1 == map3);
+  EXPECT_EQ(map1.hash(), map3.hash());
 }
 
 TEST(MetainfoMapImplTest, Conversion) {
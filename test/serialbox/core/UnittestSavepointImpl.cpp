@@ -208,10 +208,20 @@ TEST(SavepointImplTest, Hash) {
   EXPECT_EQ(s1, s1);
   EXPECT_EQ(hash(s1), hash(s1));
 
-  // 3) For two diffrent savepoints s1 and s2 that are not equal, their hash will be equal if they
-  //    have the same name.
+  // 3) Savepoints sharing the same name but differing in their meta-info are (very likely) hashed
+  //    differently.
   EXPECT_NE(s1, s2);
-  EXPECT_EQ(hash(s1), hash(s2));
+  EXPECT_NE(hash(s1), hash(s2));
+
+  // 4) The hash does not depend on the order in which the meta-info was added.
+  SavepointImpl s3("savepoint");
+  s3.addMetainfo("key1", double(5));
+  s3.addMetainfo("key2", std::string("value"));
+  SavepointImpl s4("savepoint");
+  s4.addMetainfo("key2", std::string("value"));
+  s4.addMetainfo("key1", double(5));
+  EXPECT_EQ(s3, s4);
+  EXPECT_EQ(hash(s3), hash(s4));
 }
 
 TEST(SavepointImplTest, HashMap) {
@@ -12,9 +12,11 @@
 ///
 //===------------------------------------------------------------------------------------------===//
 
+#include "serialbox/core/JsonReader.h"
 #include "serialbox/core/SavepointVector.h"
 #include <boost/algorithm/string.hpp>
 #include <gtest/gtest.h>
+#include <sstream>
 
 using namespace serialbox;
 
@@ -198,6 +200,41 @@ TEST(SavepointVectorTest, Construction) {
   }
 }
 
+TEST(SavepointVectorTest, FieldIndex) {
+  SavepointVector s;
+  for(int i = 0; i < 6; ++i)
+    ASSERT_EQ(s.insert(SavepointImpl("sp" + std::to_string(i))), i);
+
+  // Field "u" exists at savepoints 0 and 4, "v" at every savepoint (added out of order)
+  ASSERT_TRUE(s.addField(4, FieldID{"u", 1}));
+  ASSERT_TRUE(s.addField(0, FieldID{"u", 0}));
+  ASSERT_FALSE(s.addField(0, FieldID{"u", 0}));
+  for(int i = 5; i >= 0; --i)
+    ASSERT_TRUE(s.addField(i, FieldID{"v", unsigned(i)}));
+
+  EXPECT_EQ(s.findFieldAtOrBefore(0, "u"), 0);
+  EXPECT_EQ(s.findFieldAtOrBefore(3, "u"), 0);
+  EXPECT_EQ(s.findFieldAtOrBefore(4, "u"), 4);
+  EXPECT_EQ(s.findFieldAtOrBefore(5, "u"), 4);
+  EXPECT_EQ(s.findFieldAtOrBefore(3, "v"), 3);
+  EXPECT_EQ(s.findFieldAtOrBefore(3, "w"), -1);
+
+  EXPECT_EQ(s.findFieldAfter(-1, "u"), 0);
+  EXPECT_EQ(s.findFieldAfter(0, "u"), 4);
+  EXPECT_EQ(s.findFieldAfter(4, "u"), -1);
+  EXPECT_EQ(s.findFieldAfter(2, "v"), 3);
+  EXPECT_EQ(s.findFieldAfter(-1, "w"), -1);
+
+  // The index survives swap and clear
+  SavepointVector s2;
+  s2.swap(s);
+  EXPECT_EQ(s2.findFieldAtOrBefore(3, "u"), 0);
+  EXPECT_EQ(s.findFieldAtOrBefore(3, "u"), -1);
+
+  s2.clear();
+  EXPECT_EQ(s2.findFieldAfter(-1, "u"), -1);
+}
+
 TEST(SavepointVectorTest, toJSON) {
   // s1 and s2 have same name but different meta-info, s3 has a different name and no meta-info
   SavepointImpl savepoint1("savepoint");
@@ -312,6 +349,11 @@ TEST(SavepointVectorTest, fromJSON) {
     EXPECT_EQ(s.getFieldID(savepoint1, "u"), (FieldID{"u", 0}));
     EXPECT_EQ(s.getFieldID(savepoint1, "v"), (FieldID{"v", 0}));
     EXPECT_EQ(s.getFieldID(savepoint2, "u"), (FieldID{"u", 1}));
+
+    // Check field index
+    EXPECT_EQ(s.findFieldAtOrBefore(2, "u"), 1);
+    EXPECT_EQ(s.findFieldAtOrBefore(2, "v"), 0);
+    EXPECT_EQ(s.findFieldAfter(0, "v"), -1);
   }
   
   // -----------------------------------------------------------------------------------------------
@@ -373,6 +415,60 @@ TEST(SavepointVectorTest, fromJSON) {
     SavepointVector s;
     ASSERT_THROW(s.fromJSON(j), Exception);
   }
+
+  // -----------------------------------------------------------------------------------------------
+  // Failure (entry in "fields_per_savepoint" refers to a different savepoint)
+  // -----------------------------------------------------------------------------------------------
+  {
+    std::istringstream ss(R"(
+     {
+         "fields_per_savepoint": [
+             {
+                 "savepoint": {
+                     "u": 0
+                 }
+             },
+             {
+                 "savepoint": {
+                     "u": 1
+                 }
+             }
+         ],
+         "savepoints": [
+             {
+                 "meta_info": null,
+                 "name": "savepoint"
+             },
+             {
+                 "meta_info": null,
+                 "name": "different-savepoint"
+             }
+         ]
+     }
+    )");
+
+    JsonReader reader(ss);
+    SavepointVector s;
+    ASSERT_THROW(s.fromJSON(reader), Exception);
+  }
+
+  // Savepoints without fields followed by savepoints with fields
+  {
+    SavepointImpl savepoint1("savepoint");
+    SavepointImpl savepoint2("savepoint");
+    savepoint2.addMetainfo("key1", 5);
+
+    SavepointVector s;
+    ASSERT_EQ(s.insert(savepoint1), 0);
+    ASSERT_EQ(s.insert(savepoint2), 1);
+    ASSERT_TRUE(s.addField(savepoint2, FieldID{"u", 2}));
+
+    SavepointVector s_from_json(s.toJSON());
+    ASSERT_EQ(s_from_json.size(), 2);
+    EXPECT_TRUE(s_from_json.fieldsOf(0).empty());
+    ASSERT_TRUE(s_from_json.hasField(savepoint2, "u"));
+    EXPECT_EQ(s_from_json.getFieldID(savepoint2, "u").id, 2);
+  }
 }
 
 TEST(SavepointVectorTest, toString) {
@@ -15,7 +15,13 @@
 #include "utility/SerializerTestBase.h"
 #include "utility/Storage.h"
 #include "serialbox/core/SerializerImpl.h"
+#include "serialbox/core/archive/ArchiveFactory.h"
+#include "serialbox/core/archive/BinaryArchive.h"
+#include <atomic>
+#include <fstream>
 #include <gtest/gtest.h>
+#include <iterator>
+#include <thread>
 
 using namespace serialbox;
 using namespace unittest;
@@ -508,6 +514,376 @@ TEST_F(SerializerImplUtilityTest, toString) {
   EXPECT_NE(ss.str().find("key"), std::string::npos);
 }
 
+TEST_F(SerializerImplUtilityTest, MetaDataSharding) {
+  using Storage = Storage<double>;
+  Storage storage(Storage::ColMajor, {5, 1, 1}, Storage::random);
+  Storage storage_output(Storage::ColMajor, {5, 1, 1});
+  auto sv = storage.toStorageView();
+
+  auto savepoint = [](int time) {
+    SavepointImpl sp("sp");
+    sp.addMetainfo("time", time);
+    return sp;
+  };
+
+  auto readFile = [](const filesystem::path& file) {
+    std::ifstream ifs(file.string());
+    return std::string(std::istreambuf_iterator<char>(ifs), std::istreambuf_iterator<char>());
+  };
+
+  // Write
+  {
+    SerializerImpl s_write(OpenModeKind::Write, directory->path().string(), "Field", "Binary");
+    ASSERT_THROW(s_write.enableMetaDataSharding(0), Exception);
+    s_write.enableMetaDataSharding(2);
+    EXPECT_TRUE(s_write.isMetaDataShardingEnabled());
+
+    s_write.registerField("u", sv.type(), sv.dims());
+    s_write.registerField("v", sv.type(), sv.dims());
+    for(int i = 0; i < 5; ++i)
+      s_write.write("u", savepoint(i), sv);
+
+    for(int shard = 0; shard < 3; ++shard)
+      EXPECT_TRUE(filesystem::exists(s_write.metaDataShardFile(shard)));
+    EXPECT_FALSE(filesystem::exists(s_write.metaDataShardFile(3)));
+
+    // Only the shard of the modified savepoint is rewritten
+    std::string shard0 = readFile(s_write.metaDataShardFile(0));
+    std::string shard1 = readFile(s_write.metaDataShardFile(1));
+    s_write.write("v", savepoint(4), sv);
+    s_write.write("v", savepoint(5), sv);
+    EXPECT_EQ(readFile(s_write.metaDataShardFile(0)), shard0);
+    EXPECT_EQ(readFile(s_write.metaDataShardFile(1)), shard1);
+
+    s_write.write("v", savepoint(0), sv);
+    EXPECT_NE(readFile(s_write.metaDataShardFile(0)), shard0);
+    EXPECT_EQ(readFile(s_write.metaDataShardFile(1)), shard1);
+  }
+
+  // Read
+  {
+    SerializerImpl s_read(OpenModeKind::Read, directory->path().string(), "Field", "Binary");
+    EXPECT_EQ(s_read.metaDataShardSize(), 2);
+    ASSERT_EQ(s_read.savepointVector().size(), 6);
+    for(int i = 0; i < 6; ++i)
+      EXPECT_EQ(s_read.savepointVector()[i], savepoint(i));
+
+    EXPECT_EQ(s_read.savepointVector().fieldsOf(0).size(), 2);
+    EXPECT_EQ(s_read.savepointVector().fieldsOf(3).size(), 1);
+    EXPECT_EQ(s_read.savepointVector().fieldsOf(5).size(), 1);
+
+    auto sv_output = storage_output.toStorageView();
+    s_read.read("v", savepoint(5), sv_output);
+    ASSERT_TRUE(Storage::verify(storage_output, storage));
+  }
+
+  // Append keeps the shard size, disabling the sharding removes the shards
+  {
+    SerializerImpl s_append(OpenModeKind::Append, directory->path().string(), "Field", "Binary");
+    EXPECT_EQ(s_append.metaDataShardSize(), 2);
+    s_append.write("u", savepoint(6), sv);
+    EXPECT_TRUE(filesystem::exists(s_append.metaDataShardFile(3)));
+
+    s_append.disableMetaDataSharding();
+    s_append.updateMetaData();
+    EXPECT_FALSE(filesystem::exists(s_append.metaDataShardFile(0)));
+    EXPECT_FALSE(filesystem::exists(s_append.metaDataShardFile(3)));
+  }
+
+  {
+    SerializerImpl s_read(OpenModeKind::Read, directory->path().string(), "Field", "Binary");
+    EXPECT_FALSE(s_read.isMetaDataShardingEnabled());
+    ASSERT_EQ(s_read.savepointVector().size(), 7);
+    EXPECT_EQ(s_read.savepointVector().fieldsOf(0).size(), 2);
+  }
+
+  // Reopening in Write mode removes the shards of the previous run
+  {
+    SerializerImpl s_write(OpenModeKind::Write, directory->path().string(), "Field", "Binary");
+    s_write.enableMetaDataSharding(2);
+    s_write.registerField("u", sv.type(), sv.dims());
+    for(int i = 0; i < 5; ++i)
+      s_write.write("u", savepoint(i), sv);
+    EXPECT_TRUE(filesystem::exists(s_write.metaDataShardFile(2)));
+  }
+  {
+    SerializerImpl s_write(OpenModeKind::Write, directory->path().string(), "Field", "Binary");
+    for(int shard = 0; shard < 3; ++shard)
+      EXPECT_FALSE(filesystem::exists(s_write.metaDataShardFile(shard)));
+
+    s_write.enableMetaDataSharding(2);
+    s_write.registerField("u", sv.type(), sv.dims());
+    s_write.write("u", savepoint(0), sv);
+    EXPECT_TRUE(filesystem::exists(s_write.metaDataShardFile(0)));
+    EXPECT_FALSE(filesystem::exists(s_write.metaDataShardFile(1)));
+    EXPECT_FALSE(filesystem::exists(s_write.metaDataShardFile(2)));
+  }
+  {
+    SerializerImpl s_read(OpenModeKind::Read, directory->path().string(), "Field", "Binary");
+    EXPECT_EQ(s_read.savepointVector().size(), 1);
+  }
+
+  // Missing shard
+  {
+    SerializerImpl s_write(OpenModeKind::Write, directory->path().string(), "Field", "Binary");
+    s_write.enableMetaDataSharding(1);
+    s_write.registerSavepoint(savepoint(0));
+    s_write.registerSavepoint(savepoint(1));
+    s_write.updateMetaData();
+    filesystem::remove(s_write.metaDataShardFile(1));
+  }
+  ASSERT_THROW(SerializerImpl(OpenModeKind::Read, directory->path().string(), "Field", "Binary"),
+               Exception);
+}
+
+TEST_F(SerializerImplUtilityTest, MetaDataShardingLazy) {
+  using Storage = Storage<double>;
+  Storage storage(Storage::ColMajor, {5, 1, 1}, Storage::random);
+  Storage storage_output(Storage::ColMajor, {5, 1, 1});
+  auto sv = storage.toStorageView();
+
+  auto savepoint = [](int time) {
+    SavepointImpl sp("sp");
+    sp.addMetainfo("time", time);
+    return sp;
+  };
+
+  // Write 10 savepoints into the shards [0, 3), [3, 6), [6, 9) and [9, 10)
+  {
+    SerializerImpl s_write(OpenModeKind::Write, directory->path().string(), "Field", "Binary");
+    s_write.enableMetaDataSharding(3);
+    s_write.registerField("u", sv.type(), sv.dims());
+    for(int i = 0; i < 10; ++i)
+      s_write.write("u", savepoint(i), sv);
+  }
+
+  // Append only loads the last shard and the shards of the savepoints written to
+  {
+    SerializerImpl s_append(OpenModeKind::Append, directory->path().string(), "Field", "Binary");
+    ASSERT_EQ(s_append.savepointVector().size(), 10);
+    EXPECT_EQ(s_append.savepointVector().numUnloadedShards(), 3);
+
+    s_append.registerField("v", sv.type(), sv.dims());
+    s_append.write("v", savepoint(9), sv);
+    EXPECT_EQ(s_append.savepointVector().numUnloadedShards(), 3);
+
+    s_append.write("v", savepoint(4), sv);
+    EXPECT_EQ(s_append.savepointVector().numUnloadedShards(), 1);
+
+    // The field index only loads the shards up to the found savepoint
+    EXPECT_EQ(s_append.savepointVector().findFieldAtOrBefore(8, "v"), 4);
+    EXPECT_EQ(s_append.savepointVector().numUnloadedShards(), 1);
+    EXPECT_EQ(s_append.savepointVector().findFieldAfter(-1, "v"), 4);
+    EXPECT_EQ(s_append.savepointVector().numUnloadedShards(), 0);
+  }
+
+  // Reading a savepoint accessed by index only opens its shard
+  {
+    SerializerImpl s_read(OpenModeKind::Read, directory->path().string(), "Field", "Binary");
+    ASSERT_EQ(s_read.savepointVector().size(), 10);
+    EXPECT_EQ(s_read.savepointVector().numUnloadedShards(), 3);
+
+    filesystem::remove(s_read.metaDataShardFile(0));
+    filesystem::remove(s_read.metaDataShardFile(2));
+
+    const SavepointImpl& sp = s_read.savepointVector()[4];
+    EXPECT_EQ(sp, savepoint(4));
+    EXPECT_EQ(s_read.savepointVector().numUnloadedShards(), 2);
+
+    auto sv_output = storage_output.toStorageView();
+    s_read.read("v", sp, sv_output);
+    ASSERT_TRUE(Storage::verify(storage_output, storage));
+    EXPECT_EQ(s_read.savepointVector().numUnloadedShards(), 2);
+
+    EXPECT_EQ(s_read.savepointVector().fieldsOf(4).size(), 2);
+    EXPECT_EQ(s_read.savepointVector().fieldsOf(9).size(), 2);
+    EXPECT_EQ(s_read.savepointVector().numUnloadedShards(), 2);
+
+    // The removed shards cannot be loaded
+    EXPECT_THROW(s_read.savepointVector()[0], Exception);
+    EXPECT_THROW(s_read.savepointVector().find(savepoint(10)), Exception);
+  }
+}
+
+TEST_F(SerializerImplUtilityTest, ReadAlsoPrevious) {
+  using Storage = Storage<double>;
+  Storage init(Storage::ColMajor, {4, 3}, Storage::random);
+  Storage update(Storage::ColMajor, {4, 3}, Storage::random);
+  Storage output(Storage::ColMajor, {4, 3});
+
+  auto savepoint = [](int t) {
+    SavepointImpl sp("step");
+    sp.addMetainfo("t", t);
+    return sp;
+  };
+
+  // Field "u" is written at the first savepoint and rewritten at t = 5
+  {
+    SerializerImpl s_write(OpenModeKind::Write, directory->path().string(), "Field", "Binary");
+    auto sv_init = init.toStorageView();
+    auto sv_update = update.toStorageView();
+    s_write.registerField("u", sv_init.type(), sv_init.dims());
+    s_write.write("u", savepoint(0), sv_init);
+    for(int t = 1; t < 10; ++t)
+      s_write.registerSavepoint(savepoint(t));
+    s_write.write("u", savepoint(5), sv_update);
+  }
+
+  SerializerImpl s_read(OpenModeKind::Read, directory->path().string(), "Field", "Binary");
+  auto sv = output.toStorageView();
+
+  s_read.read("u", savepoint(4), sv, true);
+  ASSERT_TRUE(Storage::verify(output, init));
+
+  s_read.read("u", savepoint(9), sv, true);
+  ASSERT_TRUE(Storage::verify(output, update));
+
+  ASSERT_THROW(s_read.read("u", savepoint(4), sv), Exception);
+  EXPECT_EQ(s_read.savepointVector().findFieldAfter(0, "u"), 5);
+}
+
+TEST_F(SerializerImplUtilityTest, ReadSavepoint) {
+  using Storage = Storage<double>;
+  const int numFields = 6;
+
+  std::vector<Storage> inputs;
+  for(int i = 0; i < numFields; ++i)
+    inputs.emplace_back(Storage::ColMajor, std::vector<int>{6, 5, 4}, Storage::random);
+
+  SavepointImpl sp_0("sp"), sp_1("sp");
+  sp_1.addMetainfo("restart", true);
+
+  // Field "f_i" is written at both savepoints, such that the records of a file are not contiguous
+  {
+    SerializerImpl s_write(OpenModeKind::Write, directory->path().string(), "Field", "Binary");
+    for(int i = 0; i < numFields; ++i) {
+      auto sv = inputs[i].toStorageView();
+      s_write.registerField("f_" + std::to_string(i), sv.type(), sv.dims());
+      s_write.write("f_" + std::to_string(i), sp_0, sv);
+    }
+    for(int i = numFields - 1; i >= 0; --i) {
+      auto sv = inputs[(i + 1) % numFields].toStorageView();
+      s_write.write("f_" + std::to_string(i), sp_1, sv);
+    }
+  }
+
+  SerializerImpl s_read(OpenModeKind::Read, directory->path().string(), "Field", "Binary");
+
+  for(int numThreads : {1, 4}) {
+    std::vector<Storage> outputs;
+    std::unordered_map<std::string, StorageView> storageViews;
+    for(int i = 0; i < numFields; ++i)
+      outputs.emplace_back(Storage::ColMajor, std::vector<int>{6, 5, 4});
+    for(int i = 0; i < numFields; ++i)
+      storageViews.emplace("f_" + std::to_string(i), outputs[i].toStorageView());
+
+    auto statistics = s_read.readSavepoint(sp_1, storageViews, numThreads);
+    EXPECT_EQ(statistics.numFields, numFields);
+    EXPECT_EQ(statistics.numFiles, numFields);
+    EXPECT_EQ(statistics.numBytes, numFields * 6 * 5 * 4 * sizeof(double));
+    EXPECT_GE(statistics.bandwidth(), 0.0);
+
+    for(int i = 0; i < numFields; ++i)
+      ASSERT_TRUE(Storage::verify(outputs[i], inputs[(i + 1) % numFields]));
+  }
+
+  // Errors
+  Storage output(Storage::ColMajor, {6, 5, 4});
+  Storage outputWrongDims(Storage::ColMajor, {6, 5});
+
+  std::unordered_map<std::string, StorageView> unknownField{{"X", output.toStorageView()}};
+  ASSERT_THROW(s_read.readSavepoint(sp_0, unknownField), Exception);
+
+  std::unordered_map<std::string, StorageView> wrongDims{{"f_0", outputWrongDims.toStorageView()}};
+  ASSERT_THROW(s_read.readSavepoint(sp_0, wrongDims), Exception);
+
+  std::unordered_map<std::string, StorageView> storageViews{{"f_0", output.toStorageView()}};
+  ASSERT_THROW(s_read.readSavepoint(SavepointImpl("X"), storageViews), Exception);
+}
+
+TEST_F(SerializerImplUtilityTest, ConcurrentWriteAndRead) {
+  using Storage = Storage<double>;
+  const int numWriters = 4, numReaders = 4, numSteps = 20;
+
+  auto savepoint = [](int t) {
+    SavepointImpl sp("step");
+    sp.addMetainfo("t", t);
+    return sp;
+  };
+
+  auto value = [](int writer, int t) { return double(1000 * writer + t); };
+
+  Storage init(Storage::ColMajor, {8, 6, 4}, Storage::random);
+  auto sv_init = init.toStorageView();
+
+  SerializerImpl s_write(OpenModeKind::Write, directory->path().string(), "Field", "Binary");
+  s_write.registerField("init", sv_init.type(), sv_init.dims());
+  s_write.write("init", SavepointImpl("init"), sv_init);
+
+  // Each writer registers and writes its own field at the savepoints shared by all writers while
+  // the readers read the initial field and query the meta-data
+  std::atomic<int> numFinishedWriters(0);
+  std::atomic<int> numErrors(0);
+  std::vector<std::thread> threads;
+
+  for(int w = 0; w < numWriters; ++w)
+    threads.emplace_back([&, w]() {
+      try {
+        Storage u(Storage::ColMajor, {8, 6, 4});
+        auto sv = u.toStorageView();
+        const std::string name = "u_" + std::to_string(w);
+        s_write.registerField(name, sv.type(), sv.dims());
+        s_write.addFieldMetainfoImpl(name, "writer", w);
+
+        for(int t = 0; t < numSteps; ++t) {
+          for(int k = 0; k < 4; ++k)
+            for(int j = 0; j < 6; ++j)
+              for(int i = 0; i < 8; ++i)
+                u(i, j, k) = value(w, t);
+          s_write.write(name, savepoint(t), sv);
+        }
+      } catch(std::exception& e) {
+        ++numErrors;
+      }
+      ++numFinishedWriters;
+    });
+
+  for(int r = 0; r < numReaders; ++r)
+    threads.emplace_back([&]() {
+      try {
+        Storage output(Storage::ColMajor, {8, 6, 4});
+        auto sv = output.toStorageView();
+        do {
+          s_write.read("init", SavepointImpl("init"), sv);
+          if(!Storage::verify(output, init) || !s_write.hasField("init") ||
+             s_write.fieldnames().empty())
+            ++numErrors;
+          s_write.toJSON();
+        } while(numFinishedWriters.load() < numWriters);
+      } catch(std::exception& e) {
+        ++numErrors;
+      }
+    });
+
+  for(auto& thread : threads)
+    thread.join();
+
+  ASSERT_EQ(numErrors.load(), 0);
+  ASSERT_EQ(s_write.savepoints().size(), numSteps + 1);
+
+  // All fields are present on disk
+  SerializerImpl s_read(OpenModeKind::Read, directory->path().string(), "Field", "Binary");
+  ASSERT_EQ(s_read.fieldnames().size(), numWriters + 1);
+
+  Storage output(Storage::ColMajor, {8, 6, 4});
+  auto sv = output.toStorageView();
+  for(int w = 0; w < numWriters; ++w)
+    for(int t = 0; t < numSteps; ++t) {
+      s_read.read("u_" + std::to_string(w), savepoint(t), sv);
+      ASSERT_EQ(output(1, 2, 3), value(w, t));
+    }
+}
+
 #ifdef SERIALBOX_ASYNC_API
 TEST_F(SerializerImplUtilityTest, AsyncRead) {
   using Storage = Storage<double>;
@@ -548,10 +924,113 @@ TEST_F(SerializerImplUtilityTest, AsyncRead) {
     s_read.readAsync("field", sp, sv_2);
     s_read.readAsync("field-XXX", sp, sv_3);
     ASSERT_THROW(s_read.waitForAll(), Exception);
+
+    // All reads are reported, a failed read does not abort the others
+    s_read.readAsync("field-XXX", sp, sv_1);
+    s_read.readAsync("field", sp, sv_2);
+    s_read.readAsync("field-YYY", sp, sv_3);
+    auto result = s_read.waitForAllResults();
+    ASSERT_EQ(result.entries.size(), 3);
+    EXPECT_EQ(result.numFailed(), 2);
+    EXPECT_EQ(result.failed(), (std::vector<std::size_t>{0, 2}));
+    EXPECT_EQ(result.entries[2].name, "field-YYY");
+    EXPECT_FALSE(result.entries[2].error.empty());
+    EXPECT_TRUE(result.entries[1].success);
+    EXPECT_TRUE(s_read.waitForAllResults().entries.empty());
   }
 }
 #endif
 
+TEST_F(SerializerImplUtilityTest, ReadBatch) {
+  using Storage = Storage<double>;
+  Storage u(Storage::ColMajor, {10, 15, 20}, Storage::random);
+  Storage v(Storage::ColMajor, {10, 15, 20}, Storage::random);
+  Storage u_output(Storage::ColMajor, {10, 15, 20});
+  Storage v_output(Storage::ColMajor, {10, 15, 20});
+  Storage w_output(Storage::ColMajor, {10, 15, 20});
+
+  SavepointImpl sp("sp");
+  {
+    SerializerImpl s_write(OpenModeKind::Write, directory->path().string(), "Field", "Binary");
+    auto sv_u = u.toStorageView();
+    auto sv_v = v.toStorageView();
+    s_write.registerField("u", sv_u.type(), sv_u.dims());
+    s_write.registerField("v", sv_v.type(), sv_v.dims());
+    s_write.write("u", sp, sv_u);
+    s_write.write("v", sp, sv_v);
+  }
+
+  // Truncate the data of v
+  filesystem::path file = directory->path() / "Field_v.dat";
+  filesystem::resize_file(file, filesystem::file_size(file) / 2);
+
+  SerializerImpl s_read(OpenModeKind::Read, directory->path().string(), "Field", "Binary");
+  std::vector<SerializerImpl::ReadRequest> requests{
+      {"u", sp, u_output.toStorageView()},
+      {"v", sp, v_output.toStorageView()},
+      {"w", sp, w_output.toStorageView()}};
+
+  auto result = s_read.readBatch(requests, 2);
+  ASSERT_EQ(result.entries.size(), 3);
+  EXPECT_FALSE(result.success());
+  EXPECT_EQ(result.failed(), (std::vector<std::size_t>{1, 2}));
+  EXPECT_NE(result.entries[1].error.find("unexpected end of file"), std::string::npos);
+  EXPECT_NE(result.toString().find("2 of 3 reads failed"), std::string::npos);
+  ASSERT_TRUE(Storage::verify(u_output, u));
+
+  // Restore the file and resume with the failed read
+  BinaryArchive::writeToFile(file.string(), v.toStorageView());
+
+  std::vector<SerializerImpl::ReadRequest> retry{requests[1]};
+  ASSERT_TRUE(s_read.readBatch(retry).success());
+  ASSERT_TRUE(Storage::verify(v_output, v));
+}
+
+TEST_F(SerializerImplUtilityTest, TrustMetaData) {
+  using Storage = Storage<double>;
+  Storage u(Storage::ColMajor, {4, 3}, Storage::random);
+  auto sv = u.toStorageView();
+
+  const std::string dir = directory->path().string();
+  const filesystem::path file = directory->path() / "Field_u.dat";
+  const filesystem::path strayFile = directory->path() / "Field_stray.dat";
+
+  auto writeArchive = [&]() {
+    SerializerImpl s_write(OpenModeKind::Write, dir, "Field", "Binary");
+    s_write.registerField("u", sv.type(), sv.dims());
+    s_write.write("u", SavepointImpl("sp"), sv);
+    std::ofstream(strayFile.string()) << "stray";
+  };
+
+  // Trusted meta-data references all files, only those are removed when writing
+  writeArchive();
+  ArchiveFactory::setTrustMetaData(true);
+  {
+    SerializerImpl s_write(OpenModeKind::Write, dir, "Field", "Binary");
+    EXPECT_FALSE(filesystem::exists(file));
+    EXPECT_TRUE(filesystem::exists(strayFile));
+  }
+  writeArchive();
+  {
+    SerializerImpl s_read(OpenModeKind::Read, dir, "Field", "Binary");
+    EXPECT_TRUE(s_read.hasField("u"));
+  }
+  ArchiveFactory::setTrustMetaData(false);
+
+  // Otherwise the directory is scanned for the files of the archive
+  writeArchive();
+  {
+    SerializerImpl s_write(OpenModeKind::Write, dir, "Field", "Binary");
+    EXPECT_FALSE(filesystem::exists(file));
+    EXPECT_FALSE(filesystem::exists(strayFile));
+    EXPECT_TRUE(s_write.fieldnames().empty());
+  }
+
+  ASSERT_THROW(SerializerImpl(OpenModeKind::Read, (directory->path() / "X").string(), "Field",
+                              "Binary"),
+               Exception);
+}
+
 //===------------------------------------------------------------------------------------------===//
 //     Read/Write tests
 //===------------------------------------------------------------------------------------------===//
@@ -758,6 +1237,105 @@ TYPED_TEST(SerializerImplReadWriteTest, SliceWriteAndRead) {
 #endif
 }
 
+TYPED_TEST(SerializerImplReadWriteTest, HaloStripping) {
+  using Storage = Storage<TypeParam>;
+
+  Storage u_input(Storage::ColMajor, {10, 12, 5}, Storage::random);
+  Storage v_input(Storage::ColMajor, {10, 12, 5}, Storage::random);
+  Storage u_output(Storage::ColMajor, {10, 12, 5});
+  Storage v_output(Storage::ColMajor, {10, 12, 5});
+
+  MetainfoMapImpl haloInfo;
+  haloInfo.insert("__iminushalosize", 2);
+  haloInfo.insert("__iplushalosize", 3);
+  haloInfo.insert("__jminushalosize", 1);
+  haloInfo.insert("__jplushalosize", 1);
+  haloInfo.insert("__kminushalosize", 0);
+  haloInfo.insert("__kplushalosize", 0);
+
+  SavepointImpl sp("sp");
+
+  // Write: "u" has halos, "v" has none and is stored in full
+  {
+    SerializerImpl s_write(OpenModeKind::Write, this->directory->path().string(), "Field",
+                           "Binary");
+    EXPECT_FALSE(s_write.isHaloStrippingEnabled());
+    s_write.enableHaloStripping();
+    EXPECT_TRUE(s_write.isHaloStrippingEnabled());
+
+    auto sv_u = u_input.toStorageView();
+    auto sv_v = v_input.toStorageView();
+    s_write.registerField("u", sv_u.type(), sv_u.dims(), haloInfo);
+    s_write.registerField("v", sv_v.type(), sv_v.dims());
+
+    s_write.write("u", sp, sv_u);
+    s_write.write("v", sp, sv_v);
+
+    ASSERT_EQ(s_write.strippedHalos().size(), 1);
+    EXPECT_EQ(s_write.strippedHalos().at("u"),
+              (SerializerImpl::HaloWidths{{2, 3}, {1, 1}, {0, 0}}));
+  }
+
+  // Only the compute domain of "u" is stored
+  EXPECT_EQ(filesystem::file_size(this->directory->path() / "Field_u.dat"),
+            5 * 10 * 5 * sizeof(TypeParam));
+  EXPECT_EQ(filesystem::file_size(this->directory->path() / "Field_v.dat"),
+            10 * 12 * 5 * sizeof(TypeParam));
+
+  // Read: the halos of "u" are left untouched
+  {
+    SerializerImpl s_read(OpenModeKind::Read, this->directory->path().string(), "Field", "Binary");
+    ASSERT_EQ(s_read.strippedHalos().size(), 1);
+
+    u_output.forEach([](int) { return TypeParam(-1); });
+    auto sv_u = u_output.toStorageView();
+    auto sv_v = v_output.toStorageView();
+    s_read.read("u", sp, sv_u);
+    s_read.read("v", sp, sv_v);
+
+    ASSERT_TRUE(Storage::verify(v_output, v_input));
+
+    for(int k = 0; k < 5; ++k)
+      for(int j = 0; j < 12; ++j)
+        for(int i = 0; i < 10; ++i) {
+          if(i >= 2 && i < 7 && j >= 1 && j < 11)
+            ASSERT_EQ(u_output(i, j, k), u_input(i, j, k));
+          else
+            ASSERT_EQ(u_output(i, j, k), TypeParam(-1));
+        }
+
+    // Sliced reading is relative to the full field
+    u_output.forEach([](int) { return TypeParam(-1); });
+    sv_u = u_output.toStorageView();
+    s_read.readSliced("u", sp, sv_u, Slice(1, 8, 2)(0, -1)(2, 3));
+
+    for(int k = 0; k < 5; ++k)
+      for(int j = 0; j < 12; ++j)
+        for(int i = 0; i < 10; ++i) {
+          if((i == 3 || i == 5) && j >= 1 && j < 11 && k == 2)
+            ASSERT_EQ(u_output(i, j, k), u_input(i, j, k));
+          else
+            ASSERT_EQ(u_output(i, j, k), TypeParam(-1));
+        }
+  }
+
+  // Appending keeps the layout of the field, even if stripping is disabled
+  {
+    SerializerImpl s_app(OpenModeKind::Append, this->directory->path().string(), "Field", "Binary");
+    EXPECT_FALSE(s_app.isHaloStrippingEnabled());
+
+    SavepointImpl sp2("sp2");
+    auto sv_u = u_input.toStorageView();
+    s_app.write("u", sp2, sv_u);
+
+    u_output.forEach([](int) { return TypeParam(-1); });
+    sv_u = u_output.toStorageView();
+    s_app.read("u", sp2, sv_u);
+    ASSERT_EQ(u_output(2, 1, 0), u_input(2, 1, 0));
+    ASSERT_EQ(u_output(1, 1, 0), TypeParam(-1));
+  }
+}
+
 #ifdef SERIALBOX_RUN_LARGE_FILE_TESTS
 
 TYPED_TEST(SerializerImplReadWriteTest, LargeFile) {
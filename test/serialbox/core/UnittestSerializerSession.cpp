@@ -0,0 +1,175 @@
+//===-- serialbox/core/UnittestSerializerSession.cpp --------------------------------*- C++ -*-===//
+//
+//                                    S E R I A L B O X
+//
+// This file is distributed under terms of BSD license.
+// See LICENSE.txt for more information
+//
+//===------------------------------------------------------------------------------------------===//
+//
+/// \file
+/// This file implements the unittests of the per-thread writer sessions.
+///
+//===------------------------------------------------------------------------------------------===//
+
+#include "utility/SerializerTestBase.h"
+#include "utility/Storage.h"
+#include "serialbox/core/SerializerSession.h"
+#include <gtest/gtest.h>
+#include <thread>
+
+using namespace serialbox;
+using namespace unittest;
+
+namespace {
+
+class SerializerSessionTest : public SerializerUnittestBase {};
+
+SavepointImpl savepoint(int t) {
+  SavepointImpl sp("step");
+  sp.addMetainfo("t", t);
+  return sp;
+}
+
+} // anonymous namespace
+
+TEST_F(SerializerSessionTest, WriteAndFlush) {
+  using Storage = Storage<double>;
+  Storage u(Storage::RowMajor, {5, 6, 7}, {{2, 2}, {4, 2}, {4, 5}}, Storage::random);
+  Storage v(Storage::ColMajor, {3, 4}, Storage::random);
+  Storage u_output(Storage::ColMajor, {5, 6, 7});
+  Storage v_output(Storage::ColMajor, {3, 4});
+
+  auto sv_u = u.toStorageView();
+  auto sv_v = v.toStorageView();
+
+  SerializerImpl s_write(OpenModeKind::Write, directory->path().string(), "Field", "Binary");
+  s_write.registerField("u", sv_u.type(), sv_u.dims());
+
+  {
+    SerializerSession session(s_write);
+    session.registerField("v", sv_v.type(), sv_v.dims());
+    ASSERT_THROW(session.registerField("v", sv_v.type(), sv_v.dims()), Exception);
+    ASSERT_TRUE(session.registerSavepoint(savepoint(0)));
+
+    session.write("u", savepoint(1), sv_u);
+    session.write("v", savepoint(1), sv_v);
+
+    // Nothing is merged until the session is flushed
+    EXPECT_EQ(session.numRecords(), 2);
+    EXPECT_EQ(session.size(), 5 * 6 * 7 * sizeof(double) + 3 * 4 * sizeof(double));
+    EXPECT_FALSE(s_write.hasField("v"));
+    EXPECT_TRUE(s_write.savepoints().empty());
+
+    // Errors are reported on write
+    ASSERT_THROW(session.write("u", savepoint(1), sv_u), Exception);
+    ASSERT_THROW(session.write("w", savepoint(1), sv_u), Exception);
+    ASSERT_THROW(session.write("v", savepoint(2), sv_u), Exception);
+
+    session.flush();
+    EXPECT_EQ(session.numRecords(), 0);
+    EXPECT_EQ(session.size(), 0);
+    EXPECT_TRUE(s_write.hasField("v"));
+    ASSERT_EQ(s_write.savepoints().size(), 2);
+    EXPECT_EQ(*s_write.savepoints()[0], savepoint(0));
+
+    // The session is flushed on destruction
+    session.write("u", savepoint(2), sv_u);
+  }
+  ASSERT_EQ(s_write.savepoints().size(), 3);
+
+  // Fields already written by another session are reported on flush, without merging anything
+  {
+    SerializerSession session(s_write);
+    session.registerField("w", sv_v.type(), sv_v.dims());
+    session.write("w", savepoint(3), sv_v);
+    session.write("u", savepoint(2), sv_u);
+    ASSERT_THROW(session.flush(), Exception);
+    EXPECT_EQ(session.numRecords(), 2);
+    EXPECT_EQ(session.size(), 5 * 6 * 7 * sizeof(double) + 3 * 4 * sizeof(double));
+    EXPECT_FALSE(s_write.hasField("w"));
+    EXPECT_EQ(s_write.savepoints().size(), 3);
+  }
+
+  // Fields inconsistent with the fields of the serializer are reported on flush
+  {
+    SerializerSession session(s_write);
+    session.registerField("u", sv_v.type(), sv_v.dims());
+    ASSERT_THROW(session.flush(), Exception);
+  }
+
+  SerializerImpl s_read(OpenModeKind::Read, directory->path().string(), "Field", "Binary");
+  auto sv_u_output = u_output.toStorageView();
+  auto sv_v_output = v_output.toStorageView();
+
+  s_read.read("u", savepoint(1), sv_u_output);
+  ASSERT_TRUE(Storage::verify(u_output, u));
+  s_read.read("v", savepoint(1), sv_v_output);
+  ASSERT_TRUE(Storage::verify(v_output, v));
+  s_read.read("u", savepoint(2), sv_u_output);
+  ASSERT_TRUE(Storage::verify(u_output, u));
+
+  ASSERT_THROW(SerializerSession session(s_read), Exception);
+}
+
+TEST_F(SerializerSessionTest, Capacity) {
+  using Storage = Storage<double>;
+  Storage u(Storage::ColMajor, {4, 4}, Storage::random);
+  auto sv = u.toStorageView();
+
+  SerializerImpl s_write(OpenModeKind::Write, directory->path().string(), "Field", "Binary");
+  s_write.registerField("u", sv.type(), sv.dims());
+
+  SerializerSession session(s_write, 2 * sv.sizeInBytes());
+  session.write("u", savepoint(0), sv);
+  session.write("u", savepoint(1), sv);
+  EXPECT_EQ(session.numRecords(), 2);
+  session.write("u", savepoint(2), sv);
+  EXPECT_EQ(session.numRecords(), 0);
+  EXPECT_EQ(s_write.savepoints().size(), 3);
+}
+
+TEST_F(SerializerSessionTest, ConcurrentSessions) {
+  using Storage = Storage<double>;
+  const int numThreads = 8, numSteps = 10;
+
+  SerializerImpl s_write(OpenModeKind::Write, directory->path().string(), "Field", "Binary");
+
+  std::vector<Storage> storages;
+  for(int i = 0; i < numThreads; ++i)
+    storages.emplace_back(Storage::ColMajor, std::vector<int>{6, 5, 4}, Storage::random);
+
+  std::vector<std::thread> threads;
+  for(int i = 0; i < numThreads; ++i)
+    threads.emplace_back([&, i]() {
+      auto sv = storages[i].toStorageView();
+      SerializerSession session(s_write, 3 * sv.sizeInBytes());
+
+      // All sessions register the same field as well
+      session.registerField("shared", sv.type(), sv.dims());
+      session.registerField("u_" + std::to_string(i), sv.type(), sv.dims());
+      for(int t = 0; t < numSteps; ++t) {
+        session.write("u_" + std::to_string(i), savepoint(t), sv);
+        if(t == i)
+          session.write("shared", savepoint(t), sv);
+      }
+    });
+
+  for(auto& thread : threads)
+    thread.join();
+
+  SerializerImpl s_read(OpenModeKind::Read, directory->path().string(), "Field", "Binary");
+  ASSERT_EQ(s_read.savepoints().size(), numSteps);
+  ASSERT_EQ(s_read.fieldnames().size(), numThreads + 1);
+
+  Storage output(Storage::ColMajor, {6, 5, 4});
+  auto sv_output = output.toStorageView();
+  for(int i = 0; i < numThreads; ++i) {
+    for(int t = 0; t < numSteps; ++t) {
+      s_read.read("u_" + std::to_string(i), savepoint(t), sv_output);
+      ASSERT_TRUE(Storage::verify(output, storages[i]));
+    }
+    s_read.read("shared", savepoint(i), sv_output);
+    ASSERT_TRUE(Storage::verify(output, storages[i]));
+  }
+}
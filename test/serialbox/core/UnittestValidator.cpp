@@ -0,0 +1,209 @@
+//===-- serialbox/core/UnittestValidator.cpp ----------------------------------------*- C++ -*-===//
+//
+//                                    S E R I A L B O X
+//
+// This file is distributed under terms of BSD license.
+// See LICENSE.txt for more information
+//
+//===------------------------------------------------------------------------------------------===//
+//
+/// \file
+/// This file implements the unittests of the Validator.
+///
+//===------------------------------------------------------------------------------------------===//
+
+#include "utility/SerializerTestBase.h"
+#include "utility/Storage.h"
+#include "serialbox/core/SerializerImpl.h"
+#include "serialbox/core/Validator.h"
+#include <fstream>
+#include <gtest/gtest.h>
+
+using namespace serialbox;
+using namespace unittest;
+
+namespace {
+
+class ValidatorTest : public SerializerUnittestBase {
+protected:
+  virtual void SetUp() override {
+    SerializerUnittestBase::SetUp();
+    referenceDirectory = (directory->path() / "reference").string();
+    runDirectory = (directory->path() / "run").string();
+  }
+
+  std::string referenceDirectory;
+  std::string runDirectory;
+};
+
+} // anonymous namespace
+
+TEST_F(ValidatorTest, WriteValidation) {
+  using Storage = Storage<double>;
+
+  Storage u_0(Storage::RowMajor, {5, 6, 7}, {{2, 2}, {4, 2}, {4, 5}}, Storage::random);
+  Storage u_1(Storage::RowMajor, {5, 6, 7}, {{2, 2}, {4, 2}, {4, 5}}, Storage::random);
+  Storage v_0(Storage::ColMajor, {5, 6, 7}, Storage::random);
+
+  SavepointImpl sp_0("sp");
+  sp_0.addMetainfo("time", 0);
+  SavepointImpl sp_1("sp");
+  sp_1.addMetainfo("time", 1);
+
+  // Write reference
+  {
+    SerializerImpl s_write(OpenModeKind::Write, referenceDirectory, "Field", "Binary");
+    auto sv_u_0 = u_0.toStorageView();
+    auto sv_u_1 = u_1.toStorageView();
+    auto sv_v_0 = v_0.toStorageView();
+
+    s_write.registerField("u", sv_u_0.type(), sv_u_0.dims());
+    s_write.registerField("v", sv_v_0.type(), sv_v_0.dims());
+    s_write.write("u", sp_0, sv_u_0);
+    s_write.write("v", sp_0, sv_v_0);
+    s_write.write("u", sp_1, sv_u_1);
+  }
+
+  // Validate a run against the reference
+  {
+    SerializerImpl s_run(OpenModeKind::Write, runDirectory, "Field", "Binary");
+    EXPECT_FALSE(s_run.isValidationEnabled());
+    Validator& validator = s_run.enableValidation(referenceDirectory, "Field");
+    EXPECT_TRUE(s_run.isValidationEnabled());
+
+    // Run data with a different memory layout
+    Storage u_0_run(Storage::ColMajor, {5, 6, 7});
+    Storage u_1_run(Storage::ColMajor, {5, 6, 7});
+    for(int i = 0; i < 5; ++i)
+      for(int j = 0; j < 6; ++j)
+        for(int k = 0; k < 7; ++k) {
+          u_0_run(i, j, k) = u_0(i, j, k);
+          u_1_run(i, j, k) = u_1(i, j, k);
+        }
+    u_1_run(1, 2, 3) += 1e-3;
+
+    auto sv_u_0 = u_0_run.toStorageView();
+    auto sv_u_1 = u_1_run.toStorageView();
+    auto sv_v_0 = v_0.toStorageView();
+
+    s_run.registerField("u", sv_u_0.type(), sv_u_0.dims());
+    s_run.registerField("v", sv_v_0.type(), sv_v_0.dims());
+
+    s_run.write("u", sp_0, sv_u_0);
+    s_run.write("v", sp_0, sv_v_0);
+    EXPECT_TRUE(validator.success());
+
+    s_run.write("u", sp_1, sv_u_1);
+    EXPECT_FALSE(validator.success());
+
+    // Field is not present in the reference at this savepoint
+    s_run.write("v", sp_1, sv_v_0);
+
+    ASSERT_EQ(validator.mismatches().size(), 2);
+    EXPECT_EQ(validator.mismatches()[0].field, "u");
+    EXPECT_EQ(validator.mismatches()[0].numErrors, 1);
+    EXPECT_NEAR(validator.mismatches()[0].maxAbsError, 1e-3, 1e-9);
+    EXPECT_EQ(validator.mismatches()[1].field, "v");
+    EXPECT_EQ(validator.mismatches()[1].numErrors, 0);
+
+    const auto& statistics = validator.statistics();
+    EXPECT_EQ(statistics.at("u").numRecords, 2);
+    EXPECT_EQ(statistics.at("u").numFailedRecords, 1);
+    EXPECT_EQ(statistics.at("u").numElements, 2 * 5 * 6 * 7);
+    EXPECT_EQ(statistics.at("v").numRecords, 2);
+    EXPECT_EQ(statistics.at("v").numFailedRecords, 1);
+
+    // No data is written, only the report
+    EXPECT_TRUE(s_run.savepoints().empty());
+    EXPECT_FALSE(filesystem::exists(filesystem::path(runDirectory) / "Field_u.dat"));
+
+    // The report is written once the meta-data is updated
+    EXPECT_FALSE(filesystem::exists(s_run.validationReportFile()));
+    s_run.updateMetaData();
+    ASSERT_TRUE(filesystem::exists(s_run.validationReportFile()));
+
+    std::ifstream ifs(s_run.validationReportFile().string());
+    json::json report;
+    ifs >> report;
+    EXPECT_FALSE(bool(report["success"]));
+    EXPECT_EQ(report["mismatches"].size(), 2);
+    EXPECT_EQ(int(report["statistics"]["u"]["num_failed_records"]), 1);
+
+    // A larger tolerance accepts the perturbation
+    validator.setTolerance("u", 1e-2);
+    EXPECT_DOUBLE_EQ(validator.tolerance("u"), 1e-2);
+    EXPECT_DOUBLE_EQ(validator.tolerance("v"), 1e-12);
+    EXPECT_TRUE(validator.validate("u", sp_1, sv_u_1));
+  }
+}
+
+TEST_F(ValidatorTest, Exceptions) {
+  {
+    SerializerImpl s_write(OpenModeKind::Write, referenceDirectory, "Field", "Binary");
+    s_write.updateMetaData();
+  }
+
+  SerializerImpl s_run(OpenModeKind::Append, referenceDirectory, "Field", "Binary");
+
+  // Reference does not exist
+  ASSERT_THROW(s_run.enableValidation(runDirectory, "Field"), Exception);
+
+  // Validating against itself
+  ASSERT_THROW(s_run.enableValidation(referenceDirectory, "Field"), Exception);
+  EXPECT_FALSE(s_run.isValidationEnabled());
+}
+
+TEST_F(ValidatorTest, ValidationFromEnvironment) {
+  using Storage = Storage<double>;
+  Storage u(Storage::ColMajor, {5, 6, 7}, Storage::random);
+  auto sv_u = u.toStorageView();
+  SavepointImpl sp("sp");
+
+  for(const std::string& dir : {referenceDirectory, runDirectory}) {
+    SerializerImpl s_write(OpenModeKind::Write, dir, "Field", "Binary");
+    s_write.registerField("u", sv_u.type(), sv_u.dims());
+    s_write.write("u", sp, sv_u);
+  }
+
+  const filesystem::path dataFile = filesystem::path(runDirectory) / "Field_u.dat";
+
+  // Validating against itself leaves the data untouched
+  ::setenv("SERIALBOX_VALIDATION_REFERENCE", runDirectory.c_str(), 1);
+  EXPECT_THROW(SerializerImpl(OpenModeKind::Write, runDirectory, "Field", "Binary"), Exception);
+  EXPECT_TRUE(filesystem::exists(dataFile));
+
+  // Only the report is written when validating
+  ::setenv("SERIALBOX_VALIDATION_REFERENCE", referenceDirectory.c_str(), 1);
+  {
+    SerializerImpl s_run(OpenModeKind::Write, runDirectory, "Field", "Binary");
+    ::unsetenv("SERIALBOX_VALIDATION_REFERENCE");
+    ASSERT_TRUE(s_run.isValidationEnabled());
+
+    s_run.registerField("u", sv_u.type(), sv_u.dims());
+    s_run.write("u", sp, sv_u);
+    s_run.updateMetaData();
+    EXPECT_TRUE(s_run.validator()->success());
+    EXPECT_TRUE(filesystem::exists(s_run.validationReportFile()));
+  }
+
+  {
+    SerializerImpl s_read(OpenModeKind::Read, runDirectory, "Field", "Binary");
+    ASSERT_EQ(s_read.savepoints().size(), 1);
+
+    Storage u_output(Storage::ColMajor, {5, 6, 7});
+    auto sv_u_output = u_output.toStorageView();
+    s_read.read("u", sp, sv_u_output);
+    ASSERT_TRUE(Storage::verify(u, u_output));
+  }
+
+  // Leaving validation mode drops the files of the previous run
+  ::setenv("SERIALBOX_VALIDATION_REFERENCE", referenceDirectory.c_str(), 1);
+  {
+    SerializerImpl s_run(OpenModeKind::Write, runDirectory, "Field", "Binary");
+    ::unsetenv("SERIALBOX_VALIDATION_REFERENCE");
+    EXPECT_TRUE(filesystem::exists(dataFile));
+
+    s_run.disableValidation();
+    EXPECT_FALSE(filesystem::exists(dataFile));
+  }
+}
@@ -0,0 +1,133 @@
+//===-- serialbox/core/UnittestVirtualSerializer.cpp --------------------------------*- C++ -*-===//
+//
+//                                    S E R I A L B O X
+//
+// This file is distributed under terms of BSD license.
+// See LICENSE.txt for more information
+//
+//===------------------------------------------------------------------------------------------===//
+//
+/// \file
+/// This file implements the unittests of the VirtualSerializer.
+///
+//===------------------------------------------------------------------------------------------===//
+
+#include "utility/SerializerTestBase.h"
+#include "utility/Storage.h"
+#include "serialbox/core/VirtualSerializer.h"
+#include <gtest/gtest.h>
+
+using namespace serialbox;
+using namespace unittest;
+
+namespace {
+
+class VirtualSerializerTest : public SerializerUnittestBase {
+protected:
+  using Storage = unittest::Storage<double>;
+
+  static SavepointImpl savepointAt(int time) {
+    SavepointImpl savepoint("sp");
+    savepoint.addMetainfo("time", time);
+    return savepoint;
+  }
+
+  /// \brief Write rank `rank` storing `u` (filled with `100 * rank + time`) at the savepoints
+  /// `time = first, ..., last` and `v` at `time = last`
+  void writeRank(int rank, int first, int last) {
+    Storage u(Storage::ColMajor, {4, 3});
+    auto sv_u = u.toStorageView();
+
+    SerializerImpl s(OpenModeKind::Write, directory->path().string(),
+                     "Rank" + std::to_string(rank), "Binary");
+    s.registerField("u", sv_u.type(), sv_u.dims());
+    s.registerField("v", sv_u.type(), sv_u.dims());
+    for(int time = first; time <= last; ++time) {
+      u.forEach([&](int) { return 100.0 * rank + time; });
+      s.write("u", savepointAt(time), sv_u);
+    }
+    s.write("v", savepointAt(last), sv_u);
+  }
+
+  void expectValue(Storage& u, double value) {
+    for(int j = 0; j < 3; ++j)
+      for(int i = 0; i < 4; ++i)
+        ASSERT_EQ(u(i, j), value);
+  }
+};
+
+} // anonymous namespace
+
+TEST_F(VirtualSerializerTest, Read) {
+  writeRank(0, 0, 2);
+  writeRank(1, 1, 4);
+  const std::string dir = directory->path().string();
+
+  VirtualSerializer vs;
+  EXPECT_EQ(vs.addSerializer(dir, "Rank0", "Binary"), 0);
+  EXPECT_EQ(vs.addSerializer(dir, "Rank1", "Binary"), 1);
+  ASSERT_EQ(vs.numSerializers(), 2);
+
+  // Savepoints are unified by first occurrence
+  ASSERT_EQ(vs.savepointVector().size(), 5);
+  for(int time = 0; time < 5; ++time)
+    EXPECT_EQ(vs.savepointVector()[time], savepointAt(time));
+
+  ASSERT_EQ(vs.locationsOf(savepointAt(1)).size(), 2);
+  EXPECT_EQ(vs.locationsOf(savepointAt(1))[1].member, 1);
+  EXPECT_EQ(vs.locationsOf(savepointAt(1))[1].savepointIdx, 0);
+  EXPECT_TRUE(vs.locationsOf(savepointAt(7)).empty());
+
+  EXPECT_TRUE(vs.hasField("v", savepointAt(2)));
+  EXPECT_FALSE(vs.hasField("v", savepointAt(3)));
+  EXPECT_EQ(vs.fieldnames(), (std::vector<std::string>{"u", "v"}));
+  EXPECT_EQ(vs.fieldnamesAt(savepointAt(0)), (std::vector<std::string>{"u"}));
+
+  // Reads are dispatched to the first member storing the field
+  Storage u(Storage::ColMajor, {4, 3});
+  auto sv_u = u.toStorageView();
+  vs.read("u", savepointAt(1), sv_u);
+  expectValue(u, 1.0);
+  vs.read("u", savepointAt(4), sv_u);
+  expectValue(u, 104.0);
+  vs.read("v", savepointAt(4), sv_u);
+  expectValue(u, 104.0);
+
+  EXPECT_THROW(vs.read("u", savepointAt(7), sv_u), Exception);
+  EXPECT_THROW(vs.read("v", savepointAt(0), sv_u), Exception);
+
+  // The members are shared
+  VirtualSerializer other;
+  other.addSerializer(dir, "Rank1", "Binary");
+  EXPECT_EQ(&other.serializer(0), &vs.serializer(1));
+  EXPECT_THROW(other.addSerializer(dir, "Rank2", "Binary"), Exception);
+}
+
+TEST_F(VirtualSerializerTest, ParallelRead) {
+  const int numRanks = 4;
+  for(int rank = 0; rank < numRanks; ++rank)
+    writeRank(rank, rank, rank + 3);
+
+  VirtualSerializer vs;
+  for(int rank = 0; rank < numRanks; ++rank)
+    vs.addSerializer(directory->path().string(), "Rank" + std::to_string(rank), "Binary");
+
+  std::vector<std::unique_ptr<Storage>> storages;
+  std::vector<VirtualSerializer::ReadRequest> requests;
+  for(std::size_t i = 0; i < vs.savepointVector().size(); ++i) {
+    storages.emplace_back(new Storage(Storage::ColMajor, {4, 3}));
+    requests.push_back(VirtualSerializer::ReadRequest{"u", vs.savepointVector()[i],
+                                                      storages.back()->toStorageView()});
+  }
+
+  vs.read(requests, 3);
+
+  // The first rank storing a savepoint `time` is `max(0, time - 3)`
+  for(std::size_t time = 0; time < storages.size(); ++time)
+    expectValue(*storages[time], 100.0 * std::max(0, int(time) - 3) + time);
+
+  // Failing requests are reported
+  requests.push_back(
+      VirtualSerializer::ReadRequest{"w", savepointAt(0), storages[0]->toStorageView()});
+  EXPECT_THROW(vs.read(requests, 3), Exception);
+}
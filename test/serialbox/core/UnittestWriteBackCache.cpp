@@ -0,0 +1,269 @@
+//===-- serialbox/core/UnittestWriteBackCache.cpp -----------------------------------*- C++ -*-===//
+//
+//                                    S E R I A L B O X
+//
+// This file is distributed under terms of BSD license.
+// See LICENSE.txt for more information
+//
+//===------------------------------------------------------------------------------------------===//
+//
+/// \file
+/// This file implements the unittests of the write-back cache.
+///
+//===------------------------------------------------------------------------------------------===//
+
+#include "utility/SerializerTestBase.h"
+#include "utility/Storage.h"
+#include "serialbox/core/SerializerImpl.h"
+#include "serialbox/core/WriteBackCache.h"
+#include <gtest/gtest.h>
+
+using namespace serialbox;
+using namespace unittest;
+
+namespace {
+
+class WriteBackCacheTest : public SerializerUnittestBase {};
+
+SavepointImpl savepoint(int t) {
+  SavepointImpl sp("step");
+  sp.addMetainfo("t", t);
+  return sp;
+}
+
+/// \brief Insert the record and evict records until the cache is within its capacity
+std::vector<WriteBackCache::Record> insert(WriteBackCache& cache, const std::string& name,
+                                           int savepointIdx, const StorageView& storageView) {
+  cache.insert(name, savepointIdx, storageView);
+  std::vector<WriteBackCache::Record> evicted;
+  while(cache.exceedsCapacity()) {
+    evicted.push_back(cache.oldest());
+    cache.popOldest();
+  }
+  return evicted;
+}
+
+} // anonymous namespace
+
+TEST_F(WriteBackCacheTest, Eviction) {
+  using Storage = Storage<double>;
+  Storage u(Storage::RowMajor, {4, 5}, {{1, 1}, {0, 2}}, Storage::random);
+  Storage u_output(Storage::ColMajor, {4, 5});
+  auto sv = u.toStorageView();
+  auto sv_output = u_output.toStorageView();
+  const std::size_t size = sv.sizeInBytes();
+
+  // LRU: overwriting renews the record
+  {
+    WriteBackCache cache(2 * size, WriteBackCache::PolicyKind::LRU);
+    EXPECT_TRUE(insert(cache, "u", 0, sv).empty());
+    EXPECT_TRUE(insert(cache, "u", 1, sv).empty());
+    EXPECT_TRUE(insert(cache, "u", 0, sv).empty());
+    EXPECT_EQ(cache.numOverwrites(), 1);
+    EXPECT_EQ(cache.size(), 2 * size);
+    EXPECT_FALSE(cache.exceedsCapacity());
+
+    auto evicted = insert(cache, "v", 0, sv);
+    ASSERT_EQ(evicted.size(), 1);
+    EXPECT_EQ(evicted[0].name, "u");
+    EXPECT_EQ(evicted[0].savepointIdx, 1);
+    EXPECT_EQ(cache.find("u", 1), nullptr);
+
+    const WriteBackCache::Record* record = cache.find("u", 0);
+    ASSERT_NE(record, nullptr);
+    record->copyTo(sv_output);
+    ASSERT_TRUE(Storage::verify(u_output, u));
+  }
+
+  // FIFO: overwriting does not renew the record
+  {
+    WriteBackCache cache(2 * size, WriteBackCache::PolicyKind::FIFO);
+    insert(cache, "u", 0, sv);
+    insert(cache, "u", 1, sv);
+    insert(cache, "u", 0, sv);
+
+    auto evicted = insert(cache, "v", 0, sv);
+    ASSERT_EQ(evicted.size(), 1);
+    EXPECT_EQ(evicted[0].savepointIdx, 0);
+  }
+
+  // Records larger than the capacity are evicted right away
+  {
+    WriteBackCache cache(size / 2);
+    EXPECT_EQ(insert(cache, "u", 0, sv).size(), 1);
+    EXPECT_EQ(cache.numRecords(), 0);
+    EXPECT_EQ(cache.size(), 0);
+  }
+
+  // Lookup of the last record at or before a savepoint
+  {
+    WriteBackCache cache(10 * size);
+    cache.insert("u", 2, sv);
+    cache.insert("u", 5, sv);
+    cache.insert("v", 3, sv);
+    EXPECT_EQ(cache.findAtOrBefore("u", 1), nullptr);
+    EXPECT_EQ(cache.findAtOrBefore("u", 4)->savepointIdx, 2);
+    EXPECT_EQ(cache.findAtOrBefore("u", 9)->savepointIdx, 5);
+    EXPECT_EQ(cache.findAtOrBefore("v", 2), nullptr);
+    EXPECT_EQ(cache.findAtOrBefore("w", 9), nullptr);
+
+    // Records are evicted in the order they were cached
+    EXPECT_EQ(cache.oldest().savepointIdx, 2);
+    cache.popOldest();
+    EXPECT_EQ(cache.oldest().savepointIdx, 5);
+    EXPECT_EQ(cache.numRecords(), 2);
+    EXPECT_EQ(cache.size(), 2 * size);
+    EXPECT_EQ(cache.find("u", 2), nullptr);
+  }
+}
+
+TEST_F(WriteBackCacheTest, Serializer) {
+  using Storage = Storage<double>;
+  const int numIterations = 10;
+
+  Storage u(Storage::ColMajor, {8, 6, 4}, Storage::random);
+  Storage v(Storage::ColMajor, {8, 6, 4}, Storage::random);
+  Storage output(Storage::ColMajor, {8, 6, 4});
+  auto sv_u = u.toStorageView();
+  auto sv_v = v.toStorageView();
+  auto sv_output = output.toStorageView();
+  const std::size_t size = sv_u.sizeInBytes();
+
+  {
+    SerializerImpl s_write(OpenModeKind::Write, directory->path().string(), "Field", "Binary");
+    s_write.registerField("u", sv_u.type(), sv_u.dims());
+    s_write.enableWriteBackCache(2 * size);
+    ASSERT_TRUE(s_write.isWriteBackCacheEnabled());
+
+    // Each iteration of the outer loop rewrites the same savepoints, only the last is kept
+    for(int iteration = 0; iteration < numIterations; ++iteration) {
+      s_write.write("u", savepoint(0), iteration % 2 ? sv_u : sv_v);
+      s_write.write("u", savepoint(1), sv_v);
+    }
+    EXPECT_EQ(s_write.writeBackCache()->numOverwrites(), 2 * (numIterations - 1));
+
+    // Cached records can be read back
+    s_write.read("u", savepoint(0), sv_output);
+    ASSERT_TRUE(Storage::verify(output, u));
+    s_write.read("u", savepoint(1), sv_output);
+    ASSERT_TRUE(Storage::verify(output, v));
+
+    // Nothing has been written so far
+    EXPECT_FALSE(s_write.savepointVector().hasField(0, "u"));
+
+    // Evict savepoint 0
+    s_write.registerSavepoint(savepoint(2));
+    s_write.write("u", savepoint(2), sv_u);
+    EXPECT_TRUE(s_write.savepointVector().hasField(0, "u"));
+    EXPECT_EQ(s_write.writeBackCache()->numRecords(), 2);
+
+    // Rewriting a committed record replaces it
+    s_write.write("u", savepoint(0), sv_v);
+    s_write.flushWriteBackCache();
+    EXPECT_EQ(s_write.writeBackCache()->numRecords(), 0);
+
+    s_write.write("u", savepoint(3), sv_v);
+    s_write.read("u", savepoint(3), sv_output);
+    ASSERT_TRUE(Storage::verify(output, v));
+
+    // Records at previous savepoints are taken from the cache if they are more recent
+    s_write.registerSavepoint(savepoint(4));
+    s_write.read("u", savepoint(4), sv_output, true);
+    ASSERT_TRUE(Storage::verify(output, v));
+  }
+
+  // The cache is flushed on destruction
+  SerializerImpl s_read(OpenModeKind::Read, directory->path().string(), "Field", "Binary");
+  ASSERT_EQ(s_read.savepoints().size(), 5);
+  s_read.read("u", savepoint(0), sv_output);
+  ASSERT_TRUE(Storage::verify(output, v));
+  s_read.read("u", savepoint(2), sv_output);
+  ASSERT_TRUE(Storage::verify(output, u));
+  s_read.read("u", savepoint(3), sv_output);
+  ASSERT_TRUE(Storage::verify(output, v));
+
+  ASSERT_THROW(s_read.enableWriteBackCache(size), Exception);
+}
+
+TEST_F(WriteBackCacheTest, FailedCommit) {
+  using Storage = Storage<double>;
+  Storage u(Storage::ColMajor, {8, 6}, Storage::random);
+  Storage v(Storage::ColMajor, {8, 6}, Storage::random);
+  Storage output(Storage::ColMajor, {8, 6});
+  auto sv_u = u.toStorageView();
+  auto sv_v = v.toStorageView();
+  auto sv_output = output.toStorageView();
+
+  SerializerImpl s_write(OpenModeKind::Write, directory->path().string(), "Field", "Binary");
+  s_write.registerField("u", sv_u.type(), sv_u.dims());
+  s_write.enableWriteBackCache(sv_u.sizeInBytes());
+
+  // The data file of "u" cannot be created
+  auto dataFile = directory->path() / "Field_u.dat";
+  filesystem::create_directory(dataFile);
+
+  s_write.write("u", savepoint(0), sv_u);
+  ASSERT_THROW(s_write.write("u", savepoint(1), sv_v), Exception);
+
+  // The record which could not be committed is kept
+  EXPECT_EQ(s_write.writeBackCache()->numRecords(), 2);
+  EXPECT_FALSE(s_write.savepointVector().hasField(0, "u"));
+  ASSERT_THROW(s_write.flushWriteBackCache(), Exception);
+  EXPECT_EQ(s_write.writeBackCache()->numRecords(), 2);
+
+  filesystem::remove(dataFile);
+  s_write.flushWriteBackCache();
+  EXPECT_EQ(s_write.writeBackCache()->numRecords(), 0);
+
+  s_write.read("u", savepoint(0), sv_output);
+  ASSERT_TRUE(Storage::verify(output, u));
+  s_write.read("u", savepoint(1), sv_output);
+  ASSERT_TRUE(Storage::verify(output, v));
+}
+
+TEST_F(WriteBackCacheTest, HaloStripping) {
+  using Storage = Storage<double>;
+  Storage u(Storage::ColMajor, {8, 6}, Storage::random);
+  Storage output(Storage::ColMajor, {8, 6});
+  auto sv_u = u.toStorageView();
+  auto sv_output = output.toStorageView();
+
+  MetainfoMapImpl haloInfo;
+  haloInfo.insert("__iminushalosize", 2);
+  haloInfo.insert("__iplushalosize", 1);
+  haloInfo.insert("__jminushalosize", 1);
+  haloInfo.insert("__jplushalosize", 1);
+
+  SerializerImpl s_write(OpenModeKind::Write, directory->path().string(), "Field", "Binary");
+  s_write.enableHaloStripping();
+  s_write.registerField("u", sv_u.type(), sv_u.dims(), haloInfo);
+  s_write.enableWriteBackCache(2 * sv_u.sizeInBytes());
+  s_write.write("u", savepoint(0), sv_u);
+
+  // Cached records and committed records only fill the compute domain
+  auto expectComputeDomain = [&]() {
+    for(int j = 0; j < 6; ++j)
+      for(int i = 0; i < 8; ++i) {
+        if(i >= 2 && i < 7 && j >= 1 && j < 5)
+          ASSERT_EQ(output(i, j), u(i, j));
+        else
+          ASSERT_EQ(output(i, j), -1.0);
+      }
+  };
+
+  output.forEach([](int) { return -1.0; });
+  s_write.read("u", savepoint(0), sv_output);
+  expectComputeDomain();
+
+  std::unordered_map<std::string, StorageView> storageViews{{"u", sv_output}};
+  output.forEach([](int) { return -1.0; });
+  s_write.readSavepoint(savepoint(0), storageViews);
+  expectComputeDomain();
+
+  s_write.flushWriteBackCache();
+  EXPECT_EQ(s_write.writeBackCache()->numRecords(), 0);
+
+  output.forEach([](int) { return -1.0; });
+  s_write.read("u", savepoint(0), sv_output);
+  expectComputeDomain();
+}
@@ -15,6 +15,7 @@
 #include "utility/SerializerTestBase.h"
 #include "utility/Storage.h"
 #include "serialbox/core/archive/BinaryArchive.h"
+#include "serialbox/core/archive/BinaryBuffer.h"
 #include "serialbox/core/Version.h"
 #include <boost/algorithm/string.hpp>
 #include <gtest/gtest.h>
@@ -199,6 +200,45 @@ TEST_F(BinaryArchiveUtilityTest, ToAndFromFile) {
   // Read from non-existing file -> Exception
   ASSERT_THROW(BinaryArchive::readFromFile((this->directory->path() / "X.dat").string(), sv_output),
                Exception);
+
+  // Read from truncated file -> Exception
+  filesystem::resize_file(this->directory->path() / "test.dat", 10);
+  ASSERT_THROW(
+      BinaryArchive::readFromFile((this->directory->path() / "test.dat").string(), sv_output),
+      Exception);
+}
+
+TEST_F(BinaryArchiveUtilityTest, TruncatedFile) {
+  using Storage = Storage<double>;
+  Storage dense(Storage::ColMajor, {8, 4}, Storage::random);
+  Storage sparse(Storage::ColMajor, {8, 4});
+  Storage output(Storage::ColMajor, {8, 4});
+  sparse.forEach([](int) { return 0.0; });
+  sparse(1, 2) = 1.0;
+
+  auto sv_dense = dense.toStorageView();
+  auto sv_sparse = sparse.toStorageView();
+  auto sv_output = output.toStorageView();
+
+  {
+    BinaryArchive archive(OpenModeKind::Write, this->directory->path().string(), "field");
+    archive.write(sv_dense, "dense", nullptr);
+    archive.write(sv_sparse, "sparse", nullptr);
+    ASSERT_EQ(archive.fieldTable()["sparse"][0].encoding, BinaryArchive::EncodingKind::Sparse);
+  }
+
+  filesystem::resize_file(this->directory->path() / "field_dense.dat", 100);
+  filesystem::resize_file(this->directory->path() / "field_sparse.dat", 10);
+
+  BinaryArchive archive(OpenModeKind::Read, this->directory->path().string(), "field");
+  ASSERT_THROW(archive.read(sv_output, FieldID{"dense", 0}, nullptr), Exception);
+  ASSERT_THROW(archive.read(sv_output, FieldID{"sparse", 0}, nullptr), Exception);
+
+  try {
+    archive.read(sv_output, FieldID{"dense", 0}, nullptr);
+  } catch(Exception& e) {
+    EXPECT_NE(std::string(e.what()).find("unexpected end of file"), std::string::npos);
+  }
 }
 
 TEST_F(BinaryArchiveUtilityTest, SliceWriteAndRead) {
@@ -348,6 +388,43 @@ TEST_F(BinaryArchiveUtilityTest, SliceWriteAndRead) {
   }
 }
 
+TEST_F(BinaryArchiveUtilityTest, StridedSliceRead) {
+  using Storage = Storage<double>;
+  Storage u(Storage::ColMajor, {64, 64, 64}, Storage::random);
+  Storage u_output(Storage::ColMajor, {64, 64, 64});
+
+  {
+    BinaryArchive archive(OpenModeKind::Write, directory->path().string(), "field");
+    auto sv = u.toStorageView();
+    archive.write(sv, "u", nullptr);
+    archive.write(sv, "v", nullptr); // Second record of the file
+  }
+
+  BinaryArchive archive(OpenModeKind::Read, directory->path().string(), "field");
+
+  // The touched planes are read separately
+  auto sv_output = u_output.toStorageView();
+  sv_output.setSlice(Slice(1, -1, 4)(0, -1, 4)(3, -1, 8));
+
+  const std::size_t planeSize = 64 * 64 * sizeof(double);
+  auto extents = BinaryBuffer(sv_output).extents(sv_output, BinaryBuffer::FileRequestCost);
+  ASSERT_EQ(extents.size(), 8);
+
+  std::size_t numBytesRead = 0;
+  for(const auto& extent : extents) {
+    EXPECT_LE(extent.size, planeSize);
+    numBytesRead += extent.size;
+  }
+  EXPECT_LE(numBytesRead, 8 * planeSize); // An eighth of the record
+
+  archive.read(sv_output, FieldID{"u", 0}, nullptr);
+
+  for(int k = 3; k < 64; k += 8)
+    for(int j = 0; j < 64; j += 4)
+      for(int i = 1; i < 64; i += 4)
+        ASSERT_EQ(u_output(i, j, k), u(i, j, k));
+}
+
 //===------------------------------------------------------------------------------------------===//
 //     Read/Write tests
 //===------------------------------------------------------------------------------------------===//
@@ -550,3 +627,183 @@ TYPED_TEST(BinaryArchiveReadWriteTest, WriteAndRead) {
     EXPECT_FALSE(filesystem::exists(this->directory->path() / ("field_storage_7d.dat")));
   }
 }
+
+TYPED_TEST(BinaryArchiveReadWriteTest, SparseWriteAndRead) {
+  using Storage = Storage<TypeParam>;
+
+  // Field which is zero except for a few levels
+  Storage sparse_input(Storage::RowMajor, {8, 9, 10}, {{2, 2}, {4, 2}, {4, 5}});
+  sparse_input.forEach([](int) { return TypeParam(0); });
+  for(int i = 0; i < 8; ++i)
+    for(int j = 0; j < 9; ++j) {
+      sparse_input(i, j, 3) = TypeParam(i + j + 1);
+      sparse_input(i, j, 7) = TypeParam(i * j + 1);
+    }
+
+  Storage dense_input(Storage::ColMajor, {8, 9, 10}, Storage::sequential);
+
+  Storage sparse_output_colmajor(Storage::ColMajor, {8, 9, 10}, Storage::random);
+  Storage sparse_output_rowmajor(Storage::RowMajor, {8, 9, 10}, Storage::random);
+  Storage sparse_output_sliced(Storage::ColMajor, {8, 9, 10}, Storage::random);
+
+  {
+    BinaryArchive archiveWrite(OpenModeKind::Write, this->directory->path().string(), "field");
+
+    auto sv_sparse = sparse_input.toStorageView();
+    auto sv_dense = dense_input.toStorageView();
+
+    ASSERT_EQ(archiveWrite.write(sv_sparse, "sparse", nullptr), (FieldID{"sparse", 0}));
+    ASSERT_EQ(archiveWrite.write(sv_dense, "sparse", nullptr), (FieldID{"sparse", 1}));
+
+    // Deduplication works independently of the encoding
+    ASSERT_EQ(archiveWrite.write(sv_sparse, "sparse", nullptr), (FieldID{"sparse", 0}));
+
+    const auto& fieldOffsetTable = archiveWrite.fieldTable().at("sparse");
+    EXPECT_EQ(fieldOffsetTable[0].encoding, BinaryArchive::EncodingKind::Sparse);
+    EXPECT_EQ(fieldOffsetTable[1].encoding, BinaryArchive::EncodingKind::Dense);
+
+    // Dense field is stored right after the sparse field
+    EXPECT_LT(fieldOffsetTable[1].offset, std::streamoff(sv_sparse.sizeInBytes()));
+  }
+
+  {
+    BinaryArchive archiveRead(OpenModeKind::Read, this->directory->path().string(), "field");
+    EXPECT_EQ(archiveRead.fieldTable().at("sparse")[0].encoding,
+              BinaryArchive::EncodingKind::Sparse);
+
+    auto sv_colmajor = sparse_output_colmajor.toStorageView();
+    archiveRead.read(sv_colmajor, FieldID{"sparse", 0}, nullptr);
+    ASSERT_TRUE(Storage::verify(sparse_output_colmajor, sparse_input));
+
+    auto sv_rowmajor = sparse_output_rowmajor.toStorageView();
+    archiveRead.read(sv_rowmajor, FieldID{"sparse", 0}, nullptr);
+    ASSERT_TRUE(Storage::verify(sparse_output_rowmajor, sparse_input));
+
+    auto sv_sliced = sparse_output_sliced.toStorageView();
+    sv_sliced.setSlice(Slice(1, -1, 3)(0, -1, 2)(2, 9, 5));
+    archiveRead.read(sv_sliced, FieldID{"sparse", 0}, nullptr);
+    for(int k = 2; k < 9; k += 5)
+      for(int j = 0; j < 9; j += 2)
+        for(int i = 1; i < 8; i += 3)
+          ASSERT_EQ(sparse_output_sliced(i, j, k), sparse_input(i, j, k))
+              << "(i,j,k) = (" << i << "," << j << "," << k << ")";
+
+    Storage dense_output(Storage::ColMajor, {8, 9, 10});
+    auto sv_dense = dense_output.toStorageView();
+    archiveRead.read(sv_dense, FieldID{"sparse", 1}, nullptr);
+    ASSERT_TRUE(Storage::verify(dense_output, dense_input));
+  }
+}
+
+TYPED_TEST(BinaryArchiveReadWriteTest, AppendDeduplication) {
+  using Storage = Storage<TypeParam>;
+
+  Storage u_0(Storage::ColMajor, {5, 6, 7}, Storage::random);
+  Storage u_1(Storage::ColMajor, {5, 6, 7}, Storage::random);
+  Storage u_2(Storage::ColMajor, {5, 6, 7}, Storage::random);
+
+  auto sv_0 = u_0.toStorageView();
+  auto sv_1 = u_1.toStorageView();
+  auto sv_2 = u_2.toStorageView();
+
+  {
+    BinaryArchive archive(OpenModeKind::Write, this->directory->path().string(), "field");
+    ASSERT_EQ(archive.write(sv_0, "u", nullptr), (FieldID{"u", 0}));
+    ASSERT_EQ(archive.write(sv_1, "u", nullptr), (FieldID{"u", 1}));
+  }
+
+  // Records of the previous run are detected by their checksum
+  {
+    BinaryArchive archive(OpenModeKind::Append, this->directory->path().string(), "field");
+    ASSERT_EQ(archive.write(sv_1, "u", nullptr), (FieldID{"u", 1}));
+    ASSERT_EQ(archive.write(sv_2, "u", nullptr), (FieldID{"u", 2}));
+    ASSERT_EQ(archive.write(sv_0, "u", nullptr), (FieldID{"u", 0}));
+    ASSERT_EQ(archive.write(sv_2, "u", nullptr), (FieldID{"u", 2}));
+
+    // Index is rebuilt if the field table is reset
+    archive.clearFieldTable();
+    ASSERT_EQ(archive.write(sv_2, "u", nullptr), (FieldID{"u", 0}));
+    ASSERT_EQ(archive.write(sv_1, "u", nullptr), (FieldID{"u", 1}));
+    ASSERT_EQ(archive.write(sv_2, "u", nullptr), (FieldID{"u", 0}));
+  }
+}
+
+TYPED_TEST(BinaryArchiveReadWriteTest, ForeignByteOrder) {
+  using Storage = Storage<TypeParam>;
+  using ByteOrderKind = BinaryArchive::ByteOrderKind;
+
+  const ByteOrderKind foreignByteOrder =
+      (BinaryArchive::nativeByteOrder() == ByteOrderKind::LittleEndian ? ByteOrderKind::BigEndian
+                                                                        : ByteOrderKind::LittleEndian);
+
+  Storage dense_input(Storage::ColMajor, {5, 6, 7}, Storage::random);
+  Storage sparse_input(Storage::ColMajor, {5, 6, 7});
+  sparse_input.forEach([](int) { return TypeParam(0); });
+  sparse_input(1, 2, 3) = TypeParam(5);
+  sparse_input(4, 5, 6) = TypeParam(-7);
+
+  auto sv_dense = dense_input.toStorageView();
+  auto sv_sparse = sparse_input.toStorageView();
+
+  // Create an empty archive which claims to be of foreign byte order
+  {
+    BinaryArchive archive(OpenModeKind::Write, this->directory->path().string(), "field");
+    EXPECT_EQ(archive.byteOrder(), BinaryArchive::nativeByteOrder());
+    archive.updateMetaData();
+
+    std::ifstream ifs(archive.metaDataFile());
+    json::json j;
+    ifs >> j;
+    ifs.close();
+
+    j["byte_order"] = (foreignByteOrder == ByteOrderKind::BigEndian ? "big" : "little");
+    std::ofstream ofs(archive.metaDataFile(), std::ios::out | std::ios::trunc);
+    ofs << j.dump(4);
+  }
+
+  // Appending keeps the byte order of the archive
+  {
+    BinaryArchive archive(OpenModeKind::Append, this->directory->path().string(), "field");
+    ASSERT_EQ(archive.byteOrder(), foreignByteOrder);
+    ASSERT_EQ(archive.write(sv_dense, "dense", nullptr), (FieldID{"dense", 0}));
+    ASSERT_EQ(archive.write(sv_sparse, "sparse", nullptr), (FieldID{"sparse", 0}));
+    EXPECT_EQ(archive.fieldTable().at("sparse")[0].encoding, BinaryArchive::EncodingKind::Sparse);
+
+    // Deduplication is not affected by the byte order
+    ASSERT_EQ(archive.write(sv_dense, "dense", nullptr), (FieldID{"dense", 0}));
+  }
+
+  // Data on disk is byte-swapped
+  {
+    std::ifstream ifs((this->directory->path() / "field_dense.dat").string(), std::ios::binary);
+    char bytes[sizeof(TypeParam)];
+    ifs.read(bytes, sizeof(TypeParam));
+    std::reverse(bytes, bytes + sizeof(TypeParam));
+    EXPECT_EQ(std::memcmp(bytes, &dense_input(0, 0, 0), sizeof(TypeParam)), 0);
+  }
+
+  // Read
+  {
+    BinaryArchive archive(OpenModeKind::Read, this->directory->path().string(), "field");
+    ASSERT_EQ(archive.byteOrder(), foreignByteOrder);
+
+    Storage dense_output(Storage::RowMajor, {5, 6, 7}, Storage::random);
+    auto sv_dense_output = dense_output.toStorageView();
+    archive.read(sv_dense_output, FieldID{"dense", 0}, nullptr);
+    ASSERT_TRUE(Storage::verify(dense_output, dense_input));
+
+    Storage sparse_output(Storage::ColMajor, {5, 6, 7}, Storage::random);
+    auto sv_sparse_output = sparse_output.toStorageView();
+    archive.read(sv_sparse_output, FieldID{"sparse", 0}, nullptr);
+    ASSERT_TRUE(Storage::verify(sparse_output, sparse_input));
+
+    Storage sliced_output(Storage::ColMajor, {5, 6, 7}, Storage::random);
+    auto sv_sliced_output = sliced_output.toStorageView();
+    sv_sliced_output.setSlice(Slice(0, -1, 2)(1, -1, 3)(2, 5));
+    archive.read(sv_sliced_output, FieldID{"dense", 0}, nullptr);
+    for(int k = 2; k < 5; ++k)
+      for(int j = 1; j < 6; j += 3)
+        for(int i = 0; i < 5; i += 2)
+          ASSERT_EQ(sliced_output(i, j, k), dense_input(i, j, k));
+  }
+}
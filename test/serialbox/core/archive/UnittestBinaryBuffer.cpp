@@ -0,0 +1,165 @@
+//===-- serialbox/core/archive/UnittestBinaryBuffer.cpp -----------------------------*- C++ -*-===//
+//
+//                                    S E R I A L B O X
+//
+// This file is distributed under terms of BSD license.
+// See LICENSE.txt for more information
+//
+//===------------------------------------------------------------------------------------------===//
+//
+/// \file
+/// This file contains the unittests for the BinaryBuffer.
+///
+//===------------------------------------------------------------------------------------------===//
+
+#include "utility/Storage.h"
+#include "serialbox/core/archive/BinaryBuffer.h"
+#include <gtest/gtest.h>
+#include <sstream>
+
+using namespace serialbox;
+using namespace unittest;
+
+namespace {
+
+std::size_t numBytes(const std::vector<BinaryBuffer::Extent>& extents) {
+  std::size_t size = 0;
+  for(const auto& extent : extents)
+    size += extent.size;
+  return size;
+}
+
+} // anonymous namespace
+
+TEST(BinaryBufferTest, Extents) {
+  using Storage = Storage<double>;
+  Storage u(Storage::ColMajor, {64, 64, 64});
+
+  // Unsliced and dense slices are loaded with a single request
+  {
+    auto sv = u.toStorageView();
+    BinaryBuffer buffer(sv);
+    auto extents = buffer.extents(sv, BinaryBuffer::FileRequestCost);
+    ASSERT_EQ(extents.size(), 1);
+    EXPECT_EQ(extents[0].offset, 0);
+    EXPECT_EQ(extents[0].size, buffer.size());
+  }
+  {
+    auto sv = u.toStorageView();
+    sv.setSlice(Slice()()(10, 20));
+    BinaryBuffer buffer(sv);
+    auto extents = buffer.extents(sv, BinaryBuffer::FileRequestCost);
+    ASSERT_EQ(extents.size(), 1);
+    EXPECT_EQ(buffer.offset(), 10 * 64 * 64 * sizeof(double));
+    EXPECT_EQ(extents[0].size, 10 * 64 * 64 * sizeof(double));
+  }
+
+  // Every 4th element in each dimension: only the touched planes are loaded
+  {
+    auto sv = u.toStorageView();
+    sv.setSlice(Slice(0, -1, 4)(0, -1, 4)(0, -1, 4));
+    BinaryBuffer buffer(sv);
+    auto extents = buffer.extents(sv, BinaryBuffer::FileRequestCost);
+    ASSERT_EQ(extents.size(), 16);
+    EXPECT_EQ(extents[1].offset, 4 * 64 * 64 * sizeof(double));
+    EXPECT_EQ(extents[0].size, (60 * 64 + 61) * sizeof(double));
+    EXPECT_LT(numBytes(extents), buffer.size() / 4);
+
+    // Without request cost, each element is loaded separately
+    EXPECT_EQ(buffer.extents(sv, 0).size(), 16 * 16 * 16);
+    EXPECT_EQ(numBytes(buffer.extents(sv, 0)), 16 * 16 * 16 * sizeof(double));
+
+    // With a large request cost, everything is loaded at once
+    EXPECT_EQ(buffer.extents(sv, buffer.size()).size(), 1);
+  }
+
+  // Empty slice
+  {
+    auto sv = u.toStorageView();
+    sv.setSlice(Slice(4, 4));
+    BinaryBuffer buffer(sv);
+    EXPECT_TRUE(buffer.extents(sv, BinaryBuffer::FileRequestCost).empty());
+  }
+}
+
+TEST(BinaryBufferTest, LoadExtents) {
+  using Storage = Storage<int>;
+  Storage u(Storage::ColMajor, {4, 5, 6}, Storage::sequential);
+  Storage u_output(Storage::ColMajor, {4, 5, 6});
+
+  // Record preceded by some other data
+  auto sv = u.toStorageView();
+  BinaryBuffer inputBuffer(sv);
+  inputBuffer.copyStorageViewToBuffer(sv);
+  std::stringstream stream;
+  stream << "header";
+  stream.write(inputBuffer.data(), inputBuffer.size());
+
+  auto sv_output = u_output.toStorageView();
+  sv_output.setSlice(Slice(1, 3)(0, -1, 2)(1, -1, 2));
+  BinaryBuffer buffer(sv_output);
+  auto extents = buffer.extents(sv_output, 0);
+  ASSERT_GT(extents.size(), 1);
+
+  buffer.load(stream, 6, extents);
+  buffer.byteSwapExtents(extents, sizeof(int));
+  buffer.byteSwapExtents(extents, sizeof(int));
+  buffer.copyBufferToStorageView(sv_output);
+
+  for(int k = 1; k < 6; k += 2)
+    for(int j = 0; j < 5; j += 2)
+      for(int i = 1; i < 3; ++i)
+        ASSERT_EQ(u_output(i, j, k), u(i, j, k));
+
+  // Loading beyond the end of the stream fails
+  ASSERT_THROW(buffer.load(stream, 100, extents), Exception);
+}
+
+namespace {
+
+/// Stream buffer failing the first `numFailures` reads
+class FlakyStreamBuffer : public std::stringbuf {
+public:
+  FlakyStreamBuffer(const std::string& data, int numFailures)
+      : std::stringbuf(data), numFailures_(numFailures) {}
+
+protected:
+  std::streamsize xsgetn(char* s, std::streamsize n) override {
+    if(numFailures_ > 0) {
+      --numFailures_;
+      throw std::ios_base::failure("injected failure");
+    }
+    return std::stringbuf::xsgetn(s, n);
+  }
+
+private:
+  int numFailures_;
+};
+
+} // anonymous namespace
+
+TEST(BinaryBufferTest, ReadFully) {
+  const std::string data("0123456789");
+  std::vector<Byte> buffer(6);
+
+  // Failed reads are retried
+  {
+    FlakyStreamBuffer streamBuffer(data, MaxReadRetries);
+    std::istream stream(&streamBuffer);
+    readFully(stream, 2, buffer.data(), buffer.size());
+    EXPECT_EQ(std::string(buffer.data(), buffer.size()), "234567");
+  }
+
+  // ... but only a bounded number of times
+  {
+    FlakyStreamBuffer streamBuffer(data, MaxReadRetries + 1);
+    std::istream stream(&streamBuffer);
+    ASSERT_THROW(readFully(stream, 2, buffer.data(), buffer.size()), Exception);
+  }
+
+  // Short reads are detected
+  {
+    std::stringstream stream(data);
+    ASSERT_THROW(readFully(stream, 6, buffer.data(), buffer.size()), Exception);
+  }
+}
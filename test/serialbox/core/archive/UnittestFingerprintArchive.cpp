@@ -0,0 +1,129 @@
+//===-- serialbox/core/archive/UnittestFingerprintArchive.cpp -----------------------*- C++ -*-===//
+//
+//                                    S E R I A L B O X
+//
+// This file is distributed under terms of BSD license.
+// See LICENSE.txt for more information
+//
+//===------------------------------------------------------------------------------------------===//
+//
+/// \file
+/// This file contains the unittests for the Fingerprint Archive.
+///
+//===------------------------------------------------------------------------------------------===//
+
+#include "utility/SerializerTestBase.h"
+#include "utility/Storage.h"
+#include "serialbox/core/archive/BinaryArchive.h"
+#include "serialbox/core/archive/FingerprintArchive.h"
+#include "serialbox/core/hash/HashFactory.h"
+#include <cmath>
+#include <gtest/gtest.h>
+#include <limits>
+
+using namespace serialbox;
+using namespace unittest;
+
+namespace {
+
+template <class T>
+class FingerprintArchiveReadWriteTest : public SerializerUnittestBase {};
+
+using TestTypes = testing::Types<double, float, int, std::int64_t>;
+
+} // anonymous namespace
+
+TYPED_TEST_CASE(FingerprintArchiveReadWriteTest, TestTypes);
+
+TYPED_TEST(FingerprintArchiveReadWriteTest, WriteAndRead) {
+  using Storage = Storage<TypeParam>;
+
+  Storage u_0(Storage::RowMajor, {5, 6, 7}, {{2, 2}, {4, 2}, {4, 5}}, Storage::random);
+  Storage u_1(Storage::ColMajor, {5, 6, 7}, Storage::random);
+
+  auto sv_0 = u_0.toStorageView();
+  auto sv_1 = u_1.toStorageView();
+
+  // -----------------------------------------------------------------------------------------------
+  // Writing
+  // -----------------------------------------------------------------------------------------------
+  {
+    FingerprintArchive archive(OpenModeKind::Write, this->directory->path().string(), "field");
+    BinaryArchive binaryArchive(OpenModeKind::Write, this->directory->path().string(), "binary");
+
+    FieldID id_0 = archive.write(sv_0, "u", nullptr);
+    FieldID id_1 = archive.write(sv_1, "u", nullptr);
+    EXPECT_EQ(id_0.id, 0);
+    EXPECT_EQ(id_1.id, 1);
+
+    // Identical data is recorded only once
+    EXPECT_EQ(archive.write(sv_0, "u", nullptr).id, 0);
+
+    // Checksums agree with the BinaryArchive
+    FieldID binaryId = binaryArchive.write(sv_0, "u", nullptr);
+    EXPECT_EQ(archive.fingerprint(id_0).checksum,
+              binaryArchive.fieldTable()["u"][binaryId.id].checksum);
+
+    // Statistics
+    TypeParam min = u_0(0, 0, 0), max = u_0(0, 0, 0);
+    double sum = 0.0;
+    for(int i = 0; i < 5; ++i)
+      for(int j = 0; j < 6; ++j)
+        for(int k = 0; k < 7; ++k) {
+          min = std::min(min, u_0(i, j, k));
+          max = std::max(max, u_0(i, j, k));
+          sum += u_0(i, j, k);
+        }
+    EXPECT_DOUBLE_EQ(archive.fingerprint(id_0).min, double(min));
+    EXPECT_DOUBLE_EQ(archive.fingerprint(id_0).max, double(max));
+    EXPECT_NEAR(archive.fingerprint(id_0).mean, sum / (5 * 6 * 7), 1e-6 * std::abs(sum));
+
+    // Fields cannot be read
+    ASSERT_THROW(archive.read(sv_0, id_0, nullptr), Exception);
+    ASSERT_THROW(archive.fingerprint(FieldID{"u", 2}), Exception);
+    ASSERT_THROW(archive.fingerprint(FieldID{"v", 0}), Exception);
+  }
+
+  // -----------------------------------------------------------------------------------------------
+  // Reading
+  // -----------------------------------------------------------------------------------------------
+  {
+    FingerprintArchive archive(OpenModeKind::Read, this->directory->path().string(), "field");
+    ASSERT_EQ(archive.fieldTable().size(), 1);
+    ASSERT_EQ(archive.fieldTable().at("u").size(), 2);
+    EXPECT_EQ(archive.fingerprint(FieldID{"u", 1}).checksum,
+              FingerprintArchive::computeFingerprint(sv_1, *archive.hash()).checksum);
+
+    // Writing in read mode is not allowed
+    ASSERT_THROW(archive.write(sv_0, "u", nullptr), Exception);
+  }
+
+  // -----------------------------------------------------------------------------------------------
+  // Appending
+  // -----------------------------------------------------------------------------------------------
+  {
+    FingerprintArchive archive(OpenModeKind::Append, this->directory->path().string(), "field");
+    EXPECT_EQ(archive.write(sv_1, "u", nullptr).id, 1);
+    EXPECT_EQ(archive.write(sv_1, "v", nullptr).id, 0);
+  }
+  {
+    FingerprintArchive archive(OpenModeKind::Read, this->directory->path().string(), "field");
+    EXPECT_EQ(archive.fieldTable().size(), 2);
+  }
+
+  // Reading non-existing archives fails
+  ASSERT_THROW(FingerprintArchive(OpenModeKind::Read, this->directory->path().string(), "X"),
+               Exception);
+}
+
+TEST(FingerprintArchiveTest, NaN) {
+  using Storage = Storage<double>;
+  Storage u(Storage::ColMajor, {4}, Storage::sequential);
+  u(1) = std::numeric_limits<double>::quiet_NaN();
+
+  auto hash = HashFactory::create(HashFactory::defaultHash());
+  auto fingerprint = FingerprintArchive::computeFingerprint(u.toStorageView(), *hash);
+  EXPECT_DOUBLE_EQ(fingerprint.min, u(0));
+  EXPECT_DOUBLE_EQ(fingerprint.max, u(3));
+  EXPECT_DOUBLE_EQ(fingerprint.mean, (u(0) + u(2) + u(3)) / 3);
+}
@@ -0,0 +1,192 @@
+//===-- serialbox/core/archive/UnittestLogArchive.cpp -------------------------------*- C++ -*-===//
+//
+//                                    S E R I A L B O X
+//
+// This file is distributed under terms of BSD license.
+// See LICENSE.txt for more information
+//
+//===------------------------------------------------------------------------------------------===//
+//
+/// \file
+/// This file contains the unittests for the Log Archive.
+///
+//===------------------------------------------------------------------------------------------===//
+
+#include "utility/SerializerTestBase.h"
+#include "utility/Storage.h"
+#include "serialbox/core/SerializerImpl.h"
+#include "serialbox/core/archive/LogArchive.h"
+#include <gtest/gtest.h>
+
+using namespace serialbox;
+using namespace unittest;
+
+namespace {
+
+template <class T>
+class LogArchiveReadWriteTest : public SerializerUnittestBase {};
+
+using TestTypes = testing::Types<double, float, int, std::int64_t>;
+
+class LogArchiveTest : public SerializerUnittestBase {};
+
+} // anonymous namespace
+
+TYPED_TEST_CASE(LogArchiveReadWriteTest, TestTypes);
+
+TYPED_TEST(LogArchiveReadWriteTest, WriteAndRead) {
+  using Storage = Storage<TypeParam>;
+
+  Storage u_0(Storage::RowMajor, {5, 6, 7}, {{2, 2}, {4, 2}, {4, 5}}, Storage::random);
+  Storage u_1(Storage::ColMajor, {5, 6, 7}, Storage::random);
+  Storage v_0(Storage::ColMajor, {3, 4}, Storage::random);
+  Storage u_output(Storage::ColMajor, {5, 6, 7});
+  Storage v_output(Storage::ColMajor, {3, 4});
+
+  auto sv_u_0 = u_0.toStorageView();
+  auto sv_u_1 = u_1.toStorageView();
+  auto sv_v_0 = v_0.toStorageView();
+  auto sv_u_output = u_output.toStorageView();
+  auto sv_v_output = v_output.toStorageView();
+  const std::string dir = this->directory->path().string();
+  const std::uint64_t size_u = 5 * 6 * 7 * sizeof(TypeParam), size_v = 3 * 4 * sizeof(TypeParam);
+
+  // -----------------------------------------------------------------------------------------------
+  // Writing
+  // -----------------------------------------------------------------------------------------------
+  {
+    LogArchive archive(OpenModeKind::Write, dir, "field");
+    EXPECT_EQ(archive.write(sv_u_0, "u", nullptr).id, 0);
+    EXPECT_EQ(archive.write(sv_v_0, "v", nullptr).id, 0);
+    EXPECT_EQ(archive.write(sv_u_1, "u", nullptr).id, 1);
+    archive.updateMetaData();
+
+    // Records are appended in the order they are written
+    EXPECT_EQ(archive.fieldTable().at("u")[0].offset, 0);
+    EXPECT_EQ(archive.fieldTable().at("v")[0].offset, size_u);
+    EXPECT_EQ(archive.fieldTable().at("u")[1].offset, size_u + size_v);
+    EXPECT_EQ(archive.logSize(), 2 * size_u + size_v);
+    EXPECT_EQ(filesystem::file_size(archive.logFile()), 2 * size_u + size_v);
+
+    archive.read(sv_u_output, FieldID{"u", 1}, nullptr);
+    ASSERT_TRUE(Storage::verify(u_output, u_1));
+
+    // Records need to match the StorageView
+    ASSERT_THROW(archive.read(sv_v_output, FieldID{"u", 0}, nullptr), Exception);
+  }
+
+  // -----------------------------------------------------------------------------------------------
+  // Appending
+  // -----------------------------------------------------------------------------------------------
+  {
+    LogArchive archive(OpenModeKind::Append, dir, "field");
+    ASSERT_EQ(archive.fieldTable().at("u").size(), 2);
+    EXPECT_EQ(archive.write(sv_u_1, "u", nullptr).id, 2);
+    EXPECT_EQ(archive.write(sv_v_0, "w", nullptr).id, 0);
+    EXPECT_EQ(archive.fieldTable().at("u")[2].offset, 2 * size_u + size_v);
+    archive.updateMetaData();
+  }
+
+  // -----------------------------------------------------------------------------------------------
+  // Reading
+  // -----------------------------------------------------------------------------------------------
+  {
+    LogArchive archive(OpenModeKind::Read, dir, "field");
+    ASSERT_EQ(archive.fieldTable().size(), 3);
+    ASSERT_EQ(archive.fieldTable().at("u").size(), 3);
+
+    archive.read(sv_u_output, FieldID{"u", 0}, nullptr);
+    ASSERT_TRUE(Storage::verify(u_output, u_0));
+    archive.read(sv_u_output, FieldID{"u", 2}, nullptr);
+    ASSERT_TRUE(Storage::verify(u_output, u_1));
+    archive.read(sv_v_output, FieldID{"v", 0}, nullptr);
+    ASSERT_TRUE(Storage::verify(v_output, v_0));
+    archive.read(sv_v_output, FieldID{"w", 0}, nullptr);
+    ASSERT_TRUE(Storage::verify(v_output, v_0));
+
+    EXPECT_EQ(archive.locate(FieldID{"u", 2}).file, archive.logFile());
+    EXPECT_EQ(archive.locate(FieldID{"u", 2}).offset, 2 * size_u + size_v);
+
+    ASSERT_THROW(archive.read(sv_u_output, FieldID{"u", 3}, nullptr), Exception);
+    ASSERT_THROW(archive.read(sv_u_output, FieldID{"x", 0}, nullptr), Exception);
+    ASSERT_THROW(archive.write(sv_u_0, "u", nullptr), Exception);
+  }
+
+  // Writing removes the log and its index
+  {
+    LogArchive archive(OpenModeKind::Write, dir, "field");
+    ASSERT_TRUE(archive.fieldTable().empty());
+    ASSERT_FALSE(filesystem::exists(archive.logFile()));
+    ASSERT_FALSE(filesystem::exists(archive.metaDataFile()));
+
+    // Records are readable once they have been flushed by updating the meta-data
+    archive.write(sv_u_0, "u", nullptr);
+    ASSERT_THROW(archive.read(sv_u_output, FieldID{"u", 0}, nullptr), Exception);
+    archive.updateMetaData();
+    archive.read(sv_u_output, FieldID{"u", 0}, nullptr);
+    ASSERT_TRUE(Storage::verify(u_output, u_0));
+  }
+
+  // Reading non-existing archives fails
+  ASSERT_THROW(LogArchive(OpenModeKind::Read, dir, "X"), Exception);
+}
+
+TEST_F(LogArchiveTest, SlicedRead) {
+  using Storage = Storage<double>;
+  Storage u(Storage::ColMajor, {6, 5, 10}, Storage::random);
+  Storage u_output(Storage::ColMajor, {6, 5, 10});
+  auto sv = u.toStorageView();
+
+  {
+    LogArchive archive(OpenModeKind::Write, directory->path().string(), "field");
+    archive.write(sv, "v", nullptr);
+    archive.write(sv, "u", nullptr);
+    archive.updateMetaData();
+  }
+
+  LogArchive archive(OpenModeKind::Read, directory->path().string(), "field");
+  StorageView sv_output = u_output.toStorageView();
+  sv_output.setSlice(Slice()()(4, 8, 2));
+  archive.read(sv_output, FieldID{"u", 0}, nullptr);
+
+  for(int k = 4; k < 8; k += 2)
+    for(int j = 0; j < 5; ++j)
+      for(int i = 0; i < 6; ++i)
+        ASSERT_EQ(u_output(i, j, k), u(i, j, k));
+}
+
+TEST_F(LogArchiveTest, Serializer) {
+  using Storage = Storage<double>;
+  const int numSavepoints = 3;
+
+  Storage u(Storage::ColMajor, {4, 3, 2}, Storage::random);
+  Storage v(Storage::ColMajor, {4, 3}, Storage::random);
+  Storage u_output(Storage::ColMajor, {4, 3, 2});
+  Storage v_output(Storage::ColMajor, {4, 3});
+  auto sv_u = u.toStorageView();
+  auto sv_v = v.toStorageView();
+
+  {
+    SerializerImpl s(OpenModeKind::Write, directory->path().string(), "Field", "Log");
+    s.registerField("u", sv_u.type(), sv_u.dims());
+    s.registerField("v", sv_v.type(), sv_v.dims());
+    for(int t = 0; t < numSavepoints; ++t) {
+      SavepointImpl savepoint("step");
+      savepoint.addMetainfo("t", t);
+      s.write("u", savepoint, sv_u);
+      s.write("v", savepoint, sv_v);
+    }
+  }
+
+  SerializerImpl s(OpenModeKind::Read, directory->path().string(), "Field", "Log");
+  ASSERT_EQ(s.savepoints().size(), numSavepoints);
+
+  // All fields of a savepoint are read from a single file
+  std::unordered_map<std::string, StorageView> storageViews{{"u", u_output.toStorageView()},
+                                                            {"v", v_output.toStorageView()}};
+  auto statistics = s.readSavepoint(*s.savepoints()[1], storageViews);
+  EXPECT_EQ(statistics.numFields, 2);
+  EXPECT_EQ(statistics.numFiles, 1);
+  ASSERT_TRUE(Storage::verify(u_output, u));
+  ASSERT_TRUE(Storage::verify(v_output, v));
+}
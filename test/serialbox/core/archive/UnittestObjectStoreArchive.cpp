@@ -0,0 +1,179 @@
+//===-- serialbox/core/archive/UnittestObjectStoreArchive.cpp -----------------------*- C++ -*-===//
+//
+//                                    S E R I A L B O X
+//
+// This file is distributed under terms of BSD license.
+// See LICENSE.txt for more information
+//
+//===------------------------------------------------------------------------------------------===//
+//
+/// \file
+/// This file contains the unittests for the ObjectStore Archive.
+///
+//===------------------------------------------------------------------------------------------===//
+
+#include "utility/SerializerTestBase.h"
+#include "utility/Storage.h"
+#include "serialbox/core/SerializerImpl.h"
+#include "serialbox/core/archive/ObjectStoreArchive.h"
+#include <atomic>
+#include <gtest/gtest.h>
+
+using namespace serialbox;
+using namespace unittest;
+
+namespace {
+
+/// \brief LocalObjectStore counting the requests
+class CountingObjectStore : public LocalObjectStore {
+public:
+  using LocalObjectStore::LocalObjectStore;
+
+  virtual void put(const std::string& key, const Byte* data, std::size_t size) override {
+    ++numPuts;
+    LocalObjectStore::put(key, data, size);
+  }
+
+  virtual void getRange(const std::string& key, std::uintmax_t offset, std::size_t size,
+                        Byte* data) const override {
+    numBytesRead += size;
+    LocalObjectStore::getRange(key, offset, size, data);
+  }
+
+  std::atomic<int> numPuts{0};
+  mutable std::atomic<std::size_t> numBytesRead{0};
+};
+
+template <class T>
+class ObjectStoreArchiveReadWriteTest : public SerializerUnittestBase {};
+
+using TestTypes = testing::Types<double, float, int, std::int64_t>;
+
+class ObjectStoreArchiveTest : public SerializerUnittestBase {};
+
+} // anonymous namespace
+
+TYPED_TEST_CASE(ObjectStoreArchiveReadWriteTest, TestTypes);
+
+TYPED_TEST(ObjectStoreArchiveReadWriteTest, WriteAndRead) {
+  using Storage = Storage<TypeParam>;
+
+  Storage u_0(Storage::RowMajor, {5, 6, 7}, {{2, 2}, {4, 2}, {4, 5}}, Storage::random);
+  Storage u_1(Storage::ColMajor, {5, 6, 7}, Storage::random);
+  Storage u_output(Storage::ColMajor, {5, 6, 7});
+
+  auto sv_0 = u_0.toStorageView();
+  auto sv_1 = u_1.toStorageView();
+  auto sv_output = u_output.toStorageView();
+  const std::string dir = this->directory->path().string();
+
+  // -----------------------------------------------------------------------------------------------
+  // Writing
+  // -----------------------------------------------------------------------------------------------
+  {
+    ObjectStoreArchive archive(OpenModeKind::Write, dir, "field");
+    archive.setNumThreads(2);
+
+    EXPECT_EQ(archive.write(sv_0, "u", nullptr).id, 0);
+    EXPECT_EQ(archive.write(sv_1, "u", nullptr).id, 1);
+
+    // Identical data is stored once (also across fields)
+    EXPECT_EQ(archive.write(sv_0, "u", nullptr).id, 0);
+    EXPECT_EQ(archive.write(sv_0, "v", nullptr).id, 0);
+    EXPECT_EQ(archive.numPendingBytes(), 2 * 5 * 6 * 7 * sizeof(TypeParam));
+
+    // Pending records can be read
+    archive.read(sv_output, FieldID{"v", 0}, nullptr);
+    ASSERT_TRUE(Storage::verify(u_output, u_0));
+
+    // Nothing is uploaded until the batch is full
+    archive.updateMetaData();
+    EXPECT_FALSE(filesystem::exists(filesystem::path(dir) / archive.manifestKey()));
+
+    archive.flush();
+    EXPECT_EQ(archive.numPendingBytes(), 0);
+    EXPECT_TRUE(filesystem::exists(filesystem::path(dir) / archive.manifestKey()));
+    EXPECT_TRUE(filesystem::exists(
+        filesystem::path(dir) / ObjectStoreArchive::objectKey(archive.fieldTable().at("u")[1])));
+
+    archive.read(sv_output, FieldID{"u", 1}, nullptr);
+    ASSERT_TRUE(Storage::verify(u_output, u_1));
+  }
+
+  // -----------------------------------------------------------------------------------------------
+  // Appending (the records are uploaded on destruction)
+  // -----------------------------------------------------------------------------------------------
+  {
+    ObjectStoreArchive archive(OpenModeKind::Append, dir, "field");
+    EXPECT_EQ(archive.write(sv_1, "u", nullptr).id, 1);
+    EXPECT_EQ(archive.write(sv_1, "w", nullptr).id, 0);
+  }
+
+  // -----------------------------------------------------------------------------------------------
+  // Reading
+  // -----------------------------------------------------------------------------------------------
+  {
+    ObjectStoreArchive archive(OpenModeKind::Read, dir, "field");
+    ASSERT_EQ(archive.fieldTable().size(), 3);
+    ASSERT_EQ(archive.fieldTable().at("u").size(), 2);
+
+    archive.read(sv_output, FieldID{"u", 0}, nullptr);
+    ASSERT_TRUE(Storage::verify(u_output, u_0));
+    archive.read(sv_output, FieldID{"w", 0}, nullptr);
+    ASSERT_TRUE(Storage::verify(u_output, u_1));
+
+    ASSERT_THROW(archive.read(sv_output, FieldID{"u", 2}, nullptr), Exception);
+    ASSERT_THROW(archive.read(sv_output, FieldID{"x", 0}, nullptr), Exception);
+    ASSERT_THROW(archive.write(sv_0, "u", nullptr), Exception);
+  }
+
+  // Reading non-existing archives fails
+  ASSERT_THROW(ObjectStoreArchive(OpenModeKind::Read, dir, "X"), Exception);
+}
+
+TEST_F(ObjectStoreArchiveTest, SlicedRead) {
+  using Storage = Storage<double>;
+  Storage u(Storage::ColMajor, {6, 5, 10}, Storage::random);
+  Storage u_output(Storage::ColMajor, {6, 5, 10});
+  auto sv = u.toStorageView();
+
+  auto store = std::make_shared<CountingObjectStore>(directory->path().string());
+  {
+    ObjectStoreArchive archive(OpenModeKind::Write, store, "field");
+    archive.write(sv, "u", nullptr);
+  }
+  EXPECT_EQ(store->numPuts, 2); // Record and manifest
+
+  ObjectStoreArchive archive(OpenModeKind::Read, store, "field");
+
+  // Only the range covering the slice of the last dimension is fetched
+  StorageView sv_output = u_output.toStorageView();
+  sv_output.setSlice(Slice()()(4, 8, 2));
+  archive.read(sv_output, FieldID{"u", 0}, nullptr);
+  EXPECT_EQ(store->numBytesRead, 6 * 5 * 3 * sizeof(double));
+
+  for(int k = 4; k < 8; k += 2)
+    for(int j = 0; j < 5; ++j)
+      for(int i = 0; i < 6; ++i)
+        ASSERT_EQ(u_output(i, j, k), u(i, j, k));
+}
+
+TEST_F(ObjectStoreArchiveTest, Serializer) {
+  using Storage = Storage<double>;
+  Storage u(Storage::ColMajor, {4, 3}, Storage::random);
+  Storage u_output(Storage::ColMajor, {4, 3});
+  auto sv = u.toStorageView();
+  auto sv_output = u_output.toStorageView();
+
+  SavepointImpl savepoint("sp");
+  {
+    SerializerImpl s(OpenModeKind::Write, directory->path().string(), "Field", "ObjectStore");
+    s.registerField("u", sv.type(), sv.dims());
+    s.write("u", savepoint, sv);
+  }
+  {
+    SerializerImpl s(OpenModeKind::Read, directory->path().string(), "Field", "ObjectStore");
+    s.read("u", savepoint, sv_output);
+    ASSERT_TRUE(Storage::verify(u_output, u));
+  }
+}
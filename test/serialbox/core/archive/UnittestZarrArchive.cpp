@@ -0,0 +1,199 @@
+//===-- serialbox/core/archive/UnittestZarrArchive.cpp ------------------------------*- C++ -*-===//
+//
+//                                    S E R I A L B O X
+//
+// This file is distributed under terms of BSD license.
+// See LICENSE.txt for more information
+//
+//===------------------------------------------------------------------------------------------===//
+//
+/// \file
+/// This file contains the unittests for the Zarr Archive.
+///
+//===------------------------------------------------------------------------------------------===//
+
+#include "utility/SerializerTestBase.h"
+#include "utility/Storage.h"
+#include "serialbox/core/SerializerImpl.h"
+#include "serialbox/core/archive/ZarrArchive.h"
+#include <fstream>
+#include <gtest/gtest.h>
+
+using namespace serialbox;
+using namespace unittest;
+
+namespace {
+
+template <class T>
+class ZarrArchiveReadWriteTest : public SerializerUnittestBase {};
+
+using TestTypes = testing::Types<double, float, int, std::int64_t>;
+
+class ZarrArchiveTest : public SerializerUnittestBase {};
+
+} // anonymous namespace
+
+TYPED_TEST_CASE(ZarrArchiveReadWriteTest, TestTypes);
+
+TYPED_TEST(ZarrArchiveReadWriteTest, WriteAndRead) {
+  using Storage = Storage<TypeParam>;
+
+  Storage u_0(Storage::RowMajor, {5, 6, 7}, {{2, 2}, {4, 2}, {4, 5}}, Storage::random);
+  Storage u_1(Storage::ColMajor, {5, 6, 7}, Storage::random);
+  Storage v_0(Storage::ColMajor, {3, 4}, Storage::random);
+  Storage u_output(Storage::ColMajor, {5, 6, 7});
+  Storage v_output(Storage::ColMajor, {3, 4});
+
+  auto sv_u_0 = u_0.toStorageView();
+  auto sv_u_1 = u_1.toStorageView();
+  auto sv_v_0 = v_0.toStorageView();
+  auto sv_u_output = u_output.toStorageView();
+  auto sv_v_output = v_output.toStorageView();
+  const std::string dir = this->directory->path().string();
+
+  // -----------------------------------------------------------------------------------------------
+  // Writing
+  // -----------------------------------------------------------------------------------------------
+  {
+    ZarrArchive archive(OpenModeKind::Write, dir, "field");
+    EXPECT_EQ(archive.write(sv_u_0, "u", nullptr).id, 0);
+    EXPECT_EQ(archive.write(sv_u_1, "u", nullptr).id, 1);
+    EXPECT_EQ(archive.write(sv_v_0, "v", nullptr).id, 0);
+    archive.updateMetaData();
+
+    // Records of the same field need to have the same dimensions
+    ASSERT_THROW(archive.write(sv_v_0, "u", nullptr), Exception);
+
+    archive.read(sv_u_output, FieldID{"u", 1}, nullptr);
+    ASSERT_TRUE(Storage::verify(u_output, u_1));
+  }
+
+  // -----------------------------------------------------------------------------------------------
+  // Appending
+  // -----------------------------------------------------------------------------------------------
+  {
+    ZarrArchive archive(OpenModeKind::Append, dir, "field");
+    ASSERT_EQ(archive.fieldTable().at("u").numRecords, 2);
+    EXPECT_EQ(archive.write(sv_u_1, "u", nullptr).id, 2);
+    EXPECT_EQ(archive.write(sv_v_0, "w", nullptr).id, 0);
+    archive.updateMetaData();
+  }
+
+  // -----------------------------------------------------------------------------------------------
+  // Reading
+  // -----------------------------------------------------------------------------------------------
+  {
+    ZarrArchive archive(OpenModeKind::Read, dir, "field");
+    ASSERT_EQ(archive.fieldTable().size(), 3);
+    ASSERT_EQ(archive.fieldTable().at("u").numRecords, 3);
+    ASSERT_EQ(archive.fieldTable().at("u").dims, (std::vector<int>{5, 6, 7}));
+
+    archive.read(sv_u_output, FieldID{"u", 0}, nullptr);
+    ASSERT_TRUE(Storage::verify(u_output, u_0));
+    archive.read(sv_u_output, FieldID{"u", 2}, nullptr);
+    ASSERT_TRUE(Storage::verify(u_output, u_1));
+    archive.read(sv_v_output, FieldID{"w", 0}, nullptr);
+    ASSERT_TRUE(Storage::verify(v_output, v_0));
+
+    ASSERT_THROW(archive.read(sv_u_output, FieldID{"u", 3}, nullptr), Exception);
+    ASSERT_THROW(archive.read(sv_u_output, FieldID{"x", 0}, nullptr), Exception);
+    ASSERT_THROW(archive.write(sv_u_0, "u", nullptr), Exception);
+  }
+
+  // Writing clears the group
+  {
+    ZarrArchive archive(OpenModeKind::Write, dir, "field");
+    ASSERT_TRUE(archive.fieldTable().empty());
+    ASSERT_FALSE(filesystem::exists(archive.group()));
+  }
+
+  // Reading non-existing archives fails
+  ASSERT_THROW(ZarrArchive(OpenModeKind::Read, dir, "X"), Exception);
+}
+
+TEST_F(ZarrArchiveTest, Layout) {
+  using Storage = Storage<double>;
+  Storage u(Storage::ColMajor, {4, 3}, Storage::random);
+  auto sv = u.toStorageView();
+
+  ZarrArchive archive(OpenModeKind::Write, directory->path().string(), "field");
+  archive.write(sv, "u", nullptr);
+  archive.write(sv, "u", nullptr);
+  archive.updateMetaData();
+
+  filesystem::path arrayDir = directory->path() / "field.zarr" / "u";
+  ASSERT_TRUE(filesystem::exists(directory->path() / "field.zarr" / ".zgroup"));
+  ASSERT_TRUE(filesystem::exists(arrayDir / "0.0.0"));
+  ASSERT_TRUE(filesystem::exists(arrayDir / "1.0.0"));
+  EXPECT_EQ(filesystem::file_size(arrayDir / "1.0.0"), 4 * 3 * sizeof(double));
+
+  json::json arrayNode;
+  std::ifstream fs((arrayDir / ".zarray").string());
+  fs >> arrayNode;
+
+  EXPECT_EQ(arrayNode["zarr_format"], 2);
+  EXPECT_EQ(arrayNode["shape"], (std::vector<int>{2, 4, 3}));
+  EXPECT_EQ(arrayNode["chunks"], (std::vector<int>{1, 4, 3}));
+  EXPECT_EQ(arrayNode["dtype"],
+            ZarrArchive::dtypeOf(TypeID::Float64, BinaryArchive::nativeByteOrder()));
+  EXPECT_EQ(arrayNode["order"], "F");
+  EXPECT_TRUE(arrayNode["compressor"].is_null());
+
+  EXPECT_EQ(ZarrArchive::dtypeOf(TypeID::Int32, BinaryArchive::ByteOrderKind::BigEndian), ">i4");
+  EXPECT_EQ(ZarrArchive::dtypeOf(TypeID::Float32, BinaryArchive::ByteOrderKind::LittleEndian),
+            "<f4");
+  ASSERT_THROW(
+      ZarrArchive::dtypeOf(TypeID::String, BinaryArchive::ByteOrderKind::LittleEndian),
+      Exception);
+}
+
+TEST_F(ZarrArchiveTest, SlicedRead) {
+  using Storage = Storage<double>;
+  Storage u(Storage::ColMajor, {6, 5, 10}, Storage::random);
+  Storage u_output(Storage::ColMajor, {6, 5, 10});
+  auto sv = u.toStorageView();
+
+  {
+    ZarrArchive archive(OpenModeKind::Write, directory->path().string(), "field");
+    archive.write(sv, "u", nullptr);
+    archive.updateMetaData();
+  }
+
+  ZarrArchive archive(OpenModeKind::Read, directory->path().string(), "field");
+  StorageView sv_output = u_output.toStorageView();
+  sv_output.setSlice(Slice()()(4, 8, 2));
+  archive.read(sv_output, FieldID{"u", 0}, nullptr);
+
+  for(int k = 4; k < 8; k += 2)
+    for(int j = 0; j < 5; ++j)
+      for(int i = 0; i < 6; ++i)
+        ASSERT_EQ(u_output(i, j, k), u(i, j, k));
+}
+
+TEST_F(ZarrArchiveTest, Serializer) {
+  using Storage = Storage<double>;
+  Storage u(Storage::ColMajor, {4, 3}, Storage::random);
+  Storage u_output(Storage::ColMajor, {4, 3});
+  auto sv = u.toStorageView();
+  auto sv_output = u_output.toStorageView();
+
+  SavepointImpl savepoint("sp");
+  {
+    SerializerImpl s(OpenModeKind::Write, directory->path().string(), "Field", "Zarr");
+    s.registerField("u", sv.type(), sv.dims());
+    s.addFieldMetainfoImpl("u", "halo", 3);
+    s.write("u", savepoint, sv);
+  }
+  {
+    SerializerImpl s(OpenModeKind::Read, directory->path().string(), "Field", "Zarr");
+    s.read("u", savepoint, sv_output);
+    ASSERT_TRUE(Storage::verify(u_output, u));
+  }
+
+  // The meta-information of the field is stored in the attributes of the array
+  json::json attributes;
+  std::ifstream fs((directory->path() / "Field.zarr" / "u" / ".zattrs").string());
+  fs >> attributes;
+  EXPECT_EQ(attributes["serialbox_dims"], (std::vector<int>{4, 3}));
+  EXPECT_TRUE(attributes["serialbox_metainfo"].count("halo"));
+}